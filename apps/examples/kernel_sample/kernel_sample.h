@@ -152,6 +152,10 @@ void mutex_test(void);
 
 void recursive_mutex_test(void);
 
+/* mutexbench.c *************************************************************/
+
+void mutexbench_test(void);
+
 /* sem.c ********************************************************************/
 
 void sem_test(void);
@@ -176,6 +180,10 @@ void mqueue_test(void);
 
 void timedmqueue_test(void);
 
+/* mqbench.c ****************************************************************/
+
+void mqbench_test(void);
+
 /* cancel.c *****************************************************************/
 
 void cancel_test(void);
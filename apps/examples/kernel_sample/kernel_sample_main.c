@@ -361,6 +361,14 @@ static int user_main(int argc, char *argv[])
 		check_test_memory_usage();
 #endif
 
+#ifndef CONFIG_DISABLE_PTHREAD
+		/* Measure the cost of locking and unlocking a mutex */
+
+		printf("\nuser_main: mutex benchmark\n");
+		mutexbench_test();
+		check_test_memory_usage();
+#endif
+
 #ifndef CONFIG_DISABLE_PTHREAD
 		/* Verify pthread cancellation */
 
@@ -424,6 +432,14 @@ static int user_main(int argc, char *argv[])
 		check_test_memory_usage();
 #endif
 
+#if !defined(CONFIG_DISABLE_MQUEUE) && !defined(CONFIG_DISABLE_PTHREAD) && defined(CONFIG_MQ_ZEROCOPY)
+		/* Compare copying and zero-copy message queue throughput */
+
+		printf("\nuser_main: message queue benchmark\n");
+		mqbench_test();
+		check_test_memory_usage();
+#endif
+
 #ifndef CONFIG_DISABLE_SIGNALS
 		/* Verify signal handlers */
 
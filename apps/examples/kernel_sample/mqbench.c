@@ -0,0 +1,242 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**************************************************************************
+ * examples/kernel_sample/mqbench.c
+ *
+ * Message queue throughput: mq_send()/mq_receive(), which copy every
+ * message in and out of the queue, against the zero-copy interfaces
+ * (mq_getbuf/mq_sendbuf/mq_receivebuf/mq_freebuf) on a queue created with
+ * MQ_ZEROCOPY.  A sender thread passes MQBENCH_NMSGS messages of each size
+ * to the receiver, which checks them.
+ **************************************************************************/
+
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <mqueue.h>
+#include <time.h>
+#include <errno.h>
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define MQBENCH_NAME       "mqbench"
+#define MQBENCH_NMSGS      2000
+#define MQBENCH_MAXMSG     8
+#define MQBENCH_MAXSIZE    1024
+
+/**************************************************************************
+ * Private Types
+ **************************************************************************/
+
+struct mqbench_s {
+	size_t msgsize;				/* Size of each message */
+	bool zerocopy;				/* Use the zero-copy interfaces */
+	mqd_t mqfd;
+	int nerrors;
+};
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+static const size_t g_msgsizes[] = { 16, 128, 512, MQBENCH_MAXSIZE };
+
+/* Buffers of the copying sender and receiver */
+
+static uint8_t g_sendbuf[MQBENCH_MAXSIZE];
+static uint8_t g_recvbuf[MQBENCH_MAXSIZE];
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+/* Every message is filled with its sequence number */
+
+static void mqbench_fill(FAR uint8_t *msg, size_t msgsize, int seq)
+{
+	memset(msg, (uint8_t)seq, msgsize);
+}
+
+static bool mqbench_check(FAR const uint8_t *msg, size_t msgsize, int seq)
+{
+	return msg[0] == (uint8_t)seq && msg[msgsize - 1] == (uint8_t)seq;
+}
+
+static void *mqbench_sender(void *arg)
+{
+	FAR struct mqbench_s *bench = (FAR struct mqbench_s *)arg;
+	FAR void *buf;
+	int i;
+
+	for (i = 0; i < MQBENCH_NMSGS; i++) {
+		if (bench->zerocopy) {
+			buf = mq_getbuf(bench->mqfd);
+			if (buf == NULL) {
+				printf("mqbench: ERROR mq_getbuf failed: %d\n", errno);
+				bench->nerrors++;
+				break;
+			}
+
+			mqbench_fill(buf, bench->msgsize, i);
+			if (mq_sendbuf(bench->mqfd, buf, bench->msgsize, 1) < 0) {
+				printf("mqbench: ERROR mq_sendbuf failed: %d\n", errno);
+				mq_freebuf(bench->mqfd, buf);
+				bench->nerrors++;
+				break;
+			}
+		} else {
+			mqbench_fill(g_sendbuf, bench->msgsize, i);
+			if (mq_send(bench->mqfd, (FAR const char *)g_sendbuf, bench->msgsize, 1) < 0) {
+				printf("mqbench: ERROR mq_send failed: %d\n", errno);
+				bench->nerrors++;
+				break;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static void mqbench_receive(FAR struct mqbench_s *bench)
+{
+	FAR void *buf;
+	ssize_t nbytes;
+	int i;
+
+	for (i = 0; i < MQBENCH_NMSGS; i++) {
+		if (bench->zerocopy) {
+			nbytes = mq_receivebuf(bench->mqfd, &buf, NULL);
+		} else {
+			buf = g_recvbuf;
+			nbytes = mq_receive(bench->mqfd, (FAR char *)g_recvbuf, sizeof(g_recvbuf), NULL);
+		}
+
+		if (nbytes < 0) {
+			printf("mqbench: ERROR receive failed: %d\n", errno);
+			bench->nerrors++;
+			return;
+		}
+
+		if (nbytes != bench->msgsize || !mqbench_check(buf, nbytes, i)) {
+			printf("mqbench: ERROR bad message %d (%d bytes)\n", i, (int)nbytes);
+			bench->nerrors++;
+		}
+
+		if (bench->zerocopy) {
+			mq_freebuf(bench->mqfd, buf);
+		}
+	}
+}
+
+/* Run one size in one mode and return the elapsed time in microseconds */
+
+static uint32_t mqbench_run(FAR struct mqbench_s *bench)
+{
+	struct mq_attr attr;
+	struct timespec start;
+	struct timespec end;
+	pthread_t sender;
+	int ret;
+
+	attr.mq_maxmsg   = MQBENCH_MAXMSG;
+	attr.mq_msgsize  = bench->msgsize;
+	attr.mq_flags    = 0;
+	attr.mq_curmsgs  = 0;
+
+	/* Plain queues are limited to CONFIG_MQ_MAXMSGSIZE; larger messages
+	 * are copied through the pool of a zero-copy queue.
+	 */
+
+	if (bench->zerocopy || bench->msgsize > CONFIG_MQ_MAXMSGSIZE) {
+		attr.mq_flags = MQ_ZEROCOPY;
+	}
+
+	bench->mqfd = mq_open(MQBENCH_NAME, O_RDWR | O_CREAT, 0666, &attr);
+	if (bench->mqfd == (mqd_t)-1) {
+		printf("mqbench: ERROR mq_open failed: %d\n", errno);
+		bench->nerrors++;
+		return 0;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	ret = pthread_create(&sender, NULL, mqbench_sender, bench);
+	if (ret != 0) {
+		printf("mqbench: ERROR pthread_create failed: %d\n", ret);
+		bench->nerrors++;
+	} else {
+		mqbench_receive(bench);
+		pthread_join(sender, NULL);
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	mq_close(bench->mqfd);
+	mq_unlink(MQBENCH_NAME);
+
+	return (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+void mqbench_test(void)
+{
+	struct mqbench_s bench;
+	uint32_t usecs[2];
+	int nerrors = 0;
+	int mode;
+	int i;
+
+	printf("mqbench: %d messages per run, queue depth %d\n", MQBENCH_NMSGS, MQBENCH_MAXMSG);
+	printf("mqbench: %6s %12s %12s\n", "size", "copy msg/s", "zcopy msg/s");
+
+	for (i = 0; i < sizeof(g_msgsizes) / sizeof(g_msgsizes[0]); i++) {
+		for (mode = 0; mode < 2; mode++) {
+			memset(&bench, 0, sizeof(bench));
+			bench.msgsize  = g_msgsizes[i];
+			bench.zerocopy = (mode == 1);
+
+			usecs[mode] = mqbench_run(&bench);
+			nerrors += bench.nerrors;
+			if (usecs[mode] == 0) {
+				usecs[mode] = 1;
+			}
+		}
+
+		printf("mqbench: %6d %12lu %12lu\n", (int)g_msgsizes[i],
+			   (unsigned long)((uint64_t)MQBENCH_NMSGS * 1000000 / usecs[0]),
+			   (unsigned long)((uint64_t)MQBENCH_NMSGS * 1000000 / usecs[1]));
+	}
+
+	if (nerrors > 0) {
+		printf("mqbench: ERROR %d errors\n", nerrors);
+	}
+}
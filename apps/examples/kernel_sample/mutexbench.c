@@ -0,0 +1,234 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**************************************************************************
+ * examples/kernel_sample/mutexbench.c
+ *
+ * Cost of a pthread_mutex_lock()/pthread_mutex_unlock() pair:
+ *
+ *  - uncontended: one thread locks and unlocks the mutex in a loop
+ *  - recursive:   the same for a recursive mutex that is already held
+ *  - contended:   two threads of the same priority yield while holding
+ *                 the mutex, so that every lock has to wait for the other
+ *                 thread
+ *
+ * Run it with and without CONFIG_PTHREAD_MUTEX_FASTPATH to compare.
+ **************************************************************************/
+
+/**************************************************************************
+ * Included Files
+ **************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "kernel_sample.h"
+
+/**************************************************************************
+ * Private Definitions
+ **************************************************************************/
+
+#define MUTEXBENCH_NLOOPS      10000
+#define MUTEXBENCH_NCONTENDED  1000
+
+/**************************************************************************
+ * Private Variables
+ **************************************************************************/
+
+static pthread_mutex_t g_benchmutex;
+static volatile int g_benchcount;
+static int g_bencherrors;
+
+/**************************************************************************
+ * Private Functions
+ **************************************************************************/
+
+static uint32_t mutexbench_usecs(FAR const struct timespec *start, FAR const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1000000 + (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void mutexbench_report(FAR const char *name, int npairs, uint32_t usecs)
+{
+	printf("mutexbench: %-12s %6d pairs %8lu us %6lu ns/pair\n", name, npairs,
+		   (unsigned long)usecs, (unsigned long)((uint64_t)usecs * 1000 / npairs));
+}
+
+static void mutexbench_lockunlock(int nloops)
+{
+	int ret;
+	int i;
+
+	for (i = 0; i < nloops; i++) {
+		ret = pthread_mutex_lock(&g_benchmutex);
+		if (ret != 0) {
+			printf("mutexbench: ERROR pthread_mutex_lock failed: %d\n", ret);
+			g_bencherrors++;
+			return;
+		}
+
+		g_benchcount++;
+
+		ret = pthread_mutex_unlock(&g_benchmutex);
+		if (ret != 0) {
+			printf("mutexbench: ERROR pthread_mutex_unlock failed: %d\n", ret);
+			g_bencherrors++;
+			return;
+		}
+	}
+}
+
+static void *mutexbench_contender(void *arg)
+{
+	int i;
+
+	for (i = 0; i < MUTEXBENCH_NCONTENDED; i++) {
+		if (pthread_mutex_lock(&g_benchmutex) != 0) {
+			g_bencherrors++;
+			break;
+		}
+
+		/* Let the other thread run; it will block on the mutex */
+
+		g_benchcount++;
+		sched_yield();
+
+		if (pthread_mutex_unlock(&g_benchmutex) != 0) {
+			g_bencherrors++;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void mutexbench_uncontended(FAR const char *name, FAR pthread_mutexattr_t *attr, bool hold)
+{
+	struct timespec start;
+	struct timespec end;
+
+	pthread_mutex_init(&g_benchmutex, attr);
+	g_benchcount = 0;
+
+	if (hold) {
+		pthread_mutex_lock(&g_benchmutex);
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	mutexbench_lockunlock(MUTEXBENCH_NLOOPS);
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	if (hold) {
+		pthread_mutex_unlock(&g_benchmutex);
+	}
+
+	pthread_mutex_destroy(&g_benchmutex);
+
+	if (g_benchcount != MUTEXBENCH_NLOOPS) {
+		printf("mutexbench: ERROR %s count %d\n", name, g_benchcount);
+		g_bencherrors++;
+	}
+
+	mutexbench_report(name, MUTEXBENCH_NLOOPS, mutexbench_usecs(&start, &end));
+}
+
+static void mutexbench_contended(void)
+{
+	struct sched_param sparam;
+	struct timespec start;
+	struct timespec end;
+	pthread_attr_t attr;
+	pthread_t threads[2];
+	int ret;
+	int i;
+
+	pthread_mutex_init(&g_benchmutex, NULL);
+	g_benchcount = 0;
+
+	/* Both threads run at the same priority so that sched_yield() switches
+	 * between them.
+	 */
+
+	pthread_attr_init(&attr);
+	sched_getparam(0, &sparam);
+	pthread_attr_setschedparam(&attr, &sparam);
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < 2; i++) {
+		ret = pthread_create(&threads[i], &attr, mutexbench_contender, NULL);
+		if (ret != 0) {
+			printf("mutexbench: ERROR pthread_create failed: %d\n", ret);
+			g_bencherrors++;
+			threads[i] = 0;
+		}
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (threads[i] != 0) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	pthread_mutex_destroy(&g_benchmutex);
+
+	if (g_benchcount != 2 * MUTEXBENCH_NCONTENDED) {
+		printf("mutexbench: ERROR contended count %d\n", g_benchcount);
+		g_bencherrors++;
+	}
+
+	mutexbench_report("contended", 2 * MUTEXBENCH_NCONTENDED, mutexbench_usecs(&start, &end));
+}
+
+/**************************************************************************
+ * Public Functions
+ **************************************************************************/
+
+void mutexbench_test(void)
+{
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+	pthread_mutexattr_t attr;
+#endif
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	printf("mutexbench: fast path enabled\n");
+#else
+	printf("mutexbench: fast path disabled\n");
+#endif
+
+	g_bencherrors = 0;
+	mutexbench_uncontended("uncontended", NULL, false);
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	mutexbench_uncontended("recursive", &attr, true);
+	pthread_mutexattr_destroy(&attr);
+#endif
+
+	mutexbench_contended();
+
+	if (g_bencherrors > 0) {
+		printf("mutexbench: ERROR %d errors\n", g_bencherrors);
+	}
+}
@@ -0,0 +1,397 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * examples/mboxbench/mboxbench_main.c
+ *
+ * Throughput and latency of the lwIP mailboxes:
+ *
+ *  - mbox throughput: producer threads post to a mailbox emptied by a
+ *                     single consumer thread
+ *  - mbox latency:    a message bounces between two threads over two
+ *                     mailboxes
+ *  - tcpip throughput: producer threads queue callbacks to the tcpip thread
+ *  - tcpip latency:   a callback to the tcpip thread wakes up the caller
+ *
+ * Run it with and without CONFIG_NET_LWIP_MBOX_LOCKFREE to compare.
+ *
+ * Usage: mboxbench [nmsgs [nproducers]]
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
+#include <net/lwip/sys.h>
+#include <net/lwip/tcpip.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MBOXBENCH_NMSGS       10000
+#define MBOXBENCH_NROUNDTRIPS 1000
+#define MBOXBENCH_MAXPRODUCERS 8
+#define MBOXBENCH_MBOXSIZE    32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mboxbench_producer_s {
+	int nmsgs;
+	int id;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sys_mbox_t g_mbox_req;
+static sys_mbox_t g_mbox_rsp;
+static sem_t g_done;
+static volatile int g_ncallbacks;
+static int g_ntarget;
+static int g_errors;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t mboxbench_usecs(FAR const struct timespec *start, FAR const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1000000 + (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void mboxbench_report(FAR const char *name, FAR const char *unit, int count, uint32_t usecs)
+{
+	printf("mboxbench: %-16s %6d %-5s %8lu us %6lu ns/%s\n", name, count, unit,
+		   (unsigned long)usecs, (unsigned long)((uint64_t)usecs * 1000 / count), unit);
+}
+
+static int mboxbench_start_producers(FAR pthread_t *threads, FAR struct mboxbench_producer_s *args, int nproducers, int nmsgs, pthread_startroutine_t entry)
+{
+	struct sched_param sparam;
+	pthread_attr_t attr;
+	int ret;
+	int i;
+
+	/* Producers run at the priority of the caller, like application tasks
+	 * calling into the socket layer.
+	 */
+
+	pthread_attr_init(&attr);
+	sched_getparam(0, &sparam);
+	pthread_attr_setschedparam(&attr, &sparam);
+
+	for (i = 0; i < nproducers; i++) {
+		args[i].id = i;
+		args[i].nmsgs = nmsgs / nproducers;
+		if (i == 0) {
+			args[i].nmsgs += nmsgs % nproducers;
+		}
+
+		ret = pthread_create(&threads[i], &attr, entry, &args[i]);
+		if (ret != 0) {
+			printf("mboxbench: ERROR pthread_create failed: %d\n", ret);
+			g_errors++;
+			return i;
+		}
+	}
+
+	return nproducers;
+}
+
+static void mboxbench_join(FAR pthread_t *threads, int nthreads)
+{
+	int i;
+
+	for (i = 0; i < nthreads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+}
+
+/* Raw mailbox throughput ***************************************************/
+
+static void *mboxbench_mbox_producer(void *arg)
+{
+	FAR struct mboxbench_producer_s *producer = (FAR struct mboxbench_producer_s *)arg;
+	int i;
+
+	for (i = 0; i < producer->nmsgs; i++) {
+		sys_mbox_post(&g_mbox_req, (void *)(uintptr_t)(i + 1));
+	}
+
+	return NULL;
+}
+
+static void *mboxbench_mbox_consumer(void *arg)
+{
+	int nmsgs = (int)(intptr_t)arg;
+	void *msg;
+	int i;
+
+	for (i = 0; i < nmsgs; i++) {
+		if (sys_arch_mbox_fetch(&g_mbox_req, &msg, 0) == SYS_ARCH_CANCELED || msg == NULL) {
+			g_errors++;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void mboxbench_mbox_throughput(int nmsgs, int nproducers)
+{
+	struct mboxbench_producer_s args[MBOXBENCH_MAXPRODUCERS];
+	pthread_t threads[MBOXBENCH_MAXPRODUCERS + 1];
+	struct timespec start;
+	struct timespec end;
+	int nthreads;
+
+	if (sys_mbox_new(&g_mbox_req, MBOXBENCH_MBOXSIZE) != ERR_OK) {
+		printf("mboxbench: ERROR sys_mbox_new failed\n");
+		g_errors++;
+		return;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	if (pthread_create(&threads[0], NULL, mboxbench_mbox_consumer, (void *)(intptr_t)nmsgs) != 0) {
+		printf("mboxbench: ERROR pthread_create failed\n");
+		g_errors++;
+		sys_mbox_free(&g_mbox_req);
+		return;
+	}
+
+	nthreads = 1 + mboxbench_start_producers(&threads[1], args, nproducers, nmsgs, mboxbench_mbox_producer);
+	if (nthreads != nproducers + 1) {
+		/* The consumer would wait forever for the missing messages */
+
+		pthread_cancel(threads[0]);
+	}
+
+	mboxbench_join(threads, nthreads);
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	sys_mbox_free(&g_mbox_req);
+	mboxbench_report("mbox throughput", "msgs", nmsgs, mboxbench_usecs(&start, &end));
+}
+
+/* Raw mailbox latency ******************************************************/
+
+static void *mboxbench_mbox_echo(void *arg)
+{
+	int nroundtrips = (int)(intptr_t)arg;
+	void *msg;
+	int i;
+
+	for (i = 0; i < nroundtrips; i++) {
+		if (sys_arch_mbox_fetch(&g_mbox_req, &msg, 0) == SYS_ARCH_CANCELED) {
+			g_errors++;
+			break;
+		}
+
+		sys_mbox_post(&g_mbox_rsp, msg);
+	}
+
+	return NULL;
+}
+
+static void mboxbench_mbox_latency(int nroundtrips)
+{
+	struct timespec start;
+	struct timespec end;
+	pthread_t thread;
+	void *msg;
+	int i;
+
+	if (sys_mbox_new(&g_mbox_req, MBOXBENCH_MBOXSIZE) != ERR_OK) {
+		printf("mboxbench: ERROR sys_mbox_new failed\n");
+		g_errors++;
+		return;
+	}
+
+	if (sys_mbox_new(&g_mbox_rsp, MBOXBENCH_MBOXSIZE) != ERR_OK) {
+		printf("mboxbench: ERROR sys_mbox_new failed\n");
+		g_errors++;
+		sys_mbox_free(&g_mbox_req);
+		return;
+	}
+
+	if (pthread_create(&thread, NULL, mboxbench_mbox_echo, (void *)(intptr_t)nroundtrips) != 0) {
+		printf("mboxbench: ERROR pthread_create failed\n");
+		g_errors++;
+		goto errout;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < nroundtrips; i++) {
+		sys_mbox_post(&g_mbox_req, (void *)(uintptr_t)(i + 1));
+		if (sys_arch_mbox_fetch(&g_mbox_rsp, &msg, 0) == SYS_ARCH_CANCELED || msg != (void *)(uintptr_t)(i + 1)) {
+			printf("mboxbench: ERROR round trip %d\n", i);
+			g_errors++;
+			break;
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	if (i < nroundtrips) {
+		pthread_cancel(thread);
+	}
+
+	pthread_join(thread, NULL);
+	mboxbench_report("mbox latency", "trips", nroundtrips, mboxbench_usecs(&start, &end));
+
+errout:
+	sys_mbox_free(&g_mbox_rsp);
+	sys_mbox_free(&g_mbox_req);
+}
+
+/* tcpip thread throughput **************************************************/
+
+static void mboxbench_count_callback(void *ctx)
+{
+	if (++g_ncallbacks == g_ntarget) {
+		sem_post(&g_done);
+	}
+}
+
+static void *mboxbench_tcpip_producer(void *arg)
+{
+	FAR struct mboxbench_producer_s *producer = (FAR struct mboxbench_producer_s *)arg;
+	int i;
+
+	for (i = 0; i < producer->nmsgs; i++) {
+		if (tcpip_callback_with_block(mboxbench_count_callback, NULL, 1) != ERR_OK) {
+			g_errors++;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void mboxbench_tcpip_throughput(int nmsgs, int nproducers)
+{
+	struct mboxbench_producer_s args[MBOXBENCH_MAXPRODUCERS];
+	pthread_t threads[MBOXBENCH_MAXPRODUCERS];
+	struct timespec start;
+	struct timespec end;
+	int nthreads;
+
+	g_ncallbacks = 0;
+	g_ntarget = nmsgs;
+	sem_init(&g_done, 0, 0);
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	nthreads = mboxbench_start_producers(threads, args, nproducers, nmsgs, mboxbench_tcpip_producer);
+	mboxbench_join(threads, nthreads);
+	if (nthreads == nproducers && g_errors == 0) {
+		sem_wait(&g_done);
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	sem_destroy(&g_done);
+	mboxbench_report("tcpip throughput", "msgs", nmsgs, mboxbench_usecs(&start, &end));
+}
+
+/* tcpip thread latency *****************************************************/
+
+static void mboxbench_wake_callback(void *ctx)
+{
+	sem_post((FAR sem_t *)ctx);
+}
+
+static void mboxbench_tcpip_latency(int nroundtrips)
+{
+	struct timespec start;
+	struct timespec end;
+	int i;
+
+	sem_init(&g_done, 0, 0);
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < nroundtrips; i++) {
+		if (tcpip_callback_with_block(mboxbench_wake_callback, &g_done, 1) != ERR_OK) {
+			printf("mboxbench: ERROR tcpip_callback failed\n");
+			g_errors++;
+			break;
+		}
+
+		sem_wait(&g_done);
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	sem_destroy(&g_done);
+	mboxbench_report("tcpip latency", "trips", nroundtrips, mboxbench_usecs(&start, &end));
+}
+
+/****************************************************************************
+ * mboxbench_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int mboxbench_main(int argc, char *argv[])
+#endif
+{
+	int nmsgs = MBOXBENCH_NMSGS;
+	int nproducers = 1;
+
+	if (argc > 1) {
+		nmsgs = atoi(argv[1]);
+	}
+
+	if (argc > 2) {
+		nproducers = atoi(argv[2]);
+	}
+
+	if (nmsgs <= 0 || nproducers <= 0 || nproducers > MBOXBENCH_MAXPRODUCERS) {
+		printf("Usage: mboxbench [nmsgs [nproducers (1..%d)]]\n", MBOXBENCH_MAXPRODUCERS);
+		return -1;
+	}
+
+#ifdef CONFIG_NET_LWIP_MBOX_LOCKFREE
+	printf("mboxbench: lock-free mailboxes, %d messages, %d producers\n", nmsgs, nproducers);
+#else
+	printf("mboxbench: semaphore mailboxes, %d messages, %d producers\n", nmsgs, nproducers);
+#endif
+
+	g_errors = 0;
+	mboxbench_mbox_throughput(nmsgs, nproducers);
+	mboxbench_mbox_latency(MBOXBENCH_NROUNDTRIPS);
+	mboxbench_tcpip_throughput(nmsgs, nproducers);
+	mboxbench_tcpip_latency(MBOXBENCH_NROUNDTRIPS);
+
+	if (g_errors > 0) {
+		printf("mboxbench: ERROR %d errors\n", g_errors);
+		return -1;
+	}
+
+	return 0;
+}
@@ -27,6 +27,11 @@
 #include <errno.h>
 #include <semaphore.h>
 #include <sys/types.h>
+#ifdef CONFIG_SEM_STATISTICS
+#include <pthread.h>
+#include <unistd.h>
+#include <tinyara/semaphore.h>
+#endif
 #include "tc_internal.h"
 
 #define SEM_VALUE SEM_VALUE_MAX
@@ -65,7 +70,7 @@ static void tc_libc_semaphore_sem_init(void)
 	TC_ASSERT_EQ("sem_init", sem.semcount, value);
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	TC_ASSERT_EQ("sem_init", sem.flags, 0);
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if CONFIG_SEM_PREALLOCHOLDERS > 0 || defined(CONFIG_SEM_TCBHOLDERS)
 	TC_ASSERT_EQ("sem_init", sem.hhead, NULL);
 #else
 	TC_ASSERT_EQ("sem_init", sem.holder.htcb, NULL);
@@ -114,6 +119,72 @@ static void tc_libc_semaphore_sem_getvalue(void)
 	return;
 }
 
+#ifdef CONFIG_SEM_STATISTICS
+static void *sem_getstats_waiter(void *arg)
+{
+	sem_wait((sem_t *)arg);
+	return NULL;
+}
+
+/**
+* @fn                   :tc_libc_semaphore_sem_getstats
+* @brief                :this tc test sem_getstats and sem_resetstats functions
+* @Scenario             :If sem or stats is NULL, it return ERROR and errno EINVAL is set.
+*                        A thread blocking in sem_wait is counted as one wait and
+*                        sem_resetstats clears the wait statistics.
+* API's covered         :sem_getstats, sem_resetstats
+* Preconditions         :NA
+* Postconditions        :NA
+* @return               :total_pass on success.
+*/
+static void tc_libc_semaphore_sem_getstats(void)
+{
+	sem_t sem;
+	struct semstats_s stats;
+	pthread_t waiter;
+	int ret_chk;
+
+	ret_chk = sem_init(&sem, PSHARED, 0);
+	TC_ASSERT_EQ("sem_init", ret_chk, OK);
+
+	ret_chk = sem_getstats(NULL, &stats);
+	TC_ASSERT_EQ("sem_getstats", ret_chk, ERROR);
+	TC_ASSERT_EQ("sem_getstats", get_errno(), EINVAL);
+
+	ret_chk = sem_getstats(&sem, NULL);
+	TC_ASSERT_EQ("sem_getstats", ret_chk, ERROR);
+	TC_ASSERT_EQ("sem_getstats", get_errno(), EINVAL);
+
+	ret_chk = sem_getstats(&sem, &stats);
+	TC_ASSERT_EQ("sem_getstats", ret_chk, OK);
+	TC_ASSERT_EQ("sem_getstats", stats.nwaits, 0);
+	TC_ASSERT_EQ("sem_getstats", stats.maxwait, 0);
+
+	/* Let another thread block on the semaphore, then release it */
+
+	ret_chk = pthread_create(&waiter, NULL, sem_getstats_waiter, &sem);
+	TC_ASSERT_EQ("pthread_create", ret_chk, OK);
+	usleep(100 * 1000);
+	sem_post(&sem);
+	pthread_join(waiter, NULL);
+
+	ret_chk = sem_getstats(&sem, &stats);
+	TC_ASSERT_EQ("sem_getstats", ret_chk, OK);
+	TC_ASSERT_EQ("sem_getstats", stats.nwaits, 1);
+	TC_ASSERT_GT("sem_getstats", stats.maxwait, 0);
+
+	ret_chk = sem_resetstats(&sem);
+	TC_ASSERT_EQ("sem_resetstats", ret_chk, OK);
+	ret_chk = sem_getstats(&sem, &stats);
+	TC_ASSERT_EQ("sem_getstats", ret_chk, OK);
+	TC_ASSERT_EQ("sem_resetstats", stats.nwaits, 0);
+	TC_ASSERT_EQ("sem_resetstats", stats.maxwait, 0);
+
+	sem_destroy(&sem);
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /****************************************************************************
  * Name: libc_semaphore
  ****************************************************************************/
@@ -122,6 +193,9 @@ int libc_semaphore_main(void)
 {
 	tc_libc_semaphore_sem_init();
 	tc_libc_semaphore_sem_getvalue();
+#ifdef CONFIG_SEM_STATISTICS
+	tc_libc_semaphore_sem_getstats();
+#endif
 
 	return 0;
 }
@@ -586,6 +586,73 @@ static void tc_mqueue_mq_unlink(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_MQ_ZEROCOPY
+static void tc_mqueue_mq_zerocopy_ownership(void)
+{
+	mqd_t mqdes;
+	struct mq_attr attr;
+	FAR void *buf;
+	FAR void *buf2;
+	FAR void *rbuf;
+	ssize_t nbytes;
+	int ret;
+
+	attr.mq_maxmsg = 2;
+	attr.mq_msgsize = 64;
+	attr.mq_flags = MQ_ZEROCOPY;
+
+	mqdes = mq_open("mqzerocopy", O_CREAT | O_RDWR | O_NONBLOCK, 0666, &attr);
+	TC_ASSERT_NEQ("mq_open", mqdes, (mqd_t)-1);
+
+	/* A buffer can only be freed once */
+
+	buf = mq_getbuf(mqdes);
+	TC_ASSERT_NEQ_CLEANUP("mq_getbuf", buf, NULL, goto cleanup);
+	ret = mq_freebuf(mqdes, buf);
+	TC_ASSERT_EQ_CLEANUP("mq_freebuf", ret, OK, goto cleanup);
+	ret = mq_freebuf(mqdes, buf);
+	TC_ASSERT_EQ_CLEANUP("mq_freebuf", ret, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_freebuf", errno, EINVAL, goto cleanup);
+
+	/* A sent buffer belongs to the queue until it is received */
+
+	buf = mq_getbuf(mqdes);
+	TC_ASSERT_NEQ_CLEANUP("mq_getbuf", buf, NULL, goto cleanup);
+	memset(buf, 0x5a, 64);
+	ret = mq_sendbuf(mqdes, buf, 64, 1);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", ret, OK, goto cleanup);
+	ret = mq_sendbuf(mqdes, buf, 64, 1);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", ret, ERROR, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_sendbuf", errno, EINVAL, goto cleanup);
+	ret = mq_freebuf(mqdes, buf);
+	TC_ASSERT_EQ_CLEANUP("mq_freebuf", ret, ERROR, goto cleanup);
+
+	nbytes = mq_receivebuf(mqdes, &rbuf, NULL);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuf", nbytes, 64, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_receivebuf", rbuf, buf, goto cleanup);
+	ret = mq_freebuf(mqdes, rbuf);
+	TC_ASSERT_EQ_CLEANUP("mq_freebuf", ret, OK, goto cleanup);
+
+	/* Misuse must not have added buffers to the pool */
+
+	buf = mq_getbuf(mqdes);
+	TC_ASSERT_NEQ_CLEANUP("mq_getbuf", buf, NULL, goto cleanup);
+	buf2 = mq_getbuf(mqdes);
+	TC_ASSERT_NEQ_CLEANUP("mq_getbuf", buf2, NULL, goto cleanup);
+	TC_ASSERT_NEQ_CLEANUP("mq_getbuf", buf, buf2, goto cleanup);
+	rbuf = mq_getbuf(mqdes);
+	TC_ASSERT_EQ_CLEANUP("mq_getbuf", rbuf, NULL, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("mq_getbuf", errno, EAGAIN, goto cleanup);
+	mq_freebuf(mqdes, buf);
+	mq_freebuf(mqdes, buf2);
+
+	TC_SUCCESS_RESULT();
+cleanup:
+	mq_close(mqdes);
+	mq_unlink("mqzerocopy");
+}
+#endif
+
 /****************************************************************************
  * Name: mqueue
  ****************************************************************************/
@@ -595,6 +662,9 @@ int mqueue_main(void)
 	tc_mqueue_mq_notify();
 	tc_mqueue_mq_timedsend_timedreceive();
 	tc_mqueue_mq_unlink();
+#ifdef CONFIG_MQ_ZEROCOPY
+	tc_mqueue_mq_zerocopy_ownership();
+#endif
 
 	return 0;
 }
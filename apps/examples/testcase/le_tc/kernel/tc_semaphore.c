@@ -23,6 +23,10 @@
 #include <errno.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#ifdef CONFIG_SEM_TCBHOLDERS
+#include <unistd.h>
+#include "../../../../../os/kernel/sched/sched.h"
+#endif
 #include "tc_internal.h"
 
 #define PSHARED     0
@@ -352,6 +356,183 @@ static void tc_semaphore_sem_destroy(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_SEM_TCBHOLDERS
+/**
+* @fn                   :sem_tcbfreeholders
+* @description          :Count the free holder containers in the TCB of the calling thread
+* @return               :int
+*/
+static int sem_tcbfreeholders(void)
+{
+	struct tcb_s *tcb = sched_gettcb(getpid());
+	int nfree = 0;
+	int i;
+
+	for (i = 0; i < CONFIG_SEM_NTCBHOLDERS; i++) {
+		if (tcb->holders[i].sem == NULL) {
+			nfree++;
+		}
+	}
+
+	return nfree;
+}
+
+/**
+* @fn                   :sem_tcbholder_func
+* @description          :Function for tc_semaphore_sem_tcbholders_exit, exits holding the semaphore
+* @return               :void*
+*/
+static void *sem_tcbholder_func(void *arg)
+{
+	if (sem_wait((sem_t *)arg) == ERROR) {
+		pthread_exit("sem_wait");
+	}
+
+	pthread_exit(NULL);
+	return NULL;
+}
+
+/**
+* @fn                   :tc_semaphore_sem_tcbholders_exit
+* @brief                :this tc tests the holders of a thread that exits holding a semaphore
+* @scenario             :A thread takes the semaphore and exits without posting it.
+*                        Its holder container is unlinked from the semaphore when it exits,
+*                        and the next holder gets a holder list of its own.
+* API's covered         :sem_wait, sem_post
+* Preconditions         :CONFIG_SEM_TCBHOLDERS
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_semaphore_sem_tcbholders_exit(void)
+{
+	pthread_addr_t pexit_value = NULL;
+	struct sched_param param;
+	pthread_attr_t attr;
+	pthread_t tid;
+	sem_t sem;
+	int ret_chk;
+
+	ret_chk = sem_init(&sem, PSHARED, 1);
+	TC_ASSERT_EQ("sem_init", ret_chk, OK);
+
+	/* Run the thread above the caller so that its TCB is released by the
+	 * time pthread_join() returns.
+	 */
+
+	ret_chk = sched_getparam(0, &param);
+	TC_ASSERT_EQ("sched_getparam", ret_chk, OK);
+	TC_ASSERT_LT("sched_getparam", param.sched_priority, SCHED_PRIORITY_MAX);
+	param.sched_priority++;
+
+	ret_chk = pthread_attr_init(&attr);
+	TC_ASSERT_EQ("pthread_attr_init", ret_chk, OK);
+
+	ret_chk = pthread_attr_setschedparam(&attr, &param);
+	TC_ASSERT_EQ("pthread_attr_setschedparam", ret_chk, OK);
+
+	ret_chk = pthread_create(&tid, &attr, sem_tcbholder_func, &sem);
+	TC_ASSERT_EQ("pthread_create", ret_chk, OK);
+
+	ret_chk = pthread_join(tid, &pexit_value);
+	TC_ASSERT_EQ("pthread_join", ret_chk, OK);
+	TC_ASSERT_EQ("pthread_join", pexit_value, NULL);
+	TC_ASSERT_EQ("sem_wait", sem.semcount, 0);
+	TC_ASSERT_EQ("sem_wait", sem.hhead, NULL);
+
+	/* The count the thread took with it is given back by hand */
+
+	ret_chk = sem_post(&sem);
+	TC_ASSERT_EQ("sem_post", ret_chk, OK);
+
+	ret_chk = sem_wait(&sem);
+	TC_ASSERT_EQ("sem_wait", ret_chk, OK);
+	TC_ASSERT_NEQ("sem_wait", sem.hhead, NULL);
+	TC_ASSERT_EQ("sem_wait", sem.hhead->htcb, sched_gettcb(getpid()));
+	TC_ASSERT_EQ("sem_wait", sem.hhead->flink, NULL);
+	TC_ASSERT_EQ("sem_wait", sem.hhead->counts, 1);
+
+	ret_chk = sem_post(&sem);
+	TC_ASSERT_EQ("sem_post", ret_chk, OK);
+	TC_ASSERT_EQ("sem_post", sem.hhead, NULL);
+
+	ret_chk = sem_destroy(&sem);
+	TC_ASSERT_EQ("sem_destroy", ret_chk, OK);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_semaphore_sem_tcbholders_reinit
+* @brief                :this tc tests the holders of a semaphore re-initialized while it is held
+* @scenario             :The semaphore is re-initialized at the same address while the calling
+*                        thread holds it.  The holder container left behind must not be taken
+*                        for a holder of the new semaphore, and it is reclaimed when the thread
+*                        runs out of free containers.
+* API's covered         :sem_init, sem_wait, sem_post
+* Preconditions         :CONFIG_SEM_TCBHOLDERS
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_semaphore_sem_tcbholders_reinit(void)
+{
+	sem_t sem[CONFIG_SEM_NTCBHOLDERS];
+	int nfree;
+	int ret_chk;
+	int i;
+
+	nfree = sem_tcbfreeholders();
+	TC_ASSERT_GT("sem_tcbfreeholders", nfree, 0);
+
+	ret_chk = sem_init(&sem[0], PSHARED, 1);
+	TC_ASSERT_EQ("sem_init", ret_chk, OK);
+
+	ret_chk = sem_wait(&sem[0]);
+	TC_ASSERT_EQ("sem_wait", ret_chk, OK);
+	TC_ASSERT_EQ("sem_wait", sem_tcbfreeholders(), nfree - 1);
+
+	/* Re-initialize it without posting or destroying it */
+
+	ret_chk = sem_init(&sem[0], PSHARED, 1);
+	TC_ASSERT_EQ("sem_init", ret_chk, OK);
+
+	ret_chk = sem_wait(&sem[0]);
+	TC_ASSERT_EQ("sem_wait", ret_chk, OK);
+	TC_ASSERT_NEQ("sem_wait", sem[0].hhead, NULL);
+	TC_ASSERT_EQ("sem_wait", sem[0].hhead->counts, 1);
+
+	ret_chk = sem_post(&sem[0]);
+	TC_ASSERT_EQ("sem_post", ret_chk, OK);
+	TC_ASSERT_EQ("sem_post", sem[0].hhead, NULL);
+
+	/* Only the stale container is in use now: holding nfree semaphores
+	 * needs it back.
+	 */
+
+	for (i = 0; i < nfree; i++) {
+		ret_chk = sem_init(&sem[i], PSHARED, 1);
+		TC_ASSERT_EQ("sem_init", ret_chk, OK);
+
+		ret_chk = sem_wait(&sem[i]);
+		TC_ASSERT_EQ("sem_wait", ret_chk, OK);
+		TC_ASSERT_NEQ("sem_wait", sem[i].hhead, NULL);
+	}
+
+	TC_ASSERT_EQ("sem_wait", sem_tcbfreeholders(), 0);
+
+	for (i = 0; i < nfree; i++) {
+		ret_chk = sem_post(&sem[i]);
+		TC_ASSERT_EQ("sem_post", ret_chk, OK);
+
+		ret_chk = sem_destroy(&sem[i]);
+		TC_ASSERT_EQ("sem_destroy", ret_chk, OK);
+	}
+
+	TC_ASSERT_EQ("sem_post", sem_tcbfreeholders(), nfree);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 /****************************************************************************
  * Name: semaphore
  ****************************************************************************/
@@ -362,6 +543,10 @@ int semaphore_main(void)
 	tc_semaphore_sem_trywait();
 	tc_semaphore_sem_timedwait();
 	tc_semaphore_sem_destroy();
+#ifdef CONFIG_SEM_TCBHOLDERS
+	tc_semaphore_sem_tcbholders_exit();
+	tc_semaphore_sem_tcbholders_reinit();
+#endif
 
 	return 0;
 }
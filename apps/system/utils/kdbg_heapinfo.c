@@ -69,7 +69,7 @@ int kdbg_heapinfo(int argc, char **args)
 	}
 
 	struct mm_heap_s *user_heap = mm_get_heap_info();
-	while ((option = getopt(argc, args, "iap:f")) != ERROR) {
+	while ((option = getopt(argc, args, "iap:ft")) != ERROR) {
 		switch (option) {
 		case 'i':
 			sched_foreach(kdbg_heapinfo_init, NULL);
@@ -87,6 +87,11 @@ int kdbg_heapinfo(int argc, char **args)
 			mode = HEAPINFO_DETAIL_FREE;
 			pid = HEAPINFO_PID_NOTNEEDED;
 			break;
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+		case 't':
+			heapinfo_parse(user_heap, HEAPINFO_TRACE, HEAPINFO_PID_NOTNEEDED);
+			return OK;
+#endif
 		case '?':
 		default:
 			printf("Invalid option\n");
@@ -120,6 +125,9 @@ usage:
 	printf(" -a           Show the all allocation details\n");
 	printf(" -p PID       Show the specific PID allocation details \n");
 	printf(" -f           Show the free list \n");
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+	printf(" -t           Dump the allocation trace for tools/heapbench\n");
+#endif
 #endif
 	return ERROR;
 }
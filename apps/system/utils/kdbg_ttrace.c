@@ -21,6 +21,7 @@
 #include <errno.h>
 #include <getopt.h>
 #include <string.h>
+#include <unistd.h>
 #include <debug.h>
 #include <ttrace.h>
 #include <sys/types.h>
@@ -29,8 +30,11 @@
 #include <tinyara/clock.h>
 #include <tinyara/ttrace_internal.h>
 
+#define TTRACE_SCHED_WRITE 'o'
+
 int param = 0;
 int selected_tags = 0;
+static char *outpath;
 
 static void show_help(void);
 static void wait_ttrace_dump(void);
@@ -94,6 +98,10 @@ static void show_help()
 	printf("    -i     Show information(state, available/selected/TP used tags, bufsize)\r\n");
 	printf("    -d     Dump trace buffer, It should be run after finish\r\n");
 	printf("    -p     Print trace buffer, It should be run after finish)\r\n");
+#ifdef CONFIG_TTRACE_SCHED
+	printf("    -k 1|0 Start/stop recording scheduler events\r\n");
+	printf("    -o     Write recorded scheduler events to a file, for tools/ttrace2json\r\n");
+#endif
 }
 
 static int assign_tag(char *name)
@@ -123,10 +131,12 @@ static int parse_args(int argc, char **args)
 	 * -g : TTRACE_FUNC_TAG, TP's tag(hidden to user)
 	 * -d : TTRACE_DUMP, dump mode(hang), It should be run after finish.
 	 * -p : TTRACE_PRINT, print traces, It should be run after finish.
+	 * -k : TTRACE_SCHED_ENABLE, start(1) or stop(0) scheduler recording
+	 * -o : write the scheduler records to a file
 	 */
 	while (1) {
 		optarg = NULL;
-		ret = getopt(argc, args, "sfidpb:");
+		ret = getopt(argc, args, "sfidpb:k:o:");
 		if (ret == '?') {
 			show_help();
 			return TTRACE_INVALID;
@@ -139,7 +149,9 @@ static int parse_args(int argc, char **args)
 		cmd = ret;
 		printf("cmd: %d, %c, optarg: %d, %c, %s\r\n", cmd, cmd, optarg, optarg, optarg);
 
-		if (optarg != NULL) {
+		if (cmd == TTRACE_SCHED_WRITE) {
+			outpath = optarg;
+		} else if (optarg != NULL) {
 			param = atoi(optarg);
 		}
 	}
@@ -230,6 +242,48 @@ static int read_tracebuffer(FILE *file, int bufsize)
 	return TTRACE_VALID;
 }
 
+static int write_schedrecords(FILE *file, const char *path)
+{
+	char buffer[128];
+	FILE *out;
+	ssize_t nread;
+	int total = 0;
+	int ret = TTRACE_VALID;
+
+	if (run_cmd(file, TTRACE_SCHED_SELECT, 1) != TTRACE_VALID) {
+		printf("Scheduler recording is not supported\r\n");
+		return TTRACE_INVALID;
+	}
+
+	out = fopen(path, "w");
+	if (out == NULL) {
+		printf("Failed to open : %s\r\n", path);
+		ret = TTRACE_INVALID;
+		goto errout;
+	}
+
+	while ((nread = read(file->fs_fd, buffer, sizeof(buffer))) > 0) {
+		if ((ssize_t)fwrite(buffer, 1, nread, out) != nread) {
+			printf("Failed to write : %s\r\n", path);
+			ret = TTRACE_INVALID;
+			break;
+		}
+		total += nread;
+	}
+
+	if (nread < 0) {
+		printf("Failed to read scheduler records, stop recording first (-k 0)\r\n");
+		ret = TTRACE_INVALID;
+	}
+
+	fclose(out);
+	printf("%d bytes written to %s\r\n", total, path);
+
+errout:
+	run_cmd(file, TTRACE_SCHED_SELECT, 0);
+	return ret;
+}
+
 static void wait_ttrace_dump()
 {
 	int i = 0;
@@ -255,6 +309,8 @@ static int send_cmds(FILE *file, int cmd)
 		bufsize = run_cmd(file, TTRACE_USED_BUFSIZE, param);
 		ret = read_tracebuffer(file, bufsize);
 		return ret;
+	} else if (cmd == TTRACE_SCHED_WRITE) {
+		return write_schedrecords(file, outpath);
 	}
 
 	if (run_cmd(file, cmd, param) == TTRACE_INVALID) {
@@ -62,6 +62,10 @@
 #include <unistd.h>
 #include <errno.h>
 
+#ifdef CONFIG_NET_SENDFILE
+#include <tinyara/net/net.h>
+#endif
+
 #include "lib_internal.h"
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0 || CONFIG_NFILE_DESCRIPTORS > 0
@@ -97,6 +101,9 @@
  *   nothing in TinyAra but provide some Linux compatible (and adding
  *   another 'almost standard' interface).
  *
+ *   With CONFIG_NET_SENDFILE, transfers to a TCP socket are handed to
+ *   net_sendfile() which queues the file data without the I/O buffer.
+ *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
  *   sendfile interface.  Other UNIX systems implement sendfile() with
@@ -140,6 +147,21 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 	ssize_t ntransferred;
 	bool endxfr;
 
+#ifdef CONFIG_NET_SENDFILE
+	/* Let the network stack take the data of a file straight to a TCP
+	 * socket.
+	 */
+
+	if ((unsigned int)outfd >= CONFIG_NFILE_DESCRIPTORS && (unsigned int)infd < CONFIG_NFILE_DESCRIPTORS) {
+		ntransferred = net_sendfile(outfd, infd, offset, count);
+		if (ntransferred >= 0 || get_errno() != ENOSYS) {
+			return ntransferred;
+		}
+
+		/* Not a TCP socket, copy through the I/O buffer */
+	}
+#endif
+
 	/* Get the current file position. */
 
 	if (offset) {
@@ -0,0 +1,72 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/semaphore/sem_getstats.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+
+#include <tinyara/semaphore.h>
+
+#ifdef CONFIG_SEM_STATISTICS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sem_getstats
+ *
+ * Description:
+ *    Return the contention statistics of a semaphore: the number of times
+ *    a thread had to wait for it, the longest of those waits in clock
+ *    ticks, and the current and largest number of threads holding counts
+ *    on it.  For a pthread mutex, pass the semaphore inside the mutex.
+ *
+ *    The statistics are updated by sem_wait() and by the priority
+ *    inheritance logic.  Semaphores with SEM_PRIO_NONE have no holders.
+ *
+ * Parameters:
+ *    sem   - A pointer to the semaphore to be queried
+ *    stats - The user provided location in which to store the statistics
+ *
+ * Return Value:
+ *   0 if successful.  Otherwise, -1 is returned and the errno value is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int sem_getstats(FAR sem_t *sem, FAR struct semstats_s *stats)
+{
+	if (sem == NULL || stats == NULL) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	*stats = sem->stats;
+	return OK;
+}
+
+#endif							/* CONFIG_SEM_STATISTICS */
@@ -58,9 +58,25 @@
 
 #include <sys/types.h>
 #include <limits.h>
+#include <string.h>
 #include <semaphore.h>
 #include <errno.h>
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_TCBHOLDERS
+/* Generation given to the next initialized semaphore.  A thread's holder
+ * container only matches a semaphore of the same generation, so one that
+ * was left behind by a semaphore freed or re-initialized without
+ * sem_destroy() is not taken for a holder of a new semaphore at the same
+ * address.
+ */
+
+static uint16_t g_semgen;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,12 +121,18 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 		sem->flags = 0;
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if CONFIG_SEM_PREALLOCHOLDERS > 0 || defined(CONFIG_SEM_TCBHOLDERS)
 		sem->hhead = NULL;
+#ifdef CONFIG_SEM_TCBHOLDERS
+		sem->gen = ++g_semgen;
+#endif
 #else
 		sem->holder.htcb = NULL;
 		sem->holder.counts = 0;
 #endif
+#ifdef CONFIG_SEM_STATISTICS
+		memset(&sem->stats, 0, sizeof(struct semstats_s));
+#endif
 #endif
 		return OK;
 	} else {
@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/semaphore/sem_resetstats.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+
+#include <tinyara/semaphore.h>
+
+#ifdef CONFIG_SEM_STATISTICS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sem_resetstats
+ *
+ * Description:
+ *    Start a new measurement period for the contention statistics of a
+ *    semaphore.  The wait count and the longest wait are cleared; the
+ *    largest number of holders is set to the current number.  A wait that
+ *    completes at the same time may be lost.
+ *
+ * Parameters:
+ *    sem - A pointer to the semaphore
+ *
+ * Return Value:
+ *   0 if successful.  Otherwise, -1 is returned and the errno value is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int sem_resetstats(FAR sem_t *sem)
+{
+	if (sem == NULL) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	sem->stats.nwaits = 0;
+	sem->stats.maxwait = 0;
+	sem->stats.maxholders = sem->stats.nholders;
+	return OK;
+}
+
+#endif							/* CONFIG_SEM_STATISTICS */
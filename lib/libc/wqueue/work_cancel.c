@@ -124,6 +124,23 @@ static int work_qcancel(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work
 	 */
 
 	if (work->worker != NULL) {
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+		/* Immediate work is on the FIFO list, delayed work in the deadline
+		 * heap.  Make sure that it is really there first: the worker field
+		 * of work that was never queued may hold anything.
+		 */
+
+		if (!work_isqueued(wqueue, work)) {
+			work_unlock();
+			return -ENOENT;
+		}
+
+		if (work->delay == 0) {
+			dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+		} else {
+			work_heapremove(wqueue, work);
+		}
+#else
 		/* A little test of the integrity of the work queue */
 
 		DEBUGASSERT(work->dq.flink || (FAR dq_entry_t *)work == wqueue->q.tail);
@@ -134,6 +151,7 @@ static int work_qcancel(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work
 		 */
 
 		dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+#endif
 		work->worker = NULL;
 		ret = OK;
 	}
@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <signal.h>
 #include <assert.h>
 #include <queue.h>
@@ -118,6 +119,54 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+static int work_qqueue(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
+{
+	bool wakeup;
+
+	DEBUGASSERT(work != NULL && worker != NULL);
+
+	/* Get exclusive access to the work queue */
+
+	while (work_lock() < 0);
+
+	/* Queued work always has a worker, but a worker alone does not prove
+	 * that the work is queued: the structure may never have been
+	 * initialized.
+	 */
+
+	if (work->worker != NULL && work_isqueued(wqueue, work)) {
+		work_unlock();
+		return -EALREADY;
+	}
+
+	work->worker = worker;		/* Work callback */
+	work->arg = arg;			/* Callback argument */
+	work->delay = delay;		/* Delay until work performed */
+	work->qtime = clock_systimer();	/* Time work queued */
+
+	if (delay == 0) {
+		/* Immediate work is run in the order it was queued */
+
+		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+		wakeup = true;
+	} else {
+		/* Delayed work only needs the worker to be woken up if it is now
+		 * the earliest deadline; otherwise the worker is already waiting
+		 * for an earlier one.
+		 */
+
+		wakeup = work_heapinsert(wqueue, work);
+	}
+
+	if (wakeup) {
+		work_wakeup(wqueue);
+	}
+
+	work_unlock();
+	return OK;
+}
+#else
 static int work_qqueue(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
 {
 	DEBUGASSERT(work != NULL);
@@ -142,6 +191,7 @@ static int work_qqueue(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work,
 	work_unlock();
 	return OK;
 }
+#endif							/* CONFIG_SCHED_WORKQUEUE_DEADLINE */
 
 /****************************************************************************
  * Public Functions
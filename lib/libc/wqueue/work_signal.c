@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <signal.h>
+#include <semaphore.h>
 #include <errno.h>
 
 #include <tinyara/wqueue.h>
@@ -88,6 +89,33 @@
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up the worker of the user-mode work queue if it is idle, or about
+ *   to become idle.  Must be called with the work queue locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+void work_wakeup(FAR struct usr_wqueue_s *wqueue)
+{
+	int semcount;
+
+	/* The worker waits on the semaphore after it has released the work
+	 * queue lock, so a count of zero may belong to a worker that is about
+	 * to wait.  A single pending post is enough for it to look at the
+	 * queue again; never let the count grow beyond that.
+	 */
+
+	if (sem_getvalue(&wqueue->sem, &semcount) == OK && semcount <= 0) {
+		sem_post(&wqueue->sem);
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: work_signal
  *
@@ -109,6 +137,17 @@ int work_signal(int qid)
 	int ret;
 
 	if (qid == USRWORK) {
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+		/* Wake up the worker thread */
+
+		ret = work_lock();
+		if (ret < 0) {
+			return ret;
+		}
+
+		work_wakeup(&g_usrwork);
+		work_unlock();
+#else
 		/* Signal the worker thread */
 
 		ret = kill(g_usrwork.pid, SIGWORK);
@@ -116,6 +155,7 @@ int work_signal(int qid)
 			int errcode = errno;
 			ret = -errcode;
 		}
+#endif
 	} else {
 		ret = -EINVAL;
 	}
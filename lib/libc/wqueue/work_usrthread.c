@@ -60,6 +60,8 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <sched.h>
+#include <semaphore.h>
+#include <time.h>
 #include <errno.h>
 #include <assert.h>
 #include <queue.h>
@@ -134,6 +136,94 @@ pthread_mutex_t g_usrmutex;
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+void work_process(FAR struct usr_wqueue_s *wqueue)
+{
+	FAR struct work_s *work;
+	struct timespec abstime;
+	worker_t worker;
+	FAR void *arg;
+	systime_t ctick;
+	systime_t next;
+
+	if (work_lock() < 0) {
+		/* Break out earlier if we were awakened by a signal */
+
+		return;
+	}
+
+	for (;;) {
+		/* Immediate work first, in the order it was queued, then the delayed
+		 * work whose deadline has passed.  Only the root of the deadline heap
+		 * ever needs to be examined.
+		 */
+
+		ctick = clock_systimer();
+		work = (FAR struct work_s *)wqueue->q.head;
+		if (work != NULL) {
+			dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+		} else if (wqueue->root != NULL && ctick - wqueue->root->qtime >= wqueue->root->delay) {
+			work = wqueue->root;
+			work_heapremove(wqueue, work);
+		} else {
+			break;
+		}
+
+		/* Extract the work description and mark the work as no longer being
+		 * queued before unlocking the work queue.
+		 */
+
+		worker = work->worker;
+		arg = work->arg;
+		DEBUGASSERT(worker != NULL);
+		work->worker = NULL;
+
+		/* Do the work.  Unlock the the work queue while the work is being
+		 * performed... we don't have any idea how long this will take!
+		 */
+
+		work_unlock();
+		worker(arg);
+
+		if (work_lock() < 0) {
+			return;
+		}
+	}
+
+	/* Nothing is due.  Sleep until the earliest deadline, or until the end
+	 * of the polling period if that comes first.  work_queue() posts the
+	 * semaphore if new work changes the earliest deadline; a post made
+	 * after the lock is released is kept by the semaphore count.
+	 */
+
+	next = 0;
+	if (wqueue->root != NULL) {
+		next = WORK_DEADLINE(wqueue->root) - ctick;
+	}
+
+	if (wqueue->delay > 0 && (next == 0 || next > wqueue->delay)) {
+		next = wqueue->delay;
+	}
+
+	work_unlock();
+
+	if (next > 0) {
+		/* sem_timedwait() takes an absolute CLOCK_REALTIME time */
+
+		(void)clock_gettime(CLOCK_REALTIME, &abstime);
+		abstime.tv_sec += next / TICK_PER_SEC;
+		abstime.tv_nsec += (next % TICK_PER_SEC) * NSEC_PER_TICK;
+		if (abstime.tv_nsec >= NSEC_PER_SEC) {
+			abstime.tv_sec++;
+			abstime.tv_nsec -= NSEC_PER_SEC;
+		}
+
+		(void)sem_timedwait(&wqueue->sem, &abstime);
+	} else {
+		(void)sem_wait(&wqueue->sem);
+	}
+}
+#else
 void work_process(FAR struct usr_wqueue_s *wqueue)
 {
 	volatile FAR struct work_s *work;
@@ -282,6 +372,7 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
 
 	work_unlock();
 }
+#endif							/* CONFIG_SCHED_WORKQUEUE_DEADLINE */
 
 /****************************************************************************
  * Name: work_usrthread
@@ -351,6 +442,19 @@ int work_usrstart(void)
 	g_usrwork.delay = CONFIG_LIB_USRWORKPERIOD / USEC_PER_TICK;
 	dq_init(&g_usrwork.q);
 
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	/* Delayed work is kept in a deadline heap and the worker waits on a
+	 * semaphore instead of for SIGWORK.  The semaphore is used for
+	 * signaling and, hence, should not have priority inheritance enabled.
+	 */
+
+	g_usrwork.root = NULL;
+	(void)sem_init(&g_usrwork.sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	(void)sem_setprotocol(&g_usrwork.sem, SEM_PRIO_NONE);
+#endif
+#endif
+
 #ifdef CONFIG_BUILD_PROTECTED
 	{
 		/* Set up the work queue lock */
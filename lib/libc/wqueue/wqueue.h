@@ -59,6 +59,7 @@
 
 #include <tinyara/config.h>
 
+#include <stdbool.h>
 #include <semaphore.h>
 #include <pthread.h>
 
@@ -70,6 +71,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The time at which delayed work becomes due */
+
+#define WORK_DEADLINE(w) ((w)->qtime + (w)->delay)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -79,6 +84,10 @@
 struct usr_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	FAR struct work_s *root;	/* Heap of delayed work, earliest deadline first */
+	sem_t sem;					/* Posted to wake up the idle worker */
+#endif
 	pid_t pid;					/* The task ID of the worker thread(s) */
 };
 
@@ -137,5 +146,34 @@ int work_lock(void);
 
 void work_unlock(void);
 
+/****************************************************************************
+ * Name: work_heapinsert, work_heapremove, work_isqueued
+ *
+ * Description:
+ *   Add delayed work to, or remove it from, the deadline heap of the
+ *   user-mode work queue (see work_heap.c).  Must be called with the work
+ *   queue locked.  work_heapinsert() returns true if the work became the
+ *   earliest pending work.  work_isqueued() searches the FIFO list and the
+ *   heap for work.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+bool work_heapinsert(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work);
+void work_heapremove(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work);
+bool work_isqueued(FAR struct usr_wqueue_s *wqueue, FAR struct work_s *work);
+
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up the worker of the user-mode work queue if it is idle, or about
+ *   to become idle.  Must be called with the work queue locked.
+ *
+ ****************************************************************************/
+
+void work_wakeup(FAR struct usr_wqueue_s *wqueue);
+#endif
+
 #endif							/* CONFIG_LIB_USRWORK && !__KERNEL__ */
 #endif							/* __LIBC_WQUEUE_WQUEUE_H */
@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/arm/src/armv7-r/arm_cyclecount.c
+ *
+ * CPU cycle counter (PMCCNTR) of the ARMv7-R performance monitor unit.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#include <tinyara/arch.h>
+
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNTER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PMCR_E        (1 << 0)	/* Enable all counters */
+#define PMCR_C        (1 << 2)	/* Reset the cycle counter */
+#define PMCR_D        (1 << 3)	/* Count every 64th cycle */
+#define PMCNTEN_C     (1 << 31)	/* Cycle counter enable */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_cyclecount_initialize
+ *
+ * Description:
+ *   Reset the cycle counter and let it count every CPU cycle.
+ *
+ ****************************************************************************/
+
+void up_cyclecount_initialize(void)
+{
+	unsigned int pmcr;
+
+	__asm__ __volatile__("\tmrc p15, 0, %0, c9, c12, 0\n" : "=r"(pmcr));
+	pmcr = (pmcr & ~PMCR_D) | PMCR_E | PMCR_C;
+	__asm__ __volatile__("\tmcr p15, 0, %0, c9, c12, 0\n" : : "r"(pmcr));
+	__asm__ __volatile__("\tmcr p15, 0, %0, c9, c12, 1\n" : : "r"(PMCNTEN_C));
+}
+
+/****************************************************************************
+ * Name: up_cyclecount
+ *
+ * Description:
+ *   Return the free running 32-bit count of CPU cycles.
+ *
+ ****************************************************************************/
+
+uint32_t up_cyclecount(void)
+{
+	unsigned int count;
+
+	__asm__ __volatile__("\tmrc p15, 0, %0, c9, c13, 0\n" : "=r"(count));
+	return count;
+}
+
+#endif							/* CONFIG_ARCH_HAVE_CYCLECOUNTER */
@@ -162,6 +162,12 @@ void up_initialize(void)
 
 	up_calibratedelay();
 
+#ifdef CONFIG_SCHED_CPUACCT
+	/* Start the cycle counter used for the per-thread CPU accounting */
+
+	up_cyclecount_initialize();
+#endif
+
 	/* Colorize the interrupt stack */
 
 	up_color_intstack();
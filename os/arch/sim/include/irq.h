@@ -0,0 +1,161 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/include/irq.h
+ *
+ * This file should never be included directly but, rather, only indirectly
+ * through tinyara/irq.h
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_SIM_INCLUDE_IRQ_H
+#define __ARCH_SIM_INCLUDE_IRQ_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#ifndef __ASSEMBLY__
+#include <stdint.h>
+#endif
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* The only "interrupt" is the system timer, which is driven by a host
+ * interval timer signal.
+ */
+
+#define SIM_IRQ_TIMER       0
+#define NR_IRQS             1
+
+/* The context of a suspended thread is the set of i386 callee-saved
+ * registers, the stack pointer and the resume address, saved and restored
+ * by up_setjmp() and up_longjmp().
+ */
+
+#define JB_EBX              0
+#define JB_ESI              1
+#define JB_EDI              2
+#define JB_EBP              3
+#define JB_SP               4
+#define JB_PC               5
+
+#define XCPTCONTEXT_REGS    6
+#define XCPTCONTEXT_SIZE    (4 * XCPTCONTEXT_REGS)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+typedef uint32_t xcpt_reg_t;
+
+/* This struct defines the way the registers are stored */
+
+struct xcptcontext {
+#ifndef CONFIG_DISABLE_SIGNALS
+	/* The following function pointer is non-zero if there are pending
+	 * signals to be processed when the thread is next resumed.
+	 */
+
+	void *sigdeliver;			/* Actual type is sig_deliver_t */
+#endif
+
+	/* Register save area */
+
+	xcpt_reg_t regs[XCPTCONTEXT_REGS];
+};
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/* Interrupts are masked in software: the host timer signal is never
+ * blocked, but its handler only records the tick in g_irqpending while
+ * g_irqdisabled is set.  The pending tick is then processed when the
+ * interrupts are re-enabled.
+ */
+
+EXTERN volatile uint8_t g_irqdisabled;
+EXTERN volatile uint8_t g_irqpending;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+void up_irqdispatch(void);
+
+/****************************************************************************
+ * Inline functions
+ ****************************************************************************/
+
+/* Save the current interrupt enable state & disable interrupts */
+
+static inline irqstate_t irqsave(void)
+{
+	irqstate_t flags = g_irqdisabled;
+	g_irqdisabled = 1;
+	__asm__ __volatile__("" : : : "memory");
+	return flags;
+}
+
+/* Restore saved interrupt state, running any tick that arrived meanwhile */
+
+static inline void irqrestore(irqstate_t flags)
+{
+	__asm__ __volatile__("" : : : "memory");
+	g_irqdisabled = (uint8_t)flags;
+	if (!flags && g_irqpending) {
+		up_irqdispatch();
+	}
+}
+
+/* Disable interrupts */
+
+static inline void irqdisable(void)
+{
+	(void)irqsave();
+}
+
+/* Enable interrupts */
+
+static inline void irqenable(void)
+{
+	irqrestore(0);
+}
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* __ASSEMBLY__ */
+
+#endif							/* __ARCH_SIM_INCLUDE_IRQ_H */
@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/sim/src/sim_boot.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/mount.h>
+#include <stdio.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/board.h>
+#include <tinyara/fs/mtd.h>
+#include <tinyara/fs/mksmartfs.h>
+
+#include <arch/board/board.h>
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+#define SIM_SMARTDEV_FMT "/dev/smart%dd1"
+#else
+#define SIM_SMARTDEV_FMT "/dev/smart%d"
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_filemtd_setup
+ *
+ * Description:
+ *   Put a SMART block device on top of the host flash image and mount it,
+ *   formatting the image only when it does not hold a volume yet.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SIM_FILEMTD) && defined(CONFIG_MTD_SMART)
+static void sim_filemtd_setup(void)
+{
+	FAR struct mtd_dev_s *mtd;
+	int ret;
+
+	mtd = up_filemtd_initialize();
+	if (mtd == NULL) {
+		return;
+	}
+
+	ret = smart_initialize(CONFIG_SIM_FILEMTD_MINOR, mtd, NULL);
+	if (ret < 0) {
+		lldbg("ERROR: smart_initialize failed: %d\n", ret);
+		return;
+	}
+
+#ifdef CONFIG_SIM_AUTOMOUNT_USERFS
+	{
+		char devname[16];
+
+		snprintf(devname, sizeof(devname), SIM_SMARTDEV_FMT, CONFIG_SIM_FILEMTD_MINOR);
+
+		ret = mount(devname, CONFIG_SIM_AUTOMOUNT_USERFS_MOUNTPOINT, "smartfs", 0, NULL);
+		if (ret < 0) {
+			/* Most likely a fresh image; format it and try again */
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+			ret = mksmartfs(devname, 1, true);
+#else
+			ret = mksmartfs(devname, true);
+#endif
+			if (ret == OK) {
+				ret = mount(devname, CONFIG_SIM_AUTOMOUNT_USERFS_MOUNTPOINT, "smartfs", 0, NULL);
+			}
+
+			if (ret < 0) {
+				lldbg("ERROR: mounting '%s' failed: %d\n", devname, errno);
+			}
+		}
+	}
+#endif
+}
+#else
+#define sim_filemtd_setup()
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: board_app_initialize
+ *
+ * Description:
+ *   Perform architecture specific initialization
+ *
+ ****************************************************************************/
+
+int board_app_initialize(void)
+{
+#ifdef CONFIG_FS_PROCFS
+	int ret;
+
+	/* Mount the procfs file system */
+
+	ret = mount(NULL, SIM_PROCFS_MOUNTPOINT, "procfs", 0, NULL);
+	if (ret < 0) {
+		lldbg("Failed to mount procfs at %s: %d\n", SIM_PROCFS_MOUNTPOINT, ret);
+	}
+#endif
+
+	sim_filemtd_setup();
+
+	return OK;
+}
+
+#ifdef CONFIG_BOARD_INITIALIZE
+/****************************************************************************
+ * Name: board_initialize
+ *
+ * Description:
+ *   If CONFIG_BOARD_INITIALIZE is selected, then an additional
+ *   initialization call will be performed in the boot-up sequence to a
+ *   function called board_initialize().  board_initialize() will be
+ *   called immediately after up_initialize() is called and just before the
+ *   initial application is started.
+ *
+ ****************************************************************************/
+
+void board_initialize(void)
+{
+	board_app_initialize();
+}
+#endif
@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_assert.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_assert
+ *
+ * Description:
+ *   Report the failed assertion and terminate the simulator with a failure
+ *   status, so that scripted runs notice it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HAVE_FILENAME
+void up_assert(const uint8_t *filename, int lineno)
+#else
+void up_assert(void)
+#endif
+{
+	(void)irqsave();
+
+#ifdef CONFIG_HAVE_FILENAME
+#ifdef CONFIG_PRINT_TASKNAME
+	lldbg("Assertion failed at file:%s line: %d task: %s\n", filename, lineno, this_task()->name);
+#else
+	lldbg("Assertion failed at file:%s line: %d\n", filename, lineno);
+#endif
+#else
+	lldbg("Assertion failed\n");
+#endif
+
+	up_hostexit(EXIT_FAILURE);
+}
@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_blocktask.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <sched.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_block_task
+ *
+ * Description:
+ *   The currently executing task at the head of
+ *   the ready to run list must be stopped.  Save its context
+ *   and move it to the inactive list specified by task_state.
+ *
+ * Inputs:
+ *   tcb: Refers to a task in the ready-to-run list (normally
+ *     the task at the head of the list).  It most be
+ *     stopped, its context saved and moved into one of the
+ *     waiting task lists.  It it was the task at the head
+ *     of the ready-to-run list, then a context to the new
+ *     ready to run task must be performed.
+ *   task_state: Specifies which waiting task list should be
+ *     hold the blocked task TCB.
+ *
+ ****************************************************************************/
+
+void up_block_task(struct tcb_s *tcb, tstate_t task_state)
+{
+	struct tcb_s *rtcb = this_task();
+	bool switch_needed;
+
+	/* Verify that the context switch can be performed */
+
+	ASSERT((tcb->task_state >= FIRST_READY_TO_RUN_STATE) && (tcb->task_state <= LAST_READY_TO_RUN_STATE));
+
+	/* Remove the tcb task from the ready-to-run list.  If we
+	 * are blocking the task at the head of the task list (the
+	 * most likely case), then a context switch to the next
+	 * ready-to-run task is needed. In this case, it should
+	 * also be true that rtcb == tcb.
+	 */
+
+	switch_needed = sched_removereadytorun(tcb);
+
+	/* Add the task to the specified blocked task list */
+
+	sched_addblocked(tcb, (tstate_t)task_state);
+
+	/* If there are any pending tasks, then add them to the g_readytorun
+	 * task list now
+	 */
+
+	if (g_pendingtasks.head) {
+		switch_needed |= sched_mergepending();
+	}
+
+	/* Now, perform the context switch if one is needed.  In the timer
+	 * interrupt the switch is deferred to up_irqdispatch().
+	 */
+
+	if (switch_needed && !up_interrupt_context()) {
+		up_switchcontext(rtcb, this_task());
+	}
+}
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_createstack.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <sched.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/arch.h>
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+#include <tinyara/mm/mm.h>
+#endif
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_create_stack
+ *
+ * Description:
+ *   Allocate a stack for a new thread and setup up stack-related
+ *   information in the TCB.
+ *
+ * Input Parameters:
+ *   - tcb: The TCB of new task
+ *   - stack_size:  The requested stack size.  At least this much
+ *     must be allocated.
+ *   - ttype:  The thread type.  This may be one of following (defined in
+ *     include/tinyara/sched.h):
+ *
+ *       TCB_FLAG_TTYPE_TASK     Normal user task
+ *       TCB_FLAG_TTYPE_PTHREAD  User pthread
+ *       TCB_FLAG_TTYPE_KERNEL   Kernel thread
+ *
+ ****************************************************************************/
+
+int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
+{
+	/* Is there already a stack allocated of a different size? */
+
+	if (tcb->stack_alloc_ptr && tcb->adj_stack_size != stack_size) {
+		/* Yes.. Release the old stack */
+
+		up_release_stack(tcb, ttype);
+	}
+
+	/* Do we need to allocate a new stack? */
+
+	if (!tcb->stack_alloc_ptr) {
+		tcb->stack_alloc_ptr = (uint32_t *)kumm_malloc(stack_size);
+		if (!tcb->stack_alloc_ptr) {
+			sdbg("ERROR: Failed to allocate stack, size %d\n", stack_size);
+			return -ENOMEM;
+		}
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+		heapinfo_exclude_stacksize(tcb->stack_alloc_ptr);
+#endif
+	}
+
+	/* Same push-down stack layout as the ARM ports: adj_stack_ptr is the
+	 * highest word of the stack, rounded down to the ABI alignment.
+	 */
+
+	return up_use_stack(tcb, tcb->stack_alloc_ptr, stack_size);
+}
+
+/****************************************************************************
+ * Name: up_stack_color
+ *
+ * Description:
+ *   Write a well know value into the stack
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STACK_COLORATION
+void up_stack_color(FAR void *stackbase, size_t nbytes)
+{
+	uint32_t *stkptr = (uint32_t *)(((uintptr_t)stackbase + 3) & ~3);
+	uintptr_t stkend = (((uintptr_t)stackbase + nbytes) & ~3);
+	size_t nwords = (stkend - (uintptr_t)stkptr) >> 2;
+
+	while (nwords-- > 0) {
+		*stkptr++ = STACK_COLOR;
+	}
+}
+#endif
@@ -0,0 +1,277 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_devconsole.c
+ *
+ * /dev/console of the simulation, on top of the host terminal.  Input is
+ * collected from the IDLE loop into a small ring buffer so that the host
+ * descriptor never stays readable while the IDLE thread sleeps on it.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <semaphore.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/fs/fs.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SIM_CONSOLE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEVCONSOLE_BUFSIZE      256
+#define DEVCONSOLE_NPOLLWAITERS 2
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t devconsole_read(FAR struct file *filep, FAR char *buffer, size_t len);
+static ssize_t devconsole_write(FAR struct file *filep, FAR const char *buffer, size_t len);
+#ifndef CONFIG_DISABLE_POLL
+static int devconsole_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations devconsole_fops = {
+	0,							/* open */
+	0,							/* close */
+	devconsole_read,			/* read */
+	devconsole_write,			/* write */
+	0,							/* seek */
+	0							/* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+	, devconsole_poll			/* poll */
+#endif
+};
+
+/* Receive ring buffer, filled by up_devconsole_poll() */
+
+static char g_rxbuffer[DEVCONSOLE_BUFSIZE];
+static volatile uint16_t g_rxhead;
+static volatile uint16_t g_rxtail;
+
+/* Readers blocked waiting for input */
+
+static sem_t g_rxsem;
+static volatile uint8_t g_rxwaiters;
+
+#ifndef CONFIG_DISABLE_POLL
+static FAR struct pollfd *g_rxfds[DEVCONSOLE_NPOLLWAITERS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devconsole_read
+ ****************************************************************************/
+
+static ssize_t devconsole_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+	irqstate_t flags;
+	size_t nread = 0;
+
+	flags = irqsave();
+
+	while (g_rxhead == g_rxtail) {
+		if (filep->f_oflags & O_NONBLOCK) {
+			irqrestore(flags);
+			return -EAGAIN;
+		}
+
+		g_rxwaiters++;
+		if (sem_wait(&g_rxsem) < 0) {
+			g_rxwaiters--;
+			irqrestore(flags);
+			return -get_errno();
+		}
+	}
+
+	while (nread < len && g_rxtail != g_rxhead) {
+		buffer[nread++] = g_rxbuffer[g_rxtail];
+		g_rxtail = (g_rxtail + 1) % DEVCONSOLE_BUFSIZE;
+	}
+
+	irqrestore(flags);
+	return nread;
+}
+
+/****************************************************************************
+ * Name: devconsole_write
+ ****************************************************************************/
+
+static ssize_t devconsole_write(FAR struct file *filep, FAR const char *buffer, size_t len)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	up_hostconsole_write(buffer, len);
+	irqrestore(flags);
+
+	return len;
+}
+
+/****************************************************************************
+ * Name: devconsole_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int devconsole_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
+{
+	FAR struct pollfd **slot;
+	irqstate_t flags;
+	int ret = OK;
+	int i;
+
+	flags = irqsave();
+
+	if (setup) {
+		for (i = 0; i < DEVCONSOLE_NPOLLWAITERS; i++) {
+			if (g_rxfds[i] == NULL) {
+				g_rxfds[i] = fds;
+				fds->priv = &g_rxfds[i];
+				break;
+			}
+		}
+
+		if (i >= DEVCONSOLE_NPOLLWAITERS) {
+			fds->priv = NULL;
+			ret = -EBUSY;
+			goto errout;
+		}
+
+		/* Output never blocks; input is ready if the ring is not empty */
+
+		fds->revents |= (fds->events & POLLOUT);
+		if (g_rxhead != g_rxtail) {
+			fds->revents |= (fds->events & POLLIN);
+		}
+
+		if (fds->revents != 0) {
+			sem_post(fds->sem);
+		}
+	} else if (fds->priv) {
+		slot = (FAR struct pollfd **)fds->priv;
+		*slot = NULL;
+		fds->priv = NULL;
+	}
+
+errout:
+	irqrestore(flags);
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_devconsole
+ *
+ * Description:
+ *   Put the host terminal in raw mode and register /dev/console.
+ *
+ ****************************************************************************/
+
+void up_devconsole(void)
+{
+	sem_init(&g_rxsem, 0, 0);
+	up_hostconsole_start();
+	(void)register_driver("/dev/console", &devconsole_fops, 0666, NULL);
+}
+
+/****************************************************************************
+ * Name: up_devconsole_poll
+ *
+ * Description:
+ *   Called from the IDLE loop.  Move pending host input into the ring
+ *   buffer and wake up readers and pollers.
+ *
+ ****************************************************************************/
+
+void up_devconsole_poll(void)
+{
+	irqstate_t flags;
+	uint16_t next;
+	bool received = false;
+	int ch;
+#ifndef CONFIG_DISABLE_POLL
+	int i;
+#endif
+
+	flags = irqsave();
+
+	for (;;) {
+		next = (g_rxhead + 1) % DEVCONSOLE_BUFSIZE;
+		if (next == g_rxtail || !up_hostconsole_checkc()) {
+			break;
+		}
+
+		ch = up_hostconsole_getc();
+		if (ch < 0) {
+			break;
+		}
+
+		g_rxbuffer[g_rxhead] = (char)ch;
+		g_rxhead = next;
+		received = true;
+	}
+
+	if (received) {
+		while (g_rxwaiters > 0) {
+			g_rxwaiters--;
+			sem_post(&g_rxsem);
+		}
+
+#ifndef CONFIG_DISABLE_POLL
+		for (i = 0; i < DEVCONSOLE_NPOLLWAITERS; i++) {
+			FAR struct pollfd *fds = g_rxfds[i];
+			if (fds && (fds->events & POLLIN)) {
+				fds->revents |= POLLIN;
+				sem_post(fds->sem);
+			}
+		}
+#endif
+	}
+
+	irqrestore(flags);
+}
+
+#endif							/* CONFIG_SIM_CONSOLE */
@@ -0,0 +1,301 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_filemtd.c
+ *
+ * MTD device backed by a regular file on the host so that a file system
+ * image survives restarts of the simulation.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/fs/mtd.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SIM_FILEMTD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_SIM_FILEMTD_BLOCKSIZE > CONFIG_SIM_FILEMTD_ERASESIZE
+#error "Must have CONFIG_SIM_FILEMTD_BLOCKSIZE <= CONFIG_SIM_FILEMTD_ERASESIZE"
+#endif
+
+#define FILEMTD_BLKPER     (CONFIG_SIM_FILEMTD_ERASESIZE / CONFIG_SIM_FILEMTD_BLOCKSIZE)
+#define FILEMTD_SIZE       (CONFIG_SIM_FILEMTD_ERASESIZE * CONFIG_SIM_FILEMTD_NERASEBLOCKS)
+#define FILEMTD_ERASESTATE 0xff
+
+#if FILEMTD_BLKPER * CONFIG_SIM_FILEMTD_BLOCKSIZE != CONFIG_SIM_FILEMTD_ERASESIZE
+#error "CONFIG_SIM_FILEMTD_ERASESIZE must be an even multiple of CONFIG_SIM_FILEMTD_BLOCKSIZE"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Every access to the image is a host system call.  They are made with the
+ * simulated interrupts disabled so that a timer tick cannot switch tasks in
+ * the middle of the host C library.
+ */
+
+struct filemtd_dev_s {
+	struct mtd_dev_s mtd;		/* MTD device */
+	int fd;						/* Host file descriptor of the image */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int filemtd_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks);
+static ssize_t filemtd_bread(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR uint8_t *buf);
+static ssize_t filemtd_bwrite(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR const uint8_t *buf);
+static ssize_t filemtd_byteread(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR uint8_t *buf);
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t filemtd_bytewrite(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR const uint8_t *buf);
+#endif
+static int filemtd_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct filemtd_dev_s g_filemtd = {
+	{
+		filemtd_erase,
+		filemtd_bread,
+		filemtd_bwrite,
+		filemtd_byteread,
+#ifdef CONFIG_MTD_BYTE_WRITE
+		filemtd_bytewrite,
+#endif
+		filemtd_ioctl
+	},
+	-1
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemtd_erase
+ ****************************************************************************/
+
+static int filemtd_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
+{
+	FAR struct filemtd_dev_s *priv = (FAR struct filemtd_dev_s *)dev;
+	irqstate_t flags;
+	int ret;
+
+	DEBUGASSERT(dev);
+
+	if (startblock >= CONFIG_SIM_FILEMTD_NERASEBLOCKS) {
+		return 0;
+	}
+
+	if (startblock + nblocks > CONFIG_SIM_FILEMTD_NERASEBLOCKS) {
+		nblocks = CONFIG_SIM_FILEMTD_NERASEBLOCKS - startblock;
+	}
+
+	flags = irqsave();
+	ret = up_hostfile_fill(priv->fd, FILEMTD_ERASESTATE, nblocks * CONFIG_SIM_FILEMTD_ERASESIZE, startblock * CONFIG_SIM_FILEMTD_ERASESIZE);
+	irqrestore(flags);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: filemtd_bread
+ ****************************************************************************/
+
+static ssize_t filemtd_bread(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR uint8_t *buf)
+{
+	FAR struct filemtd_dev_s *priv = (FAR struct filemtd_dev_s *)dev;
+	off_t maxblock = CONFIG_SIM_FILEMTD_NERASEBLOCKS * FILEMTD_BLKPER;
+	irqstate_t flags;
+	int ret;
+
+	DEBUGASSERT(dev && buf);
+
+	if (startblock >= maxblock) {
+		return 0;
+	}
+
+	if (startblock + nblocks > maxblock) {
+		nblocks = maxblock - startblock;
+	}
+
+	flags = irqsave();
+	ret = up_hostfile_read(priv->fd, buf, nblocks * CONFIG_SIM_FILEMTD_BLOCKSIZE, startblock * CONFIG_SIM_FILEMTD_BLOCKSIZE);
+	irqrestore(flags);
+	return ret < 0 ? ret : nblocks;
+}
+
+/****************************************************************************
+ * Name: filemtd_bwrite
+ ****************************************************************************/
+
+static ssize_t filemtd_bwrite(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR const uint8_t *buf)
+{
+	FAR struct filemtd_dev_s *priv = (FAR struct filemtd_dev_s *)dev;
+	off_t maxblock = CONFIG_SIM_FILEMTD_NERASEBLOCKS * FILEMTD_BLKPER;
+	irqstate_t flags;
+	int ret;
+
+	DEBUGASSERT(dev && buf);
+
+	if (startblock >= maxblock) {
+		return 0;
+	}
+
+	if (startblock + nblocks > maxblock) {
+		nblocks = maxblock - startblock;
+	}
+
+	flags = irqsave();
+	ret = up_hostfile_write(priv->fd, buf, nblocks * CONFIG_SIM_FILEMTD_BLOCKSIZE, startblock * CONFIG_SIM_FILEMTD_BLOCKSIZE);
+	irqrestore(flags);
+	return ret < 0 ? ret : nblocks;
+}
+
+/****************************************************************************
+ * Name: filemtd_byteread
+ ****************************************************************************/
+
+static ssize_t filemtd_byteread(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR uint8_t *buf)
+{
+	FAR struct filemtd_dev_s *priv = (FAR struct filemtd_dev_s *)dev;
+	irqstate_t flags;
+	int ret;
+
+	DEBUGASSERT(dev && buf);
+
+	if (offset + nbytes > FILEMTD_SIZE) {
+		return 0;
+	}
+
+	flags = irqsave();
+	ret = up_hostfile_read(priv->fd, buf, nbytes, offset);
+	irqrestore(flags);
+	return ret < 0 ? ret : nbytes;
+}
+
+/****************************************************************************
+ * Name: filemtd_bytewrite
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t filemtd_bytewrite(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR const uint8_t *buf)
+{
+	FAR struct filemtd_dev_s *priv = (FAR struct filemtd_dev_s *)dev;
+	irqstate_t flags;
+	int ret;
+
+	DEBUGASSERT(dev && buf);
+
+	if (offset + nbytes > FILEMTD_SIZE) {
+		return 0;
+	}
+
+	flags = irqsave();
+	ret = up_hostfile_write(priv->fd, buf, nbytes, offset);
+	irqrestore(flags);
+	return ret < 0 ? ret : nbytes;
+}
+#endif
+
+/****************************************************************************
+ * Name: filemtd_ioctl
+ ****************************************************************************/
+
+static int filemtd_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
+{
+	int ret = -EINVAL;			/* Assume good command with bad parameters */
+
+	switch (cmd) {
+	case MTDIOC_GEOMETRY: {
+		FAR struct mtd_geometry_s *geo = (FAR struct mtd_geometry_s *)((uintptr_t)arg);
+		if (geo) {
+			geo->blocksize = CONFIG_SIM_FILEMTD_BLOCKSIZE;
+			geo->erasesize = CONFIG_SIM_FILEMTD_ERASESIZE;
+			geo->neraseblocks = CONFIG_SIM_FILEMTD_NERASEBLOCKS;
+			ret = OK;
+		}
+	}
+	break;
+
+	case MTDIOC_BULKERASE:
+		ret = filemtd_erase(dev, 0, CONFIG_SIM_FILEMTD_NERASEBLOCKS);
+		break;
+
+	default:
+		ret = -ENOTTY;			/* Bad command */
+		break;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_filemtd_initialize
+ *
+ * Description:
+ *   Open (or create) the flash image CONFIG_SIM_FILEMTD_PATH on the host and
+ *   return the MTD device that accesses it.  A newly created image reads as
+ *   erased flash.
+ *
+ ****************************************************************************/
+
+FAR struct mtd_dev_s *up_filemtd_initialize(void)
+{
+	irqstate_t flags;
+
+	if (g_filemtd.fd < 0) {
+		flags = irqsave();
+		g_filemtd.fd = up_hostfile_open(CONFIG_SIM_FILEMTD_PATH, FILEMTD_SIZE);
+		irqrestore(flags);
+		if (g_filemtd.fd < 0) {
+			lldbg("ERROR: Failed to open %s: %d\n", CONFIG_SIM_FILEMTD_PATH, g_filemtd.fd);
+			return NULL;
+		}
+	}
+
+	return &g_filemtd.mtd;
+}
+
+#endif							/* CONFIG_SIM_FILEMTD */
@@ -0,0 +1,166 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_hostconsole.c
+ *
+ * Host side of the simulation console: the controlling terminal in raw
+ * mode.  This file is compiled against the host C library.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/select.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <termios.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+void up_hostidle_watchfd(int fd);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct termios g_oldtermios;
+static bool g_rawmode;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hostconsole_restore
+ *
+ * Description:
+ *   atexit() hook putting the terminal back the way we found it.
+ *
+ ****************************************************************************/
+
+static void hostconsole_restore(void)
+{
+	if (g_rawmode) {
+		tcsetattr(STDIN_FILENO, TCSANOW, &g_oldtermios);
+		g_rawmode = false;
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_hostconsole_start
+ *
+ * Description:
+ *   Switch stdin to raw mode (echo and line editing are done by the
+ *   simulated shell) and let the idle loop wake up on keyboard input.
+ *
+ ****************************************************************************/
+
+void up_hostconsole_start(void)
+{
+	struct termios raw;
+
+	if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &g_oldtermios) == 0) {
+		raw = g_oldtermios;
+		raw.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+		raw.c_lflag &= ~(ECHO | ICANON | IEXTEN);
+		raw.c_cc[VMIN] = 1;
+		raw.c_cc[VTIME] = 0;
+
+		if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0) {
+			g_rawmode = true;
+			atexit(hostconsole_restore);
+		}
+	}
+
+	up_hostidle_watchfd(STDIN_FILENO);
+}
+
+/****************************************************************************
+ * Name: up_hostconsole_checkc
+ *
+ * Description:
+ *   Return true if a character can be read without blocking.
+ *
+ ****************************************************************************/
+
+bool up_hostconsole_checkc(void)
+{
+	struct timeval tv;
+	fd_set rfds;
+
+	FD_ZERO(&rfds);
+	FD_SET(STDIN_FILENO, &rfds);
+	tv.tv_sec = 0;
+	tv.tv_usec = 0;
+
+	return select(STDIN_FILENO + 1, &rfds, NULL, NULL, &tv) > 0;
+}
+
+/****************************************************************************
+ * Name: up_hostconsole_getc
+ *
+ * Description:
+ *   Read one character; returns -1 on end of file or error.
+ *
+ ****************************************************************************/
+
+int up_hostconsole_getc(void)
+{
+	unsigned char ch;
+	ssize_t nread;
+
+	do {
+		nread = read(STDIN_FILENO, &ch, 1);
+	} while (nread < 0 && errno == EINTR);
+
+	return nread == 1 ? (int)ch : -1;
+}
+
+/****************************************************************************
+ * Name: up_hostconsole_write
+ ****************************************************************************/
+
+void up_hostconsole_write(const char *buffer, size_t buflen)
+{
+	ssize_t nwritten;
+
+	while (buflen > 0) {
+		nwritten = write(STDOUT_FILENO, buffer, buflen);
+		if (nwritten < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			break;
+		}
+
+		buffer += nwritten;
+		buflen -= nwritten;
+	}
+}
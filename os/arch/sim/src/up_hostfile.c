@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_hostfile.c
+ *
+ * Host side of the file backed MTD device.  This file is compiled against
+ * the host C library.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#define _FILE_OFFSET_BITS 64
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HOSTFILE_CHUNK 4096
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_hostfile_fill
+ *
+ * Description:
+ *   Set nbytes of the file starting at offset to value.
+ *
+ ****************************************************************************/
+
+int up_hostfile_fill(int fd, uint8_t value, size_t nbytes, size_t offset)
+{
+	uint8_t chunk[HOSTFILE_CHUNK];
+	size_t len;
+	ssize_t ret;
+
+	memset(chunk, value, sizeof(chunk));
+	while (nbytes > 0) {
+		len = nbytes < sizeof(chunk) ? nbytes : sizeof(chunk);
+		ret = pwrite(fd, chunk, len, offset);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			return -errno;
+		}
+
+		nbytes -= ret;
+		offset += ret;
+	}
+
+	return 0;
+}
+
+/****************************************************************************
+ * Name: up_hostfile_open
+ *
+ * Description:
+ *   Open the image at path, creating it or growing it to size bytes.  Any
+ *   space that had to be added reads as erased (0xff) flash.
+ *
+ ****************************************************************************/
+
+int up_hostfile_open(const char *path, size_t size)
+{
+	struct stat st;
+	int fd;
+	int ret;
+
+	fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	if (fstat(fd, &st) < 0) {
+		ret = -errno;
+		close(fd);
+		return ret;
+	}
+
+	if ((size_t)st.st_size < size) {
+		ret = up_hostfile_fill(fd, 0xff, size - st.st_size, st.st_size);
+		if (ret < 0) {
+			close(fd);
+			return ret;
+		}
+	}
+
+	return fd;
+}
+
+/****************************************************************************
+ * Name: up_hostfile_read
+ ****************************************************************************/
+
+int up_hostfile_read(int fd, void *buffer, size_t nbytes, size_t offset)
+{
+	ssize_t ret;
+
+	do {
+		ret = pread(fd, buffer, nbytes, offset);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 0) {
+		return -errno;
+	}
+
+	/* Reads past the end of a short image see erased flash */
+
+	if ((size_t)ret < nbytes) {
+		memset((uint8_t *)buffer + ret, 0xff, nbytes - ret);
+	}
+
+	return nbytes;
+}
+
+/****************************************************************************
+ * Name: up_hostfile_write
+ ****************************************************************************/
+
+int up_hostfile_write(int fd, const void *buffer, size_t nbytes, size_t offset)
+{
+	const uint8_t *src = buffer;
+	size_t remaining = nbytes;
+	ssize_t ret;
+
+	while (remaining > 0) {
+		ret = pwrite(fd, src, remaining, offset);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			return -errno;
+		}
+
+		src += ret;
+		offset += ret;
+		remaining -= ret;
+	}
+
+	return nbytes;
+}
@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_hostsys.c
+ *
+ * Host side timer, idle and process services of the simulation.  This file
+ * is compiled against the host C library.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/select.h>
+#include <sys/time.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HOSTIDLE_MAXFDS 4
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+/* Provided by the simulated kernel (up_irq.c) */
+
+void up_timerinterrupt(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_idlefds[HOSTIDLE_MAXFDS];
+static int g_nidlefds;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hostsys_sigalrm
+ *
+ * Description:
+ *   SIGALRM handler.  It may switch to another simulated thread and only
+ *   return much later, so the signal is installed with SA_NODEFER.
+ *
+ ****************************************************************************/
+
+static void hostsys_sigalrm(int signo)
+{
+	up_timerinterrupt();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_hosttimer_start
+ *
+ * Description:
+ *   Start a periodic host interval timer with the given period.
+ *
+ ****************************************************************************/
+
+void up_hosttimer_start(unsigned int usec)
+{
+	struct sigaction act;
+	struct itimerval it;
+
+	memset(&act, 0, sizeof(act));
+	act.sa_handler = hostsys_sigalrm;
+	act.sa_flags = SA_NODEFER | SA_RESTART;
+	sigemptyset(&act.sa_mask);
+	sigaction(SIGALRM, &act, NULL);
+
+	it.it_interval.tv_sec = usec / 1000000;
+	it.it_interval.tv_usec = usec % 1000000;
+	it.it_value = it.it_interval;
+	setitimer(ITIMER_REAL, &it, NULL);
+}
+
+/****************************************************************************
+ * Name: up_hostidle_watchfd
+ *
+ * Description:
+ *   Add a descriptor whose readability should end up_hostidle() early.
+ *
+ ****************************************************************************/
+
+void up_hostidle_watchfd(int fd)
+{
+	if (g_nidlefds < HOSTIDLE_MAXFDS) {
+		g_idlefds[g_nidlefds++] = fd;
+	}
+}
+
+/****************************************************************************
+ * Name: up_hostidle
+ *
+ * Description:
+ *   Give the host CPU away until the next timer signal or until one of the
+ *   watched descriptors becomes readable.
+ *
+ ****************************************************************************/
+
+void up_hostidle(void)
+{
+	fd_set rfds;
+	int maxfd = -1;
+	int i;
+
+	FD_ZERO(&rfds);
+	for (i = 0; i < g_nidlefds; i++) {
+		FD_SET(g_idlefds[i], &rfds);
+		if (g_idlefds[i] > maxfd) {
+			maxfd = g_idlefds[i];
+		}
+	}
+
+	/* A NULL timeout is fine: SIGALRM interrupts the wait every tick */
+
+	(void)select(maxfd + 1, &rfds, NULL, NULL, NULL);
+}
+
+/****************************************************************************
+ * Name: up_hostusleep
+ ****************************************************************************/
+
+void up_hostusleep(unsigned int usec)
+{
+	struct timespec ts;
+
+	ts.tv_sec = usec / 1000000;
+	ts.tv_nsec = (usec % 1000000) * 1000;
+	while (nanosleep(&ts, &ts) < 0) {
+	}
+}
+
+/****************************************************************************
+ * Name: up_hostexit
+ ****************************************************************************/
+
+void up_hostexit(int status)
+{
+	exit(status);
+}
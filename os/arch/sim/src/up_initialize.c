@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_initialize.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/syslog/ramlog.h>
+#include <tinyara/syslog/syslog_console.h>
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_initialize
+ *
+ * Description:
+ *   up_initialize will be called once during OS initialization after the
+ *   basic OS services have been initialized.  For the simulation this
+ *   starts the host interval timer that drives the system tick and
+ *   registers the host backed devices.
+ *
+ ****************************************************************************/
+
+void up_initialize(void)
+{
+	/* Initialize global variables */
+
+	g_ininterrupt = false;
+
+#ifdef CONFIG_SCHED_CPUACCT
+	/* Start the cycle counter used for the per-thread CPU accounting */
+
+	up_cyclecount_initialize();
+#endif
+
+	/* Initialize the interrupt subsystem */
+
+	up_irqinitialize();
+
+	/* Initialize the system timer interrupt */
+
+#if !defined(CONFIG_SUPPRESS_INTERRUPTS) && !defined(CONFIG_SUPPRESS_TIMER_INTS)
+	up_timer_initialize();
+#endif
+
+	/* Register devices */
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+
+#if defined(CONFIG_DEV_NULL)
+	devnull_register();			/* Standard /dev/null */
+#endif
+
+#if defined(CONFIG_DEV_ZERO)
+	devzero_register();			/* Standard /dev/zero */
+#endif
+
+#endif							/* CONFIG_NFILE_DESCRIPTORS */
+
+	/* Initialize the console device driver */
+
+#if defined(CONFIG_SIM_CONSOLE)
+	up_devconsole();
+#elif defined(CONFIG_SYSLOG_CONSOLE)
+	syslog_console_init();
+#elif defined(CONFIG_RAMLOG_CONSOLE)
+	ramlog_consoleinit();
+#endif
+
+	/* Initialize the system logging device */
+
+#ifdef CONFIG_SYSLOG_CHAR
+	syslog_initialize();
+#endif
+#ifdef CONFIG_RAMLOG_SYSLOG
+	ramlog_sysloginit();
+#endif
+
+	/* Initialize the network */
+
+	up_netinitialize();
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_initialstate.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <tinyara/arch.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_start
+ *
+ * Description:
+ *   First code run by every new thread.  Contexts are always resumed with
+ *   interrupts disabled, so enable them before entering the thread.
+ *
+ ****************************************************************************/
+
+static void up_start(void)
+{
+	FAR struct tcb_s *tcb = this_task();
+
+#ifndef CONFIG_SUPPRESS_INTERRUPTS
+	irqenable();
+#endif
+	up_sigdeliver();
+
+	tcb->start();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_initial_state
+ *
+ * Description:
+ *   A new thread is being started and a new TCB has been created. This
+ *   function is called to initialize the processor specific portions of
+ *   the new TCB.
+ *
+ *   This function must setup the intial architecture registers and/or
+ *   stack so that execution will begin at tcb->start on the next context
+ *   switch.
+ *
+ ****************************************************************************/
+
+void up_initial_state(struct tcb_s *tcb)
+{
+	struct xcptcontext *xcp = &tcb->xcp;
+
+	/* Initialize the initial register context structure */
+
+	memset(xcp, 0, sizeof(struct xcptcontext));
+
+	/* The IDLE thread runs on the host main stack and its context is saved
+	 * the first time it is switched out.
+	 */
+
+	if (tcb->adj_stack_ptr == NULL) {
+		return;
+	}
+
+	/* Resume as if up_start() had just been called: leave room for the
+	 * (unused) return address below a 16-byte aligned stack top.
+	 */
+
+	xcp->regs[JB_SP] = (xcpt_reg_t)STACK_ALIGN_DOWN((uintptr_t)tcb->adj_stack_ptr) - sizeof(xcpt_reg_t);
+	xcp->regs[JB_PC] = (xcpt_reg_t)up_start;
+}
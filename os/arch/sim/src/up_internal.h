@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_internal.h
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_SIM_SRC_UP_INTERNAL_H
+#define __ARCH_SIM_SRC_UP_INTERNAL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#ifndef __ASSEMBLY__
+#include <tinyara/compiler.h>
+#include <tinyara/sched.h>
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determine which console driver to use */
+
+#if !defined(CONFIG_DEV_CONSOLE) || CONFIG_NFILE_DESCRIPTORS == 0
+#undef CONFIG_SIM_CONSOLE
+#endif
+
+/* Stacks are allocated from the TinyAra heap and must satisfy the i386
+ * System V ABI, which requires 16-byte alignment at function entry.
+ */
+
+#define STACK_ALIGNMENT     16
+#define STACK_ALIGN_MASK    (STACK_ALIGNMENT - 1)
+#define STACK_ALIGN_DOWN(a) ((a) & ~STACK_ALIGN_MASK)
+#define STACK_ALIGN_UP(a)   (((a) + STACK_ALIGN_MASK) & ~STACK_ALIGN_MASK)
+
+/* Stack coloration value */
+
+#define STACK_COLOR         0xdeadbeef
+
+/* The heap is a static array in the simulator's .bss */
+
+#if CONFIG_RAM_SIZE > 0
+#define SIM_HEAP_SIZE       CONFIG_RAM_SIZE
+#else
+#define SIM_HEAP_SIZE       (4 * 1024 * 1024)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+/* True while the simulated timer interrupt is being processed */
+
+extern volatile bool g_ininterrupt;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+struct mtd_dev_s;
+
+/* up_setjmp.S **************************************************************/
+
+int up_setjmp(xcpt_reg_t *jb) __attribute__((returns_twice));
+void up_longjmp(xcpt_reg_t *jb, int val) noreturn_function;
+
+/* up_switchcontext.c *******************************************************/
+
+void up_switchcontext(FAR struct tcb_s *rtcb, FAR struct tcb_s *nexttcb);
+void up_sigdeliver(void);
+
+/* up_irq.c *****************************************************************/
+
+void up_irqinitialize(void);
+void up_timerinterrupt(void);
+
+/* up_createstack.c *********************************************************/
+
+#ifdef CONFIG_STACK_COLORATION
+void up_stack_color(FAR void *stackbase, size_t nbytes);
+#endif
+
+/* up_timerisr.c ************************************************************/
+
+void up_timer_initialize(void);
+
+/* up_devconsole.c **********************************************************/
+
+#ifdef CONFIG_SIM_CONSOLE
+void up_devconsole(void);
+void up_devconsole_poll(void);
+#else
+#define up_devconsole()
+#define up_devconsole_poll()
+#endif
+
+/* up_filemtd.c *************************************************************/
+
+#ifdef CONFIG_SIM_FILEMTD
+FAR struct mtd_dev_s *up_filemtd_initialize(void);
+#endif
+
+/* up_netdev.c **************************************************************/
+
+#ifdef CONFIG_SIM_TAPDEV
+void up_netinitialize(void);
+void up_netdev_poll(void);
+#else
+#define up_netinitialize()
+#define up_netdev_poll()
+#endif
+
+/* Host interfaces **********************************************************/
+
+/* The following are built against the host C library (HOSTSRCS) and only
+ * take and return plain C types.
+ */
+
+/* up_hostsys.c */
+
+void up_hosttimer_start(unsigned int usec);
+void up_hostidle(void);
+void up_hostidle_watchfd(int fd);
+void up_hostusleep(unsigned int usec);
+void up_hostexit(int status) noreturn_function;
+
+/* up_hostconsole.c */
+
+void up_hostconsole_start(void);
+int up_hostconsole_getc(void);
+bool up_hostconsole_checkc(void);
+void up_hostconsole_write(const char *buffer, size_t buflen);
+
+/* up_hostfile.c */
+
+int up_hostfile_open(const char *path, size_t size);
+int up_hostfile_read(int fd, void *buffer, size_t nbytes, size_t offset);
+int up_hostfile_write(int fd, const void *buffer, size_t nbytes, size_t offset);
+int up_hostfile_fill(int fd, uint8_t value, size_t nbytes, size_t offset);
+
+/* up_tapdev.c */
+
+int up_tapdev_init(const char *ifname);
+bool up_tapdev_avail(void);
+int up_tapdev_read(uint8_t *buffer, size_t buflen);
+void up_tapdev_send(const uint8_t *buffer, size_t buflen);
+
+#endif							/* __ASSEMBLY__ */
+
+#endif							/* __ARCH_SIM_SRC_UP_INTERNAL_H */
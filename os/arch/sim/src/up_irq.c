@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_irq.c
+ *
+ * Software interrupt masking and dispatch of the simulated timer
+ * interrupt.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Interrupts stay disabled until up_irqinitialize() */
+
+volatile uint8_t g_irqdisabled = 1;
+volatile uint8_t g_irqpending;
+volatile bool g_ininterrupt;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_irqinitialize
+ ****************************************************************************/
+
+void up_irqinitialize(void)
+{
+#ifndef CONFIG_SUPPRESS_INTERRUPTS
+	irqenable();
+#endif
+}
+
+/****************************************************************************
+ * Name: up_timerinterrupt
+ *
+ * Description:
+ *   Called from the host timer signal handler, on the stack of whichever
+ *   thread was running.  If interrupts are disabled the tick is left
+ *   pending for irqrestore() to pick up.
+ *
+ ****************************************************************************/
+
+void up_timerinterrupt(void)
+{
+	g_irqpending = 1;
+	if (!g_irqdisabled) {
+		up_irqdispatch();
+	}
+}
+
+/****************************************************************************
+ * Name: up_irqdispatch
+ *
+ * Description:
+ *   Process pending interrupts with interrupts disabled, switching to the
+ *   new head of the ready-to-run list when the handlers changed it.  Must
+ *   be entered with interrupts enabled; they are enabled again on return.
+ *
+ ****************************************************************************/
+
+void up_irqdispatch(void)
+{
+	FAR struct tcb_s *rtcb;
+
+	g_irqdisabled = 1;
+	while (g_irqpending) {
+		g_irqpending = 0;
+
+		rtcb = this_task();
+		g_ininterrupt = true;
+		irq_dispatch(SIM_IRQ_TIMER, NULL);
+		g_ininterrupt = false;
+
+		if (this_task() != rtcb) {
+			up_switchcontext(rtcb, this_task());
+		}
+	}
+
+	g_irqdisabled = 0;
+
+	/* Deliver any signal queued for this thread by the handler */
+
+	up_sigdeliver();
+}
+
+/****************************************************************************
+ * Name: up_interrupt_context
+ *
+ * Description:
+ *   Return true if we are currently executing in the interrupt handler
+ *   context.
+ *
+ ****************************************************************************/
+
+bool up_interrupt_context(void)
+{
+	return g_ininterrupt;
+}
+
+/****************************************************************************
+ * Name: up_disable_irq
+ ****************************************************************************/
+
+void up_disable_irq(int irq)
+{
+}
+
+/****************************************************************************
+ * Name: up_enable_irq
+ ****************************************************************************/
+
+void up_enable_irq(int irq)
+{
+}
@@ -0,0 +1,262 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_netdev.c
+ *
+ * lwIP network interface of the simulation on top of a host TAP device.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <net/if.h>
+#include <arpa/inet.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/wqueue.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/netif.h>
+#include <net/lwip/tcpip.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/netif/etharp.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SIM_TAPDEV
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_WORKQUEUE
+#error "CONFIG_SIM_TAPDEV requires CONFIG_SCHED_WORKQUEUE"
+#endif
+
+#define NETDEV_MTU       1500
+#define NETDEV_FRAMESIZE (NETDEV_MTU + 18)	/* Ethernet header, VLAN tag */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct netif g_simnetif;
+static struct work_s g_rxwork;
+
+/* Frames are staged here on their way to and from the host.  Transmit runs
+ * on the tcpip thread and receive on the work queue thread, so each has its
+ * own buffer.
+ */
+
+static uint8_t g_txbuf[NETDEV_FRAMESIZE];
+static uint8_t g_rxbuf[NETDEV_FRAMESIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_linkoutput
+ *
+ * Description:
+ *   lwIP link output hook: flatten the pbuf chain and hand the frame to the
+ *   TAP device.
+ *
+ ****************************************************************************/
+
+static err_t netdev_linkoutput(struct netif *netif, struct pbuf *p)
+{
+	irqstate_t flags;
+	u16_t len;
+
+	if (p->tot_len > NETDEV_FRAMESIZE) {
+		LINK_STATS_INC(link.drop);
+		return ERR_BUF;
+	}
+
+	len = pbuf_copy_partial(p, g_txbuf, p->tot_len, 0);
+
+	flags = irqsave();
+	up_tapdev_send(g_txbuf, len);
+	irqrestore(flags);
+
+	LINK_STATS_INC(link.xmit);
+	return ERR_OK;
+}
+
+/****************************************************************************
+ * Name: netdev_rxworker
+ *
+ * Description:
+ *   Work queue worker: pass every frame waiting on the TAP device to lwIP.
+ *
+ ****************************************************************************/
+
+static void netdev_rxworker(FAR void *arg)
+{
+	struct netif *netif = (struct netif *)arg;
+	struct pbuf *p;
+	irqstate_t flags;
+	int len;
+
+	for (;;) {
+		flags = irqsave();
+		len = up_tapdev_read(g_rxbuf, sizeof(g_rxbuf));
+		irqrestore(flags);
+
+		if (len <= 0) {
+			break;
+		}
+
+		p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+		if (p == NULL) {
+			LINK_STATS_INC(link.memerr);
+			LINK_STATS_INC(link.drop);
+			continue;
+		}
+
+		pbuf_take(p, g_rxbuf, len);
+		if (netif->input(p, netif) != ERR_OK) {
+			LINK_STATS_INC(link.err);
+			pbuf_free(p);
+			continue;
+		}
+
+		LINK_STATS_INC(link.recv);
+	}
+}
+
+/****************************************************************************
+ * Name: netdev_init
+ *
+ * Description:
+ *   netif_add() initialization callback.
+ *
+ ****************************************************************************/
+
+static err_t netdev_init(struct netif *netif)
+{
+	netif->name[0] = 'e';
+	netif->name[1] = 'n';
+
+	snprintf(netif->d_ifname, IFNAMSIZ, "en%d", netif->num);
+
+	/* Locally administered address; the host side of the TAP has its own */
+
+	netif->hwaddr_len = IFHWADDRLEN;
+	netif->hwaddr[0] = 0x02;
+	netif->hwaddr[1] = 0x00;
+	netif->hwaddr[2] = 0x54;
+	netif->hwaddr[3] = 0x41;
+	netif->hwaddr[4] = 0x52;
+	netif->hwaddr[5] = 0x41;
+	memcpy(netif->d_mac.ether_addr_octet, netif->hwaddr, IFHWADDRLEN);
+
+	netif->output = etharp_output;
+	netif->linkoutput = netdev_linkoutput;
+	netif->mtu = NETDEV_MTU;
+	netif->flags = NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET | NETIF_FLAG_BROADCAST | NETIF_FLAG_IGMP | NETIF_FLAG_LINK_UP;
+
+	return ERR_OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_netinitialize
+ *
+ * Description:
+ *   Attach to the host TAP device and register it with lwIP as the default
+ *   interface.
+ *
+ ****************************************************************************/
+
+void up_netinitialize(void)
+{
+	ip_addr_t ipaddr;
+	ip_addr_t netmask;
+	ip_addr_t gw;
+	irqstate_t flags;
+	int ret;
+
+	flags = irqsave();
+	ret = up_tapdev_init(CONFIG_SIM_TAPDEV_NAME);
+	irqrestore(flags);
+
+	if (ret < 0) {
+		lldbg("ERROR: Failed to open TAP device %s: %d\n", CONFIG_SIM_TAPDEV_NAME, ret);
+		return;
+	}
+
+	ipaddr.addr = htonl(CONFIG_SIM_NET_IPADDR);
+	netmask.addr = htonl(CONFIG_SIM_NET_NETMASK);
+	gw.addr = htonl(CONFIG_SIM_NET_DRIPADDR);
+
+	if (netif_add(&g_simnetif, &ipaddr, &netmask, &gw, NULL, netdev_init, tcpip_input) == NULL) {
+		lldbg("ERROR: netif_add failed\n");
+		return;
+	}
+
+	g_simnetif.d_ipaddr = ipaddr.addr;
+	g_simnetif.d_netmask = netmask.addr;
+	g_simnetif.d_draddr = gw.addr;
+
+	netif_set_default(&g_simnetif);
+	netif_set_up(&g_simnetif);
+}
+
+/****************************************************************************
+ * Name: up_netdev_poll
+ *
+ * Description:
+ *   Called from the IDLE loop.  Hand received frames to the low priority
+ *   work queue; lwIP may block, which the IDLE thread must never do.
+ *
+ ****************************************************************************/
+
+void up_netdev_poll(void)
+{
+	irqstate_t flags;
+	bool avail;
+
+	if (!work_available(&g_rxwork)) {
+		return;
+	}
+
+	flags = irqsave();
+	avail = up_tapdev_avail();
+	irqrestore(flags);
+
+	if (avail) {
+		work_queue(LPWORK, &g_rxwork, netdev_rxworker, &g_simnetif, 0);
+	}
+}
+
+#endif							/* CONFIG_SIM_TAPDEV */
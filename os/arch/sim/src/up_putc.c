@@ -0,0 +1,72 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_putc.c
+ *
+ * Low-level console output of the simulation.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <tinyara/arch.h>
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_putc
+ *
+ * Description:
+ *   Output one character on the console
+ *
+ ****************************************************************************/
+
+int up_putc(int ch)
+{
+	char c = (char)ch;
+	irqstate_t flags;
+
+	flags = irqsave();
+	up_hostconsole_write(&c, 1);
+	irqrestore(flags);
+
+	return ch;
+}
+
+/****************************************************************************
+ * Name: up_puts
+ *
+ * Description:
+ *   Output a string on the console
+ *
+ ****************************************************************************/
+
+void up_puts(FAR const char *str)
+{
+	while (*str) {
+		up_putc(*str++);
+	}
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_schedulesigaction.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <sched.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+
+#ifndef CONFIG_DISABLE_SIGNALS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_schedule_sigaction
+ *
+ * Description:
+ *   This function is called by the OS when one or more
+ *   signal handling actions have been queued for execution.
+ *   The architecture specific code must configure things so
+ *   that the 'sigdeliver' callback is executed on the thread
+ *   specified by 'tcb' as soon as possible.
+ *
+ *   If the thread is running and we are not in the timer interrupt, the
+ *   signal is delivered immediately.  Otherwise the callback is recorded
+ *   and run by up_sigdeliver() when the thread is next resumed or when
+ *   the interrupt completes.
+ *
+ ****************************************************************************/
+
+void up_schedule_sigaction(struct tcb_s *tcb, sig_deliver_t sigdeliver)
+{
+	/* Refuse to handle nested signal actions */
+
+	svdbg("tcb=0x%p sigdeliver=0x%p\n", tcb, sigdeliver);
+
+	if (!tcb->xcp.sigdeliver) {
+		irqstate_t flags;
+
+		/* Make sure that interrupts are disabled */
+
+		flags = irqsave();
+
+		if (tcb == this_task() && !up_interrupt_context()) {
+			/* In this case just deliver the signal now. */
+
+			sigdeliver(tcb);
+		} else {
+			tcb->xcp.sigdeliver = sigdeliver;
+		}
+
+		irqrestore(flags);
+	}
+}
+
+#endif							/* !CONFIG_DISABLE_SIGNALS */
@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_stackframe.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <sched.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <arch/irq.h>
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_stack_frame
+ *
+ * Description:
+ *   Allocate a stack frame in the TCB's stack to hold thread-specific data.
+ *   This function may be called anytime after up_create_stack() or
+ *   up_use_stack() have been called but before the task has been started.
+ *
+ * Input Parameters:
+ *   - tcb:  The TCB of new task
+ *   - frame_size:  The size of the stack frame to allocate.
+ *
+ *  Returned Value:
+ *   - A pointer to bottom of the allocated stack frame.  NULL will be
+ *     returned on any failures.
+ *
+ ****************************************************************************/
+
+FAR void *up_stack_frame(FAR struct tcb_s *tcb, size_t frame_size)
+{
+	uintptr_t topaddr;
+
+	/* Align the frame_size */
+
+	frame_size = STACK_ALIGN_UP(frame_size);
+
+	/* Is there already a stack allocated? Is it big enough? */
+
+	if (!tcb->stack_alloc_ptr || tcb->adj_stack_size <= frame_size) {
+		return NULL;
+	}
+
+	/* Save the adjusted stack values in the struct tcb_s */
+
+	topaddr = (uintptr_t)tcb->adj_stack_ptr - frame_size;
+	tcb->adj_stack_ptr = (FAR void *)topaddr;
+	tcb->adj_stack_size -= frame_size;
+
+	/* Reset the initial stack pointer */
+
+	tcb->xcp.regs[JB_SP] = (xcpt_reg_t)topaddr - sizeof(xcpt_reg_t);
+
+	/* And return the pointer to the allocated region */
+
+	return (FAR void *)(topaddr + sizeof(uint32_t));
+}
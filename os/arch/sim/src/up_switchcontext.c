@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_switchcontext.c
+ *
+ * Context switch and deferred signal delivery for the simulation.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sched.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+
+#include "sched/sched.h"
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_switchcontext
+ *
+ * Description:
+ *   Save the context of rtcb and resume nexttcb.  Returns when rtcb is
+ *   next resumed.
+ *
+ *   Interrupts are always disabled when a context is resumed; each resume
+ *   path restores the interrupt state of the thread it returns to.  Here
+ *   that is the state saved on entry, for the timer path it is done by
+ *   up_irqdispatch() and for a new thread by up_start().
+ *
+ ****************************************************************************/
+
+void up_switchcontext(FAR struct tcb_s *rtcb, FAR struct tcb_s *nexttcb)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	if (up_setjmp(rtcb->xcp.regs) == 0) {
+		up_longjmp(nexttcb->xcp.regs, 1);
+	}
+
+	/* We get here when rtcb is again at the head of the ready-to-run list */
+
+	irqrestore(flags);
+	up_sigdeliver();
+}
+
+/****************************************************************************
+ * Name: up_sigdeliver
+ *
+ * Description:
+ *   Run the signal delivery that up_schedule_sigaction() could not perform
+ *   immediately because the target thread was not running.
+ *
+ ****************************************************************************/
+
+void up_sigdeliver(void)
+{
+#ifndef CONFIG_DISABLE_SIGNALS
+	struct tcb_s *rtcb = this_task();
+	sig_deliver_t sigdeliver;
+	int saved_errno;
+
+	sigdeliver = (sig_deliver_t)rtcb->xcp.sigdeliver;
+	if (sigdeliver) {
+		svdbg("rtcb=%p sigdeliver=%p\n", rtcb, sigdeliver);
+
+		/* Save the errno so that the signal handler cannot corrupt it */
+
+		saved_errno = rtcb->pterrno;
+		rtcb->xcp.sigdeliver = NULL;
+
+		sigdeliver(rtcb);
+
+		rtcb->pterrno = saved_errno;
+	}
+#endif
+}
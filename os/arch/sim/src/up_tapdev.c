@@ -0,0 +1,153 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_tapdev.c
+ *
+ * Host side of the simulation network device: a Linux TAP interface.  This
+ * file is compiled against the host C library.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <linux/if.h>
+#include <linux/if_tun.h>
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+void up_hostidle_watchfd(int fd);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_tapfd = -1;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_tapdev_init
+ *
+ * Description:
+ *   Attach to the (already configured) TAP interface ifname.  The interface
+ *   is normally created beforehand with "ip tuntap add" so that the
+ *   simulation does not need to run as root.
+ *
+ ****************************************************************************/
+
+int up_tapdev_init(const char *ifname)
+{
+	struct ifreq ifr;
+	int ret;
+
+	g_tapfd = open("/dev/net/tun", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	if (g_tapfd < 0) {
+		return -errno;
+	}
+
+	memset(&ifr, 0, sizeof(ifr));
+	ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+	strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+
+	if (ioctl(g_tapfd, TUNSETIFF, &ifr) < 0) {
+		ret = -errno;
+		close(g_tapfd);
+		g_tapfd = -1;
+		return ret;
+	}
+
+	up_hostidle_watchfd(g_tapfd);
+	return 0;
+}
+
+/****************************************************************************
+ * Name: up_tapdev_avail
+ *
+ * Description:
+ *   Return true if a frame is waiting to be read.
+ *
+ ****************************************************************************/
+
+bool up_tapdev_avail(void)
+{
+	struct timeval tv;
+	fd_set rfds;
+
+	if (g_tapfd < 0) {
+		return false;
+	}
+
+	FD_ZERO(&rfds);
+	FD_SET(g_tapfd, &rfds);
+	tv.tv_sec = 0;
+	tv.tv_usec = 0;
+
+	return select(g_tapfd + 1, &rfds, NULL, NULL, &tv) > 0;
+}
+
+/****************************************************************************
+ * Name: up_tapdev_read
+ *
+ * Description:
+ *   Read one frame without blocking.  Returns its length, 0 if there is
+ *   none or a negated errno.
+ *
+ ****************************************************************************/
+
+int up_tapdev_read(uint8_t *buffer, size_t buflen)
+{
+	ssize_t ret;
+
+	do {
+		ret = read(g_tapfd, buffer, buflen);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 0) {
+		return errno == EAGAIN ? 0 : -errno;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: up_tapdev_send
+ ****************************************************************************/
+
+void up_tapdev_send(const uint8_t *buffer, size_t buflen)
+{
+	ssize_t ret;
+
+	do {
+		ret = write(g_tapfd, buffer, buflen);
+	} while (ret < 0 && errno == EINTR);
+}
@@ -0,0 +1,87 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * arch/sim/src/up_usestack.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <sched.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+
+#include "up_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_use_stack
+ *
+ * Description:
+ *   Setup up stack-related information in the TCB using pre-allocated
+ *   stack memory.
+ *
+ * Input Parameters:
+ *   - tcb: The TCB of new task
+ *   - stack_size:  The allocated stack size.
+ *
+ ****************************************************************************/
+
+int up_use_stack(struct tcb_s *tcb, void *stack, size_t stack_size)
+{
+	uintptr_t top_of_stack;
+
+	/* Is there already a different stack allocated? */
+
+	if (tcb->stack_alloc_ptr && tcb->stack_alloc_ptr != stack) {
+		/* Yes... Release the old stack allocation */
+
+		up_release_stack(tcb, tcb->flags & TCB_FLAG_TTYPE_MASK);
+	}
+
+	/* Save the new stack allocation */
+
+	tcb->stack_alloc_ptr = stack;
+
+	/* The i386 stack grows toward lower addresses.  The top of the stack is
+	 * the highest word, rounded down to the ABI alignment.
+	 */
+
+	top_of_stack = STACK_ALIGN_DOWN((uintptr_t)stack + stack_size - sizeof(uint32_t));
+
+	/* Save the adjusted stack values in the struct tcb_s */
+
+	tcb->adj_stack_ptr = (FAR void *)top_of_stack;
+	tcb->adj_stack_size = top_of_stack - (uintptr_t)stack + sizeof(uint32_t);
+
+#ifdef CONFIG_STACK_COLORATION
+	up_stack_color(stack, tcb->adj_stack_size);
+#endif
+
+	return OK;
+}
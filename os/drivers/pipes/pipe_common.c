@@ -63,6 +63,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <sched.h>
 #include <semaphore.h>
 #include <fcntl.h>
@@ -105,6 +106,7 @@
  ****************************************************************************/
 
 static void pipecommon_semtake(sem_t *sem);
+static int pipecommon_setsize(FAR struct pipe_dev_s *dev, size_t size);
 
 /****************************************************************************
  * Private Data
@@ -153,6 +155,85 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev, pollevent_t events
 #define pipecommon_pollnotify(dev, event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on one of the read/write wait semaphores.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+	int sval;
+
+	while (sem_getvalue(sem, &sval) == 0 && sval < 0) {
+		sem_post(sem);
+	}
+}
+
+/****************************************************************************
+ * Name: pipecommon_setsize
+ *
+ * Description:
+ *   Change the size of the ringbuffer.  If the buffer is already allocated,
+ *   it is replaced by a buffer of the new size holding the same data.  The
+ *   caller holds d_bfsem.
+ *
+ ****************************************************************************/
+
+static int pipecommon_setsize(FAR struct pipe_dev_s *dev, size_t size)
+{
+	FAR uint8_t *buffer;
+	size_t nbytes;
+	size_t n;
+
+	/* One byte of the buffer is always unused; two is the smallest size that
+	 * can hold any data.
+	 */
+
+	if (size < 2 || size > CONFIG_DEV_PIPE_MAXSIZE) {
+		return -EINVAL;
+	}
+
+	if (dev->d_buffer == NULL) {
+		/* The buffer will be allocated with the new size on the next open */
+
+		dev->d_bufsize = (pipe_ndx_t)size;
+		return OK;
+	}
+
+	nbytes = PIPE_NBYTES(dev);
+	if (nbytes >= size) {
+		return -EBUSY;
+	}
+
+	buffer = (FAR uint8_t *)kmm_malloc(size);
+	if (buffer == NULL) {
+		return -ENOMEM;
+	}
+
+	/* Move the buffered data to the beginning of the new buffer */
+
+	n = PIPE_RDSEGMENT(dev);
+	memcpy(buffer, &dev->d_buffer[dev->d_rdndx], n);
+	if (n < nbytes) {
+		memcpy(&buffer[n], dev->d_buffer, nbytes - n);
+	}
+
+	kmm_free(dev->d_buffer);
+	dev->d_buffer = buffer;
+	dev->d_bufsize = (pipe_ndx_t)size;
+	dev->d_rdndx = 0;
+	dev->d_wrndx = (pipe_ndx_t)nbytes;
+
+	/* There may be more room for writers now */
+
+	pipecommon_wakeup(&dev->d_wrsem);
+	pipecommon_pollnotify(dev, POLLOUT);
+	return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -172,6 +253,7 @@ FAR struct pipe_dev_s *pipecommon_allocdev(void)
 		/* Initialize the private structure */
 
 		memset(dev, 0, sizeof(struct pipe_dev_s));
+		dev->d_bufsize = CONFIG_DEV_PIPE_SIZE;
 		sem_init(&dev->d_bfsem, 0, 1);
 		sem_init(&dev->d_rdsem, 0, 0);
 		sem_init(&dev->d_wrsem, 0, 0);
@@ -229,7 +311,7 @@ int pipecommon_open(FAR struct file *filep)
 	 */
 
 	if (dev->d_refs == 0 && dev->d_buffer == NULL) {
-		dev->d_buffer = (uint8_t *)kmm_malloc(CONFIG_DEV_PIPE_SIZE);
+		dev->d_buffer = (uint8_t *)kmm_malloc(dev->d_bufsize);
 		if (!dev->d_buffer) {
 			(void)sem_post(&dev->d_bfsem);
 			return -ENOMEM;
@@ -385,7 +467,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 	FAR uint8_t *start = (uint8_t *)buffer;
 #endif
 	ssize_t nread = 0;
-	int sval;
+	size_t n;
 	int ret;
 
 	DEBUGASSERT(dev);
@@ -429,22 +511,31 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 		}
 	}
 
-	/* Then return whatever is available in the pipe (which is at least one byte) */
+	/* Then return whatever is available in the pipe (which is at least one
+	 * byte).  The data wraps around the end of the buffer at most once, so
+	 * this takes one or two copies.
+	 */
 
 	nread = 0;
 	while (nread < len && dev->d_wrndx != dev->d_rdndx) {
-		*buffer++ = dev->d_buffer[dev->d_rdndx];
-		if (++dev->d_rdndx >= CONFIG_DEV_PIPE_SIZE) {
+		n = PIPE_RDSEGMENT(dev);
+		if (n > len - nread) {
+			n = len - nread;
+		}
+
+		memcpy(buffer, &dev->d_buffer[dev->d_rdndx], n);
+		buffer += n;
+		nread += n;
+
+		dev->d_rdndx += n;
+		if (dev->d_rdndx >= dev->d_bufsize) {
 			dev->d_rdndx = 0;
 		}
-		nread++;
 	}
 
 	/* Notify all waiting writers that bytes have been removed from the buffer */
 
-	while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0) {
-		sem_post(&dev->d_wrsem);
-	}
+	pipecommon_wakeup(&dev->d_wrsem);
 
 	/* Notify all poll/select waiters that they can write to the FIFO */
 
@@ -464,9 +555,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
 	ssize_t nwritten = 0;
-	ssize_t last;
-	int nxtwrndx;
-	int sval;
+	size_t n;
 
 	DEBUGASSERT(dev);
 	pipe_dumpbuffer("To PIPE:", (uint8_t *)buffer, len);
@@ -496,71 +585,71 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 
 	/* Loop until all of the bytes have been written */
 
-	last = 0;
 	for (;;) {
-		/* Calculate the write index AFTER the next byte is written */
-
-		nxtwrndx = dev->d_wrndx + 1;
-		if (nxtwrndx >= CONFIG_DEV_PIPE_SIZE) {
-			nxtwrndx = 0;
-		}
-
-		/* Would the next write overflow the circular buffer? */
+		/* Copy as much as fits into the free space of the buffer.  The free
+		 * space wraps around the end of the buffer at most once, so this
+		 * takes one or two copies.
+		 */
 
-		if (nxtwrndx != dev->d_rdndx) {
-			/* No... copy the byte */
+		while (nwritten < len) {
+			n = PIPE_WRSEGMENT(dev);
+			if (n == 0) {
+				break;
+			}
 
-			dev->d_buffer[dev->d_wrndx] = *buffer++;
-			dev->d_wrndx = nxtwrndx;
+			if (n > len - nwritten) {
+				n = len - nwritten;
+			}
 
-			/* Is the write complete? */
+			memcpy(&dev->d_buffer[dev->d_wrndx], buffer, n);
+			buffer += n;
+			nwritten += n;
 
-			if (++nwritten >= len) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
+			dev->d_wrndx += n;
+			if (dev->d_wrndx >= dev->d_bufsize) {
+				dev->d_wrndx = 0;
+			}
+		}
 
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
+		/* Notify all of the waiting readers that more data is available */
 
-				/* Notify all poll/select waiters that they can write to the FIFO */
+		pipecommon_wakeup(&dev->d_rdsem);
 
-				pipecommon_pollnotify(dev, POLLIN);
+		/* Is the write complete? */
 
-				/* Return the number of bytes written */
+		if (nwritten >= len) {
+			/* Notify all poll/select waiters that they can read from the FIFO */
 
-				sem_post(&dev->d_bfsem);
-				return len;
-			}
-		} else {
-			/* There is not enough room for the next byte. Was anything written in this pass? */
+			pipecommon_pollnotify(dev, POLLIN);
 
-			if (last < nwritten) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
+			/* Return the number of bytes written */
 
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
-			}
-			last = nwritten;
+			sem_post(&dev->d_bfsem);
+			return len;
+		}
 
-			/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+		/* There is not enough room for the rest.  If O_NONBLOCK was set,
+		 * then return partial bytes written or EGAIN
+		 */
 
-			if (filep->f_oflags & O_NONBLOCK) {
-				if (nwritten == 0) {
-					nwritten = -EAGAIN;
-				}
-				sem_post(&dev->d_bfsem);
-				return nwritten;
+		if (filep->f_oflags & O_NONBLOCK) {
+			if (nwritten == 0) {
+				nwritten = -EAGAIN;
+			} else {
+				pipecommon_pollnotify(dev, POLLIN);
 			}
 
-			/* There is more to be written.. wait for data to be removed from the pipe */
-
-			sched_lock();
 			sem_post(&dev->d_bfsem);
-			pipecommon_semtake(&dev->d_wrsem);
-			sched_unlock();
-			pipecommon_semtake(&dev->d_bfsem);
+			return nwritten;
 		}
+
+		/* There is more to be written.. wait for data to be removed from the pipe */
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		pipecommon_semtake(&dev->d_wrsem);
+		sched_unlock();
+		pipecommon_semtake(&dev->d_bfsem);
 	}
 }
 
@@ -610,16 +699,12 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 		 * First, determine how many bytes are in the buffer
 		 */
 
-		if (dev->d_wrndx >= dev->d_rdndx) {
-			nbytes = dev->d_wrndx - dev->d_rdndx;
-		} else {
-			nbytes = (CONFIG_DEV_PIPE_SIZE - 1) + dev->d_wrndx - dev->d_rdndx;
-		}
+		nbytes = PIPE_NBYTES(dev);
 
 		/* Notify the POLLOUT event if the pipe is not full */
 
 		eventset = 0;
-		if (nbytes < (CONFIG_DEV_PIPE_SIZE - 1)) {
+		if (nbytes < dev->d_bufsize - 1) {
 			eventset |= POLLOUT;
 		}
 
@@ -664,10 +749,10 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct pipe_dev_s *dev = inode->i_private;
+	int ret;
 
-	/* Only one command supported */
-
-	if (cmd == PIPEIOC_POLICY) {
+	switch (cmd) {
+	case PIPEIOC_POLICY:
 		if (arg != 0) {
 			PIPE_POLICY_1(dev->d_flags);
 		} else {
@@ -675,11 +760,268 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		}
 
 		return OK;
+
+	case PIPEIOC_SETSIZE:
+		ret = sem_wait(&dev->d_bfsem);
+		if (ret != OK) {
+			return -get_errno();
+		}
+
+		ret = pipecommon_setsize(dev, (size_t)arg);
+		if (ret == OK) {
+			ret = dev->d_bufsize;
+		}
+
+		sem_post(&dev->d_bfsem);
+		return ret;
+
+	case PIPEIOC_GETSIZE:
+		return dev->d_bufsize;
+
+	default:
+		break;
 	}
 
 	return -ENOTTY;
 }
 
+/****************************************************************************
+ * Name: pipecommon_splicefrom
+ *
+ * Description:
+ *   Move up to 'len' bytes from the pipe to the file or socket descriptor
+ *   'fd' by writing directly out of the ringbuffer.  Like pipecommon_read(),
+ *   this waits until the pipe holds some data and then moves whatever is
+ *   available.  If 'offset' is not NULL, the data is written at that offset
+ *   of 'fd' and the offset is advanced; the file position of 'fd' is left
+ *   unchanged.
+ *
+ *   The pipe stays locked while 'fd' is written, so other users of the pipe
+ *   are held off until the transfer completes.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end-of-file, or a negated errno.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+ssize_t pipecommon_splicefrom(FAR struct file *filep, int fd, FAR off_t *offset, size_t len, bool nonblock)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct pipe_dev_s *dev = inode->i_private;
+	ssize_t nmoved = 0;
+	ssize_t ret;
+	size_t n;
+
+	DEBUGASSERT(dev);
+
+	if ((filep->f_oflags & O_RDOK) == 0) {
+		return -EBADF;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if ((filep->f_oflags & O_NONBLOCK) != 0) {
+		nonblock = true;
+	}
+
+	if (sem_wait(&dev->d_bfsem) < 0) {
+		return -get_errno();
+	}
+
+	/* If the pipe is empty, then wait for something to be written to it */
+
+	while (dev->d_wrndx == dev->d_rdndx) {
+		if (nonblock) {
+			sem_post(&dev->d_bfsem);
+			return -EAGAIN;
+		}
+
+		/* If there are no writers on the pipe, then return end of file */
+
+		if (dev->d_nwriters <= 0) {
+			sem_post(&dev->d_bfsem);
+			return 0;
+		}
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		ret = sem_wait(&dev->d_rdsem);
+		sched_unlock();
+
+		if (ret < 0 || sem_wait(&dev->d_bfsem) < 0) {
+			return -get_errno();
+		}
+	}
+
+	/* Write the buffered data out in at most two segments */
+
+	while ((size_t)nmoved < len && dev->d_wrndx != dev->d_rdndx) {
+		n = PIPE_RDSEGMENT(dev);
+		if (n > len - nmoved) {
+			n = len - nmoved;
+		}
+
+		if (offset) {
+			ret = pwrite(fd, &dev->d_buffer[dev->d_rdndx], n, *offset);
+		} else {
+			ret = write(fd, &dev->d_buffer[dev->d_rdndx], n);
+		}
+
+		if (ret < 0) {
+			if (nmoved == 0) {
+				nmoved = -get_errno();
+			}
+
+			break;
+		}
+
+		if (offset) {
+			*offset += ret;
+		}
+
+		nmoved += ret;
+		dev->d_rdndx += ret;
+		if (dev->d_rdndx >= dev->d_bufsize) {
+			dev->d_rdndx = 0;
+		}
+
+		/* Stop on a short write */
+
+		if ((size_t)ret < n) {
+			break;
+		}
+	}
+
+	if (nmoved > 0) {
+		pipecommon_wakeup(&dev->d_wrsem);
+		pipecommon_pollnotify(dev, POLLOUT);
+	}
+
+	sem_post(&dev->d_bfsem);
+	return nmoved;
+}
+#endif
+
+/****************************************************************************
+ * Name: pipecommon_spliceto
+ *
+ * Description:
+ *   Move up to 'len' bytes from the file or socket descriptor 'fd' to the
+ *   pipe by reading directly into the ringbuffer.  This waits until the pipe
+ *   has free space and then fills as much of it as 'fd' provides.  If
+ *   'offset' is not NULL, the data is read from that offset of 'fd' and the
+ *   offset is advanced; the file position of 'fd' is left unchanged.
+ *
+ *   The pipe stays locked while 'fd' is read, so other users of the pipe
+ *   are held off until the transfer completes.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end-of-file of 'fd', or a negated
+ *   errno.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_SPLICE
+ssize_t pipecommon_spliceto(FAR struct file *filep, int fd, FAR off_t *offset, size_t len, bool nonblock)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct pipe_dev_s *dev = inode->i_private;
+	ssize_t nmoved = 0;
+	ssize_t ret;
+	size_t n;
+
+	DEBUGASSERT(dev);
+
+	if ((filep->f_oflags & O_WROK) == 0) {
+		return -EBADF;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if ((filep->f_oflags & O_NONBLOCK) != 0) {
+		nonblock = true;
+	}
+
+	if (sem_wait(&dev->d_bfsem) < 0) {
+		return -get_errno();
+	}
+
+	/* If the pipe is full, then wait for data to be removed from it */
+
+	while (PIPE_WRSEGMENT(dev) == 0) {
+		if (nonblock) {
+			sem_post(&dev->d_bfsem);
+			return -EAGAIN;
+		}
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		ret = sem_wait(&dev->d_wrsem);
+		sched_unlock();
+
+		if (ret < 0 || sem_wait(&dev->d_bfsem) < 0) {
+			return -get_errno();
+		}
+	}
+
+	/* Read into the free space in at most two segments */
+
+	while ((size_t)nmoved < len) {
+		n = PIPE_WRSEGMENT(dev);
+		if (n == 0) {
+			break;
+		}
+
+		if (n > len - nmoved) {
+			n = len - nmoved;
+		}
+
+		if (offset) {
+			ret = pread(fd, &dev->d_buffer[dev->d_wrndx], n, *offset);
+		} else {
+			ret = read(fd, &dev->d_buffer[dev->d_wrndx], n);
+		}
+
+		if (ret < 0) {
+			if (nmoved == 0) {
+				nmoved = -get_errno();
+			}
+
+			break;
+		}
+
+		if (offset) {
+			*offset += ret;
+		}
+
+		nmoved += ret;
+		dev->d_wrndx += ret;
+		if (dev->d_wrndx >= dev->d_bufsize) {
+			dev->d_wrndx = 0;
+		}
+
+		/* Stop at end-of-file or on a short read */
+
+		if ((size_t)ret < n) {
+			break;
+		}
+	}
+
+	if (nmoved > 0) {
+		pipecommon_wakeup(&dev->d_rdsem);
+		pipecommon_pollnotify(dev, POLLIN);
+	}
+
+	sem_post(&dev->d_bfsem);
+	return nmoved;
+}
+#endif
+
 /****************************************************************************
  * Name: pipecommon_unlink
  ****************************************************************************/
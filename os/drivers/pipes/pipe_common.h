@@ -68,6 +68,11 @@
 #define CONFIG_DEV_PIPE_SIZE 1024
 #endif
 
+#if !defined(CONFIG_DEV_PIPE_MAXSIZE) || CONFIG_DEV_PIPE_MAXSIZE < CONFIG_DEV_PIPE_SIZE
+#undef  CONFIG_DEV_PIPE_MAXSIZE
+#define CONFIG_DEV_PIPE_MAXSIZE CONFIG_DEV_PIPE_SIZE
+#endif
+
 #if CONFIG_DEV_PIPE_SIZE > 0
 
 /****************************************************************************
@@ -97,15 +102,37 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+/* Number of bytes held in the buffer.  One slot is always left free so
+ * that a full buffer can be told from an empty one.
+ */
+
+#define PIPE_NBYTES(d) \
+	((d)->d_wrndx >= (d)->d_rdndx ? (d)->d_wrndx - (d)->d_rdndx : \
+	 (d)->d_bufsize + (d)->d_wrndx - (d)->d_rdndx)
+
+/* Size of the contiguous data following d_rdndx and of the contiguous free
+ * space following d_wrndx.  Either side of the ringbuffer spans at most two
+ * such segments.
+ */
+
+#define PIPE_RDSEGMENT(d) \
+	((d)->d_wrndx >= (d)->d_rdndx ? (d)->d_wrndx - (d)->d_rdndx : \
+	 (d)->d_bufsize - (d)->d_rdndx)
+
+#define PIPE_WRSEGMENT(d) \
+	((d)->d_wrndx >= (d)->d_rdndx ? \
+	 (d)->d_bufsize - (d)->d_wrndx - ((d)->d_rdndx == 0 ? 1 : 0) : \
+	 (d)->d_rdndx - (d)->d_wrndx - 1)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
-/* Make the buffer index as small as possible for the configured pipe size */
+/* Make the buffer index as small as possible for the largest pipe size */
 
-#if CONFIG_DEV_PIPE_SIZE > 65535
+#if CONFIG_DEV_PIPE_MAXSIZE > 65535
 typedef uint32_t pipe_ndx_t;	/* 32-bit index */
-#elif CONFIG_DEV_PIPE_SIZE > 255
+#elif CONFIG_DEV_PIPE_MAXSIZE > 255
 typedef uint16_t pipe_ndx_t;	/* 16-bit index */
 #else
 typedef uint8_t pipe_ndx_t;		/*  8-bit index */
@@ -122,6 +149,7 @@ struct pipe_dev_s {
 	sem_t d_wrsem;				/* Full buffer - Writer waits for data read */
 	pipe_ndx_t d_wrndx;			/* Index in d_buffer to save next byte written */
 	pipe_ndx_t d_rdndx;			/* Index in d_buffer to return the next byte read */
+	pipe_ndx_t d_bufsize;		/* Size of d_buffer in bytes */
 	uint8_t d_refs;				/* References counts on pipe (limited to 255) */
 	uint8_t d_nwriters;			/* Number of reference counts for write access */
 	uint8_t d_pipeno;			/* Pipe minor number */
@@ -163,6 +191,10 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 #endif
 int pipecommon_unlink(FAR struct inode *priv);
+#ifdef CONFIG_DEV_PIPE_SPLICE
+ssize_t pipecommon_splicefrom(FAR struct file *filep, int fd, FAR off_t *offset, size_t len, bool nonblock);
+ssize_t pipecommon_spliceto(FAR struct file *filep, int fd, FAR off_t *offset, size_t len, bool nonblock);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ *   splice(): move data between a pipe or FIFO and another descriptor
+ *   without copying it through a user buffer.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <tinyara/cancelpt.h>
+#include <tinyara/fs/fs.h>
+
+#include "pipe_common.h"
+
+#if CONFIG_DEV_PIPE_SIZE > 0 && defined(CONFIG_DEV_PIPE_SPLICE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_getpipe
+ *
+ * Description:
+ *   Return the open file of 'fd' in 'pipep' if 'fd' refers to a pipe or a
+ *   FIFO, or NULL otherwise.  All pipes and FIFOs are served by
+ *   pipecommon_read(), which is how they are recognized.  Socket
+ *   descriptors are never pipes.
+ *
+ ****************************************************************************/
+
+static int splice_getpipe(int fd, FAR struct file **pipep)
+{
+	FAR struct file *filep;
+	FAR struct inode *inode;
+
+	*pipep = NULL;
+	if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS) {
+		return OK;
+	}
+
+	filep = fs_getfilep(fd);
+	if (filep == NULL || filep->f_inode == NULL) {
+		return -EBADF;
+	}
+
+	inode = filep->f_inode;
+	if (inode->u.i_ops != NULL && inode->u.i_ops->read == pipecommon_read) {
+		*pipep = filep;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   Move up to 'len' bytes between two descriptors, one of which must be a
+ *   pipe or a FIFO.  The other one may be a file, a character driver or a
+ *   socket.  The data is read into or written out of the ringbuffer of the
+ *   pipe directly, so unlike read() followed by write() it is copied only
+ *   once.
+ *
+ *   Like a read() of a pipe, splice() from a pipe waits until data is
+ *   available and then moves what is there.  splice() to a pipe waits until
+ *   the pipe has free space and fills as much of it as 'fd_in' provides.
+ *
+ *   This is similar to the Linux interface.  Moving data from one pipe to
+ *   another is not supported.
+ *
+ * Input Parameters:
+ *   fd_in   - Descriptor to read from
+ *   off_in  - If not NULL and 'fd_in' is not the pipe, the offset to read
+ *             'fd_in' at.  It is advanced by the number of bytes moved and
+ *             the file position of 'fd_in' is not changed.
+ *   fd_out  - Descriptor to write to
+ *   off_out - The same for 'fd_out'
+ *   len     - Maximum number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK makes the operations on the pipe
+ *             non-blocking.  SPLICE_F_MOVE and SPLICE_F_MORE are accepted
+ *             and ignored.
+ *
+ * Returned Value:
+ *   The number of bytes moved, or zero if the pipe has no writers left or
+ *   'fd_in' is at end-of-file.  On failure, -1 is returned with errno set:
+ *
+ *   EBADF  - A descriptor is not valid or not open in the right mode.
+ *   EINVAL - Neither or both descriptors refer to a pipe.
+ *   ESPIPE - An offset was given for the pipe.
+ *   EAGAIN - SPLICE_F_NONBLOCK or O_NONBLOCK was set and the pipe is empty
+ *            (or full).
+ *
+ *   Errors of read() or write() on the other descriptor are also reported.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out, size_t len, unsigned int flags)
+{
+	FAR struct file *inpipe;
+	FAR struct file *outpipe;
+	bool nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+	ssize_t ret;
+
+	/* splice() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	ret = splice_getpipe(fd_in, &inpipe);
+	if (ret == OK) {
+		ret = splice_getpipe(fd_out, &outpipe);
+	}
+
+	if (ret < 0) {
+		goto errout;
+	}
+
+	if (inpipe != NULL && outpipe == NULL) {
+		ret = off_in ? -ESPIPE : pipecommon_splicefrom(inpipe, fd_out, off_out, len, nonblock);
+	} else if (outpipe != NULL && inpipe == NULL) {
+		ret = off_out ? -ESPIPE : pipecommon_spliceto(outpipe, fd_in, off_in, len, nonblock);
+	} else {
+		ret = -EINVAL;
+	}
+
+	if (ret < 0) {
+		goto errout;
+	}
+
+	leave_cancellation_point();
+	return ret;
+
+errout:
+	set_errno(-ret);
+	leave_cancellation_point();
+	return ERROR;
+}
+
+#endif							/* CONFIG_DEV_PIPE_SIZE > 0 && CONFIG_DEV_PIPE_SPLICE */
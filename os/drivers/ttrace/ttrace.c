@@ -40,6 +40,7 @@
 #include <tinyara/kmalloc.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace_sched.h>
 
 #include <arch/irq.h>
 
@@ -55,6 +56,8 @@
 #define TTRACE_FUNC_TAG        'g'
 #define TTRACE_USED_BUFSIZE    'u'
 #define TTRACE_BUFFER          'b'
+#define TTRACE_SCHED_ENABLE    'k'
+#define TTRACE_SCHED_SELECT    'r'
 
 #define TTRACE_STATE_IDLE       0
 #define TTRACE_STATE_RUNNING    1
@@ -100,6 +103,9 @@ static const struct file_operations g_ttracefops = {
 static char g_packets[CONFIG_TTRACE_BUFSIZE];
 static uint32_t g_state = TTRACE_STATE_IDLE;
 static uint32_t g_selected_tag = 0;
+#ifdef CONFIG_TTRACE_SCHED
+static bool g_schedselect;		/* read() returns the scheduler records */
+#endif
 
 /* This is the device structure for the T-trace function. It
  * must be statically initialized because the T-trace ttrace_putc function
@@ -124,6 +130,18 @@ static ssize_t ttrace_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
 	struct inode *inode = filep->f_inode;
 	struct ttrace_dev_s *priv = inode->i_private;
+#ifdef CONFIG_TTRACE_SCHED
+	ssize_t nread;
+
+	if (g_schedselect) {
+		nread = ttrace_sched_read(filep->f_pos, buffer, len);
+		if (nread > 0) {
+			filep->f_pos += nread;
+		}
+
+		return nread;
+	}
+#endif
 
 	if (TTRACE_STATE_IDLE != g_state) {
 		return TTRACE_INVALID;
@@ -211,12 +229,27 @@ static ssize_t ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		}
 		break;
 	case TTRACE_USED_BUFSIZE:
+#ifdef CONFIG_TTRACE_SCHED
+		if (g_schedselect) {
+			ret = ttrace_sched_size();
+			break;
+		}
+#endif
 		ttdbg("used bufsize: %d\r\n", priv->ttrace_head);
 		ret = priv->ttrace_head;
 		break;
 	case TTRACE_BUFFER:
 		ttdbg("Resize of trace buffer is not supported yet.\r\n");
 		break;
+#ifdef CONFIG_TTRACE_SCHED
+	case TTRACE_SCHED_ENABLE:
+		ttrace_sched_enable(arg != 0);
+		break;
+	case TTRACE_SCHED_SELECT:
+		g_schedselect = (arg != 0);
+		filep->f_pos = 0;
+		break;
+#endif
 	default:
 		ttdbg("Invalid commands, cmd: %c, arg: %d\r\n", cmd, arg);
 		break;
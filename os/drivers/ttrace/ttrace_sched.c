@@ -0,0 +1,331 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/ttrace/ttrace_sched.c
+ *
+ * Scheduler event recorder.  The sched_note_* hooks append fixed size
+ * records (include/tinyara/ttrace_sched.h) to a ring buffer which always
+ * holds the most recent CONFIG_TTRACE_SCHED_NRECORDS events.  The hooks
+ * run from the scheduler and from interrupt handlers, so a record is
+ * claimed and filled with interrupts disabled; that is a handful of
+ * stores and nothing ever waits for the ring.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/ttrace_sched.h>
+
+#include <arch/irq.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TTRACE_SCHED_HDRSIZE   sizeof(struct ttrace_sched_hdr_s)
+#define TTRACE_SCHED_RECSIZE   sizeof(struct ttrace_sched_rec_s)
+
+/* Resolution of the timestamps in microseconds */
+
+#if defined(CONFIG_TTRACE_SCHED_ARCH_TIMESTAMP) || defined(CONFIG_SCHED_TICKLESS)
+#define TTRACE_SCHED_TSRES     1
+#else
+#define TTRACE_SCHED_TSRES     USEC_PER_TICK
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ttrace_sched_rec_s g_schedrec[CONFIG_TTRACE_SCHED_NRECORDS];
+static unsigned int g_schedhead;	/* Index of the next record to fill */
+static uint32_t g_schedcount;		/* Records written since enabled */
+static bool g_schedenabled;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ttrace_sched_timestamp
+ ****************************************************************************/
+
+static inline uint32_t ttrace_sched_timestamp(void)
+{
+#if defined(CONFIG_TTRACE_SCHED_ARCH_TIMESTAMP)
+	return up_ttrace_timestamp();
+#elif defined(CONFIG_SCHED_TICKLESS)
+	struct timespec ts;
+
+	(void)up_timer_gettime(&ts);
+	return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+#else
+	return (uint32_t)TICK2USEC(clock_systimer());
+#endif
+}
+
+/****************************************************************************
+ * Name: ttrace_sched_alloc
+ *
+ * Description:
+ *   Claim the next record, overwriting the oldest one if the ring is full,
+ *   and fill in the fields common to all records.  Called with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+static FAR struct ttrace_sched_rec_s *ttrace_sched_alloc(uint8_t type, FAR struct tcb_s *tcb)
+{
+	FAR struct ttrace_sched_rec_s *rec = &g_schedrec[g_schedhead];
+
+	if (++g_schedhead >= CONFIG_TTRACE_SCHED_NRECORDS) {
+		g_schedhead = 0;
+	}
+
+	if (g_schedcount < UINT32_MAX) {
+		g_schedcount++;
+	}
+
+	rec->ts   = ttrace_sched_timestamp();
+	rec->type = type;
+	rec->prio = tcb->sched_priority;
+	rec->pid  = tcb->pid;
+	return rec;
+}
+
+/****************************************************************************
+ * Name: ttrace_sched_name
+ ****************************************************************************/
+
+static void ttrace_sched_name(FAR struct tcb_s *tcb, FAR void *arg)
+{
+	FAR struct ttrace_sched_rec_s *rec;
+
+	rec = ttrace_sched_alloc((uint8_t)(uintptr_t)arg, tcb);
+#if CONFIG_TASK_NAME_SIZE > 0
+	strncpy(rec->u.name, tcb->name, TTRACE_SCHED_NAMELEN);
+#else
+	memset(rec->u.name, 0, TTRACE_SCHED_NAMELEN);
+#endif
+}
+
+/****************************************************************************
+ * Name: ttrace_sched_args
+ ****************************************************************************/
+
+static void ttrace_sched_args(uint8_t type, FAR struct tcb_s *tcb, uint32_t arg0, uint32_t arg1)
+{
+	FAR struct ttrace_sched_rec_s *rec;
+	irqstate_t flags;
+
+	flags = irqsave();
+	rec = ttrace_sched_alloc(type, tcb);
+	rec->u.a.arg0 = arg0;
+	rec->u.a.arg1 = arg1;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: ttrace_sched_nrecords
+ ****************************************************************************/
+
+static inline uint32_t ttrace_sched_nrecords(void)
+{
+	return g_schedcount < CONFIG_TTRACE_SCHED_NRECORDS ? g_schedcount : CONFIG_TTRACE_SCHED_NRECORDS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_note_start, sched_note_stop, sched_note_switch
+ *
+ * Description:
+ *   Scheduler instrumentation hooks (see CONFIG_SCHED_INSTRUMENTATION).
+ *
+ ****************************************************************************/
+
+void sched_note_start(FAR struct tcb_s *tcb)
+{
+	irqstate_t flags;
+
+	if (g_schedenabled) {
+		flags = irqsave();
+		ttrace_sched_name(tcb, (FAR void *)TTRACE_SCHED_START);
+		irqrestore(flags);
+	}
+}
+
+void sched_note_stop(FAR struct tcb_s *tcb)
+{
+	if (g_schedenabled) {
+		ttrace_sched_args(TTRACE_SCHED_STOP, tcb, 0, 0);
+	}
+}
+
+void sched_note_switch(FAR struct tcb_s *pFromTcb, FAR struct tcb_s *pToTcb)
+{
+	if (g_schedenabled) {
+		ttrace_sched_args(TTRACE_SCHED_SWITCH, pToTcb, pFromTcb->pid, pFromTcb->sched_priority);
+	}
+}
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+/****************************************************************************
+ * Name: sched_note_irqhandler
+ ****************************************************************************/
+
+void sched_note_irqhandler(int irq, FAR void *handler, bool enter)
+{
+	if (g_schedenabled) {
+		ttrace_sched_args(enter ? TTRACE_SCHED_IRQENTER : TTRACE_SCHED_IRQLEAVE, sched_self(), irq, (uint32_t)(uintptr_t)handler);
+	}
+}
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SEMAPHORE
+/****************************************************************************
+ * Name: sched_note_semwait, sched_note_semwake
+ ****************************************************************************/
+
+void sched_note_semwait(FAR struct tcb_s *tcb, FAR void *sem)
+{
+	if (g_schedenabled) {
+		ttrace_sched_args(TTRACE_SCHED_SEMWAIT, tcb, (uint32_t)(uintptr_t)sem, 0);
+	}
+}
+
+void sched_note_semwake(FAR struct tcb_s *tcb, FAR void *sem)
+{
+	uint32_t poster;
+
+	if (g_schedenabled) {
+		poster = up_interrupt_context() ? (uint32_t)-1 : (uint32_t)sched_self()->pid;
+		ttrace_sched_args(TTRACE_SCHED_SEMWAKE, tcb, (uint32_t)(uintptr_t)sem, poster);
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: ttrace_sched_enable
+ ****************************************************************************/
+
+void ttrace_sched_enable(bool enable)
+{
+	irqstate_t flags;
+
+	if (enable == g_schedenabled) {
+		return;
+	}
+
+	flags = irqsave();
+	if (enable) {
+		g_schedhead  = 0;
+		g_schedcount = 0;
+
+		/* Name the tasks that are already running so that the host tool
+		 * can label them.
+		 */
+
+		sched_foreach(ttrace_sched_name, (FAR void *)TTRACE_SCHED_NAME);
+	}
+
+	g_schedenabled = enable;
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: ttrace_sched_size
+ ****************************************************************************/
+
+size_t ttrace_sched_size(void)
+{
+	return TTRACE_SCHED_HDRSIZE + ttrace_sched_nrecords() * TTRACE_SCHED_RECSIZE;
+}
+
+/****************************************************************************
+ * Name: ttrace_sched_read
+ ****************************************************************************/
+
+ssize_t ttrace_sched_read(off_t pos, FAR char *buffer, size_t len)
+{
+	struct ttrace_sched_hdr_s hdr;
+	FAR const char *src;
+	uint32_t nrecords;
+	uint32_t first;
+	uint32_t index;
+	size_t offset;
+	size_t nbytes;
+	size_t ncopied = 0;
+
+	if (g_schedenabled) {
+		return -EBUSY;
+	}
+
+	nrecords = ttrace_sched_nrecords();
+	first = g_schedcount > CONFIG_TTRACE_SCHED_NRECORDS ? g_schedhead : 0;
+
+	while (len > 0 && pos >= 0 && (size_t)pos < ttrace_sched_size()) {
+		if ((size_t)pos < TTRACE_SCHED_HDRSIZE) {
+			hdr.magic    = TTRACE_SCHED_MAGIC;
+			hdr.version  = TTRACE_SCHED_VERSION;
+			hdr.recsize  = TTRACE_SCHED_RECSIZE;
+			hdr.nrecords = nrecords;
+			hdr.nlost    = g_schedcount - nrecords;
+			hdr.tsres    = TTRACE_SCHED_TSRES;
+
+			offset = pos;
+			nbytes = TTRACE_SCHED_HDRSIZE - offset;
+			src    = (FAR const char *)&hdr + offset;
+		} else {
+			/* Records are returned oldest first */
+
+			index  = (pos - TTRACE_SCHED_HDRSIZE) / TTRACE_SCHED_RECSIZE;
+			offset = (pos - TTRACE_SCHED_HDRSIZE) % TTRACE_SCHED_RECSIZE;
+			index  = (first + index) % CONFIG_TTRACE_SCHED_NRECORDS;
+			nbytes = TTRACE_SCHED_RECSIZE - offset;
+			src    = (FAR const char *)&g_schedrec[index] + offset;
+		}
+
+		if (nbytes > len) {
+			nbytes = len;
+		}
+
+		memcpy(buffer, src, nbytes);
+		buffer  += nbytes;
+		pos     += nbytes;
+		len     -= nbytes;
+		ncopied += nbytes;
+	}
+
+	return ncopied;
+}
@@ -89,6 +89,7 @@
 struct mtd_file_s {
 	struct procfs_file_s base;	/* Base open file structure */
 	FAR struct mtd_dev_s *pnextmtd;	/* Pointer to next registered MTD */
+	FAR struct mtd_gcstats_s *pnextgc;	/* Pointer to next GC counters */
 };
 
 /****************************************************************************
@@ -138,6 +139,10 @@ const struct procfs_operations mtd_procfsoperations = {
 static struct mtd_dev_s *g_pfirstmtd = NULL;
 static uint8_t g_nextmtdno = 0;
 
+/* Registered garbage collection counters */
+
+static struct mtd_gcstats_s *g_pfirstgc = NULL;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -172,6 +177,7 @@ static int mtd_open(FAR struct file *filep, FAR const char *relpath, int oflags,
 	}
 
 	attr->pnextmtd = g_pfirstmtd;
+	attr->pnextgc = g_pfirstgc;
 
 	/* Save the context as the open-specific state in filep->f_priv */
 
@@ -243,6 +249,31 @@ static ssize_t mtd_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 		} while (priv->pnextmtd);
 	}
 
+	/* Then report the garbage collection counters once all devices are out */
+
+	if (priv->pnextmtd == NULL && priv->pnextgc) {
+		if (priv->pnextgc == g_pfirstgc && total < buflen) {
+			ret = snprintf(&buffer[total], buflen - total, "\nGC Device        Runs   Reloc  Erase  Defer  Inline Pool\n");
+			if (ret + total < buflen) {
+				total += ret;
+			}
+		}
+
+		while (priv->pnextgc) {
+			FAR struct mtd_gcstats_s *stats = priv->pnextgc;
+
+			ret = snprintf(&buffer[total], buflen - total, "%-16s%-7u%-7u%-7u%-7u%-7u%u\n", stats->name, stats->runs, stats->relocations, stats->erases, stats->deferred, stats->inlinegc, stats->poolblocks);
+
+			if (ret + total < buflen) {
+				total += ret;
+				priv->pnextgc = stats->pnext;
+			} else {
+				buffer[total] = '\0';
+				break;
+			}
+		}
+	}
+
 	/* Update the file offset */
 
 	if (total > 0) {
@@ -357,4 +388,33 @@ int mtd_register(FAR struct mtd_dev_s *mtd, FAR const char *name)
 	return OK;
 }
 
+/****************************************************************************
+ * Name: mtd_register_gcstats
+ *
+ * Description:
+ *   Adds a set of garbage collection counters to the list reported after the
+ *   registered MTD devices.
+ *
+ ****************************************************************************/
+
+int mtd_register_gcstats(FAR struct mtd_gcstats_s *stats)
+{
+	FAR struct mtd_gcstats_s *plast;
+
+	stats->pnext = NULL;
+
+	if (g_pfirstgc == NULL) {
+		g_pfirstgc = stats;
+	} else {
+		plast = g_pfirstgc;
+		while (plast->pnext) {
+			plast = plast->pnext;
+		}
+
+		plast->pnext = stats;
+	}
+
+	return OK;
+}
+
 #endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
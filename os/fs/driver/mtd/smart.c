@@ -68,12 +68,20 @@
 #include <string.h>
 #include <debug.h>
 #include <errno.h>
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#include <assert.h>
+#include <semaphore.h>
+#endif
 
 #include <crc8.h>
 #include <crc16.h>
 #include <crc32.h>
 #include <tinyara/math.h>
 #include <tinyara/kmalloc.h>
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+#endif
 #include <tinyara/fs/fs.h>
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/mtd.h>
@@ -132,6 +140,42 @@
 
 #define SMART_FIRST_DIR_SECTOR      3	/* First root directory sector */
 
+/* Sector map checkpoint definitions.  The checkpoint area is made of
+ * CONFIG_MTD_SMART_CHECKPOINT_SLOTS slots at the end of the MTD device,
+ * written in turn.  Each slot holds a header block, the sector map with the
+ * free / release counts, and a log of the erase blocks modified since the
+ * checkpoint was taken.
+ */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+#ifndef CONFIG_MTD_SMART_CHECKPOINT_SLOTS
+#define CONFIG_MTD_SMART_CHECKPOINT_SLOTS 4
+#endif
+
+#define SMART_CKPT_SIG1             'S'
+#define SMART_CKPT_SIG2             'C'
+#define SMART_CKPT_SIG3             'K'
+#define SMART_CKPT_SIG4             'P'
+#define SMART_CKPT_RETIRED          ((uint8_t)~CONFIG_SMARTFS_ERASEDSTATE)
+#define SMART_CKPT_NSLOTS           CONFIG_MTD_SMART_CHECKPOINT_SLOTS
+#define SMART_CKPT_NOSLOT           0xFF
+#define SMART_CKPT_LOG_ERASED       ((uint16_t)(CONFIG_SMARTFS_ERASEDSTATE | (CONFIG_SMARTFS_ERASEDSTATE << 8)))
+#define SMART_CKPT_LOG_MASK         ((uint16_t)~SMART_CKPT_LOG_ERASED)
+#endif
+
+/* Background garbage collection keeps CONFIG_MTD_SMART_GC_POOL_BLOCKS erase
+ * blocks worth of free sectors on top of the reserve that inline collection
+ * needs in order to relocate a block.
+ */
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#define SMART_GC_RESERVE(d)         (((d)->sectorsPerBlk << 0) + 4)
+#define SMART_GC_TARGET(d)          (SMART_GC_RESERVE(d) + CONFIG_MTD_SMART_GC_POOL_BLOCKS * (d)->availSectPerBlk)
+#else
+#define smart_semtake(d)
+#define smart_semgive(d)
+#endif
+
 /* First logical sector number we will use for assignment of requested Alloc
  * sectors.  All enries below this are reserved (some for root dir entries,
  * other for our use, such as format sector, etc.
@@ -154,7 +198,7 @@
 #define offsetof(type, member) ((size_t)&(((type *)0)->member))
 #endif
 
-#define SMART_MAX_ALLOCS        6
+#define SMART_MAX_ALLOCS        8
 //#define CONFIG_MTD_SMART_PACK_COUNTS
 
 #ifndef CONFIG_MTD_SMART_ALLOC_DEBUG
@@ -219,7 +263,22 @@ static const uint8_t gWearBitToLevelMap4[] = {
 struct smart_cache_s {
 	uint16_t logical;			/* Logical sector number */
 	uint16_t physical;			/* Associated physical sector */
-	uint16_t birth;				/* The "birthday" of this entry */
+	uint16_t next;				/* Next entry in the hash chain / free list */
+	uint8_t referenced;			/* CLOCK reference bit */
+};
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+struct smart_ckpt_header_s {
+	uint8_t signature[4];		/* SMART_CKPT_SIGx */
+	uint32_t seq;				/* Incrementing checkpoint sequence number */
+	uint32_t datalen;			/* Bytes of sector map and counts data */
+	uint32_t datacrc;			/* CRC-32 of the sector map and counts */
+	uint16_t sectorsize;		/* Geometry the checkpoint was taken with */
+	uint16_t totalsectors;
+	uint16_t neraseblocks;
+	uint16_t reserved;
+	uint32_t crc;				/* CRC-32 of the header up to this field */
 };
 #endif
 
@@ -291,10 +350,29 @@ struct smart_struct_s {
 #else
 	FAR uint8_t *sBitMap;		/* Virtual sector used bit-map */
 	FAR struct smart_cache_s *sCache;	/* Sector cache */
-	uint16_t cache_entries;	/* Number of valid entries in the cache */
+	FAR uint16_t *cache_hash;	/* Hash chain heads into the sector cache */
+	uint16_t cache_free;		/* Head of the free cache entry list */
+	uint16_t cache_hand;		/* CLOCK replacement hand */
 	uint16_t cache_lastlog;	/* Keep track of the last sector accessed */
 	uint16_t cache_lastphys;	/* Keep the physical sector number also */
-	uint16_t cache_nextbirth;	/* Sector cache aging value */
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+	FAR uint32_t *blksummary;	/* Logical sector signature per erase block */
+	uint16_t summarywords;		/* Signature words per erase block */
+#endif
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	uint16_t ckpt_firstblock;	/* First erase block of the checkpoint area */
+	uint16_t ckpt_slotblocks;	/* Erase blocks per slot, 0 if disabled */
+	uint16_t ckpt_nlog;		/* Entries in the active slot's dirty log */
+	uint16_t ckpt_writes;		/* Sector writes since the last checkpoint */
+	uint32_t ckpt_seq;			/* Sequence number of the last checkpoint written */
+	uint8_t ckpt_slot;			/* Active slot or SMART_CKPT_NOSLOT */
+	FAR uint8_t *ckpt_dirty;	/* Bit-map of erase blocks in the dirty log */
+#endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	sem_t exclsem;				/* Serializes callers with the GC worker */
+	struct work_s gcwork;		/* Background garbage collection work */
+	struct mtd_gcstats_s gcstats;	/* Garbage collection counters */
 #endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	FAR uint8_t *erasecounts;	/* Number of erases for each erase block */
@@ -409,6 +487,19 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 
 static int smart_relocate_sector(FAR struct smart_struct_s *dev, uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_cache_reset(FAR struct smart_struct_s *dev);
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_ckpt_touch(FAR struct smart_struct_s *dev, uint16_t block);
+static int smart_ckpt_write(FAR struct smart_struct_s *dev);
+#endif
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gc_kick(FAR struct smart_struct_s *dev);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -497,6 +588,35 @@ static void smart_free(FAR struct smart_struct_s *dev, FAR void *ptr)
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: smart_semtake
+ *
+ * Description: Take the device semaphore shared with the GC worker.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_semtake(FAR struct smart_struct_s *dev)
+{
+	while (sem_wait(&dev->exclsem) != 0) {
+		/* The only case that an error should occur here is if
+		 * the wait was awakened by a signal.
+		 */
+
+		ASSERT(*get_errno_ptr() == EINTR);
+	}
+}
+
+/****************************************************************************
+ * Name: smart_semgive
+ ****************************************************************************/
+
+static void smart_semgive(FAR struct smart_struct_s *dev)
+{
+	sem_post(&dev->exclsem);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_open
  *
@@ -519,7 +639,30 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+	FAR struct smart_struct_s *dev;
+#endif
+
 	fvdbg("Entry\n");
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && defined(CONFIG_FS_WRITABLE)
+	DEBUGASSERT(inode && inode->i_private);
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+	dev = (FAR struct smart_struct_s *)inode->i_private;
+#endif
+
+	/* Checkpoint the sector map on a clean unmount if anything changed */
+
+	smart_semtake(dev);
+	if (dev->ckpt_slot == SMART_CKPT_NOSLOT || dev->ckpt_nlog > 0) {
+		smart_ckpt_write(dev);
+	}
+
+	smart_semgive(dev);
+#endif
+
 	return OK;
 }
 
@@ -754,6 +897,7 @@ static ssize_t smart_reload(struct smart_struct_s *dev, FAR uint8_t *buffer, off
 static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer, size_t start_sector, unsigned int nsectors)
 {
 	struct smart_struct_s *dev;
+	ssize_t ret;
 
 	fvdbg("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -763,7 +907,10 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer, size_t
 #else
 	dev = (struct smart_struct_s *)inode->i_private;
 #endif
-	return smart_reload(dev, buffer, start_sector, nsectors);
+	smart_semtake(dev);
+	ret = smart_reload(dev, buffer, start_sector, nsectors);
+	smart_semgive(dev);
+	return ret;
 }
 
 /****************************************************************************
@@ -798,7 +945,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 	dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-	/* I think maybe we need to lock on a mutex here */
+	smart_semtake(dev);
 
 	/* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
 	 * per erase block is a power of 2, and (2) the erase begins with that same
@@ -825,6 +972,10 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 	/* Loop for all blocks to be written */
 
 	while (remaining > 0) {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		smart_ckpt_touch(dev, nextblock / mtdBlksPerErase);
+#endif
+
 		/* If this is an aligned block, then erase the block */
 
 		if (alignedblock == nextblock) {
@@ -834,9 +985,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 			ret = MTD_ERASE(dev->mtd, eraseblock, 1);
 			if (ret < 0) {
 				fdbg("Erase block=%d failed: %d\n", eraseblock, ret);
-
-				/* Unlock the mutex if we add one */
-
+				smart_semgive(dev);
 				return ret;
 			}
 		}
@@ -860,9 +1009,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 			/* The block is not empty!!  What to do? */
 
 			fdbg("Write block %d failed: %d.\n", nextblock, nxfrd);
-
-			/* Unlock the mutex if we add one */
-
+			smart_semgive(dev);
 			return -EIO;
 		}
 
@@ -874,6 +1021,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 		alignedblock += mtdBlksPerErase;
 	}
 
+	smart_semgive(dev);
 	return nsectors;
 }
 #endif							/* CONFIG_FS_WRITABLE */
@@ -1002,9 +1150,14 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		dev->sBitMap = NULL;
 	}
 
-	dev->cache_entries = 0;
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+	if (dev->blksummary != NULL) {
+		smart_free(dev, dev->blksummary);
+		dev->blksummary = NULL;
+	}
+#endif
+
 	dev->cache_lastlog = 0xFFFF;
-	dev->cache_nextbirth = 0;
 #endif
 
 	if (dev->rwbuffer != NULL) {
@@ -1108,7 +1261,7 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 	/* Allocate the sector cache */
 
 	if (dev->sCache == NULL) {
-		dev->sCache = (FAR struct smart_cache_s *)smart_malloc(dev, CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s) + allocsize, "Sector Cache");
+		dev->sCache = (FAR struct smart_cache_s *)smart_malloc(dev, CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * (sizeof(struct smart_cache_s) + sizeof(uint16_t)) + allocsize, "Sector Cache");
 	}
 
 	if (!dev->sCache) {
@@ -1116,7 +1269,25 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		goto errexit;
 	}
 
-	dev->releasecount = (FAR uint8_t *)dev->sCache + (CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s));
+	dev->cache_hash = (FAR uint16_t *)&dev->sCache[CONFIG_MTD_SMART_SECTOR_CACHE_SIZE];
+	dev->releasecount = (FAR uint8_t *)&dev->cache_hash[CONFIG_MTD_SMART_SECTOR_CACHE_SIZE];
+	smart_cache_reset(dev);
+
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+	/* Allocate the erase block summaries.  Each erase block gets a signature
+	 * of CONFIG_MTD_SMART_BLOCK_SUMMARY_BITS bits per sector, rounded up to
+	 * a whole number of words.
+	 */
+
+	dev->summarywords = (dev->sectorsPerBlk * CONFIG_MTD_SMART_BLOCK_SUMMARY_BITS + 31) >> 5;
+	dev->blksummary = (FAR uint32_t *)smart_malloc(dev, dev->neraseblocks * dev->summarywords * sizeof(uint32_t), "Block summary");
+	if (dev->blksummary == NULL) {
+		fdbg("Error allocating SMART block summary\n");
+		goto errexit;
+	}
+
+	memset(dev->blksummary, 0, dev->neraseblocks * dev->summarywords * sizeof(uint32_t));
+#endif
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	if (dev->sectorsPerBlk > 16) {
@@ -1205,6 +1376,11 @@ errexit:
 	if (dev->sCache) {
 		smart_free(dev, dev->sCache);
 	}
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+	if (dev->blksummary) {
+		smart_free(dev, dev->blksummary);
+	}
+#endif
 #endif
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
@@ -1237,6 +1413,12 @@ errexit:
 static ssize_t smart_bytewrite(FAR struct smart_struct_s *dev, size_t offset, int nbytes, FAR const uint8_t *buffer)
 {
 	ssize_t ret;
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	if (dev->ckpt_slot != SMART_CKPT_NOSLOT) {
+		smart_ckpt_touch(dev, offset / dev->erasesize);
+	}
+#endif
 #ifdef CONFIG_MTD_BYTE_WRITE
 	/* Check if the underlying MTD device supports write */
 
@@ -1284,6 +1466,158 @@ errout:
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smart_cache_reset
+ *
+ * Description: Empties the sector map cache.  All entries are placed on the
+ *              free list and all hash chains are emptied.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_cache_reset(FAR struct smart_struct_s *dev)
+{
+	uint16_t x;
+
+	for (x = 0; x < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE; x++) {
+		dev->cache_hash[x] = 0xFFFF;
+		dev->sCache[x].logical = 0xFFFF;
+		dev->sCache[x].physical = 0xFFFF;
+		dev->sCache[x].next = x + 1;
+		dev->sCache[x].referenced = 0;
+	}
+
+	dev->sCache[CONFIG_MTD_SMART_SECTOR_CACHE_SIZE - 1].next = 0xFFFF;
+	dev->cache_free = 0;
+	dev->cache_hand = 0;
+	dev->cache_lastlog = 0xFFFF;
+	dev->cache_lastphys = 0xFFFF;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cache_find
+ *
+ * Description: Returns the index of the cache entry holding the mapping of
+ *              the given logical sector, or 0xFFFF if it is not cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static uint16_t smart_cache_find(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+	uint16_t index;
+
+	index = dev->cache_hash[logical % CONFIG_MTD_SMART_SECTOR_CACHE_SIZE];
+	while (index != 0xFFFF && dev->sCache[index].logical != logical) {
+		index = dev->sCache[index].next;
+	}
+
+	return index;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cache_unlink
+ *
+ * Description: Removes the cache entry at index from its hash chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_cache_unlink(FAR struct smart_struct_s *dev, uint16_t index)
+{
+	FAR uint16_t *link;
+
+	link = &dev->cache_hash[dev->sCache[index].logical % CONFIG_MTD_SMART_SECTOR_CACHE_SIZE];
+	while (*link != 0xFFFF) {
+		if (*link == index) {
+			*link = dev->sCache[index].next;
+			break;
+		}
+
+		link = &dev->sCache[*link].next;
+	}
+
+	dev->sCache[index].logical = 0xFFFF;
+	dev->sCache[index].next = 0xFFFF;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_summary_add
+ *
+ * Description: Records in the summary of the erase block holding the given
+ *              physical sector that the block contains the logical sector.
+ *              The summary is a small Bloom filter: each logical sector sets
+ *              two bits, so a clear bit proves the logical sector was never
+ *              written to the block since it was last erased.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+#define SMART_SUMMARY_HASH1(l)  ((uint32_t)(l))
+#define SMART_SUMMARY_HASH2(l)  (((uint32_t)(l) * 40503) >> 7)
+
+static void smart_summary_add(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical)
+{
+	FAR uint32_t *summary;
+	uint32_t nbits;
+	uint32_t bit;
+
+	if (physical >= dev->totalsectors) {
+		return;
+	}
+
+	summary = &dev->blksummary[(physical / dev->sectorsPerBlk) * dev->summarywords];
+	nbits = (uint32_t)dev->summarywords << 5;
+
+	bit = SMART_SUMMARY_HASH1(logical) % nbits;
+	summary[bit >> 5] |= (uint32_t)1 << (bit & 0x1F);
+	bit = SMART_SUMMARY_HASH2(logical) % nbits;
+	summary[bit >> 5] |= (uint32_t)1 << (bit & 0x1F);
+}
+
+/****************************************************************************
+ * Name: smart_summary_test
+ *
+ * Description: Tests if the given erase block may contain the logical
+ *              sector.  A false return means the block doesn't need to be
+ *              scanned.
+ *
+ ****************************************************************************/
+
+static bool smart_summary_test(FAR struct smart_struct_s *dev, uint16_t block, uint16_t logical)
+{
+	FAR uint32_t *summary;
+	uint32_t nbits;
+	uint32_t bit;
+
+	summary = &dev->blksummary[block * dev->summarywords];
+	nbits = (uint32_t)dev->summarywords << 5;
+
+	bit = SMART_SUMMARY_HASH1(logical) % nbits;
+	if (!(summary[bit >> 5] & ((uint32_t)1 << (bit & 0x1F)))) {
+		return false;
+	}
+
+	bit = SMART_SUMMARY_HASH2(logical) % nbits;
+	return (summary[bit >> 5] & ((uint32_t)1 << (bit & 0x1F))) != 0;
+}
+
+/****************************************************************************
+ * Name: smart_summary_clear
+ *
+ * Description: Clears the summary of an erase block after it was erased.
+ *
+ ****************************************************************************/
+
+static void smart_summary_clear(FAR struct smart_struct_s *dev, uint16_t block)
+{
+	memset(&dev->blksummary[block * dev->summarywords], 0, dev->summarywords * sizeof(uint32_t));
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1291,64 +1625,86 @@ errout:
  *              map cache.  The cache is used to minimize RAM by eliminating
  *              a one-to-one mapping of all logical sectors and only keeping
  *              a fixed number of mappings per the
- *              CONFIG_MTD_SMART_SECTOR_CACHE_SIZE parameter.  Sectors are
- *              automatically managed and removed based on the time since
- *              they were accessed last.
+ *              CONFIG_MTD_SMART_SECTOR_CACHE_SIZE parameter.  Entries are
+ *              hashed by logical sector number and replaced using the CLOCK
+ *              algorithm: the hand skips (and clears) entries referenced
+ *              since it last passed them.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
 static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical, int line)
 {
-	uint16_t index, x;
-	uint16_t oldest;
+	FAR struct smart_cache_s *entry;
+	uint16_t index;
+	uint16_t hash;
+	uint32_t x;
 
-	/* If we aren't full yet, just add the sector to the end of the list */
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+	smart_summary_add(dev, logical, physical);
+#endif
 
-	index = 1;
-	if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE) {
-		index = dev->cache_entries++;
-	} else {
-		/* Cache is full.  We must find the least accessed entry and replace it */
+	/* If the sector is already cached, then just update its mapping */
 
-		oldest = 0xFFFF;
-		for (x = 0; x < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE; x++) {
-			/* Never replace cache entries for system sectors */
+	index = smart_cache_find(dev, logical);
+	if (index == 0xFFFF) {
+		if (dev->cache_free != 0xFFFF) {
+			/* Take an entry from the free list */
 
-			if (dev->sCache[x].logical < dev->reservedsector) {
-				continue;
-			}
+			index = dev->cache_free;
+			dev->cache_free = dev->sCache[index].next;
+		} else {
+			/* Cache is full.  Advance the CLOCK hand until we find an entry
+			 * that wasn't referenced since the last sweep.  Bound the search
+			 * to two sweeps in case every entry belongs to a system sector.
+			 */
 
-			/* If the hit count is zero, then choose this entry */
+			for (x = 0; ; x++) {
+				index = dev->cache_hand;
+				if (++dev->cache_hand >= CONFIG_MTD_SMART_SECTOR_CACHE_SIZE) {
+					dev->cache_hand = 0;
+				}
 
-			if (dev->sCache[x].birth < oldest) {
-				oldest = dev->sCache[x].birth;
-				index = x;
+				if (x >= 2 * CONFIG_MTD_SMART_SECTOR_CACHE_SIZE) {
+					break;
+				}
+
+				/* Never replace cache entries for system sectors */
+
+				entry = &dev->sCache[index];
+				if (entry->logical < dev->reservedsector) {
+					continue;
+				}
+
+				if (entry->referenced) {
+					entry->referenced = 0;
+					continue;
+				}
+
+				break;
 			}
+
+			smart_cache_unlink(dev, index);
 		}
+
+		/* Link the entry into its hash chain */
+
+		hash = logical % CONFIG_MTD_SMART_SECTOR_CACHE_SIZE;
+		dev->sCache[index].logical = logical;
+		dev->sCache[index].next = dev->cache_hash[hash];
+		dev->cache_hash[hash] = index;
 	}
 
 	/* Now add the sector at index */
 
-	dev->sCache[index].logical = logical;
 	dev->sCache[index].physical = physical;
-	dev->sCache[index].birth = dev->cache_nextbirth++;
+	dev->sCache[index].referenced = 1;
 	dev->cache_lastlog = logical;
 	dev->cache_lastphys = physical;
 	if (dev->debuglevel > 1) {
 		dbg("Add Cache sector:  Log=%d, Phys=%d at index %d from line %d\n", logical, physical, index, line);
 	}
 
-	/* Test if the birthdays need to be adjusted */
-
-	if (oldest >= CONFIG_MTD_SMART_SECTOR_CACHE_SIZE + 1024) {
-		for (x = 0; x < dev->cache_entries; x++) {
-			dev->sCache[x].birth -= 1024;
-		}
-
-		dev->cache_nextbirth -= 1024;
-	}
-
 	return index;
 }
 #endif
@@ -1357,10 +1713,12 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev, uint16_t lo
  * Name: smart_cache_lookup
  *
  * Description: Perform a cache lookup for the requested logical sector.
- *              If the sector is in the cache, then update the hitcount and
+ *              If the sector is in the cache, then mark it referenced and
  *              return the physical mapping.  If a cache miss occurs, then
  *              the routine will scan the volume to find the logical sector
  *              and add / replace a cache entry with the newly located sector.
+ *              Erase blocks whose summary shows they can't hold the sector
+ *              are skipped by the scan.
  *
  ****************************************************************************/
 
@@ -1369,7 +1727,7 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 {
 	int ret;
 	uint16_t block, sector;
-	uint16_t x, physical, logicalsector;
+	uint16_t index, physical, logicalsector;
 	struct smart_sect_header_s header;
 	size_t readaddress;
 
@@ -1383,13 +1741,12 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
 	/* First search for the entry in the cache */
 
-	for (x = 0; x < dev->cache_entries; x++) {
-		if (dev->sCache[x].logical == logical) {
-			/* Entry found in the cache.  Grab the physical mapping. */
+	index = smart_cache_find(dev, logical);
+	if (index != 0xFFFF) {
+		/* Entry found in the cache.  Grab the physical mapping. */
 
-			physical = dev->sCache[x].physical;
-			break;
-		}
+		dev->sCache[index].referenced = 1;
+		physical = dev->sCache[index].physical;
 	}
 
 	/* If the entry wasn't found in the cache, then we must search the volume
@@ -1407,10 +1764,18 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 		for (sector = 0; sector < dev->sectorsPerBlk && physical == 0xFFFF; sector++) {
 			/* Now scan across each erase block */
 
-			for (block = 0; block < dev->geo.neraseblocks; block++) {
+			for (block = 0; block < dev->neraseblocks; block++) {
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+				/* Skip erase blocks that can't contain the sector */
+
+				if (!smart_summary_test(dev, block, logical)) {
+					continue;
+				}
+#endif
+
 				/* Calculate the read address for this sector */
 
-				readaddress = block * dev->erasesize + sector * CONFIG_MTD_SMART_SECTOR_SIZE;
+				readaddress = (block * dev->sectorsPerBlk + sector) * dev->mtdBlksPerSector * dev->geo.blocksize;
 
 				/* Read the header for this sector */
 
@@ -1421,7 +1786,7 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
 				/* Get the logical sector number for this physical sector */
 
-				logicalsector = *((FAR uint16_t *)header.logicalsector);
+				logicalsector = UINT8TOUINT16(header.logicalsector);
 #if CONFIG_SMARTFS_ERASEDSTATE == 0x00
 				if (logicalsector == 0) {
 					continue;
@@ -1436,7 +1801,7 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
 				/* Test if this sector has been release and skip it if it has */
 
-				if (SECOR_IS_RELEASED(header)) {
+				if (SECTOR_IS_RELEASED(header)) {
 					continue;
 				}
 
@@ -1472,38 +1837,40 @@ err_out:
  *
  * Description: Updates a cache entry (if present) replacing the logical
  *              sector's physical sector mapping with the new one provided.
- *              This does not affect the hit count.
+ *              A physical sector of 0xFFFF removes the entry.  This does
+ *              not affect the CLOCK reference bit.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
 static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical)
 {
-	uint16_t x;
-
-	/* Scan through all cache entries and find the logical sector entry */
-
-	for (x = 0; x < dev->cache_entries; x++) {
-		if (dev->sCache[x].logical == logical) {
-			/* Entry found.  Update it's physical mapping */
+	uint16_t index;
 
-			dev->sCache[x].physical = physical;
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+	if (physical != 0xFFFF) {
+		smart_summary_add(dev, logical, physical);
+	}
+#endif
 
-			/* If we are freeing a sector, then remove the logical entry from
-			   the cache.
+	index = smart_cache_find(dev, logical);
+	if (index != 0xFFFF) {
+		if (physical == 0xFFFF) {
+			/* We are freeing a sector.  Remove the logical entry from the
+			 * cache and return it to the free list.
 			 */
 
-			if (physical == 0xFFFF) {
-				dev->sCache[x].logical = dev->sCache[dev->cache_entries - 1].logical;
-				dev->sCache[x].physical = dev->sCache[dev->cache_entries - 1].physical;
-				dev->cache_entries--;
-			}
+			smart_cache_unlink(dev, index);
+			dev->sCache[index].next = dev->cache_free;
+			dev->cache_free = index;
+		} else {
+			/* Entry found.  Update it's physical mapping */
 
-			if (dev->debuglevel > 1) {
-				dbg("Update Cache:  Log=%d, Phys=%d at index %d\n", logical, physical, x);
-			}
+			dev->sCache[index].physical = physical;
+		}
 
-			break;
+		if (dev->debuglevel > 1) {
+			dbg("Update Cache:  Log=%d, Phys=%d at index %d\n", logical, physical, index);
 		}
 	}
 
@@ -1633,50 +2000,609 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev, uint16_t block,
 		 * to keep track of the number of times this has happened.
 		 */
 
-		level = 15;
-		dev->uneven_wearcount++;
+		level = 15;
+		dev->uneven_wearcount++;
+	}
+
+	bits = gWearLevelToBitMap4[level];
+
+	if (block & 0x01) {
+		/* Use the upper nibble */
+
+		dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] &= 0x0F;
+		dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] |= bits << 4;
+	} else {
+		/* Use the lower nibble */
+
+		dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] &= 0xF0;
+		dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] |= bits;
+	}
+
+	/* Mark wear bits as dirty */
+
+	dev->wearflags |= SMART_WEARFLAGS_WRITE_NEEDED;
+
+	/* Test if min / max need to be updated */
+
+	if (oldlevel + 1 == level) {
+		/* Test if max needs to be updated */
+
+		if (level > dev->maxwearlevel) {
+			dev->maxwearlevel = level;
+		}
+
+		/* Test if this was the min level.  If it was, then
+		   we need to rescan for min. */
+
+		if (oldlevel == dev->minwearlevel) {
+			smart_find_wear_minmax(dev);
+
+			if (oldlevel != dev->minwearlevel) {
+				fvdbg("##### New min wear level = %d\n", dev->minwearlevel);
+			}
+		}
+	}
+
+	return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_scan_init
+ *
+ * Description: Resets the sector map and the per erase block free and
+ *              release counts to those of an empty volume before a scan.
+ *
+ ****************************************************************************/
+
+static void smart_scan_init(FAR struct smart_struct_s *dev)
+{
+	int sector;
+	uint16_t prerelease;
+
+	dev->freesectors = dev->availSectPerBlk * dev->geo.neraseblocks;
+	dev->releasesectors = 0;
+
+	/* Initialize the freecount and releasecount arrays */
+
+	for (sector = 0; sector < dev->neraseblocks; sector++) {
+		if (sector == dev->neraseblocks - 1 && dev->totalsectors == 65534) {
+			prerelease = 2;
+		} else {
+			prerelease = 0;
+		}
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+		smart_set_count(dev, dev->freecount, sector, dev->availSectPerBlk - prerelease);
+		smart_set_count(dev, dev->releasecount, sector, prerelease);
+#else
+		dev->freecount[sector] = dev->availSectPerBlk - prerelease;
+		dev->releasecount[sector] = prerelease;
+#endif
+	}
+
+	/* Initialize the sector map */
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+	for (sector = 0; sector < dev->totalsectors; sector++) {
+		dev->sMap[sector] = -1;
+	}
+#else
+	/* Clear all logical sector used bits */
+
+	memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+#endif
+}
+
+/****************************************************************************
+ * Name: smart_scan_format
+ *
+ * Description: Reads the format information from the logical sector zero
+ *              found at the given read address.
+ *
+ ****************************************************************************/
+
+static int smart_scan_format(FAR struct smart_struct_s *dev, uint32_t readaddress)
+{
+	int ret;
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	int x;
+	char devname[22];
+	FAR struct smart_multiroot_device_s *rootdirdev;
+#endif
+
+	/* Read the sector data */
+
+	ret = MTD_READ(dev->mtd, readaddress, 32, (FAR uint8_t *)dev->rwbuffer);
+	if (ret != 32) {
+		fdbg("Error reading physical sector %d.\n", readaddress / (dev->mtdBlksPerSector * dev->geo.blocksize));
+		return -EIO;
+	}
+
+	dev->formatstatus = SMART_FMT_STAT_FORMATTED;
+	dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
+	dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
+
+	/* If rootdirentries is greater than 1, then we need to register
+	 * additional block devices.
+	 */
+
+	for (x = 1; x < dev->rootdirentries; x++) {
+		if (dev->partname[0] != '\0') {
+			snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d", dev->minor, dev->partname, x + 1);
+		} else {
+			snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor, x + 1);
+		}
+
+		/* Inode private data is a reference to a struct containing
+		 * the SMART device structure and the root directory number.
+		 */
+
+		rootdirdev = (struct smart_multiroot_device_s *)smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
+		if (rootdirdev == NULL) {
+			fdbg("Memory alloc failed\n");
+			return -ENOMEM;
+		}
+
+		/* Populate the rootdirdev */
+
+		rootdirdev->dev = dev;
+		rootdirdev->rootdirnum = x;
+		ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
+
+		/* Inode private data is a reference to the SMART device structure */
+
+		ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
+	}
+#endif
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_init
+ *
+ * Description: Reserves the sector map checkpoint area at the end of the
+ *              MTD device.  The area is removed from the device geometry,
+ *              so this must be called before the sector size is set.  The
+ *              slots are sized for a map of CONFIG_MTD_SMART_SECTOR_SIZE
+ *              sectors; the area is not reserved if it would take more than
+ *              a quarter of the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_init(FAR struct smart_struct_s *dev)
+{
+	uint32_t erasesize;
+	uint32_t nsectors;
+	uint32_t slotsize;
+	uint32_t slotblocks;
+
+	dev->ckpt_slot = SMART_CKPT_NOSLOT;
+	dev->ckpt_slotblocks = 0;
+	dev->ckpt_nlog = 0;
+	dev->ckpt_writes = 0;
+	dev->ckpt_seq = 0;
+
+	erasesize = dev->geo.erasesize;
+	if (erasesize == 0) {
+		erasesize = 262144;
+	}
+
+	if (erasesize / CONFIG_MTD_SMART_SECTOR_SIZE == 0 || erasesize / CONFIG_MTD_SMART_SECTOR_SIZE > 256) {
+		/* Leave the geometry error to be reported by the format / scan */
+
+		return OK;
+	}
+
+	nsectors = dev->geo.neraseblocks * (erasesize / CONFIG_MTD_SMART_SECTOR_SIZE);
+	if (nsectors > 65534) {
+		nsectors = 65534;
+	}
+
+	/* Header block, sector map and counts, then the dirty block log */
+
+	slotsize = dev->geo.blocksize;
+	slotsize += (nsectors * sizeof(uint16_t) + (dev->geo.neraseblocks << 1) + dev->geo.blocksize - 1) / dev->geo.blocksize * dev->geo.blocksize;
+	slotsize += dev->geo.neraseblocks * sizeof(uint16_t);
+	slotblocks = (slotsize + erasesize - 1) / erasesize;
+
+	if (SMART_CKPT_NSLOTS * slotblocks * 4 > dev->geo.neraseblocks) {
+		fdbg("Device too small for a sector map checkpoint\n");
+		return OK;
+	}
+
+	dev->ckpt_dirty = (FAR uint8_t *)smart_malloc(dev, (dev->geo.neraseblocks + 7) >> 3, "Checkpoint log");
+	if (dev->ckpt_dirty == NULL) {
+		return -ENOMEM;
+	}
+
+	memset(dev->ckpt_dirty, 0, (dev->geo.neraseblocks + 7) >> 3);
+	dev->geo.neraseblocks -= SMART_CKPT_NSLOTS * slotblocks;
+	dev->ckpt_firstblock = dev->geo.neraseblocks;
+	dev->ckpt_slotblocks = slotblocks;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_datalen / smart_ckpt_logoffset / smart_ckpt_slotaddr
+ *
+ * Description: Layout of a checkpoint slot for the current geometry.  The
+ *              sector map is followed by the release and free counts in
+ *              the same allocation, so they are saved as one buffer.
+ *
+ ****************************************************************************/
+
+static inline uint32_t smart_ckpt_datalen(FAR struct smart_struct_s *dev)
+{
+	return dev->totalsectors * sizeof(uint16_t) + (dev->neraseblocks << 1);
+}
+
+static inline uint32_t smart_ckpt_logoffset(FAR struct smart_struct_s *dev)
+{
+	return dev->geo.blocksize + (smart_ckpt_datalen(dev) + dev->geo.blocksize - 1) / dev->geo.blocksize * dev->geo.blocksize;
+}
+
+static inline uint32_t smart_ckpt_slotaddr(FAR struct smart_struct_s *dev, uint8_t slot)
+{
+	return (dev->ckpt_firstblock + slot * dev->ckpt_slotblocks) * dev->erasesize;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_retire
+ *
+ * Description: Invalidates the checkpoint in a slot by programming the
+ *              first byte of its signature.  The rest of the header stays
+ *              readable, so its sequence number still counts for the slot
+ *              rotation.
+ *
+ ****************************************************************************/
+
+static void smart_ckpt_retire(FAR struct smart_struct_s *dev, uint8_t slot)
+{
+	uint8_t byte = SMART_CKPT_RETIRED;
+
+	if (smart_bytewrite(dev, smart_ckpt_slotaddr(dev, slot), 1, &byte) != 1) {
+		fdbg("Error retiring checkpoint slot %d\n", slot);
+	}
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_touch
+ *
+ * Description: Called before an erase block is written or erased.  The
+ *              first time a block is modified after a checkpoint, its
+ *              number is appended to the checkpoint's dirty block log so
+ *              the next mount rescans it.  The log holds one entry per
+ *              erase block, so it can't overflow.
+ *
+ ****************************************************************************/
+
+static void smart_ckpt_touch(FAR struct smart_struct_s *dev, uint16_t block)
+{
+	uint16_t entry;
+	uint32_t offset;
+
+	if (dev->ckpt_slot == SMART_CKPT_NOSLOT || block >= dev->geo.neraseblocks) {
+		return;
+	}
+
+	if (dev->ckpt_dirty[block >> 3] & (1 << (block & 0x07))) {
+		return;
+	}
+
+	offset = smart_ckpt_slotaddr(dev, dev->ckpt_slot) + smart_ckpt_logoffset(dev) + dev->ckpt_nlog * sizeof(uint16_t);
+	entry = block ^ SMART_CKPT_LOG_MASK;
+	if (smart_bytewrite(dev, offset, sizeof(uint16_t), (FAR const uint8_t *)&entry) != sizeof(uint16_t)) {
+		/* We can't track this modification.  Drop the checkpoint so the
+		 * next mount does a full scan.
+		 */
+
+		fdbg("Error logging erase block %d\n", block);
+		smart_ckpt_retire(dev, dev->ckpt_slot);
+		dev->ckpt_slot = SMART_CKPT_NOSLOT;
+		return;
+	}
+
+	dev->ckpt_dirty[block >> 3] |= 1 << (block & 0x07);
+	dev->ckpt_nlog++;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_write
+ *
+ * Description: Saves the sector map and the free / release counts to the
+ *              next checkpoint slot.  The header is written last, so a
+ *              slot without a valid header is never used.  The previously
+ *              active slot is retired once the new one is complete.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_write(FAR struct smart_struct_s *dev)
+{
+	FAR struct smart_ckpt_header_s *header;
+	uint32_t datalen;
+	uint32_t blksPerErase;
+	uint32_t startblock;
+	uint32_t nblocks;
+	uint8_t slot;
+	int ret;
+
+	if (dev->ckpt_slotblocks == 0 || dev->formatstatus != SMART_FMT_STAT_FORMATTED) {
+		return OK;
+	}
+
+	datalen = smart_ckpt_datalen(dev);
+	if (smart_ckpt_logoffset(dev) + (dev->neraseblocks << 1) > dev->ckpt_slotblocks * dev->erasesize) {
+		/* The volume's sector size is smaller than the area was sized for */
+
+		return -ENOSPC;
+	}
+
+	/* Take the slots in turn so that each is erased only once every
+	 * SMART_CKPT_NSLOTS checkpoints.  The slot follows from the sequence
+	 * number, so the rotation carries on across mounts and full scans.
+	 */
+
+	slot = (dev->ckpt_seq + 1) % SMART_CKPT_NSLOTS;
+	if (slot == dev->ckpt_slot) {
+		slot = (slot + 1) % SMART_CKPT_NSLOTS;
+	}
+
+	blksPerErase = dev->erasesize / dev->geo.blocksize;
+	startblock = (dev->ckpt_firstblock + slot * dev->ckpt_slotblocks) * blksPerErase;
+
+	ret = MTD_ERASE(dev->mtd, dev->ckpt_firstblock + slot * dev->ckpt_slotblocks, dev->ckpt_slotblocks);
+	if (ret < 0) {
+		fdbg("Error %d erasing checkpoint slot %d\n", -ret, slot);
+		return ret;
+	}
+
+	/* Write the map and counts.  The last partial block is staged through
+	 * the read/write buffer.
+	 */
+
+	nblocks = datalen / dev->geo.blocksize;
+	if (nblocks > 0) {
+		ret = MTD_BWRITE(dev->mtd, startblock + 1, nblocks, (FAR uint8_t *)dev->sMap);
+		if (ret != nblocks) {
+			goto errout;
+		}
+	}
+
+	if (datalen > nblocks * dev->geo.blocksize) {
+		memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+		memcpy(dev->rwbuffer, (FAR uint8_t *)dev->sMap + nblocks * dev->geo.blocksize, datalen - nblocks * dev->geo.blocksize);
+		ret = MTD_BWRITE(dev->mtd, startblock + 1 + nblocks, 1, (FAR uint8_t *)dev->rwbuffer);
+		if (ret != 1) {
+			goto errout;
+		}
+	}
+
+	/* Now commit the slot by writing its header */
+
+	memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+	header = (FAR struct smart_ckpt_header_s *)dev->rwbuffer;
+	header->signature[0] = SMART_CKPT_SIG1;
+	header->signature[1] = SMART_CKPT_SIG2;
+	header->signature[2] = SMART_CKPT_SIG3;
+	header->signature[3] = SMART_CKPT_SIG4;
+	header->seq = dev->ckpt_seq + 1;
+	header->datalen = datalen;
+	header->datacrc = crc32((FAR const uint8_t *)dev->sMap, datalen);
+	header->sectorsize = dev->sectorsize;
+	header->totalsectors = dev->totalsectors;
+	header->neraseblocks = dev->neraseblocks;
+	header->reserved = 0;
+	header->crc = crc32((FAR const uint8_t *)header, offsetof(struct smart_ckpt_header_s, crc));
+
+	ret = MTD_BWRITE(dev->mtd, startblock, 1, (FAR uint8_t *)dev->rwbuffer);
+	if (ret != 1) {
+		goto errout;
+	}
+
+	if (dev->ckpt_slot != SMART_CKPT_NOSLOT) {
+		smart_ckpt_retire(dev, dev->ckpt_slot);
+	}
+
+	dev->ckpt_slot = slot;
+	dev->ckpt_seq++;
+	dev->ckpt_nlog = 0;
+	dev->ckpt_writes = 0;
+	memset(dev->ckpt_dirty, 0, (dev->neraseblocks + 7) >> 3);
+	return OK;
+
+errout:
+	fdbg("Error %d writing checkpoint slot %d\n", ret, slot);
+	return ret < 0 ? ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_load
+ *
+ * Description: Restores the sector map and counts from the newest valid
+ *              checkpoint and reads its dirty block log.  The sequence
+ *              number of the newest header, retired or not, is kept for
+ *              the slot rotation.  The map entries
+ *              and counts of the logged erase blocks are reset so that the
+ *              scan can rebuild them.  On failure the map and counts are
+ *              reset for a full scan.
+ *
+ ****************************************************************************/
+
+static int smart_ckpt_load(FAR struct smart_struct_s *dev)
+{
+	struct smart_ckpt_header_s header;
+	FAR uint16_t *log;
+	uint32_t datalen;
+	uint32_t seq = 0;
+	uint32_t addr;
+	uint16_t perread;
+	uint16_t entry;
+	uint16_t block;
+	uint16_t prerelease;
+	uint16_t count;
+	int sector;
+	int ret;
+	uint8_t slot;
+	uint8_t best = SMART_CKPT_NOSLOT;
+	bool retired;
+
+	dev->ckpt_slot = SMART_CKPT_NOSLOT;
+	dev->ckpt_nlog = 0;
+	dev->ckpt_writes = 0;
+	dev->ckpt_seq = 0;
+	if (dev->ckpt_slotblocks == 0) {
+		return -ENOENT;
+	}
+
+	datalen = smart_ckpt_datalen(dev);
+	if (smart_ckpt_logoffset(dev) + (dev->neraseblocks << 1) > dev->ckpt_slotblocks * dev->erasesize) {
+		return -ENOSPC;
+	}
+
+	/* Find the newest slot with a valid header for this geometry */
+
+	for (slot = 0; slot < SMART_CKPT_NSLOTS; slot++) {
+		ret = MTD_READ(dev->mtd, smart_ckpt_slotaddr(dev, slot), sizeof(header), (FAR uint8_t *)&header);
+		if (ret != sizeof(header)) {
+			continue;
+		}
+
+		retired = header.signature[0] == SMART_CKPT_RETIRED;
+		if (retired) {
+			header.signature[0] = SMART_CKPT_SIG1;
+		}
+
+		if (header.signature[0] != SMART_CKPT_SIG1 || header.signature[1] != SMART_CKPT_SIG2 || header.signature[2] != SMART_CKPT_SIG3 || header.signature[3] != SMART_CKPT_SIG4 || header.crc != crc32((FAR const uint8_t *)&header, offsetof(struct smart_ckpt_header_s, crc))) {
+			continue;
+		}
+
+		if (header.seq > dev->ckpt_seq) {
+			dev->ckpt_seq = header.seq;
+		}
+
+		if (retired) {
+			continue;
+		}
+
+		if (header.sectorsize != dev->sectorsize || header.totalsectors != dev->totalsectors || header.neraseblocks != dev->neraseblocks || header.datalen != datalen) {
+			continue;
+		}
+
+		if (best == SMART_CKPT_NOSLOT || header.seq > seq) {
+			best = slot;
+			seq = header.seq;
+		}
 	}
 
-	bits = gWearLevelToBitMap4[level];
+	if (best == SMART_CKPT_NOSLOT) {
+		return -ENOENT;
+	}
 
-	if (block & 0x01) {
-		/* Use the upper nibble */
+	/* Read the map and counts.  A newer slot that fails its CRC can't fall
+	 * back to an older one, whose log stopped when the newer was written.
+	 */
 
-		dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] &= 0x0F;
-		dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] |= bits << 4;
-	} else {
-		/* Use the lower nibble */
+	addr = smart_ckpt_slotaddr(dev, best);
+	ret = MTD_READ(dev->mtd, addr, sizeof(header), (FAR uint8_t *)&header);
+	if (ret != sizeof(header)) {
+		goto errout;
+	}
 
-		dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] &= 0xF0;
-		dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] |= bits;
+	ret = MTD_READ(dev->mtd, addr + dev->geo.blocksize, datalen, (FAR uint8_t *)dev->sMap);
+	if (ret != datalen || crc32((FAR const uint8_t *)dev->sMap, datalen) != header.datacrc) {
+		fdbg("Invalid checkpoint data in slot %d\n", best);
+		goto errout;
 	}
 
-	/* Mark wear bits as dirty */
+	/* Read the dirty block log up to the first erased entry */
 
-	dev->wearflags |= SMART_WEARFLAGS_WRITE_NEEDED;
+	memset(dev->ckpt_dirty, 0, (dev->neraseblocks + 7) >> 3);
+	log = (FAR uint16_t *)dev->rwbuffer;
+	perread = dev->sectorsize / sizeof(uint16_t);
+	addr += smart_ckpt_logoffset(dev);
 
-	/* Test if min / max need to be updated */
+	for (count = 0; count < dev->neraseblocks; count++) {
+		if ((count % perread) == 0) {
+			entry = dev->neraseblocks - count < perread ? dev->neraseblocks - count : perread;
+			ret = MTD_READ(dev->mtd, addr + count * sizeof(uint16_t), entry * sizeof(uint16_t), (FAR uint8_t *)log);
+			if (ret != entry * sizeof(uint16_t)) {
+				goto errout;
+			}
+		}
 
-	if (oldlevel + 1 == level) {
-		/* Test if max needs to be updated */
+		entry = log[count % perread];
+		if (entry == SMART_CKPT_LOG_ERASED) {
+			break;
+		}
 
-		if (level > dev->maxwearlevel) {
-			dev->maxwearlevel = level;
+		block = entry ^ SMART_CKPT_LOG_MASK;
+		if (block >= dev->neraseblocks) {
+			fdbg("Invalid checkpoint log entry %04x\n", entry);
+			goto errout;
 		}
 
-		/* Test if this was the min level.  If it was, then
-		   we need to rescan for min. */
+		dev->ckpt_dirty[block >> 3] |= 1 << (block & 0x07);
+	}
 
-		if (oldlevel == dev->minwearlevel) {
-			smart_find_wear_minmax(dev);
+	/* Forget the map entries that point into the logged blocks */
 
-			if (oldlevel != dev->minwearlevel) {
-				fvdbg("##### New min wear level = %d\n", dev->minwearlevel);
+	for (sector = 0; sector < dev->totalsectors; sector++) {
+		if (dev->sMap[sector] != 0xFFFF) {
+			block = dev->sMap[sector] / dev->sectorsPerBlk;
+			if (dev->ckpt_dirty[block >> 3] & (1 << (block & 0x07))) {
+				dev->sMap[sector] = 0xFFFF;
 			}
 		}
 	}
 
-	return 0;
+	/* Reset the counts of the logged blocks and total the free and
+	 * released sectors the same way a full scan would.
+	 */
+
+	dev->freesectors = dev->availSectPerBlk * dev->geo.neraseblocks;
+	dev->releasesectors = 0;
+
+	for (block = 0; block < dev->neraseblocks; block++) {
+		if (block == dev->neraseblocks - 1 && dev->totalsectors == 65534) {
+			prerelease = 2;
+		} else {
+			prerelease = 0;
+		}
+
+		if (dev->ckpt_dirty[block >> 3] & (1 << (block & 0x07))) {
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+			smart_set_count(dev, dev->freecount, block, dev->availSectPerBlk - prerelease);
+			smart_set_count(dev, dev->releasecount, block, prerelease);
+#else
+			dev->freecount[block] = dev->availSectPerBlk - prerelease;
+			dev->releasecount[block] = prerelease;
+#endif
+			continue;
+		}
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+		dev->freesectors -= dev->availSectPerBlk - prerelease - smart_get_count(dev, dev->freecount, block);
+		dev->releasesectors += smart_get_count(dev, dev->releasecount, block) - prerelease;
+#else
+		dev->freesectors -= dev->availSectPerBlk - prerelease - dev->freecount[block];
+		dev->releasesectors += dev->releasecount[block] - prerelease;
+#endif
+	}
+
+	dev->ckpt_slot = best;
+	dev->ckpt_nlog = count;
+	fvdbg("Restored checkpoint %d from slot %d, %d dirty blocks\n", seq, best, count);
+	return OK;
+
+errout:
+	smart_scan_init(dev);
+	return -EIO;
 }
 #endif
 
@@ -1694,7 +2620,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	int sector;
 	int ret;
 	uint16_t totalsectors;
-	uint16_t sectorsize, prerelease;
+	uint16_t sectorsize;
 	uint16_t logicalsector;
 	uint16_t loser;
 	uint32_t readaddress;
@@ -1708,10 +2634,8 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	int dupsector;
 	uint16_t duplogsector;
 #endif
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-	int x;
-	char devname[22];
-	FAR struct smart_multiroot_device_s *rootdirdev;
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	bool restored;
 #endif
 
 	fvdbg("Entry\n");
@@ -1771,37 +2695,14 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #endif
 
 	dev->formatstatus = SMART_FMT_STAT_NOFMT;
-	dev->freesectors = dev->availSectPerBlk * dev->geo.neraseblocks;
-	dev->releasesectors = 0;
-
-	/* Initialize the freecount and releasecount arrays */
-
-	for (sector = 0; sector < dev->neraseblocks; sector++) {
-		if (sector == dev->neraseblocks - 1 && dev->totalsectors == 65534) {
-			prerelease = 2;
-		} else {
-			prerelease = 0;
-		}
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-		smart_set_count(dev, dev->freecount, sector, dev->availSectPerBlk - prerelease);
-		smart_set_count(dev, dev->releasecount, sector, prerelease);
-#else
-		dev->freecount[sector] = dev->availSectPerBlk - prerelease;
-		dev->releasecount[sector] = prerelease;
-#endif
-	}
-
-	/* Initialize the sector map */
+	smart_scan_init(dev);
 
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-	for (sector = 0; sector < totalsectors; sector++) {
-		dev->sMap[sector] = -1;
-	}
-#else
-	/* Clear all logical sector used bits */
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* Try to restore the map and counts from the last checkpoint.  Only the
+	 * erase blocks modified since it was taken must then be scanned.
+	 */
 
-	memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+	restored = smart_ckpt_load(dev) == OK;
 #endif
 
 	/* Now scan the MTD device */
@@ -1813,6 +2714,17 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	}
 
 	for (sector = 0; sector < totalsectors; sector++) {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		/* Erase blocks that weren't modified since the checkpoint keep
+		 * their restored map entries and counts.
+		 */
+
+		if (restored && (sector % dev->sectorsPerBlk) == 0 && !(dev->ckpt_dirty[(sector / dev->sectorsPerBlk) >> 3] & (1 << ((sector / dev->sectorsPerBlk) & 0x07)))) {
+			sector += dev->sectorsPerBlk - 1;
+			continue;
+		}
+#endif
+
 		fvdbg("Scan sector %d\n", sector);
 
 		/* Calculate the read address for this sector */
@@ -1958,54 +2870,10 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		 */
 
 		if (logicalsector == 0) {
-			/* Read the sector data */
-
-			ret = MTD_READ(dev->mtd, readaddress, 32, (FAR uint8_t *)dev->rwbuffer);
-			if (ret != 32) {
-				fdbg("Error reading physical sector %d.\n", sector);
+			ret = smart_scan_format(dev, readaddress);
+			if (ret != OK) {
 				goto err_out;
 			}
-
-			dev->formatstatus = SMART_FMT_STAT_FORMATTED;
-			dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
-			dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
-
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-			dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
-
-			/* If rootdirentries is greater than 1, then we need to register
-			 * additional block devices.
-			 */
-
-			for (x = 1; x < dev->rootdirentries; x++) {
-				if (dev->partname[0] != '\0') {
-					snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d", dev->minor, dev->partname, x + 1);
-				} else {
-					snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor, x + 1);
-				}
-
-				/* Inode private data is a reference to a struct containing
-				 * the SMART device structure and the root directory number.
-				 */
-
-				rootdirdev = (struct smart_multiroot_device_s *)smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
-				if (rootdirdev == NULL) {
-					fdbg("Memory alloc failed\n");
-					ret = -ENOMEM;
-					goto err_out;
-				}
-
-				/* Populate the rootdirdev */
-
-				rootdirdev->dev = dev;
-				rootdirdev->rootdirnum = x;
-				ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
-
-				/* Inode private data is a reference to the SMART device structure */
-
-				ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
-			}
-#endif
 		}
 
 		/* Test for duplicate logical sectors on the device */
@@ -2147,8 +3015,26 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		if (logicalsector < dev->reservedsector) {
 			smart_add_sector_to_cache(dev, logicalsector, sector, __LINE__);
 		}
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+		else {
+			smart_summary_add(dev, logicalsector, sector);
+		}
 #endif
+#endif
+	}
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* If the format sector lives in an erase block that wasn't scanned,
+	 * read the format information from its restored location.
+	 */
+
+	if (restored && dev->formatstatus != SMART_FMT_STAT_FORMATTED && dev->sMap[0] != 0xFFFF) {
+		ret = smart_scan_format(dev, dev->sMap[0] * dev->mtdBlksPerSector * dev->geo.blocksize);
+		if (ret != OK) {
+			goto err_out;
+		}
 	}
+#endif
 
 #if defined(CONFIG_MTD_SMART_WEAR_LEVEL) && (SMART_STATUS_VERSION == 1)
 #ifdef CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT
@@ -2220,6 +3106,16 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	smart_read_wearstatus(dev);
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* Take a checkpoint after a full scan so that the next mount is fast
+	 * even if the volume isn't cleanly unmounted.
+	 */
+
+	if (!restored) {
+		smart_ckpt_write(dev);
+	}
+#endif
+
 	fdbg("SMART Scan\n");
 	fdbg("   Erase size:   %10d\n", dev->sectorsPerBlk * dev->sectorsize);
 	fdbg("   Erase count:  %10d\n", dev->neraseblocks);
@@ -2331,12 +3227,30 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev, uint16_t
 #endif
 
 	if ((freecount + releasecount == dev->availSectPerBlk && freecount < 1) || forceerase) {
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+		/* Leave the erase to the background worker while the write path
+		 * still has more than the inline collection reserve to allocate from.
+		 */
+
+		if (!forceerase && dev->freesectors > SMART_GC_RESERVE(dev)) {
+			dev->gcstats.deferred++;
+			smart_gc_kick(dev);
+			return;
+		}
+#endif
+
 		/* Erase the block */
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 		dev->unusedsectors += freecount;
 		dev->blockerases++;
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		smart_ckpt_touch(dev, block);
 #endif
 		MTD_ERASE(dev->mtd, block, 1);
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+		smart_summary_clear(dev, block);
+#endif
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 		if (dev->erasecounts) {
@@ -2780,6 +3694,14 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 		return ret;
 	}
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* The bulk erase also erased the checkpoint area */
+
+	dev->ckpt_slot = SMART_CKPT_NOSLOT;
+	dev->ckpt_nlog = 0;
+	dev->ckpt_writes = 0;
+#endif
+
 	/* Now construct a logical sector zero header to write to the device. */
 
 	sectorheader = (FAR struct smart_sect_header_s *)dev->rwbuffer;
@@ -2910,6 +3832,10 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 
 		dev->sMap[x] = -1;
 	}
+#else
+	memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+	dev->sBitMap[0] |= 0x01;
+	smart_add_sector_to_cache(dev, 0, 0, __LINE__);
 #endif
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -2996,6 +3922,9 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev, uint16_t oldsec
 
 	/* Write the data to the new physical sector location */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	smart_ckpt_touch(dev, newsector / dev->sectorsPerBlk);
+#endif
 	ret = MTD_BWRITE(dev->mtd, newsector * dev->mtdBlksPerSector, dev->mtdBlksPerSector, (FAR uint8_t *)dev->rwbuffer);
 
 #else							/* CONFIG_MTD_SMART_ENABLE_CRC */
@@ -3008,6 +3937,9 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev, uint16_t oldsec
 
 	/* Write the data to the new physical sector location */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	smart_ckpt_touch(dev, newsector / dev->sectorsPerBlk);
+#endif
 	ret = MTD_BWRITE(dev->mtd, newsector * dev->mtdBlksPerSector, dev->mtdBlksPerSector, (FAR uint8_t *)dev->rwbuffer);
 
 	/* Commit the sector */
@@ -3220,7 +4152,13 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 
 	/* Now erase the erase block */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	smart_ckpt_touch(dev, block);
+#endif
 	MTD_ERASE(dev->mtd, block, 1);
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+	smart_summary_clear(dev, block);
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 	dev->unusedsectors += freecount;
 	dev->blockerases++;
@@ -3505,6 +4443,52 @@ retry:
 	return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_gc_findblock
+ *
+ * Description:  Returns the erase block with the most released sectors, or
+ *               0xFFFF if no block has any.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static uint16_t smart_gc_findblock(FAR struct smart_struct_s *dev)
+{
+	uint16_t collectblock;
+	uint16_t releasemax;
+	int x;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+	uint8_t count;
+#endif
+
+	collectblock = 0xFFFF;
+	releasemax = 0;
+	for (x = 0; x < dev->neraseblocks; x++) {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		/* Don't collect blocks that have been worn completely */
+
+		if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
+			continue;
+		}
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+		count = smart_get_count(dev, dev->releasecount, x);
+		if (count > releasemax) {
+			releasemax = count;
+			collectblock = x;
+		}
+#else
+		if (dev->releasecount[x] > releasemax) {
+			releasemax = dev->releasecount[x];
+			collectblock = x;
+		}
+#endif
+	}
+
+	return collectblock;
+}
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -3514,21 +4498,16 @@ retry:
  *
  ****************************************************************************/
 
-#ifdef CONFIG_FS_WRITABLE
 static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 {
 	uint16_t collectblock;
-	uint16_t releasemax;
 	bool collect = TRUE;
-	int x;
 	int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-	uint8_t count;
-#endif
 
 	while (collect) {
 		collect = FALSE;
 
+#ifndef CONFIG_MTD_SMART_BACKGROUND_GC
 		/* Test if the released sectors count is greater than the
 		 * free sectors.  If it is, then we will do garbage collection.
 		 */
@@ -3536,6 +4515,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 		if (dev->releasesectors > dev->freesectors && dev->freesectors < (dev->totalsectors >> 5)) {
 			collect = TRUE;
 		}
+#endif
 
 		/* Test if we have more reached our reserved free sector limit */
 
@@ -3548,71 +4528,152 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 		if (collect) {
 			/* Find the block with the most released sectors */
 
-			collectblock = 0xFFFF;
-			releasemax = 0;
-			for (x = 0; x < dev->neraseblocks; x++) {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-				/* Don't collect blocks that have been worn completely */
+			collectblock = smart_gc_findblock(dev);
+			if (collectblock == 0xFFFF) {
+				/* Need to collect, but no sectors with released blocks! */
 
-				if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
-					continue;
-				}
+				ret = -ENOSPC;
+				goto errout;
+			}
+#ifdef CONFIG_SMART_LOCAL_CHECKFREE
+			if (smart_checkfree(dev, __LINE__) != OK) {
+				fdbg("   ...before collecting block %d\n", collectblock);
+			}
 #endif
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-				count = smart_get_count(dev, dev->releasecount, x);
-				if (count > releasemax) {
-					releasemax = count;
-					collectblock = x;
-				}
+			fvdbg("Collecting block %d, free=%d released=%d, totalfree=%d, totalrelease=%d\n", collectblock, smart_get_count(dev, dev->freecount, collectblock), smart_get_count(dev, dev->releasecount, collectblock), dev->freesectors, dev->releasesectors);
 #else
-				if (dev->releasecount[x] > releasemax) {
-					releasemax = dev->releasecount[x];
-					collectblock = x;
-				}
+			fvdbg("Collecting block %d, free=%d released=%d\n", collectblock, dev->freecount[collectblock], dev->releasecount[collectblock]);
 #endif
-			}
-			//releasemax = smart_get_count(dev, dev->releasecount, collectblock);
 
-			if (collectblock == 0xFFFF) {
-				/* Need to collect, but no sectors with released blocks! */
+			/* Relocate the active data in the collection block */
+
+			ret = smart_relocate_block(dev, collectblock);
 
-				ret = -ENOSPC;
-				goto errout;
-			}
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
 			if (smart_checkfree(dev, __LINE__) != OK) {
-				fdbg("   ...before collecting block %d\n", collectblock);
+				fdbg("   ...while collecting block %d\n", collectblock);
+			}
+#endif
+
+			if (ret != OK) {
+				goto errout;
 			}
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+			dev->gcstats.inlinegc++;
 #endif
+		}
+	}
+
+	ret = OK;
+
+errout:
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	/* Let the worker refill the pool of erased sectors */
+
+	smart_gc_kick(dev);
+#endif
+	return ret;
+}
+
+/****************************************************************************
+ * Name: smart_gc_poolshort
+ *
+ * Description:  Tests if the background worker has collection to do.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static bool smart_gc_poolshort(FAR struct smart_struct_s *dev)
+{
+	if (dev->formatstatus != SMART_FMT_STAT_FORMATTED || dev->releasesectors == 0) {
+		return false;
+	}
+
+	if (dev->freesectors < SMART_GC_TARGET(dev)) {
+		return true;
+	}
+
+	/* Also collect once released sectors outnumber the free ones on a
+	 * nearly full volume, as inline collection does without the worker.
+	 */
+
+	return dev->releasesectors > dev->freesectors && dev->freesectors < (dev->totalsectors >> 5);
+}
+
+/****************************************************************************
+ * Name: smart_gc_worker
+ *
+ * Description:  Background garbage collection.  Relocates or erases one
+ *               erase block per pass and requeues itself until the pool
+ *               of erased sectors is refilled.
+ *
+ ****************************************************************************/
+
+static void smart_gc_worker(FAR void *arg)
+{
+	FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+	uint16_t block;
+	uint16_t live;
+	bool again = false;
 
+	smart_semtake(dev);
+	dev->gcstats.runs++;
+
+	if (smart_gc_poolshort(dev)) {
+		block = smart_gc_findblock(dev);
+		if (block != 0xFFFF) {
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-			fvdbg("Collecting block %d, free=%d released=%d, totalfree=%d, totalrelease=%d\n", collectblock, smart_get_count(dev, dev->freecount, collectblock), smart_get_count(dev, dev->releasecount, collectblock), dev->freesectors, dev->releasesectors);
+			live = dev->availSectPerBlk - smart_get_count(dev, dev->freecount, block) - smart_get_count(dev, dev->releasecount, block);
 #else
-			fvdbg("Collecting block %d, free=%d released=%d\n", collectblock, dev->freecount[collectblock], dev->releasecount[collectblock]);
+			live = dev->availSectPerBlk - dev->freecount[block] - dev->releasecount[block];
 #endif
+			if (smart_relocate_block(dev, block) == OK) {
+				if (live > 0) {
+					dev->gcstats.relocations++;
+				} else {
+					dev->gcstats.erases++;
+				}
 
-			/* Relocate the active data in the collection block */
+				again = smart_gc_poolshort(dev);
+			} else {
+				fdbg("Background collection of block %d failed\n", block);
+			}
+		}
+	}
 
-			ret = smart_relocate_block(dev, collectblock);
+	if (dev->freesectors > SMART_GC_RESERVE(dev)) {
+		dev->gcstats.poolblocks = (dev->freesectors - SMART_GC_RESERVE(dev)) / dev->availSectPerBlk;
+	} else {
+		dev->gcstats.poolblocks = 0;
+	}
 
-#ifdef CONFIG_SMART_LOCAL_CHECKFREE
-			if (smart_checkfree(dev, __LINE__) != OK) {
-				fdbg("   ...while collecting block %d\n", collectblock);
-			}
-#endif
+	/* Give writers a chance to get in between two blocks */
 
-			if (ret != OK) {
-				goto errout;
-			}
-		}
+	if (again) {
+		work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, 0);
 	}
 
-	return OK;
+	smart_semgive(dev);
+}
 
-errout:
-	return ret;
+/****************************************************************************
+ * Name: smart_gc_kick
+ *
+ * Description:  Schedules the background worker if the pool of erased
+ *               sectors needs to be refilled.  Called with the device
+ *               semaphore held.
+ *
+ ****************************************************************************/
+
+static void smart_gc_kick(FAR struct smart_struct_s *dev)
+{
+	if (work_available(&dev->gcwork) && smart_gc_poolshort(dev)) {
+		work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, MSEC2TICK(CONFIG_MTD_SMART_GC_DELAY));
+	}
 }
+#endif							/* CONFIG_MTD_SMART_BACKGROUND_GC */
 #endif							/* CONFIG_FS_WRITABLE */
 
 /****************************************************************************
@@ -3837,23 +4898,17 @@ errout:
 #endif							/* CONFIG_MTD_SMART_WEAR_LEVEL */
 
 /****************************************************************************
- * Name: smart_write_alloc_sector
+ * Name: smart_set_alloc_header
  *
- * Description:  Writes a newly allocated sector's header to the RW buffer
- *               and updates sector mapping variables.  If CRC isn't enabled
- *               it also writes the header to the device.
+ * Description:  Fills in the header of a newly allocated logical sector.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static int smart_write_alloc_sector(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical)
+static void smart_set_alloc_header(FAR struct smart_struct_s *dev, FAR struct smart_sect_header_s *header, uint16_t logical)
 {
-	int ret = 1;
 	uint8_t sectsize;
-	FAR struct smart_sect_header_s *header;
 
-	memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->sectorsize);
-	header = (FAR struct smart_sect_header_s *)dev->rwbuffer;
 	header->logicalsector[0] = (uint8_t)(logical & 0x00FF);
 	header->logicalsector[1] = (uint8_t)(logical >> 8);
 	//*((FAR uint16_t *)header->logicalsector) = logical;
@@ -3883,11 +4938,33 @@ static int smart_write_alloc_sector(FAR struct smart_struct_s *dev, uint16_t log
 	header->status |= SMART_STATUS_CRC;
 #endif							/* CONFIG_MTD_SMART_ENABLE_CRC */
 #endif
+}
+
+/****************************************************************************
+ * Name: smart_write_alloc_sector
+ *
+ * Description:  Writes a newly allocated sector's header to the RW buffer
+ *               and updates sector mapping variables.  If CRC isn't enabled
+ *               it also writes the header to the device.
+ *
+ ****************************************************************************/
+
+static int smart_write_alloc_sector(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical)
+{
+	int ret = 1;
+	FAR struct smart_sect_header_s *header;
+
+	memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->sectorsize);
+	header = (FAR struct smart_sect_header_s *)dev->rwbuffer;
+	smart_set_alloc_header(dev, header, logical);
 
 	/* Write the header to the physical sector location */
 
 #ifndef CONFIG_MTD_SMART_ENABLE_CRC
 	fvdbg("Write MTD block %d\n", physical * dev->mtdBlksPerSector);
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	smart_ckpt_touch(dev, physical / dev->sectorsPerBlk);
+#endif
 	ret = MTD_BWRITE(dev->mtd, physical * dev->mtdBlksPerSector, 1, (FAR uint8_t *)dev->rwbuffer);
 	if (ret != 1) {
 		/* The block is not empty!!  What to do? */
@@ -4216,6 +5293,9 @@ relocate_good_sector:
 	if (needsrelocate) {
 		/* Write the entire sector to the new physical location, uncommitted. */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		smart_ckpt_touch(dev, physsector / dev->sectorsPerBlk);
+#endif
 		ret = MTD_BWRITE(dev->mtd, physsector * dev->mtdBlksPerSector, dev->mtdBlksPerSector, (FAR uint8_t *)dev->rwbuffer);
 		if (ret != dev->mtdBlksPerSector) {
 			fdbg("Error writing to physical sector %d\n", physsector);
@@ -4315,6 +5395,9 @@ relocate_good_sector:
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
 		/* Write the entire sector to FLASH when CRC enabled */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		smart_ckpt_touch(dev, physsector / dev->sectorsPerBlk);
+#endif
 		ret = MTD_BWRITE(dev->mtd, physsector * dev->mtdBlksPerSector, dev->mtdBlksPerSector, (FAR uint8_t *)dev->rwbuffer);
 		if (ret != dev->mtdBlksPerSector) {
 			fdbg("Error writing to physical sector %d\n", physsector);
@@ -4451,6 +5534,282 @@ errout:
 }
 #endif							/* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_findfreerun
+ *
+ * Description:  Finds up to 'count' consecutive free physical sectors inside
+ *               the erase block with the most free sectors.  Returns the
+ *               first physical sector of the run and updates 'count' with
+ *               the length of the run.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MULTI_WRITE
+static uint16_t smart_findfreerun(FAR struct smart_struct_s *dev, FAR uint16_t *count)
+{
+	struct smart_sect_header_s header;
+	uint16_t allocblock;
+	uint16_t allocfree;
+	uint16_t freecount;
+	uint16_t first;
+	uint16_t run;
+	uint16_t x;
+	uint32_t readaddr;
+	int ret;
+
+	/* Pick the erase block with the most free sectors */
+
+	allocblock = 0xFFFF;
+	allocfree = 0;
+	for (x = 0; x < dev->neraseblocks; x++) {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		if (smart_get_wear_level(dev, x) >= SMART_WEAR_FULL_RELOCATE_THRESHOLD) {
+			continue;
+		}
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+		freecount = smart_get_count(dev, dev->freecount, x);
+#else
+		freecount = dev->freecount[x];
+#endif
+		if (freecount > allocfree) {
+			allocfree = freecount;
+			allocblock = x;
+		}
+	}
+
+	if (allocblock == 0xFFFF) {
+		return 0xFFFF;
+	}
+
+	/* Find the first free sector of the block and extend the run while
+	 * the following sectors are free too.
+	 */
+
+	first = 0xFFFF;
+	run = 0;
+	for (x = allocblock * dev->sectorsPerBlk; x < allocblock * dev->sectorsPerBlk + dev->availSectPerBlk && run < *count; x++) {
+		readaddr = x * dev->mtdBlksPerSector * dev->geo.blocksize;
+		ret = MTD_READ(dev->mtd, readaddr, sizeof(struct smart_sect_header_s), (FAR uint8_t *)&header);
+		if (ret != sizeof(struct smart_sect_header_s)) {
+			fdbg("Error reading phys sector %d\n", x);
+			break;
+		}
+
+		if ((UINT8TOUINT16(header.logicalsector) == 0xFFFF) &&
+#if SMART_STATUS_VERSION == 1
+			((header.seq == 0xFF) && (header.crc8 == 0xFF)) &&
+#else
+			(header.seq == CONFIG_SMARTFS_ERASEDSTATE) &&
+#endif
+			(!(SECTOR_IS_COMMITTED(header)))) {
+			if (first == 0xFFFF) {
+				first = x;
+			}
+
+			run++;
+		} else if (first != 0xFFFF) {
+			break;
+		}
+	}
+
+	*count = run;
+	return first;
+}
+
+/****************************************************************************
+ * Name: smart_writemulti
+ *
+ * Description:  Allocates a run of logical sectors in consecutive physical
+ *               sectors and writes them with a single MTD write.  The
+ *               sectors are written uncommitted and committed afterwards,
+ *               so an interrupted request leaves no partial sectors behind.
+ *
+ ****************************************************************************/
+
+static int smart_writemulti(FAR struct smart_struct_s *dev, unsigned long arg)
+{
+	FAR struct smart_multi_write_s *req;
+	FAR struct smart_sect_header_s *header;
+	FAR uint8_t *buffer;
+	FAR uint8_t *sector;
+	uint16_t physsector;
+	uint16_t logsector;
+	uint16_t datalen;
+	uint16_t count;
+	uint16_t x;
+	size_t offset;
+	uint8_t byte;
+	int ret;
+
+	req = (FAR struct smart_multi_write_s *)arg;
+	datalen = dev->sectorsize - sizeof(struct smart_sect_header_s) - req->hdrlen;
+	if (req->hdrlen >= dev->sectorsize - sizeof(struct smart_sect_header_s) || (req->linkoffset != 0xFFFF && req->linkoffset + sizeof(uint16_t) > req->hdrlen)) {
+		return -EINVAL;
+	}
+
+	/* Keep the reserve needed for garbage collection, as allocsector does */
+
+	smart_garbagecollect(dev);
+	count = req->count;
+	if (count > CONFIG_MTD_SMART_MULTI_WRITE_MAX) {
+		count = CONFIG_MTD_SMART_MULTI_WRITE_MAX;
+	}
+
+	if (dev->freesectors <= (dev->sectorsPerBlk << 0) + 4 + count) {
+		return -ENOSPC;
+	}
+
+	/* Find the physical run first, then the logical sectors */
+
+	physsector = smart_findfreerun(dev, &count);
+	if (physsector == 0xFFFF || count == 0) {
+		return -ENOSPC;
+	}
+
+	logsector = dev->reservedsector;
+	for (x = 0; x < count; x++) {
+		for (; logsector < dev->totalsectors; logsector++) {
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+			if (dev->sMap[logsector] == (uint16_t)-1)
+#else
+			if (!(dev->sBitMap[logsector >> 3] & (1 << (logsector & 0x07))))
+#endif
+			{
+				break;
+			}
+		}
+
+		if (logsector >= dev->totalsectors) {
+			break;
+		}
+
+		req->logsectors[x] = logsector++;
+	}
+
+	count = x;
+	if (count == 0) {
+		fdbg("No free logical sector numbers!  Free sectors = %d\n", dev->freesectors);
+		return -EIO;
+	}
+
+	buffer = (FAR uint8_t *)kmm_malloc(count * dev->sectorsize);
+	if (buffer == NULL) {
+		return -ENOMEM;
+	}
+
+	/* Build the whole run in the staging buffer, uncommitted */
+
+	memset(buffer, CONFIG_SMARTFS_ERASEDSTATE, count * dev->sectorsize);
+	for (x = 0; x < count; x++) {
+		sector = &buffer[x * dev->sectorsize];
+		header = (FAR struct smart_sect_header_s *)sector;
+		smart_set_alloc_header(dev, header, req->logsectors[x]);
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+		header->status |= SMART_STATUS_COMMITTED;
+#else
+		header->status &= ~SMART_STATUS_COMMITTED;
+#endif
+
+		sector += sizeof(struct smart_sect_header_s);
+		memcpy(sector, req->hdr, req->hdrlen);
+		if (req->linkoffset != 0xFFFF && x + 1 < count) {
+			sector[req->linkoffset] = (uint8_t)(req->logsectors[x + 1] & 0x00FF);
+			sector[req->linkoffset + 1] = (uint8_t)(req->logsectors[x + 1] >> 8);
+		}
+
+		memcpy(&sector[req->hdrlen], &req->buffer[x * datalen], datalen);
+	}
+
+	/* Program headers and data of the run with one MTD write */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	smart_ckpt_touch(dev, physsector / dev->sectorsPerBlk);
+#endif
+	ret = MTD_BWRITE(dev->mtd, physsector * dev->mtdBlksPerSector, count * dev->mtdBlksPerSector, buffer);
+	if (ret != count * dev->mtdBlksPerSector) {
+		fdbg("Error writing %d sectors at physical sector %d\n", count, physsector);
+
+		/* The run may be partially programmed.  Account it as released so
+		 * garbage collection reclaims it.
+		 */
+
+		ret = -EIO;
+		goto errout_with_release;
+	}
+
+	/* Commit pass */
+
+	for (x = 0; x < count; x++) {
+		header = (FAR struct smart_sect_header_s *)&buffer[x * dev->sectorsize];
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+		byte = header->status & ~SMART_STATUS_COMMITTED;
+#else
+		byte = header->status | SMART_STATUS_COMMITTED;
+#endif
+		offset = (physsector + x) * dev->mtdBlksPerSector * dev->geo.blocksize + offsetof(struct smart_sect_header_s, status);
+		ret = smart_bytewrite(dev, offset, 1, &byte);
+		if (ret != 1) {
+			fdbg("Error committing physical sector %d\n", physsector + x);
+			ret = -EIO;
+			goto errout_with_release;
+		}
+	}
+
+	/* Map the sectors and update the free sector counts */
+
+	for (x = 0; x < count; x++) {
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+		dev->sMap[req->logsectors[x]] = physsector + x;
+#else
+		dev->sBitMap[req->logsectors[x] >> 3] |= (1 << (req->logsectors[x] & 0x07));
+		smart_add_sector_to_cache(dev, req->logsectors[x], physsector + x, __LINE__);
+#endif
+	}
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+	smart_add_count(dev, dev->freecount, physsector / dev->sectorsPerBlk, -count);
+#else
+	dev->freecount[physsector / dev->sectorsPerBlk] -= count;
+#endif
+	dev->freesectors -= count;
+
+	kmm_free(buffer);
+	req->count = count;
+	return count;
+
+errout_with_release:
+	/* Release the whole run.  Sectors that were programmed are marked as
+	 * released on the media so that a rescan agrees with the counts.
+	 */
+
+	for (x = 0; x < count; x++) {
+		header = (FAR struct smart_sect_header_s *)&buffer[x * dev->sectorsize];
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+		byte = header->status & ~(SMART_STATUS_RELEASED | SMART_STATUS_COMMITTED);
+#else
+		byte = header->status | SMART_STATUS_RELEASED | SMART_STATUS_COMMITTED;
+#endif
+		offset = (physsector + x) * dev->mtdBlksPerSector * dev->geo.blocksize + offsetof(struct smart_sect_header_s, status);
+		smart_bytewrite(dev, offset, 1, &byte);
+	}
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+	smart_add_count(dev, dev->freecount, physsector / dev->sectorsPerBlk, -count);
+	smart_add_count(dev, dev->releasecount, physsector / dev->sectorsPerBlk, count);
+#else
+	dev->freecount[physsector / dev->sectorsPerBlk] -= count;
+	dev->releasecount[physsector / dev->sectorsPerBlk] += count;
+#endif
+	dev->freesectors -= count;
+	dev->releasesectors += count;
+
+	kmm_free(buffer);
+	return ret;
+}
+#endif							/* CONFIG_MTD_SMART_MULTI_WRITE */
+
 /****************************************************************************
  * Name: smart_readsector
  *
@@ -4915,6 +6274,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+	smart_semtake(dev);
+
 	/* Process the ioctl's we care about first, pass any we don't respond
 	 * to directly to the underlying MTD device.
 	 */
@@ -4929,7 +6290,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #ifdef CONFIG_DEBUG
 		if (arg == 0) {
 			fdbg("ERROR: BIOC_XIPBASE argument is NULL\n");
-			return -EINVAL;
+			ret = -EINVAL;
+			goto ok_out;
 		}
 #endif
 
@@ -4991,7 +6353,40 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 		}
 #endif
 
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && CONFIG_MTD_SMART_CHECKPOINT_INTERVAL > 0
+		/* Periodically checkpoint the map to bound the mount scan */
+
+		if (ret >= 0 && ++dev->ckpt_writes >= CONFIG_MTD_SMART_CHECKPOINT_INTERVAL) {
+			smart_ckpt_write(dev);
+		}
+#endif
+
+		goto ok_out;
+
+#ifdef CONFIG_MTD_SMART_MULTI_WRITE
+	case BIOC_WRITEMULTI:
+
+		/* Allocate and write a run of chained sectors */
+
+		ret = smart_writemulti(dev, arg);
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED) {
+			smart_write_wearstatus(dev);
+		}
+#endif
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && CONFIG_MTD_SMART_CHECKPOINT_INTERVAL > 0
+		if (ret > 0) {
+			dev->ckpt_writes += ret;
+			if (dev->ckpt_writes >= CONFIG_MTD_SMART_CHECKPOINT_INTERVAL) {
+				smart_ckpt_write(dev);
+			}
+		}
+#endif
+
 		goto ok_out;
+#endif
 #endif							/* CONFIG_FS_WRITABLE */
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
@@ -5061,6 +6456,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	}
 
 ok_out:
+	smart_semgive(dev);
 	return ret;
 }
 
@@ -5111,6 +6507,11 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 		/* Initialize the SMART device structure */
 
 		dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+		sem_init(&dev->exclsem, 0, 1);
+		memset(&dev->gcwork, 0, sizeof(struct work_s));
+		memset(&dev->gcstats, 0, sizeof(struct mtd_gcstats_s));
+#endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
 		dev->bytesalloc = 0;
 		for (totalsectors = 0; totalsectors < SMART_MAX_ALLOCS; totalsectors++) {
@@ -5131,6 +6532,16 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 			goto errout;
 		}
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		/* Reserve the checkpoint area at the end of the device */
+
+		dev->ckpt_dirty = NULL;
+		ret = smart_ckpt_init(dev);
+		if (ret < 0) {
+			goto errout;
+		}
+#endif
+
 		/* Set the sector size to the default for now */
 
 #ifdef CONFIG_SMARTFS_BAD_SECTOR
@@ -5143,6 +6554,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #else
 		dev->sCache = NULL;
 		dev->sBitMap = NULL;
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+		dev->blksummary = NULL;
+#endif
 #endif
 		dev->rwbuffer = NULL;
 		dev->bytebuffer = NULL;
@@ -5237,6 +6651,13 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 			goto errout;
 		}
 
+#if defined(CONFIG_MTD_SMART_BACKGROUND_GC) && defined(CONFIG_MTD_REGISTRATION)
+		/* Publish the GC counters under the block device name */
+
+		strncpy(dev->gcstats.name, &dev->rwbuffer[5], MTD_GCSTATS_NAMELEN - 1);
+		mtd_register_gcstats(&dev->gcstats);
+#endif
+
 		/* Do a scan of the device */
 
 		smart_scan(dev);
@@ -5252,6 +6673,9 @@ errout:
 #else
 	smart_free(dev, dev->sBitMap);
 	smart_free(dev, dev->sCache);
+#ifdef CONFIG_MTD_SMART_BLOCK_SUMMARY
+	smart_free(dev, dev->blksummary);
+#endif
 #endif
 	if (dev->rwbuffer != NULL) {
 		smart_free(dev, dev->rwbuffer);
@@ -5268,12 +6692,21 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	if (dev->ckpt_dirty != NULL) {
+		smart_free(dev, dev->ckpt_dirty);
+	}
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 	if (rootdirdev) {
 		smart_free(dev, rootdirdev);
 	}
 #endif
 
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	sem_destroy(&dev->exclsem);
+#endif
+
 	kmm_free(dev);
 	return ret;
 }
@@ -5301,11 +6734,13 @@ int smart_validatesector(FAR struct inode *inode, uint16_t logsector, char *vali
 		return -EINVAL;
 	}
 
+	smart_semtake(dev);
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 	physsector = dev->sMap[logsector];
 #else
 	physsector = smart_cache_lookup(dev, logsector);
 #endif
+	smart_semgive(dev);
 	if (physsector != 0xFFFF) {
 		SET_TO_TRUE(validsectors, physsector);
 		return OK;
@@ -5344,6 +6779,7 @@ int smart_recoversectors(FAR struct inode *inode, char *validsectors, int *nobso
 		smart_validatesector(inode, logicalsector, validsectors);
 	}
 
+	smart_semtake(dev);
 	for (sector = 1; sector < totalsectors; sector++) {
 		readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
 		ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s), (FAR uint8_t *)&header);
@@ -5413,6 +6849,7 @@ int smart_recoversectors(FAR struct inode *inode, char *validsectors, int *nobso
 
 	ret = OK;
 err_out:
+	smart_semgive(dev);
 	return ret;
 }
 #endif
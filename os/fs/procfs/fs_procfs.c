@@ -96,6 +96,8 @@ extern const struct procfs_operations proc_operations;
 extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations uptime_operations;
 extern const struct procfs_operations version_operations;
+extern const struct procfs_operations smallcache_operations;
+extern const struct procfs_operations wqueue_operations;
 
 /* This is not good.  These are implemented in drivers/mtd.  Having to
  * deal with them here is not a good coupling.
@@ -143,6 +145,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"power/domains**", &power_procfsoperations},
 #endif
 
+#if defined(CONFIG_MM_SMALLCACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMALLCACHE)
+	{"smallcache", &smallcache_operations},
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
 	{"uptime", &uptime_operations},
 #endif
@@ -151,6 +157,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"version", &version_operations},
 #endif
 
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_WQUEUE)
+	{"wqueue", &wqueue_operations},
+#endif
+
 #if defined(CONFIG_CM) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CONNECTIVITY)
 	{"connectivity**", &cm_operations},
 #endif
@@ -94,7 +94,11 @@
  * to handle the longest line generated by this logic.
  */
 
+#ifdef CONFIG_SCHED_CPUACCT
+#define STATUS_LINELEN 40
+#else
 #define STATUS_LINELEN 32
+#endif
 
 /****************************************************************************
  * Private Types
@@ -109,6 +113,12 @@ enum proc_node_e {
 	PROC_CMDLINE,				/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	PROC_LOADAVG,				/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUACCT
+	PROC_CPUACCT,				/* CPU accounting */
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+	PROC_LATENCY,				/* Latency histograms */
+#endif
 #endif
 	PROC_STACK,					/* Task stack info */
 	PROC_GROUP,					/* Group directory */
@@ -155,6 +165,12 @@ static ssize_t proc_cmdline(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 #ifdef CONFIG_SCHED_CPULOAD
 static ssize_t proc_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 #endif
+#ifdef CONFIG_SCHED_CPUACCT
+static ssize_t proc_cpuacct(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+static ssize_t proc_latency(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+#endif
+#endif
 static ssize_t proc_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
@@ -223,6 +239,18 @@ static const struct proc_node_s g_loadavg = {
 };
 #endif
 
+#ifdef CONFIG_SCHED_CPUACCT
+static const struct proc_node_s g_cpuacct = {
+	"cpuacct", "cpuacct", (uint8_t)PROC_CPUACCT, DTYPE_FILE	/* CPU accounting */
+};
+
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+static const struct proc_node_s g_latency = {
+	"latency", "latency", (uint8_t)PROC_LATENCY, DTYPE_FILE	/* Latency histograms */
+};
+#endif
+#endif
+
 static const struct proc_node_s g_stack = {
 	"stack", "stack", (uint8_t)PROC_STACK, DTYPE_FILE	/* Task stack info */
 };
@@ -246,6 +274,12 @@ static FAR const struct proc_node_s *const g_nodeinfo[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUACCT
+	&g_cpuacct,					/* CPU accounting */
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+	&g_latency,					/* Latency histograms */
+#endif
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -262,6 +296,12 @@ static const struct proc_node_s *const g_level0info[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPUACCT
+	&g_cpuacct,					/* CPU accounting */
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+	&g_latency,					/* Latency histograms */
+#endif
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -543,6 +583,147 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_cpuacct
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUACCT
+static ssize_t proc_cpuacct(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+{
+	struct cpuacct_s acct;
+	size_t remaining;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+
+	remaining = buflen;
+	totalsize = 0;
+
+	/* Sample the counts for the thread, including the current run if this
+	 * is the running thread.
+	 */
+
+	if (sched_cpuacct(procfile->pid, &acct) < 0) {
+		return 0;
+	}
+
+	/* Show the total run time */
+
+#ifdef CONFIG_HAVE_LONG_LONG
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%llu\n", "Runtime:", (unsigned long long)acct.runtime);
+#else
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n", "Runtime:", (unsigned long)acct.runtime);
+#endif
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	if (totalsize >= buflen) {
+		return totalsize;
+	}
+
+	/* Show the number of times the thread was switched in */
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n", "Switches:", (unsigned long)acct.nswitches);
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	if (totalsize >= buflen) {
+		return totalsize;
+	}
+
+	/* Show the number of times the thread was made ready-to-run */
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n", "Wakeups:", (unsigned long)acct.nwakeups);
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	if (totalsize >= buflen) {
+		return totalsize;
+	}
+
+	/* Show the worst wakeup latency */
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n", "MaxWakeup:", (unsigned long)acct.maxwakeup);
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	if (totalsize >= buflen) {
+		return totalsize;
+	}
+
+	/* Show the longest interval with preemption disabled */
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu", "MaxPreempt:", (unsigned long)acct.maxpreemptoff);
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: proc_latency
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+static ssize_t proc_latency(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+{
+	struct cpuacct_s acct;
+	size_t remaining;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	int bound;
+	int i;
+
+	remaining = buflen;
+	totalsize = 0;
+
+	if (sched_cpuacct(procfile->pid, &acct) < 0) {
+		return 0;
+	}
+
+	/* Show one line per bucket; the bounds are powers of two cycles */
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-8s%12s%12s\n", "Cycles", "Wakeup", "PreemptOff");
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	for (i = 0; i < CPUACCT_NBUCKETS && totalsize < buflen; i++) {
+		bound = CONFIG_SCHED_CPUACCT_HISTSHIFT + i;
+		if (i < CPUACCT_NBUCKETS - 1) {
+			linesize = snprintf(procfile->line, STATUS_LINELEN, "<2^%-5d%12lu%12lu\n", bound, (unsigned long)acct.wakeup[i], (unsigned long)acct.preemptoff[i]);
+		} else {
+			linesize = snprintf(procfile->line, STATUS_LINELEN, ">=2^%-4d%12lu%12lu\n", bound - 1, (unsigned long)acct.wakeup[i], (unsigned long)acct.preemptoff[i]);
+		}
+
+		copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+		totalsize += copysize;
+		buffer += copysize;
+		remaining -= copysize;
+	}
+
+	return totalsize;
+}
+#endif
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -961,6 +1142,17 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 	case PROC_LOADAVG:			/* Average CPU utilization */
 		ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
 		break;
+#endif
+#ifdef CONFIG_SCHED_CPUACCT
+	case PROC_CPUACCT:			/* CPU accounting */
+		ret = proc_cpuacct(procfile, tcb, buffer, buflen, filep->f_pos);
+		break;
+
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+	case PROC_LATENCY:			/* Latency histograms */
+		ret = proc_latency(procfile, tcb, buffer, buflen, filep->f_pos);
+		break;
+#endif
 #endif
 	case PROC_STACK:			/* Task stack info */
 		ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -0,0 +1,288 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfssmallcache.c
+ *
+ * /proc/smallcache reports the statistics of the per task group small
+ * allocation caches (CONFIG_MM_SMALLCACHE), one line per size class.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+#include <tinyara/mm/smallcache.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_MM_SMALLCACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMALLCACHE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SMALLCACHE_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct smallcache_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	char line[SMALLCACHE_LINELEN];	/* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int smallcache_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int smallcache_close(FAR struct file *filep);
+static ssize_t smallcache_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int smallcache_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int smallcache_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations smallcache_operations = {
+	smallcache_open,			/* open */
+	smallcache_close,			/* close */
+	smallcache_read,			/* read */
+	NULL,						/* write */
+
+	smallcache_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	smallcache_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smallcache_open
+ ****************************************************************************/
+
+static int smallcache_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct smallcache_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "smallcache" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "smallcache") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct smallcache_file_s *)kmm_zalloc(sizeof(struct smallcache_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smallcache_close
+ ****************************************************************************/
+
+static int smallcache_close(FAR struct file *filep)
+{
+	FAR struct smallcache_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct smallcache_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smallcache_read
+ ****************************************************************************/
+
+static ssize_t smallcache_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct smallcache_file_s *attr;
+	FAR struct mm_smallcache_stats_s *stats;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	off_t offset;
+	int usable;
+	int ndx;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct smallcache_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+
+	/* Output a header line first */
+
+	linesize = snprintf(attr->line, SMALLCACHE_LINELEN, "%5s %7s %10s %10s %10s %10s\n", "SIZE", "CACHED", "HITS", "REFILLS", "FREES", "DRAINS");
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+	totalsize = copysize;
+
+	/* Then one line per size class that can hold an allocation */
+
+	for (ndx = 0; ndx < MM_SMALLCACHE_NCLASSES && totalsize < buflen; ndx++) {
+		usable = ((ndx + 1) << MM_MIN_SHIFT) - SIZEOF_MM_ALLOCNODE;
+		if (usable <= 0) {
+			continue;
+		}
+
+		stats = &g_mm_smallcache_stats[ndx];
+		linesize = snprintf(attr->line, SMALLCACHE_LINELEN, "%5d %7u %10u %10u %10u %10u\n", usable, stats->cached, stats->hits, stats->refills, stats->frees, stats->drains);
+		copysize = procfs_memcpy(attr->line, linesize, &buffer[totalsize], buflen - totalsize, &offset);
+		totalsize += copysize;
+	}
+
+	/* Update the file offset */
+
+	filep->f_pos += totalsize;
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: smallcache_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int smallcache_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct smallcache_file_s *oldattr;
+	FAR struct smallcache_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct smallcache_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct smallcache_file_s *)kmm_malloc(sizeof(struct smallcache_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct smallcache_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: smallcache_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int smallcache_stat(const char *relpath, struct stat *buf)
+{
+	/* "smallcache" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "smallcache") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "smallcache" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_MM_SMALLCACHE && !CONFIG_FS_PROCFS_EXCLUDE_SMALLCACHE */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
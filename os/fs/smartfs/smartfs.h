@@ -245,6 +245,10 @@
 #undef  CONFIG_SMARTFS_DYNAMIC_HEADER
 #endif
 
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+#define SMARTFS_CHAIN_INDEX_ENTRIES     (CONFIG_SMARTFS_CHAIN_INDEX_SIZE / sizeof(uint16_t))
+#endif
+
 #ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
 #define ENTRY_VALID(e) ((smartfs_rdle16(&e->flags) & SMARTFS_DIRENT_EMPTY) != \
 						(SMARTFS_ERASEDSTATE_16BIT & SMARTFS_DIRENT_EMPTY)) && \
@@ -325,6 +329,22 @@ struct smartfs_entry_header_s {
 	char name[0];				/* inode name */
 };
 
+#ifdef CONFIG_SMARTFS_DCACHE
+/* This structure is one slot of the directory lookup cache.  It holds the
+ * on-device directory entry found for a name in a parent directory.
+ */
+
+struct smartfs_dcache_entry_s {
+	uint16_t parent;			/* 1st sector of the parent directory, 0 if unused */
+	uint16_t dsector;			/* Sector number of the directory entry */
+	uint16_t doffset;			/* Offset of the directory entry */
+	uint16_t firstsector;		/* Sector number of the name */
+	uint16_t flags;				/* Flags, including mode */
+	uint32_t utc;				/* Time stamp */
+	char name[CONFIG_SMARTFS_MAXNAMLEN];	/* inode name, as stored on the device */
+};
+#endif
+
 /* This structure describes the smartfs header at the start of each
  * sector.  It manages the sector chain and used bytes in the sector.
  */
@@ -371,6 +391,12 @@ struct smartfs_ofile_s {
 								 * used field until the file is closed,
 								 * a seek, or more data is written that
 								 * causes the sector to change. */
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+	uint16_t ci_count;			/* Number of valid entries in ci_sector */
+	uint16_t ci_stride;			/* Chain sectors between two entries */
+	uint16_t ci_sector[SMARTFS_CHAIN_INDEX_ENTRIES];	/* Logical sector number
+								 * of chain sector n * ci_stride */
+#endif
 };
 
 /* This structure represents the overall mountpoint state.  An instance of this
@@ -395,6 +421,11 @@ struct smartfs_mountpt_s {
 #endif
 #ifdef CONFIG_SMARTFS_JOURNALING
 	struct journal_transaction_manager_s *journal;
+#endif
+#ifdef CONFIG_SMARTFS_DCACHE
+	struct smartfs_dcache_entry_s *fs_dcache;	/* Directory lookup cache */
+	uint32_t fs_dcache_hits;	/* Lookups answered by the cache */
+	uint32_t fs_dcache_misses;	/* Lookups that searched the directory */
 #endif
 	uint8_t fs_rootsector;		/* Root directory sector num */
 };
@@ -537,6 +568,18 @@ void smartfs_wrle32(uint8_t *dest, uint32_t val);
 struct smartfs_mountpt_s *smartfs_get_first_mount(void);
 #endif
 
+#ifdef CONFIG_SMARTFS_DCACHE
+void smartfs_dcache_invalidate(struct smartfs_mountpt_s *fs, uint16_t dsector, uint16_t doffset);
+void smartfs_dcache_flush(struct smartfs_mountpt_s *fs);
+#endif
+
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+void smartfs_chainidx_reset(struct smartfs_ofile_s *sf);
+void smartfs_chainidx_record(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf);
+void smartfs_chainidx_lookup(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf, off_t newpos);
+void smartfs_chainidx_invalidate(struct smartfs_mountpt_s *fs, uint16_t firstsector);
+#endif
+
 #ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
 uint16_t get_leftover_used_byte_count(uint8_t *buffer, uint16_t base_index);
 uint16_t get_used_byte_count_from_end(uint8_t *buffer);
@@ -82,6 +82,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Whole sectors of large appends are written in runs with BIOC_WRITEMULTI.
+ * Journaled volumes keep the per-sector path so every write is logged.
+ */
+
+#if defined(CONFIG_MTD_SMART_MULTI_WRITE) && !defined(CONFIG_SMARTFS_JOURNALING)
+#define SMARTFS_MULTI_WRITE
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -317,6 +325,9 @@ static int smartfs_open(FAR struct file *filep, const char *relpath, int oflags,
 	sf->curroffset = sizeof(struct smartfs_chain_header_s);
 	sf->currsector = sf->entry.firstsector;
 	sf->byteswritten = 0;
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+	smartfs_chainidx_reset(sf);
+#endif
 
 	/* Test if we opened for APPEND mode.  If we did, then seek to the
 	 * end of the file.
@@ -702,6 +713,97 @@ errout:
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smartfs_write_multi
+ *
+ * Description: Appends as many whole sectors of data as possible with a
+ *   single BIOC_WRITEMULTI request and links them after the current sector,
+ *   which must be full and synced.  Returns the number of bytes written, or
+ *   zero if the caller should continue sector by sector.
+ *
+ ****************************************************************************/
+
+#ifdef SMARTFS_MULTI_WRITE
+static int smartfs_write_multi(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf, const char *buffer, size_t buflen)
+{
+	struct smart_multi_write_s multi;
+	struct smart_read_write_s readwrite;
+	struct smartfs_chain_header_s header;
+	uint16_t logsectors[CONFIG_MTD_SMART_MULTI_WRITE_MAX];
+	uint8_t link[2];
+	uint16_t datsize;
+	size_t nsectors;
+	int ret;
+	int i;
+
+	/* Only worth it with more than one full sector of data to write */
+
+	datsize = fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s);
+	nsectors = buflen / datsize;
+	if (nsectors < 2) {
+		return 0;
+	}
+
+	if (nsectors > CONFIG_MTD_SMART_MULTI_WRITE_MAX) {
+		nsectors = CONFIG_MTD_SMART_MULTI_WRITE_MAX;
+	}
+
+	/* Every sector of the run is full, so they all share one header */
+
+	memset(&header, CONFIG_SMARTFS_ERASEDSTATE, sizeof(struct smartfs_chain_header_s));
+#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
+	set_used_byte_count((uint8_t *)header.used, datsize);
+#else
+	header.used[0] = (uint8_t)(datsize & 0x00FF);
+	header.used[1] = (uint8_t)(datsize >> 8);
+#endif
+
+	multi.count = nsectors;
+	multi.hdrlen = sizeof(struct smartfs_chain_header_s);
+	multi.linkoffset = offsetof(struct smartfs_chain_header_s, nextsector);
+	multi.hdr = (const uint8_t *)&header;
+	multi.buffer = (const uint8_t *)buffer;
+	multi.logsectors = logsectors;
+
+	ret = FS_IOCTL(fs, BIOC_WRITEMULTI, (unsigned long)&multi);
+	if (ret <= 0) {
+		/* No run available right now (or no driver support).  Only a media
+		 * error is reported, anything else falls back to single sectors.
+		 */
+
+		return ret == -EIO ? ret : 0;
+	}
+
+	/* Chain the run after the current sector */
+
+	link[0] = (uint8_t)(logsectors[0] & 0x00FF);
+	link[1] = (uint8_t)(logsectors[0] >> 8);
+	readwrite.logsector = sf->currsector;
+	readwrite.offset = offsetof(struct smartfs_chain_header_s, nextsector);
+	readwrite.count = sizeof(uint16_t);
+	readwrite.buffer = link;
+	ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&readwrite);
+	if (ret < 0) {
+		fdbg("Error %d writing next sector\n", ret);
+		return ret;
+	}
+
+	/* Move to the last sector of the run */
+
+	for (i = 0; i < multi.count; i++) {
+		sf->currsector = logsectors[i];
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+		smartfs_chainidx_record(fs, sf);
+#endif
+		sf->filepos += datsize;
+		sf->entry.datlen += datsize;
+	}
+
+	sf->curroffset = fs->fs_llformat.availbytes;
+	return multi.count * datsize;
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_write
  ****************************************************************************/
@@ -842,6 +944,9 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 
 			sf->curroffset = sizeof(struct smartfs_chain_header_s);
 			sf->currsector = SMARTFS_NEXTSECTOR(header);
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+			smartfs_chainidx_record(fs, sf);
+#endif
 		}
 	}
 
@@ -937,6 +1042,9 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 			sf->bflags = SMARTFS_BFLAG_DIRTY;
 			sf->currsector = SMARTFS_NEXTSECTOR(header);
 			sf->curroffset = sizeof(struct smartfs_chain_header_s);
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+			smartfs_chainidx_record(fs, sf);
+#endif
 			memset(sf->buffer, CONFIG_SMARTFS_ERASEDSTATE, fs->fs_llformat.availbytes);
 			header->type = SMARTFS_DIRENT_TYPE_FILE;
 		}
@@ -953,6 +1061,21 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 			/* Allocate a new sector if needed */
 
 			if (buflen > 0) {
+#ifdef SMARTFS_MULTI_WRITE
+				/* Write runs of whole sectors in one go when we can */
+
+				ret = smartfs_write_multi(fs, sf, &buffer[byteswritten], buflen);
+				if (ret < 0) {
+					goto errout_with_semaphore;
+				}
+
+				if (ret > 0) {
+					buflen -= ret;
+					byteswritten += ret;
+					continue;
+				}
+#endif
+
 				/* Allocate a new sector */
 
 				ret = FS_IOCTL(fs, BIOC_ALLOCSECT, 0xFFFF);
@@ -1004,6 +1127,9 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 
 				sf->currsector = SMARTFS_NEXTSECTOR(header);
 				sf->curroffset = sizeof(struct smartfs_chain_header_s);
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+				smartfs_chainidx_record(fs, sf);
+#endif
 			}
 		}
 #endif							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
@@ -1103,6 +1229,15 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_
 		sf->filepos = 0;
 	}
 
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+	/* Skip ahead to the closest sector known by the chain index */
+
+	smartfs_chainidx_lookup(fs, sf, newpos);
+#endif
+#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
+	sector_used = sf->filepos / (fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s));
+#endif
+
 	header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
 	while ((sf->currsector != SMARTFS_ERASEDSTATE_16BIT) && (sf->filepos + fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s) < newpos)) {
 		/* Read the sector's header */
@@ -1127,6 +1262,9 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_
 		sf->filepos += SMARTFS_USED(header);
 #endif
 		sf->currsector = SMARTFS_NEXTSECTOR(header);
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+		smartfs_chainidx_record(fs, sf);
+#endif
 	}
 
 #ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
@@ -1539,6 +1677,13 @@ static int smartfs_bind(FAR struct inode *blkdriver, const void *data, void **ha
 		kmm_free(fs);
 		return ret;
 	}
+#endif
+#ifdef CONFIG_SMARTFS_DCACHE
+	/* Journal recovery may have rewritten directory entries found during
+	 * the mount.
+	 */
+
+	smartfs_dcache_flush(fs);
 #endif
 	smartfs_semgive(fs);
 
@@ -2046,6 +2191,9 @@ int smartfs_rename(struct inode *mountpt, const char *oldrelpath, const char *ne
 
 		/* Now mark the old entry as inactive */
 
+#ifdef CONFIG_SMARTFS_DCACHE
+		smartfs_dcache_invalidate(fs, oldentry.dsector, oldentry.doffset);
+#endif
 		readwrite.logsector = oldentry.dsector;
 		readwrite.offset = 0;
 		readwrite.count = fs->fs_llformat.availbytes;
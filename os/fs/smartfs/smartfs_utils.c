@@ -599,6 +599,19 @@ int smartfs_mount(struct smartfs_mountpt_s *fs, bool writeable)
 	fs->fs_workbuffer = (char *)kmm_malloc(256);
 	fs->fs_rootsector = SMARTFS_ROOT_DIR_SECTOR;
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	/* Allocate the directory lookup cache.  The mount works without it if
+	 * there is no memory or the names on the device are too long.
+	 */
+
+	fs->fs_dcache = NULL;
+	fs->fs_dcache_hits = 0;
+	fs->fs_dcache_misses = 0;
+	if (fs->fs_llformat.namesize <= CONFIG_SMARTFS_MAXNAMLEN) {
+		fs->fs_dcache = (struct smartfs_dcache_entry_s *)kmm_zalloc(CONFIG_SMARTFS_DCACHE_ENTRIES * sizeof(struct smartfs_dcache_entry_s));
+	}
+#endif
+
 	/* We did it! */
 
 	fs->fs_mounted = TRUE;
@@ -642,6 +655,13 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
 	int found = FALSE;
 #endif
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	if (fs->fs_dcache != NULL) {
+		kmm_free(fs->fs_dcache);
+		fs->fs_dcache = NULL;
+	}
+#endif
+
 #if defined(CONFIG_SMARTFS_MULTI_ROOT_DIRS) || \
 	(defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS))
 	/* Start at the head of the mounts and search for our entry.  Also
@@ -745,6 +765,142 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smartfs_setentryname
+ *
+ * Description: Copies an on-device entry name into direntry->name,
+ *              allocating the name buffer if needed.
+ *
+ ****************************************************************************/
+
+static int smartfs_setentryname(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *direntry, const char *name)
+{
+	if (direntry->name == NULL) {
+		direntry->name = (char *)kmm_malloc(fs->fs_llformat.namesize + 1);
+		if (direntry->name == NULL) {
+			return ERROR;
+		}
+	}
+
+	memset(direntry->name, 0, fs->fs_llformat.namesize + 1);
+	strncpy(direntry->name, name, fs->fs_llformat.namesize);
+	return OK;
+}
+
+#ifdef CONFIG_SMARTFS_DCACHE
+/****************************************************************************
+ * Name: smartfs_dcache_slot
+ *
+ * Description: Returns the directory lookup cache slot for a name in the
+ *              directory starting at sector parent.  Only the characters
+ *              compared by the directory search (up to the name size or
+ *              the first NUL) are hashed.
+ *
+ ****************************************************************************/
+
+static struct smartfs_dcache_entry_s *smartfs_dcache_slot(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name)
+{
+	uint32_t hash = 2166136261u ^ parent;
+	uint16_t i;
+
+	for (i = 0; i < fs->fs_llformat.namesize && name[i] != '\0'; i++) {
+		hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+	}
+
+	return &fs->fs_dcache[hash % CONFIG_SMARTFS_DCACHE_ENTRIES];
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_lookup
+ *
+ * Description: Looks up a name in the directory starting at sector parent.
+ *              Returns the cached entry or NULL on a miss.
+ *
+ ****************************************************************************/
+
+static FAR const struct smartfs_dcache_entry_s *smartfs_dcache_lookup(struct smartfs_mountpt_s *fs, uint16_t parent, const char *name)
+{
+	struct smartfs_dcache_entry_s *slot;
+
+	if (fs->fs_dcache == NULL) {
+		return NULL;
+	}
+
+	slot = smartfs_dcache_slot(fs, parent, name);
+	if (slot->parent == parent && strncmp(slot->name, name, fs->fs_llformat.namesize) == 0) {
+		fs->fs_dcache_hits++;
+		return slot;
+	}
+
+	fs->fs_dcache_misses++;
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_insert
+ *
+ * Description: Adds a directory entry found by a directory search to the
+ *              cache, replacing whatever used the same slot.
+ *
+ ****************************************************************************/
+
+static void smartfs_dcache_insert(struct smartfs_mountpt_s *fs, uint16_t parent, uint16_t dsector, uint16_t doffset, uint16_t firstsector, uint16_t flags, uint32_t utc, const char *name)
+{
+	struct smartfs_dcache_entry_s *slot;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	slot = smartfs_dcache_slot(fs, parent, name);
+	slot->parent = parent;
+	slot->dsector = dsector;
+	slot->doffset = doffset;
+	slot->firstsector = firstsector;
+	slot->flags = flags;
+	slot->utc = utc;
+	memcpy(slot->name, name, fs->fs_llformat.namesize);
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_invalidate
+ *
+ * Description: Drops the cached copy of the directory entry stored at
+ *              offset doffset of directory sector dsector.  This must be
+ *              called whenever that entry is created, deleted or rewritten.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_invalidate(struct smartfs_mountpt_s *fs, uint16_t dsector, uint16_t doffset)
+{
+	int i;
+
+	if (fs->fs_dcache == NULL) {
+		return;
+	}
+
+	for (i = 0; i < CONFIG_SMARTFS_DCACHE_ENTRIES; i++) {
+		if (fs->fs_dcache[i].parent != 0 && fs->fs_dcache[i].dsector == dsector && fs->fs_dcache[i].doffset == doffset) {
+			fs->fs_dcache[i].parent = 0;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_dcache_flush
+ *
+ * Description: Drops all the cached directory entries of the mount.
+ *
+ ****************************************************************************/
+
+void smartfs_dcache_flush(struct smartfs_mountpt_s *fs)
+{
+	if (fs->fs_dcache != NULL) {
+		memset(fs->fs_dcache, 0, CONFIG_SMARTFS_DCACHE_ENTRIES * sizeof(struct smartfs_dcache_entry_s));
+	}
+}
+#endif							/* CONFIG_SMARTFS_DCACHE */
+
 /****************************************************************************
  * Name: smartfs_finddirentry
  *
@@ -772,9 +928,18 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 	uint16_t dirsector;
 	uint16_t entrysize;
 	uint16_t offset;
+	uint16_t entryfirst;
+	uint16_t entryflags;
+	uint32_t entryutc;
+	uint16_t entrysector;
+	uint16_t entryoffset;
+	bool found;
 	struct smartfs_chain_header_s *header;
 	struct smart_read_write_s readwrite;
 	struct smartfs_entry_header_s *entry;
+#ifdef CONFIG_SMARTFS_DCACHE
+	FAR const struct smartfs_dcache_entry_s *cached;
+#endif
 #ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
 	int used_value;
 #endif
@@ -783,6 +948,7 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 
 	dirstack[0] = fs->fs_rootsector;
 	entrysize = sizeof(struct smartfs_entry_header_s) + fs->fs_llformat.namesize;
+	header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
 
 	/* Test if this is a request for the root directory */
 
@@ -849,15 +1015,35 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 			/* Search for the entry in the current directory */
 
 			dirsector = dirstack[depth];
+			found = false;
+
+#ifdef CONFIG_SMARTFS_DCACHE
+			/* Try the directory lookup cache first */
+
+			cached = smartfs_dcache_lookup(fs, dirsector, fs->fs_workbuffer);
+			if (cached != NULL) {
+				entryfirst = cached->firstsector;
+				entryflags = cached->flags;
+				entryutc = cached->utc;
+				entrysector = cached->dsector;
+				entryoffset = cached->doffset;
+				if (*ptr == '\0') {
+					ret = smartfs_setentryname(fs, direntry, cached->name);
+					if (ret != OK) {
+						goto errout;
+					}
+				}
 
-			/* Read the directory */
+				found = true;
+			}
+#endif
 
-			offset = 0xFFFF;
+			/* Read the directory */
 
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
-			while (dirsector != 0xFFFF)
+			while (!found && dirsector != 0xFFFF)
 #else
-			while (dirsector != 0)
+			while (!found && dirsector != 0)
 #endif
 			{
 				/* Read the next directory in the chain */
@@ -873,7 +1059,6 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 
 				/* Point to next sector in chain */
 
-				header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
 				dirsector = SMARTFS_NEXTSECTOR(header);
 
 				/* Search for the entry */
@@ -896,127 +1081,33 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 					/* Test if the name matches */
 
 					if (strncmp(entry->name, fs->fs_workbuffer, fs->fs_llformat.namesize) == 0) {
-						/* We found it!  If this is the last segment entry,
-						 * then report the entry.  If it isn't the last
-						 * entry, then validate it is a directory entry and
-						 * open it and continue searching.
+						/* We found it!  Save the entry information before
+						 * the read/write buffer is reused.
 						 */
 
-						if (*ptr == '\0') {
-							/* We are at the last segment.  Report the entry */
-
-							/* Fill in the entry */
-
-#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							direntry->firstsector = smartfs_rdle16(&entry->firstsector);
-							direntry->flags = smartfs_rdle16(&entry->flags);
-							direntry->utc = smartfs_rdle32(&entry->utc);
-#else
-							direntry->firstsector = entry->firstsector;
-							direntry->flags = entry->flags;
-							direntry->utc = entry->utc;
-#endif
-							direntry->dsector = readwrite.logsector;
-							direntry->doffset = offset;
-							direntry->dfirst = dirstack[depth];
-							if (direntry->name == NULL) {
-								direntry->name = (char *)kmm_malloc(fs->fs_llformat.namesize + 1);
-								if (direntry->name == NULL) {
-									ret = ERROR;
-									goto errout;
-								}
-							}
-
-							memset(direntry->name, 0, fs->fs_llformat.namesize + 1);
-							strncpy(direntry->name, entry->name, fs->fs_llformat.namesize);
-							direntry->datlen = 0;
-
-							/* Scan the file's sectors to calculate the length and perform
-							 * a rudimentary check.
-							 */
-
 #ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							if ((smartfs_rdle16(&entry->flags) & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
-								dirsector = smartfs_rdle16(&entry->firstsector);
+						entryfirst = smartfs_rdle16(&entry->firstsector);
+						entryflags = smartfs_rdle16(&entry->flags);
+						entryutc = smartfs_rdle32(&entry->utc);
 #else
-							if ((entry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
-								dirsector = entry->firstsector;
+						entryfirst = entry->firstsector;
+						entryflags = entry->flags;
+						entryutc = entry->utc;
 #endif
-								readwrite.count = sizeof(struct smartfs_chain_header_s);
-								readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-								readwrite.offset = 0;
-
-								while (dirsector != SMARTFS_ERASEDSTATE_16BIT) {
-									/* Read the next sector of the file */
-
-									readwrite.logsector = dirsector;
-									ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-									if (ret < 0) {
-										fdbg("Error in sector chain at %d!\n", dirsector);
-										break;
-									}
-#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
-									if (SMARTFS_NEXTSECTOR(header) == SMARTFS_ERASEDSTATE_16BIT) {
-
-										readwrite.count = fs->fs_llformat.availbytes;
-										readwrite.buffer = (uint8_t *)fs->fs_chunk_buffer;
-
-										ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-										if (ret < 0) {
-											fdbg("Error %d reading sector %d header\n", ret, sf->currsector);
-											break;
-										}
-										used_value = get_leftover_used_byte_count((uint8_t *)readwrite.buffer, get_used_byte_count((uint8_t *)header->used));
-										direntry->datlen += used_value;
-									} else {
-										direntry->datlen += (fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s));
-									}
-									readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-#else
-									/* Add used bytes to the total and point to next sector */
-									if (SMARTFS_USED(header) != SMARTFS_ERASEDSTATE_16BIT) {
-										direntry->datlen += SMARTFS_USED(header);
-									}
-#endif
-									dirsector = SMARTFS_NEXTSECTOR(header);
-								}
-							}
-
-							*parentdirsector = dirstack[depth];
-							*filename = segment;
-							ret = OK;
-							goto errout;
-						} else {
-							/* Validate it's a directory */
-
-#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							if ((smartfs_rdle16(&entry->flags) & SMARTFS_DIRENT_TYPE) != SMARTFS_DIRENT_TYPE_DIR)
-#else
-							if ((entry->flags & SMARTFS_DIRENT_TYPE) != SMARTFS_DIRENT_TYPE_DIR)
+						entrysector = readwrite.logsector;
+						entryoffset = offset;
+#ifdef CONFIG_SMARTFS_DCACHE
+						smartfs_dcache_insert(fs, dirstack[depth], entrysector, entryoffset, entryfirst, entryflags, entryutc, entry->name);
 #endif
-							{
-								/* Not a directory!  Report the error */
-
-								ret = -ENOTDIR;
-								goto errout;
-							}
-
-							/* "Push" the directory and continue searching */
-
-							if (depth >= CONFIG_SMARTFS_DIRDEPTH - 1) {
-								/* Directory depth too big */
-
-								ret = -ENAMETOOLONG;
+						if (*ptr == '\0') {
+							ret = smartfs_setentryname(fs, direntry, entry->name);
+							if (ret != OK) {
 								goto errout;
 							}
-#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-							dirstack[++depth] = smartfs_rdle16(&entry->firstsector);
-#else
-							dirstack[++depth] = entry->firstsector;
-#endif
-							segment = ptr + 1;
-							break;
 						}
+
+						found = true;
+						break;
 					}
 
 					/* Not this entry.  Skip to the next one */
@@ -1025,41 +1116,113 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 					entry = (struct smartfs_entry_header_s *)
 							&fs->fs_rwbuffer[offset];
 				}
-
-				/* Test if a directory entry was found and break if it was */
-
-				if (offset < readwrite.count) {
-					break;
-				}
 			}
 
-			/* If we found a dir entry, then continue searching */
-
-			if (offset < readwrite.count) {
-				/* Update the segment pointer */
+			if (!found) {
+				/* Entry not found!  Report the error.  Also, if this is the last
+				 * segment, then report the parent directory sector.
+				 */
 
-				if (*ptr != '\0') {
-					ptr++;
+				if (*ptr == '\0') {
+					*parentdirsector = dirstack[depth];
+					*filename = segment;
+				} else {
+					*parentdirsector = 0xFFFF;
+					*filename = NULL;
 				}
 
-				segment = ptr;
-				continue;
+				ret = -ENOENT;
+				goto errout;
 			}
 
-			/* Entry not found!  Report the error.  Also, if this is the last
-			 * segment, then report the parent directory sector.
+			/* If this is the last segment entry, then report the entry.  If
+			 * it isn't the last entry, then validate it is a directory entry
+			 * and open it and continue searching.
 			 */
 
 			if (*ptr == '\0') {
+				/* We are at the last segment.  Fill in the entry */
+
+				direntry->firstsector = entryfirst;
+				direntry->flags = entryflags;
+				direntry->utc = entryutc;
+				direntry->dsector = entrysector;
+				direntry->doffset = entryoffset;
+				direntry->dfirst = dirstack[depth];
+				direntry->datlen = 0;
+
+				/* Scan the file's sectors to calculate the length and perform
+				 * a rudimentary check.
+				 */
+
+				if ((entryflags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_FILE) {
+					dirsector = entryfirst;
+					readwrite.count = sizeof(struct smartfs_chain_header_s);
+					readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+					readwrite.offset = 0;
+
+					while (dirsector != SMARTFS_ERASEDSTATE_16BIT) {
+						/* Read the next sector of the file */
+
+						readwrite.logsector = dirsector;
+						ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+						if (ret < 0) {
+							fdbg("Error in sector chain at %d!\n", dirsector);
+							break;
+						}
+#ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
+						if (SMARTFS_NEXTSECTOR(header) == SMARTFS_ERASEDSTATE_16BIT) {
+
+							readwrite.count = fs->fs_llformat.availbytes;
+							readwrite.buffer = (uint8_t *)fs->fs_chunk_buffer;
+
+							ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+							if (ret < 0) {
+								fdbg("Error %d reading sector %d header\n", ret, dirsector);
+								break;
+							}
+							used_value = get_leftover_used_byte_count((uint8_t *)readwrite.buffer, get_used_byte_count((uint8_t *)header->used));
+							direntry->datlen += used_value;
+						} else {
+							direntry->datlen += (fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s));
+						}
+						readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+#else
+						/* Add used bytes to the total and point to next sector */
+						if (SMARTFS_USED(header) != SMARTFS_ERASEDSTATE_16BIT) {
+							direntry->datlen += SMARTFS_USED(header);
+						}
+#endif
+						dirsector = SMARTFS_NEXTSECTOR(header);
+					}
+				}
+
 				*parentdirsector = dirstack[depth];
 				*filename = segment;
-			} else {
-				*parentdirsector = 0xFFFF;
-				*filename = NULL;
+				ret = OK;
+				goto errout;
 			}
 
-			ret = -ENOENT;
-			goto errout;
+			/* Validate it's a directory */
+
+			if ((entryflags & SMARTFS_DIRENT_TYPE) != SMARTFS_DIRENT_TYPE_DIR) {
+				/* Not a directory!  Report the error */
+
+				ret = -ENOTDIR;
+				goto errout;
+			}
+
+			/* "Push" the directory and continue searching */
+
+			if (depth >= CONFIG_SMARTFS_DIRDEPTH - 1) {
+				/* Directory depth too big */
+
+				ret = -ENAMETOOLONG;
+				goto errout;
+			}
+
+			dirstack[++depth] = entryfirst;
+			segment = ptr + 1;
 		}
 	}
 
@@ -1277,6 +1440,12 @@ int smartfs_createentry(struct smartfs_mountpt_s *fs, uint16_t parentdirsector,
 		goto errout;
 	}
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	/* Nothing may be cached for this slot, but make sure */
+
+	smartfs_dcache_invalidate(fs, psector, offset);
+#endif
+
 	/* Now fill in the entry */
 
 	direntry->firstsector = nextsector;
@@ -1371,6 +1540,9 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *en
 
 	/* Remove the entry from the directory tree */
 
+#ifdef CONFIG_SMARTFS_DCACHE
+	smartfs_dcache_invalidate(fs, entry->dsector, entry->doffset);
+#endif
 	readwrite.logsector = entry->dsector;
 	readwrite.offset = 0;
 	readwrite.count = fs->fs_llformat.availbytes;
@@ -1588,6 +1760,14 @@ int smartfs_truncatefile(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *e
 	struct smartfs_chain_header_s *header;
 	struct smart_read_write_s readwrite;
 
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+	/* The released sectors may be reused by other files, so any chain index
+	 * of this file held by another open instance is no longer valid.
+	 */
+
+	smartfs_chainidx_invalidate(fs, entry->firstsector);
+#endif
+
 	/* Walk through the directory's sectors and count entries */
 
 	nextsector = entry->firstsector;
@@ -1689,6 +1869,129 @@ errout:
 	return ret;
 }
 
+#ifdef CONFIG_SMARTFS_CHAIN_INDEX
+/****************************************************************************
+ * Name: smartfs_chainidx_reset
+ *
+ * Description: Resets the chain index of an open file so that it only
+ *              knows the first sector of the file.
+ *
+ ****************************************************************************/
+
+void smartfs_chainidx_reset(struct smartfs_ofile_s *sf)
+{
+	sf->ci_sector[0] = sf->entry.firstsector;
+	sf->ci_count = 1;
+	sf->ci_stride = 1;
+}
+
+/****************************************************************************
+ * Name: smartfs_chainidx_record
+ *
+ * Description: Records sf->currsector in the chain index if it starts at an
+ *              indexed position and extends the index.  This must be called
+ *              each time the file moves on to the next sector of its chain,
+ *              with sf->filepos at the start of that sector.
+ *
+ *              All sectors of a chain except the last one are full, so the
+ *              n-th sector of the chain holds file data from
+ *              n * (availbytes - header) onwards.
+ *
+ ****************************************************************************/
+
+void smartfs_chainidx_record(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf)
+{
+	uint16_t datsize = fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s);
+	uint32_t chainpos;
+	int i;
+
+	if (sf->currsector == SMARTFS_ERASEDSTATE_16BIT || (sf->filepos % datsize) != 0) {
+		return;
+	}
+
+	chainpos = sf->filepos / datsize;
+	if (chainpos != (uint32_t)sf->ci_count * sf->ci_stride) {
+		/* Not the next indexed position: either already known or beyond
+		 * a gap that will be filled by a later walk.
+		 */
+
+		return;
+	}
+
+	if (sf->ci_count == SMARTFS_CHAIN_INDEX_ENTRIES) {
+		/* The index is full.  Keep every other entry and double the
+		 * distance between them.  With an odd number of entries the
+		 * last entry is kept as well.
+		 */
+
+		for (i = 1; i < (SMARTFS_CHAIN_INDEX_ENTRIES + 1) / 2; i++) {
+			sf->ci_sector[i] = sf->ci_sector[2 * i];
+		}
+
+		sf->ci_count = (SMARTFS_CHAIN_INDEX_ENTRIES + 1) / 2;
+		sf->ci_stride <<= 1;
+
+		if (chainpos != (uint32_t)sf->ci_count * sf->ci_stride) {
+			return;
+		}
+	}
+
+	sf->ci_sector[sf->ci_count++] = sf->currsector;
+}
+
+/****************************************************************************
+ * Name: smartfs_chainidx_lookup
+ *
+ * Description: Moves the start of a chain walk to the indexed sector closest
+ *              to (but not after) the sector holding newpos, if that sector
+ *              is further along than the current start given by
+ *              sf->currsector and sf->filepos.
+ *
+ ****************************************************************************/
+
+void smartfs_chainidx_lookup(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf, off_t newpos)
+{
+	uint16_t datsize = fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s);
+	uint32_t ndx;
+	off_t pos;
+
+	/* A position at a sector boundary belongs to the end of the previous
+	 * sector, the same as the chain walk in smartfs_seek_internal.
+	 */
+
+	ndx = newpos > 0 ? (newpos - 1) / datsize : 0;
+	ndx /= sf->ci_stride;
+	if (ndx >= sf->ci_count) {
+		ndx = sf->ci_count - 1;
+	}
+
+	pos = (off_t)ndx * sf->ci_stride * datsize;
+	if (pos > sf->filepos) {
+		sf->currsector = sf->ci_sector[ndx];
+		sf->filepos = pos;
+	}
+}
+
+/****************************************************************************
+ * Name: smartfs_chainidx_invalidate
+ *
+ * Description: Resets the chain index of every open instance of the file
+ *              starting at firstsector.
+ *
+ ****************************************************************************/
+
+void smartfs_chainidx_invalidate(struct smartfs_mountpt_s *fs, uint16_t firstsector)
+{
+	struct smartfs_ofile_s *sf;
+
+	for (sf = fs->fs_head; sf != NULL; sf = sf->fnext) {
+		if (sf->entry.firstsector == firstsector) {
+			smartfs_chainidx_reset(sf);
+		}
+	}
+}
+#endif							/* CONFIG_SMARTFS_CHAIN_INDEX */
+
 /****************************************************************************
  * Name: smartfs_get_first_mount
  *
@@ -62,6 +62,7 @@
 #include <assert.h>
 
 #include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
 #include <tinyara/net/net.h>
 #include <tinyara/sched.h>
 #include <tinyara/cancelpt.h>
@@ -218,6 +219,30 @@ int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
 		err = ENOSYS;			/* Not implemented */
 		break;
 
+	case F_SETPIPE_SZ:
+	/* Set the size of the buffer of the pipe or FIFO referred to by fd to
+	 * the third argument, arg, taken as type int.  The new size is returned.
+	 */
+
+	case F_GETPIPE_SZ:
+		/* Return the size of the buffer of the pipe or FIFO referred to by fd. */
+
+	{
+		FAR struct inode *inode = filep->f_inode;
+		int arg = cmd == F_SETPIPE_SZ ? va_arg(ap, int) : 0;
+
+		if (INODE_IS_MOUNTPT(inode) || inode->u.i_ops->ioctl == NULL) {
+			err = EBADF;
+			break;
+		}
+
+		ret = inode->u.i_ops->ioctl(filep, cmd == F_SETPIPE_SZ ? PIPEIOC_SETSIZE : PIPEIOC_GETSIZE, (unsigned long)arg);
+		if (ret < 0) {
+			err = ret == -ENOTTY ? EBADF : -ret;
+		}
+	}
+	break;
+
 	default:
 		err = EINVAL;
 		break;
@@ -135,6 +135,8 @@
 #define F_SETLKW    12			/* Like F_SETLK, but wait for lock to become available */
 #define F_SETOWN    13			/* Set pid that will receive SIGIO and SIGURG signals for fd */
 #define F_SETSIG    14			/* Set the signal to be sent */
+#define F_SETPIPE_SZ 15			/* Set the buffer size of a pipe or FIFO (linux) */
+#define F_GETPIPE_SZ 16			/* Get the buffer size of a pipe or FIFO (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -142,6 +144,12 @@
 #define F_WRLCK     1			/* Take out a write lease */
 #define F_UNLCK     2			/* Remove a lease */
 
+/* splice() flags */
+
+#define SPLICE_F_MOVE     (1 << 0)	/* Accepted, but ignored */
+#define SPLICE_F_NONBLOCK (1 << 1)	/* Do not block on the pipe */
+#define SPLICE_F_MORE     (1 << 2)	/* Accepted, but ignored */
+
 /* close-on-exec flag for F_GETRL and F_SETFL */
 
 #define FD_CLOEXEC  1
@@ -207,6 +215,15 @@ int open(const char *path, int oflag, ...);
  * @since Tizen RT v1.0
  */
 int fcntl(int fd, int cmd, ...);
+#ifdef CONFIG_DEV_PIPE_SPLICE
+/**
+ * @ingroup FCNTL_KERNEL
+ * @brief  move data between a pipe and a file or socket (linux)
+ * @details [SYSTEM CALL API]
+ * @since Tizen RT v1.1
+ */
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out, size_t len, unsigned int flags);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
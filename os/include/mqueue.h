@@ -77,6 +77,13 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Set in mq_attr.mq_flags when creating a queue to give it a pool of
+ * mq_maxmsg buffers of mq_msgsize bytes for the zero-copy interfaces
+ * (mq_getbuf() etc., CONFIG_MQ_ZEROCOPY).
+ */
+
+#define MQ_ZEROCOPY (1 << 15)
+
 /********************************************************************************
  * Global Type Declarations
  ********************************************************************************/
@@ -169,6 +176,47 @@ int mq_setattr(mqd_t mqdes, FAR const struct mq_attr *mq_stat, FAR struct mq_att
  */
 int mq_getattr(mqd_t mqdes, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/**
+ * @brief Take a message buffer from the pool of a zero-copy queue
+ * @details [SYSTEM CALL API] \n
+ *   The queue must have been created with MQ_ZEROCOPY.  The buffer holds up
+ *   to mq_msgsize bytes and belongs to the caller until it is passed to
+ *   mq_sendbuf() or mq_freebuf().  Blocks while the pool is empty unless
+ *   the queue was opened with O_NONBLOCK (EAGAIN).  Buffers still held
+ *   when the queue is finally closed and unlinked keep its pool allocated.
+ * @return The buffer, or NULL with errno set on failure
+ * @since Tizen RT v1.1
+ */
+FAR void *mq_getbuf(mqd_t mqdes);
+/**
+ * @brief Queue a buffer from mq_getbuf() without copying it
+ * @details [SYSTEM CALL API] \n
+ *   Behaves like mq_send() except that ownership of buf passes to the
+ *   receiver.  On failure the caller still owns buf.
+ * @since Tizen RT v1.1
+ */
+int mq_sendbuf(mqd_t mqdes, FAR void *buf, size_t msglen, int prio);
+/**
+ * @brief Receive a message without copying it
+ * @details [SYSTEM CALL API] \n
+ *   Behaves like mq_receive() except that *buf is set to the message
+ *   itself.  The caller owns the buffer and must return it with
+ *   mq_freebuf() on the same queue.
+ * @return The length of the message, or ERROR with errno set
+ * @since Tizen RT v1.1
+ */
+ssize_t mq_receivebuf(mqd_t mqdes, FAR void **buf, FAR int *prio);
+/**
+ * @brief Return a buffer from mq_getbuf() or mq_receivebuf()
+ * @details [SYSTEM CALL API] \n
+ *   Fails with EINVAL if buf is not held by the caller, e.g. because it
+ *   was already freed or sent.
+ * @since Tizen RT v1.1
+ */
+int mq_freebuf(mqd_t mqdes, FAR void *buf);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -74,6 +74,7 @@ extern "C" {
 #define NETCONN_COPY      0x01
 #define NETCONN_MORE      0x02
 #define NETCONN_DONTBLOCK 0x04
+#define NETCONN_PBUF      0x08	/* Internal: data is a chain of tcp_alloc_pbuf() pbufs */
 
 /* Flags for struct netconn.flags (u8_t) */
 /** TCP: when data passed to netconn_write doesn't fit into the send buffer,
@@ -256,6 +257,9 @@ err_t netconn_send(struct netconn *conn, struct netbuf *buf);
 err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written);
 #define netconn_write(conn, dataptr, size, apiflags) \
 	netconn_write_partly(conn, dataptr, size, apiflags, NULL)
+#if LWIP_TCP_PBUF_WRITE
+err_t netconn_write_pbuf(struct netconn *conn, struct pbuf *p, u8_t apiflags, size_t *bytes_written);
+#endif
 err_t netconn_close(struct netconn *conn);
 err_t netconn_shutdown(struct netconn *conn, u8_t shut_rx, u8_t shut_tx);
 
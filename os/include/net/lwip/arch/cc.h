@@ -61,6 +61,7 @@ typedef unsigned short u16_t;
 typedef signed short s16_t;
 typedef unsigned int u32_t;
 typedef signed int s32_t;
+typedef unsigned long long u64_t;
 typedef u32_t mem_ptr_t;
 typedef int sys_prot_t;
 
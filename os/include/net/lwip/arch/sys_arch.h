@@ -39,6 +39,21 @@ typedef pid_t sys_thread_t;
 
 // === MAIL BOX ===
 
+#ifdef CONFIG_NET_LWIP_MBOX_LOCKFREE
+/* Ring of message slots guarded by atomic token counters, see sys_arch_mbox.c */
+struct sys_mbox {
+	u8_t is_valid;
+	u8_t id;
+	u32_t queue_size;
+	volatile u32_t head;
+	volatile u32_t tail;
+	volatile s32_t nmsgs;
+	volatile s32_t nfree;
+	void *msgs[SYS_MBOX_MAXSIZE];
+	sys_sem_t mail;
+	sys_sem_t room;
+};
+#else
 struct sys_mbox {
 	u8_t is_valid;
 	u8_t id;
@@ -51,6 +66,7 @@ struct sys_mbox {
 	sys_sem_t mail;
 	sys_sem_t mutex;
 };
+#endif
 
 typedef struct sys_mbox sys_mbox_t;
 
@@ -54,6 +54,11 @@
 #include <net/lwip/pbuf.h>
 #include <net/lwip/ipv4/ip_addr.h>
 
+#ifdef CONFIG_NET_LWIP_CHKSUM_ARCH
+/* LWIP_CHKSUM is up_chksum() */
+#include <tinyara/arch.h>
+#endif
+
 /** Swap the bytes in an u16_t: much like htons() for little-endian */
 #ifndef SWAP_BYTES_IN_WORD
 #if LWIP_PLATFORM_BYTESWAP && (BYTE_ORDER == LITTLE_ENDIAN)
@@ -147,6 +147,24 @@
 /* ---------- IP options ---------- */
 
 
+/* ---------- Checksum options ---------- */
+
+#if defined(CONFIG_NET_LWIP_CHKSUM_ARCH)
+#define LWIP_CHKSUM                    up_chksum
+#elif defined(CONFIG_NET_LWIP_CHKSUM_WORD)
+#define LWIP_CHKSUM_ALGORITHM          4
+#elif defined(CONFIG_NET_LWIP_CHKSUM_HALFWORD)
+#define LWIP_CHKSUM_ALGORITHM          2
+#endif
+
+#ifdef CONFIG_NET_LWIP_CHKSUM_COPY
+#define LWIP_CHECKSUM_ON_COPY          1
+#define LWIP_CHKSUM_COPY_ALGORITHM     2
+#endif
+
+/* ---------- Checksum options ---------- */
+
+
 /* ---------- ICMP options ---------- */
 #ifdef CONFIG_NET_ICMP
 #define LWIP_ICMP                       CONFIG_NET_ICMP
@@ -239,10 +257,24 @@
 #define TCP_TIMESTAMPS	CONFIG_NET_TCP_TIMESTAMPS
 #endif
 
+#ifdef CONFIG_NET_TCP_SACK
+#define LWIP_TCP_SACK                   1
+#endif
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 #define LWIP_TCP_KEEPALIVE              CONFIG_NET_TCP_KEEPALIVE
 #endif
 
+#ifdef CONFIG_NET_SENDFILE
+#define LWIP_TCP_PBUF_WRITE             1
+#endif
+
+#ifdef CONFIG_NET_TCP_PCB_HASH
+#define LWIP_TCP_PCB_HASH               1
+#define TCP_PCB_HASH_SIZE               CONFIG_NET_TCP_PCB_HASH_SIZE
+#define TCP_LISTEN_HASH_SIZE            CONFIG_NET_TCP_LISTEN_HASH_SIZE
+#endif
+
 #ifdef CONFIG_NET_TCP_WND_UPDATE_THREASHOLD
 #define TCP_WND_UPDATE_THREASHOLD	CONFIG_NET_TCP_WND_UPDATE_THREASHOLD
 #endif
@@ -269,6 +301,11 @@
 #define LWIP_NETBUF_RECVINFO	CONFIG_NET_NETBUF_RECVINFO
 #endif
 
+#ifdef CONFIG_NET_UDP_PCB_HASH
+#define LWIP_UDP_PCB_HASH               1
+#define UDP_PCB_HASH_SIZE               CONFIG_NET_UDP_PCB_HASH_SIZE
+#endif
+
 /* ---------- UDP options ---------- */
 
 
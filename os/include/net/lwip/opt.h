@@ -860,6 +860,21 @@
 #define LWIP_NETBUF_RECVINFO            0
 #endif
 
+/**
+ * LWIP_UDP_PCB_HASH==1: Index bound UDP PCBs by local port so that
+ * udp_input() only looks at the PCBs bound to the destination port.
+ */
+#ifndef LWIP_UDP_PCB_HASH
+#define LWIP_UDP_PCB_HASH               0
+#endif
+
+/**
+ * UDP_PCB_HASH_SIZE: Number of buckets of the UDP port table, a power of 2.
+ */
+#ifndef UDP_PCB_HASH_SIZE
+#define UDP_PCB_HASH_SIZE               16
+#endif
+
 /*
    ---------------------------------
    ---------- TCP options ----------
@@ -1023,6 +1038,50 @@
 #define LWIP_TCP_TIMESTAMPS             0
 #endif
 
+/**
+ * LWIP_TCP_SACK==1: Negotiate selective acknowledgments (RFC 2018). Data
+ * on the ooseq queue is reported to the peer in SACK blocks, and segments
+ * the peer reports missing are retransmitted following RFC 6675.
+ * Needs TCP_QUEUE_OOSEQ.
+ */
+#ifndef LWIP_TCP_SACK
+#define LWIP_TCP_SACK                   0
+#endif
+
+/**
+ * LWIP_TCP_PBUF_WRITE==1: Enable tcp_write_pbuf() and netconn_write_pbuf()
+ * to queue data that the caller has already placed in pbufs, without
+ * copying it again (used by sendfile()).
+ */
+#ifndef LWIP_TCP_PBUF_WRITE
+#define LWIP_TCP_PBUF_WRITE             0
+#endif
+
+/**
+ * LWIP_TCP_PCB_HASH==1: Find the PCB of an incoming segment through hash
+ * tables instead of walking the PCB lists: active and TIME-WAIT PCBs are
+ * hashed by address and port 4-tuple, listening PCBs by local port.
+ */
+#ifndef LWIP_TCP_PCB_HASH
+#define LWIP_TCP_PCB_HASH               0
+#endif
+
+/**
+ * TCP_PCB_HASH_SIZE: Number of buckets of the TCP connection table, a
+ * power of 2.
+ */
+#ifndef TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_SIZE               64
+#endif
+
+/**
+ * TCP_LISTEN_HASH_SIZE: Number of buckets of the TCP listen port table, a
+ * power of 2.
+ */
+#ifndef TCP_LISTEN_HASH_SIZE
+#define TCP_LISTEN_HASH_SIZE            16
+#endif
+
 /**
  * TCP_WND_UPDATE_THRESHOLD: difference in window to trigger an
  * explicit window update
@@ -236,6 +236,11 @@ int lwip_send(int s, const void *dataptr, size_t size, int flags);
 int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
 int lwip_socket(int domain, int type, int protocol);
 int lwip_write(int s, const void *dataptr, size_t size);
+#if LWIP_TCP_PBUF_WRITE
+struct pbuf;
+int lwip_send_pbuf(int s, struct pbuf *p, int flags);
+int lwip_send_static(int s, const void *dataptr, size_t size, int flags);
+#endif
 #if LWIP_SELECT
 int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, struct timeval *timeout);
 #endif
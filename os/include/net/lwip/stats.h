@@ -85,6 +85,11 @@ struct stats_proto {
 	STAT_COUNTER opterr;	/* Error in options. */
 	STAT_COUNTER err;		/* Misc error. */
 	STAT_COUNTER cachehit;
+	/* PCB demultiplexing of TCP and UDP input: average chain length is
+	   demuxpcb / demux. Kept 32 bits wide, the ratio is meaningless once
+	   either counter has wrapped. */
+	u32_t demux;				/* PCB lookups. */
+	u32_t demuxpcb;				/* PCBs compared by the lookups. */
 };
 
 struct stats_igmp {
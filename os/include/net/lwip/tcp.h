@@ -165,11 +165,19 @@ enum tcp_state {
 #define DEF_ACCEPT_CALLBACK
 #endif							/* LWIP_CALLBACK_API */
 
+#if LWIP_TCP_PCB_HASH
+/* next pcb in the same hash bucket of the demux table, see tcp_hash_reg() */
+#define DEF_HASH_NEXT(type)  type *hash_next;
+#else							/* LWIP_TCP_PCB_HASH */
+#define DEF_HASH_NEXT(type)
+#endif							/* LWIP_TCP_PCB_HASH */
+
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
 #define TCP_PCB_COMMON(type) \
 	type *next; /* for the linked list */ \
+	DEF_HASH_NEXT(type) \
 	void *callback_arg; \
 	/* the accept callback for listen- and normal pcbs, if LWIP_CALLBACK_API */ \
 	DEF_ACCEPT_CALLBACK \
@@ -280,6 +288,13 @@ struct tcp_pcb {
 	u32_t ts_recent;
 #endif							/* LWIP_TCP_TIMESTAMPS */
 
+#if LWIP_TCP_SACK
+	u8_t sack_flags;
+#define TF_SACK_PERM   ((u8_t)0x01U)	/* Both ends sent SACK-permitted, SACK in use */
+	u32_t rcv_sack_seq;		/* seqno of the out-of-sequence segment received last */
+	u32_t sack_recover;		/* snd_nxt when SACK loss recovery started */
+#endif							/* LWIP_TCP_SACK */
+
 	/* idle time before KEEPALIVE is sent */
 	u32_t keep_idle;
 #if LWIP_TCP_KEEPALIVE
@@ -368,6 +383,18 @@ err_t tcp_shutdown(struct tcp_pcb *pcb, int shut_rx, int shut_tx);
 
 err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags);
 
+#if LWIP_TCP_PBUF_WRITE
+/* Largest payload of a pbuf from tcp_alloc_pbuf() */
+#if LWIP_TCP_TIMESTAMPS
+#define TCP_PBUF_MAXLEN (TCP_MSS - 12)
+#else
+#define TCP_PBUF_MAXLEN TCP_MSS
+#endif
+
+struct pbuf *tcp_alloc_pbuf(u16_t len);
+err_t tcp_write_pbuf(struct tcp_pcb *pcb, struct pbuf *p, u8_t apiflags);
+#endif							/* LWIP_TCP_PBUF_WRITE */
+
 void tcp_setprio(struct tcp_pcb *pcb, u8_t prio);
 
 #define TCP_PRIO_MIN    1
@@ -85,6 +85,13 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb);
 void tcp_rexmit(struct tcp_pcb *pcb);
 void tcp_rexmit_rto(struct tcp_pcb *pcb);
 void tcp_rexmit_fast(struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+void tcp_sack_update(struct tcp_pcb *pcb, const u32_t *edges, u8_t nblocks);
+u32_t tcp_sack_pipe(struct tcp_pcb *pcb);
+u8_t tcp_sack_lost(struct tcp_pcb *pcb);
+#else							/* LWIP_TCP_SACK */
+#define tcp_sack_lost(pcb) 0
+#endif							/* LWIP_TCP_SACK */
 u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb);
 err_t tcp_process_refused_data(struct tcp_pcb *pcb);
 
@@ -296,13 +303,30 @@ struct tcp_seg {
 #define TF_SEG_OPTS_TS          (u8_t)0x02U	/* Include timestamp option. */
 #define TF_SEG_DATA_CHECKSUMMED (u8_t)0x04U	/* ALL data (not the header) is
 											   checksummed into 'chksum' */
+#define TF_SEG_OPTS_SACK_PERM   (u8_t)0x08U	/* Include SACK permitted option. */
+#define TF_SEG_SACKED           (u8_t)0x10U	/* unacked: covered by a SACK block */
+#define TF_SEG_SACK_LOST        (u8_t)0x20U	/* unacked: presumed lost (RFC 6675 IsLost) */
+#define TF_SEG_SACK_RETX        (u8_t)0x40U	/* unacked: retransmitted in SACK recovery */
 	struct tcp_hdr *tcphdr;	/* the TCP header */
 };
 
 #define LWIP_TCP_OPT_LENGTH(flags)              \
 	(flags & TF_SEG_OPTS_MSS ? 4  : 0) +        \
+	(flags & TF_SEG_OPTS_SACK_PERM ? 4 : 0) +   \
 	(flags & TF_SEG_OPTS_TS  ? 12 : 0)
 
+#if LWIP_TCP_SACK
+/** Most SACK blocks that fit into the option space (3 with timestamps) */
+#define TCP_SACK_MAX_BLOCKS     4
+/** Length of a SACK option with n blocks, padded with two NOPs */
+#define TCP_SACK_OPT_LENGTH(n)  ((n) ? 4 + 8 * (n) : 0)
+/** SACKed segments above a hole after which it is presumed lost */
+#define TCP_SACK_DUPTHRESH      3
+#define TCP_SACK_ENABLED(pcb)   (((pcb)->sack_flags & TF_SACK_PERM) != 0)
+#else							/* LWIP_TCP_SACK */
+#define TCP_SACK_ENABLED(pcb)   0
+#endif							/* LWIP_TCP_SACK */
+
 /** This returns a TCP header option for MSS in an u32_t */
 #define TCP_BUILD_MSS_OPTION(mss) htonl(0x02040000 | ((mss) & 0xFFFF))
 
@@ -332,6 +356,26 @@ extern struct tcp_pcb *tcp_tmp_pcb;	/* Only used for temporary storage. */
    3) All PCBs in the tcp_listen_pcbs list is in LISTEN state.
    4) All PCBs in the tcp_tw_pcbs list is in TIME-WAIT state.
 */
+
+#if LWIP_TCP_PCB_HASH
+/* With LWIP_TCP_PCB_HASH, the PCBs of tcp_active_pcbs and tcp_tw_pcbs are
+   also chained into a table hashed on the connection 4-tuple, and those of
+   tcp_listen_pcbs into a table hashed on the local port, so that tcp_input()
+   does not have to walk the lists.  TCP_REG and TCP_RMV keep the tables in
+   sync with the lists.  The addresses and ports of a PCB must therefore be
+   set before it is registered and must not change while it is registered;
+   code that has to change them removes the PCB from the table first. */
+void tcp_hash_reg(struct tcp_pcb **pcbs, struct tcp_pcb *npcb);
+u8_t tcp_hash_rmv(struct tcp_pcb **pcbs, struct tcp_pcb *npcb);
+struct tcp_pcb *tcp_hash_lookup(ip_addr_t *local_ip, u16_t local_port, ip_addr_t *remote_ip, u16_t remote_port);
+struct tcp_pcb_listen *tcp_hash_lookup_listen(ip_addr_t *local_ip, u16_t local_port);
+#define TCP_HASH_REG(pcbs, npcb) tcp_hash_reg((pcbs), (npcb))
+#define TCP_HASH_RMV(pcbs, npcb) tcp_hash_rmv((pcbs), (npcb))
+#else							/* LWIP_TCP_PCB_HASH */
+#define TCP_HASH_REG(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb)
+#endif							/* LWIP_TCP_PCB_HASH */
+
 /* Define two macros, TCP_REG and TCP_RMV that registers a TCP PCB
    with a PCB list or removes a PCB from a list, respectively. */
 #ifndef TCP_DEBUG_PCB_LISTS
@@ -350,6 +394,7 @@ extern struct tcp_pcb *tcp_tmp_pcb;	/* Only used for temporary storage. */
 		(npcb)->next = *(pcbs); \
 		LWIP_ASSERT("TCP_REG: npcb->next != npcb", (npcb)->next != (npcb)); \
 		*(pcbs) = (npcb); \
+		TCP_HASH_REG(pcbs, npcb); \
 		LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
 		tcp_timer_needed(); \
 	} while (0)
@@ -357,6 +402,7 @@ extern struct tcp_pcb *tcp_tmp_pcb;	/* Only used for temporary storage. */
 	do { \
 		LWIP_ASSERT("TCP_RMV: pcbs != NULL", *(pcbs) != NULL); \
 		LWIP_DEBUGF(TCP_DEBUG, ("TCP_RMV: removing %p from %p\n", (npcb), *(pcbs))); \
+		TCP_HASH_RMV(pcbs, npcb); \
 		if (*(pcbs) == (npcb)) { \
 			*(pcbs) = (*pcbs)->next; \
 		} else { \
@@ -378,11 +424,13 @@ extern struct tcp_pcb *tcp_tmp_pcb;	/* Only used for temporary storage. */
 	do {                                           \
 		(npcb)->next = *pcbs;                      \
 		*(pcbs) = (npcb);                          \
+		TCP_HASH_REG(pcbs, npcb);                  \
 		tcp_timer_needed();                        \
 	} while (0)
 
 #define TCP_RMV(pcbs, npcb)                            \
 	do {                                               \
+		TCP_HASH_RMV(pcbs, npcb);                      \
 		if (*(pcbs) == (npcb)) {                       \
 			(*(pcbs)) = (*pcbs)->next;                 \
 		} else {                                       \
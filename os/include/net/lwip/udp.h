@@ -108,6 +108,10 @@ struct udp_pcb {
 	/* Protocol specific PCB members */
 
 	struct udp_pcb *next;
+#if LWIP_UDP_PCB_HASH
+	/** next pcb with the same local port hash, see udp_hash_add() */
+	struct udp_pcb *hash_next;
+#endif							/* LWIP_UDP_PCB_HASH */
 
 	u8_t flags;
 	/** ports are in host byte order */
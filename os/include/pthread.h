@@ -324,6 +324,9 @@ struct pthread_mutex_s {
 	uint8_t type;			/* Type of the mutex.  See PTHREAD_MUTEX_* definitions */
 	int nlocks;				/* The number of recursive locks held */
 #endif
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	volatile uint8_t fastlock;	/* Locked by the fast path, no holder recorded */
+#endif
 };
 typedef struct pthread_mutex_s pthread_mutex_t;
 
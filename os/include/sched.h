@@ -69,6 +69,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <tinyara/sched.h>
 
 /********************************************************************************
@@ -362,6 +363,37 @@ void sched_note_switch(FAR struct tcb_s *pFromTcb, FAR struct tcb_s *pToTcb);
 #define sched_note_switch(t1, t2)
 #endif							/* CONFIG_SCHED_INSTRUMENTATION */
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+/**
+ *@cond
+ *@ internal
+ */
+void sched_note_irqhandler(int irq, FAR void *handler, bool enter);
+/**
+ *@endcond
+ */
+#else
+#define sched_note_irqhandler(i, h, e)
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SEMAPHORE
+/**
+ *@cond
+ *@ internal
+ */
+void sched_note_semwait(FAR struct tcb_s *tcb, FAR void *sem);
+/**
+ *@ internal
+ */
+void sched_note_semwake(FAR struct tcb_s *tcb, FAR void *sem);
+/**
+ *@endcond
+ */
+#else
+#define sched_note_semwait(t, s)
+#define sched_note_semwake(t, s)
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
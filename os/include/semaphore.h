@@ -92,18 +92,40 @@ struct tcb_s;					/* Forward reference */
  * @brief Structure of semholder
  */
 struct semholder_s {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if defined(CONFIG_SEM_TCBHOLDERS)
+	struct semholder_s *flink;	/* Implements doubly linked list */
+	struct semholder_s *blink;
+	FAR struct sem_s *sem;		/* Semaphore held (NULL: container is free) */
+#elif CONFIG_SEM_PREALLOCHOLDERS > 0
 	struct semholder_s *flink;	/* Implements singly linked list */
 #endif
 	FAR struct tcb_s *htcb;		/* Holder TCB */
 	int16_t counts;				/* Number of counts owned by this holder */
+#if defined(CONFIG_SEM_TCBHOLDERS)
+	uint16_t gen;				/* sem->gen when the container was taken */
+#endif
 };
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if defined(CONFIG_SEM_TCBHOLDERS)
+#define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, NULL, 0, 0}
+#elif CONFIG_SEM_PREALLOCHOLDERS > 0
 #define SEMHOLDER_INITIALIZER {NULL, NULL, 0}
 #else
 #define SEMHOLDER_INITIALIZER {NULL, 0}
 #endif
+
+#ifdef CONFIG_SEM_STATISTICS
+/**
+ * @ingroup SEMAPHORE_KERNEL
+ * @brief Contention statistics of a semaphore
+ */
+struct semstats_s {
+	uint32_t nwaits;			/* Number of times a thread had to wait */
+	uint32_t maxwait;			/* Longest wait in clock ticks */
+	uint8_t nholders;			/* Number of threads holding counts now */
+	uint8_t maxholders;			/* Largest number of holding threads */
+};
+#endif
 #endif							/* CONFIG_PRIORITY_INHERITANCE */
 
 /**
@@ -119,11 +141,17 @@ struct sem_s {
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t flags;			/* See PRIOINHERIT_FLAGS_* definitions */
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if CONFIG_SEM_PREALLOCHOLDERS > 0 || defined(CONFIG_SEM_TCBHOLDERS)
 	FAR struct semholder_s *hhead;	/* List of holders of semaphore counts */
+#if defined(CONFIG_SEM_TCBHOLDERS)
+	uint16_t gen;				/* Changed by every sem_init() */
+#endif
 #else
 	struct semholder_s holder;	/* Single holder */
 #endif
+#ifdef CONFIG_SEM_STATISTICS
+	struct semstats_s stats;	/* Contention statistics */
+#endif
 #endif
 };
 
@@ -135,7 +163,7 @@ typedef struct sem_s sem_t;
  * @brief Sem initializer
  */
 #ifdef CONFIG_PRIORITY_INHERITANCE
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if CONFIG_SEM_PREALLOCHOLDERS > 0 || defined(CONFIG_SEM_TCBHOLDERS)
 #define SEM_INITIALIZER(c) {(c), 0, NULL} /* semcount, flags, hhead */
 #else
 #define SEM_INITIALIZER(c) {(c), 0, SEMHOLDER_INITIALIZER} /* semcount, flags, holder */
@@ -288,12 +288,19 @@
 #define SYS_statfs                     (__SYS_filedesc+14)
 #define SYS_telldir                    (__SYS_filedesc+15)
 
+#ifdef CONFIG_DEV_PIPE_SPLICE
+#define SYS_splice                     (__SYS_filedesc+16)
+#define __SYS_streams                  (__SYS_filedesc+17)
+#else
+#define __SYS_streams                  (__SYS_filedesc+16)
+#endif
+
 #if CONFIG_NFILE_STREAMS > 0
-#define SYS_fs_fdopen                  (__SYS_filedesc+16)
-#define SYS_sched_getstreams           (__SYS_filedesc+17)
-#define __SYS_mountpoint               (__SYS_filedesc+18)
+#define SYS_fs_fdopen                  (__SYS_streams+0)
+#define SYS_sched_getstreams           (__SYS_streams+1)
+#define __SYS_mountpoint               (__SYS_streams+2)
 #else
-#define __SYS_mountpoint               (__SYS_filedesc+16)
+#define __SYS_mountpoint               __SYS_streams
 #endif
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT)
@@ -376,7 +383,15 @@
 #define SYS_mq_timedreceive            (__SYS_mqueue+7)
 #define SYS_mq_timedsend               (__SYS_mqueue+8)
 #define SYS_mq_unlink                  (__SYS_mqueue+9)
+#ifdef CONFIG_MQ_ZEROCOPY
+#define SYS_mq_getbuf                  (__SYS_mqueue+10)
+#define SYS_mq_sendbuf                 (__SYS_mqueue+11)
+#define SYS_mq_receivebuf              (__SYS_mqueue+12)
+#define SYS_mq_freebuf                 (__SYS_mqueue+13)
+#define __SYS_environ                  (__SYS_mqueue+14)
+#else
 #define __SYS_environ                  (__SYS_mqueue+10)
+#endif
 #else
 #define __SYS_environ                  __SYS_mqueue
 #endif
@@ -409,7 +424,12 @@
 #define SYS_sendto                     (__SYS_network+8)
 #define SYS_setsockopt                 (__SYS_network+9)
 #define SYS_socket                     (__SYS_network+10)
+#ifdef CONFIG_NET_SENDFILE
+#define SYS_net_sendfile               (__SYS_network+11)
+#define SYS_nnetsocket                 (__SYS_network+12)
+#else
 #define SYS_nnetsocket                 (__SYS_network+11)
+#endif
 #else
 #define SYS_nnetsocket                 __SYS_network
 #endif
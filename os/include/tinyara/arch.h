@@ -1468,6 +1468,59 @@ void up_timer_initialize(void);
 int up_timer_gettime(FAR struct timespec *ts);
 #endif
 
+/****************************************************************************
+ * Name: up_ttrace_timestamp
+ *
+ * Description:
+ *   Return a free running microsecond counter for the timestamps of the
+ *   T-trace scheduler records.  The counter may wrap at 32 bits.  Provided
+ *   by platform-specific code when CONFIG_TTRACE_SCHED_ARCH_TIMESTAMP is
+ *   selected; otherwise the system timer is used.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled, possibly from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TTRACE_SCHED_ARCH_TIMESTAMP
+uint32_t up_ttrace_timestamp(void);
+#endif
+
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Compute the 16-bit one's complement sum of len bytes at buf, which may
+ *   have any alignment.  The sum is returned in host byte order and is not
+ *   inverted, as lwIP expects from LWIP_CHKSUM.  Provided by the
+ *   architecture when it selects CONFIG_ARCH_HAVE_CHKSUM.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+uint16_t up_chksum(FAR const void *buf, int len);
+#endif
+
+/****************************************************************************
+ * Name: up_cyclecount_initialize and up_cyclecount
+ *
+ * Description:
+ *   up_cyclecount_initialize() starts the CPU cycle counter; it is called
+ *   early in up_initialize().  up_cyclecount() returns the free running
+ *   32-bit count of CPU cycles.  Differences are valid as long as the
+ *   interval is shorter than one wrap of the counter.
+ *
+ * Assumptions:
+ *   up_cyclecount() may be called with interrupts disabled and from
+ *   interrupt handlers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CYCLECOUNTER
+void up_cyclecount_initialize(void);
+uint32_t up_cyclecount(void);
+#endif
+
 /****************************************************************************
  * Name: up_alarm_cancel
  *
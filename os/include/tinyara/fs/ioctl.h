@@ -229,6 +229,12 @@
 										 *      the block with specific debug
 										 *      command and data.
 										 * OUT: None.  */
+#define BIOC_WRITEMULTI _BIOC(0x000C)	/* Allocate and write a run of chained
+										 * logical sectors in one operation
+										 * IN:  Pointer to multi-sector write
+										 *      data (see smart.h)
+										 * OUT: Number of sectors written or
+										 *      error */
 
 /* TinyAra MTD driver ioctl definitions ***************************************/
 
@@ -315,6 +321,15 @@
 											 *       (default)
 											 *     1=fre when empty
 											 * OUT: None */
+#define PIPEIOC_SETSIZE    _PIPEIOC(0x0002)	/* Set buffer size
+											 * IN: unsigned long integer
+											 *     new size in bytes
+											 * OUT: The new size is
+											 *     returned */
+#define PIPEIOC_GETSIZE    _PIPEIOC(0x0003)	/* Get buffer size
+											 * IN: None
+											 * OUT: The size is
+											 *     returned */
 /* RTC driver ioctl definitions *********************************************/
 /* (see include/tinyara/rtc.h */
 
@@ -162,6 +162,23 @@ struct mtd_dev_s {
 #endif
 };
 
+/* Garbage collection activity counters that a flash translation layer
+ * running on top of an MTD device may publish through the MTD procfs entry.
+ */
+
+#define MTD_GCSTATS_NAMELEN   16
+
+struct mtd_gcstats_s {
+	FAR struct mtd_gcstats_s *pnext;	/* Next registered set of counters */
+	char name[MTD_GCSTATS_NAMELEN];	/* Name of the owning device */
+	uint32_t runs;				/* Background collection passes */
+	uint32_t relocations;		/* Blocks relocated in the background */
+	uint32_t erases;			/* Fully released blocks erased in the background */
+	uint32_t deferred;			/* Erases moved off the write path */
+	uint32_t inlinegc;			/* Blocks collected inline on the write path */
+	uint16_t poolblocks;		/* Erase blocks worth of sectors in the pool */
+};
+
 enum mtd_partition_tag_s {
 	MTD_MASTER = 0,
 	MTD_FS = 1,
@@ -347,6 +364,19 @@ FAR struct mtd_dev_s *progmem_initialize(void);
 int mtd_register(FAR struct mtd_dev_s *mtd, FAR const char *name);
 #endif
 
+/****************************************************************************
+ * Name: mtd_register_gcstats
+ *
+ * Description:
+ *   Adds a set of garbage collection counters to the MTD procfs entry.  The
+ *   counters are owned by the caller and must stay valid while registered.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_REGISTRATION
+int mtd_register_gcstats(FAR struct mtd_gcstats_s *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
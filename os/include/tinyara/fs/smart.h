@@ -102,6 +102,23 @@ struct smart_read_write_s {
 	const uint8_t *buffer;		/* Pointer to the data to write */
 };
 
+/* The following defines a BIOC_WRITEMULTI request.  The driver allocates up
+ * to 'count' new logical sectors, places them in consecutive physical
+ * sectors and fills each one with 'hdr' followed by the next chunk of
+ * 'buffer'.  If 'linkoffset' is not 0xFFFF, the 16-bit number of the next
+ * sector of the run is stored at that offset of every header but the last.
+ * On return 'count' and 'logsectors' describe the sectors actually written.
+ */
+
+struct smart_multi_write_s {
+	uint16_t count;				/* Number of sectors requested / written */
+	uint16_t hdrlen;			/* Length of the per-sector header */
+	uint16_t linkoffset;		/* Offset of the chain link in the header */
+	const uint8_t *hdr;			/* Header copied to the start of each sector */
+	const uint8_t *buffer;		/* Data, (sector data size - hdrlen) per sector */
+	uint16_t *logsectors;		/* Receives the allocated logical sectors */
+};
+
 /* The following defines the procfs data exchange interface between the
  * SMART MTD and FS layers.
  */
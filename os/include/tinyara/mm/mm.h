@@ -59,6 +59,7 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
 
@@ -176,6 +177,15 @@
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* With CONFIG_MM_TLSF, each of the MM_NNODES power-of-two size classes is
+ * further split into MM_TLSF_SLCOUNT linearly spaced sub-classes.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#define MM_TLSF_SLSHIFT  CONFIG_MM_TLSF_SLSHIFT
+#define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLSHIFT)
+#endif
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -199,6 +209,7 @@
 #define HEAPINFO_DETAIL_ALL 2
 #define HEAPINFO_DETAIL_PID 3
 #define HEAPINFO_DETAIL_FREE 4
+#define HEAPINFO_TRACE 5
 #define HEAPINFO_PID_NOTNEEDED -1
 
 /* Determines the size of the chunk size/offset type */
@@ -236,6 +247,28 @@ typedef size_t mmaddress_t;		/* 32 bit address space */
 
 #define SIZEOF_MM_MALLOC_DEBUG_INFO \
 	(sizeof(mmaddress_t) + sizeof(pid_t) + sizeof(uint16_t))
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+/* Heap event trace record types */
+
+#define HEAPINFO_TRACE_ALLOC   'A'	/* malloc, zalloc, calloc or memalign */
+#define HEAPINFO_TRACE_FREE    'F'	/* free */
+#define HEAPINFO_TRACE_REALLOC 'R'	/* realloc or memalign done in place */
+
+/* One recorded heap event.  The trace is dumped as text by
+ * heapinfo_parse(heap, HEAPINFO_TRACE, ...) and can be replayed on a host
+ * by tools/heapbench.
+ */
+
+struct heapinfo_trace_s {
+	mmaddress_t addr;				/* Address returned to (or freed by) the user */
+	mmaddress_t prev;				/* Original address of a realloc */
+	mmaddress_t caller;				/* Return address of the caller, 0 if unknown */
+	mmsize_t size;					/* Usable size of the chunk */
+	pid_t pid;					/* PID of the caller */
+	char type;					/* HEAPINFO_TRACE_* */
+};
+#endif
 #endif
 
 /* This describes an allocated chunk.  An allocated chunk is
@@ -320,6 +353,16 @@ struct mm_heap_s {
 	int total_alloc_size;
 #endif
 
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+	/* Heap events recorded since initialization.  Recording stops when the
+	 * buffer is full so that the recorded trace can be replayed as is.
+	 */
+
+	uint32_t mm_ntrace;
+	uint32_t mm_tracedropped;
+	struct heapinfo_trace_s mm_trace[CONFIG_DEBUG_MM_HEAPINFO_TRACE_ENTRIES];
+#endif
+
 	/* This is the first and last nodes of the heap */
 
 	FAR struct mm_allocnode_s *mm_heapstart[CONFIG_MM_REGIONS];
@@ -329,12 +372,24 @@ struct mm_heap_s {
 	int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+	/* Free nodes are kept in one unordered, doubly linked list per size
+	 * class.  A bit is set in mm_flbitmap for every first-level class with
+	 * a non-empty second-level class and in mm_slbitmap[] for every
+	 * non-empty list.
+	 */
+
+	uint32_t mm_flbitmap;
+	uint32_t mm_slbitmap[MM_NNODES];
+	FAR struct mm_freenode_s *mm_freelist[MM_NNODES][MM_TLSF_SLCOUNT];
+#else
 	/* All free nodes are maintained in a doubly linked list.  This
 	 * array provides some hooks into the list at various points to
 	 * speed searches for free nodes.
 	 */
 
 	struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
 };
 
 /****************************************************************************
@@ -442,7 +497,11 @@ FAR void *kmm_malloc(size_t size);
 
 /* Functions contained in mm_free.c *****************************************/
 
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem, mmaddress_t caller_retaddr);
+#else
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+#endif
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -591,13 +650,23 @@ int kmm_mallinfo(struct mallinfo *info);
 
 void mm_shrinkchunk(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c (or mm_tlsf.c) *****************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c (or mm_tlsf.c) *****************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_findfreechunk.c (or mm_tlsf.c) ****************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size);
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
+#ifndef CONFIG_MM_TLSF
 int mm_size2ndx(size_t size);
+#endif
 
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 /* Functions contained in kmm_mallinfo.c . Used to display memory allocation details */
@@ -611,6 +680,15 @@ void heapinfo_update_total_size(struct mm_heap_s *heap, mmsize_t size);
 void heapinfo_exclude_stacksize(void *stack_ptr);
 #endif
 
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+/* Functions contained in mm_heapinfo.c to record and dump heap events.
+ * The caller must hold the heap semaphore when recording.
+ */
+
+void heapinfo_trace_event(FAR struct mm_heap_s *heap, char type, FAR void *mem, FAR void *prev, mmaddress_t caller_retaddr);
+void heapinfo_trace_dump(FAR struct mm_heap_s *heap);
+#endif
+
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 /* Functions to get heap information */
 struct mm_heap_s *mm_get_heap_info(void);
@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_MM_SMALLCACHE_H
+#define __INCLUDE_TINYARA_MM_SMALLCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_SMALLCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Small allocations are cached by chunk size.  There is one size class per
+ * MM_MIN_CHUNK step up to the chunk size of the largest cached request.
+ */
+
+#define MM_SMALLCACHE_MAXCHUNK  MM_ALIGN_UP(CONFIG_MM_SMALLCACHE_MAXSIZE + SIZEOF_MM_ALLOCNODE)
+#define MM_SMALLCACHE_NCLASSES  (MM_SMALLCACHE_MAXCHUNK >> MM_MIN_SHIFT)
+#define MM_SMALLCACHE_NDX(s)    (((s) >> MM_MIN_SHIFT) - 1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Per task group cache.  This lives in struct task_group_s; cached chunks
+ * stay allocated in the heap and are linked through their first word.
+ */
+
+struct mm_smallcache_s {
+	FAR void *sc_head[MM_SMALLCACHE_NCLASSES];	/* Free chunks of each size class */
+	uint16_t sc_count[MM_SMALLCACHE_NCLASSES];	/* Number of chunks in each list */
+};
+
+/* System-wide statistics of one size class */
+
+struct mm_smallcache_stats_s {
+	uint32_t hits;				/* Allocations served by a cache */
+	uint32_t refills;			/* Batch refills from the heap */
+	uint32_t frees;				/* Frees kept in a cache */
+	uint32_t drains;			/* Batch returns to the heap */
+	uint32_t cached;			/* Chunks currently held by all caches */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+EXTERN struct mm_smallcache_stats_s g_mm_smallcache_stats[MM_SMALLCACHE_NCLASSES];
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_smallcache_alloc
+ *
+ * Description:
+ *   Allocate a small chunk from the cache of the calling task group,
+ *   refilling the size class from the heap in one batch if it is empty.
+ *   Returns NULL if the request is not cacheable or if there is no cache
+ *   for the caller; the caller should then use the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *mm_smallcache_alloc(FAR struct mm_heap_s *heap, size_t size, mmaddress_t caller_retaddr);
+#else
+FAR void *mm_smallcache_alloc(FAR struct mm_heap_s *heap, size_t size);
+#endif
+
+/****************************************************************************
+ * Name: mm_smallcache_free
+ *
+ * Description:
+ *   Keep a small chunk in the cache of the calling task group, returning a
+ *   batch of chunks to the heap if the size class is over its high water
+ *   mark.  Returns false if the chunk was not cached; the caller should then
+ *   free it to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_smallcache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+
+/****************************************************************************
+ * Name: mm_smallcache_release
+ *
+ * Description:
+ *   Return every chunk held by a task group cache to the heap.  Called when
+ *   the last member leaves the group.
+ *
+ ****************************************************************************/
+
+void mm_smallcache_release(FAR struct mm_smallcache_s *cache);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* CONFIG_MM_SMALLCACHE */
+#endif							/* __INCLUDE_TINYARA_MM_SMALLCACHE_H */
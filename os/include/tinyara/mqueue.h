@@ -65,6 +65,7 @@
 #include <mqueue.h>
 #include <queue.h>
 #include <signal.h>
+#include <semaphore.h>
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -87,11 +88,17 @@ struct mqueue_inode_s {
 	int16_t nmsgs;				/* Number of message in the queue */
 	int16_t nwaitnotfull;		/* Number tasks waiting for not full */
 	int16_t nwaitnotempty;		/* Number tasks waiting for not empty */
-#if CONFIG_MQ_MAXMSGSIZE < 256
+#if CONFIG_MQ_MAXMSGSIZE < 256 && !defined(CONFIG_MQ_ZEROCOPY)
 	uint8_t maxmsgsize;			/* Max size of message in message queue */
 #else
 	uint16_t maxmsgsize;		/* Max size of message in message queue */
 #endif
+#ifdef CONFIG_MQ_ZEROCOPY
+	FAR char *pool;				/* Zero-copy message buffers (NULL if none) */
+	sq_queue_t poolfree;		/* Free zero-copy message buffers */
+	sem_t poolsem;				/* Counts the free zero-copy buffers */
+	int16_t poolheld;			/* Zero-copy buffers held by the user */
+#endif
 #ifndef CONFIG_DISABLE_SIGNALS
 	FAR struct mq_des *ntmqdes;	/* Notification: Owning mqdes (NULL if none) */
 	pid_t ntpid;				/* Notification: Receiving Task's PID */
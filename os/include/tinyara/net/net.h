@@ -466,6 +466,29 @@ int net_clone(FAR struct socket *psock1, FAR struct socket *psock2);
 
 int net_vfcntl(int sockfd, int cmd, va_list ap);
 
+/****************************************************************************
+ * Function: net_sendfile
+ *
+ * Description:
+ *   sendfile() for TCP sockets: queue file data to the socket without an
+ *   intermediate buffer.
+ *
+ * Parameters:
+ *   outfd    Socket descriptor of a connected TCP socket
+ *   infd     File descriptor opened for reading
+ *   offset   File offset to start at, or NULL for the current position
+ *   count    The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes sent; -1 on error with errno set appropriately.
+ *   ENOSYS if outfd is not a TCP socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+ssize_t net_sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
+#endif
+
 /****************************************************************************
  * Function: netdev_foreach
  *
@@ -62,6 +62,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <signal.h>
 #include <semaphore.h>
@@ -71,6 +72,7 @@
 
 #include <tinyara/irq.h>
 #include <tinyara/mm/shm.h>
+#include <tinyara/mm/smallcache.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/net/net.h>
 
@@ -461,6 +463,35 @@ struct task_group_s {
 
 	struct group_shm_s tg_shm;	/* Task shared memory logic                 */
 #endif
+
+#ifdef CONFIG_MM_SMALLCACHE
+	/* Small allocation cache **************************************************** */
+
+	struct mm_smallcache_s tg_smallcache;	/* Free small chunks of the group  */
+#endif
+};
+#endif
+
+/* struct cpuacct_s **************************************************************/
+/** @brief Per-thread CPU accounting.  All times are in CPU cycles. */
+
+#ifdef CONFIG_SCHED_CPUACCT
+#define CPUACCT_NBUCKETS 16
+
+struct cpuacct_s {
+	uint64_t runtime;			/* Cycles spent running                */
+	uint32_t nswitches;			/* Number of times switched in         */
+	uint32_t nwakeups;			/* Number of times made ready-to-run   */
+	uint32_t maxwakeup;			/* Longest ready-to-running latency    */
+	uint32_t maxpreemptoff;		/* Longest sched_lock() interval       */
+	uint32_t switchin;			/* Cycle count when last switched in   */
+	uint32_t readytime;			/* Cycle count when made ready-to-run  */
+	uint32_t locktime;			/* Cycle count when preemption locked  */
+	bool ready;					/* readytime is valid                  */
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+	uint32_t wakeup[CPUACCT_NBUCKETS];	/* Wakeup latency histogram    */
+	uint32_t preemptoff[CPUACCT_NBUCKETS];	/* Preemption off histogram */
+#endif
 };
 #endif
 
@@ -506,6 +537,9 @@ struct tcb_s {
 	uint8_t pend_reprios[CONFIG_SEM_NNESTPRIO];
 #endif
 	uint8_t base_priority;		/* "Normal" priority of the thread     */
+#ifdef CONFIG_SEM_TCBHOLDERS
+	struct semholder_s holders[CONFIG_SEM_NTCBHOLDERS];	/* Semaphores held */
+#endif
 #endif
 
 	uint8_t task_state;			/* Current state of the thread         */
@@ -520,6 +554,10 @@ struct tcb_s {
 #endif
 	FAR struct wdog_s *waitdog;	/* All timed waits used this wdog      */
 
+#ifdef CONFIG_SCHED_CPUACCT
+	struct cpuacct_s acct;		/* CPU accounting and latencies        */
+#endif
+
 	/* Stack-Related Fields ****************************************************** */
 
 	size_t adj_stack_size;		/* Stack size after adjustment         */
@@ -721,6 +759,20 @@ void sched_foreach(sched_foreach_t handler, FAR void *arg);
  */
 FAR struct tcb_s *sched_gettcb(pid_t pid);
 
+#ifdef CONFIG_SCHED_CPUACCT
+/**
+ * @ingroup SCHED_KERNEL
+ * @brief Return the CPU accounting data of a thread
+ * @details  The run time includes the current run of the thread if it is
+ *   the running thread.
+ * @param[in] pid The ID of the thread
+ * @param[out] acct The location to return the accounting data
+ * @return OK on success; -ESRCH if pid is not a valid thread
+ * @since Tizen RT v1.0
+ */
+int sched_cpuacct(pid_t pid, FAR struct cpuacct_s *acct);
+#endif
+
 /* File system helpers **********************************************************/
 /* These functions all extract lists from the group structure assocated with the
  * currently executing task.
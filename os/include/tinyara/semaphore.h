@@ -58,8 +58,10 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
 #include <semaphore.h>
 
+#include <tinyara/clock.h>
 #include <tinyara/fs/fs.h>
 
 /****************************************************************************
@@ -186,6 +188,71 @@ int sem_getprotocol(FAR sem_t *sem, FAR int *protocol);
 
 int sem_setprotocol(FAR sem_t *sem, int protocol);
 
+/****************************************************************************
+ * Function: sem_getstats
+ *
+ * Description:
+ *    Return the contention statistics of a semaphore.
+ *
+ * Parameters:
+ *    sem   - A pointer to the semaphore to be queried
+ *    stats - The user provided location in which to store the statistics
+ *
+ * Return Value:
+ *   0 if successful.  Otherwise, -1 is returned and the errno value is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_STATISTICS
+int sem_getstats(FAR sem_t *sem, FAR struct semstats_s *stats);
+
+/****************************************************************************
+ * Function: sem_resetstats
+ *
+ * Description:
+ *    Clear the wait statistics of a semaphore and restart the maximum
+ *    holder count from the current number of holders.
+ *
+ * Parameters:
+ *    sem - A pointer to the semaphore
+ *
+ * Return Value:
+ *   0 if successful.  Otherwise, -1 is returned and the errno value is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int sem_resetstats(FAR sem_t *sem);
+#endif
+
+/****************************************************************************
+ * Function: sem_tickwait
+ *
+ * Description:
+ *   This function is a lighter weight version of sem_timedwait().  It is
+ *   non-standard and intended only for use within the RTOS.  The timeout
+ *   is given as a delay in clock ticks from 'start' rather than as an
+ *   absolute time.
+ *
+ * Parameters:
+ *   sem   - Semaphore object
+ *   start - The system time that the delay is relative to.  If the
+ *           current time is not the same as the start time, then the
+ *           delay will be adjusted so that the end time will be the same
+ *           in any event.
+ *   delay - Ticks to wait from the start time until the semaphore is
+ *           posted.  If ticks is zero, then this function is equivalent
+ *           to sem_trywait().
+ *
+ * Return Value:
+ *   Zero (OK) is returned on success.  On failure, -1 (ERROR) is returned
+ *   and the errno is set appropriately (ETIMEDOUT, ENOMEM, EINTR).
+ *
+ ****************************************************************************/
+
+int sem_tickwait(FAR sem_t *sem, systime_t start, uint32_t delay);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
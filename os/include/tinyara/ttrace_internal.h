@@ -54,6 +54,8 @@
 #define TTRACE_BUFFER              'b'
 #define TTRACE_DUMP                'd'
 #define TTRACE_PRINT               'p'
+#define TTRACE_SCHED_ENABLE        'k'
+#define TTRACE_SCHED_SELECT        'r'
 
 #define TTRACE_CODE_VARIABLE        0
 #define TTRACE_CODE_UNIQUE         (1 << 7)
@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/ttrace_sched.h
+ *
+ * Binary format of the scheduler event records kept by the T-trace driver
+ * when CONFIG_TTRACE_SCHED is enabled.  The records are read back through
+ * the T-trace device after selecting them with the TTRACE_SCHED_SELECT
+ * ioctl.  The stream is one struct ttrace_sched_hdr_s followed by
+ * hdr.nrecords records of hdr.recsize bytes, oldest first, in the byte
+ * order of the target.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_TINYARA_TTRACE_SCHED_H
+#define __INCLUDE_TINYARA_TTRACE_SCHED_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TTRACE_SCHED_MAGIC       0x52535454	/* "TTSR" */
+#define TTRACE_SCHED_VERSION     1
+#define TTRACE_SCHED_NAMELEN     8
+
+/* Record types.  pid and prio always describe the task named below; the
+ * meaning of arg0 and arg1 depends on the type.
+ *
+ *   START    A task was created.  name holds the task name.
+ *   NAME     A task that already existed when recording was enabled.
+ *            name holds the task name.
+ *   STOP     A task exited.
+ *   SWITCH   The task started running.  arg0/arg1 are the pid/prio of
+ *            the task it replaced.
+ *   IRQENTER The task was interrupted.  arg0 is the IRQ number, arg1 the
+ *            address of the handler.
+ *   IRQLEAVE The handler for IRQ arg0 returned.
+ *   SEMWAIT  The task blocked on the semaphore at address arg0.
+ *   SEMWAKE  The task was given the semaphore at address arg0 by the task
+ *            with pid arg1, or by an interrupt handler if arg1 is -1.
+ */
+
+#define TTRACE_SCHED_START       1
+#define TTRACE_SCHED_NAME        2
+#define TTRACE_SCHED_STOP        3
+#define TTRACE_SCHED_SWITCH      4
+#define TTRACE_SCHED_IRQENTER    5
+#define TTRACE_SCHED_IRQLEAVE    6
+#define TTRACE_SCHED_SEMWAIT     7
+#define TTRACE_SCHED_SEMWAKE     8
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Stream header */
+
+struct ttrace_sched_hdr_s {
+	uint32_t magic;				/* TTRACE_SCHED_MAGIC */
+	uint16_t version;			/* TTRACE_SCHED_VERSION */
+	uint16_t recsize;			/* sizeof(struct ttrace_sched_rec_s) */
+	uint32_t nrecords;			/* Number of records that follow */
+	uint32_t nlost;				/* Older records that were overwritten */
+	uint32_t tsres;				/* Timestamp resolution in microseconds */
+};
+
+/* One scheduler event (16 bytes) */
+
+struct ttrace_sched_rec_s {
+	uint32_t ts;				/* Timestamp in microseconds, wraps */
+	uint8_t type;				/* TTRACE_SCHED_* */
+	uint8_t prio;				/* Priority of the task */
+	int16_t pid;				/* Task the event belongs to */
+	union {
+		struct {
+			uint32_t arg0;
+			uint32_t arg1;
+		} a;
+		char name[TTRACE_SCHED_NAMELEN];	/* Not terminated if full */
+	} u;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_TTRACE_SCHED
+/****************************************************************************
+ * Name: ttrace_sched_enable
+ *
+ * Description:
+ *   Start or stop recording scheduler events.  Starting discards the
+ *   records of the previous run and records the tasks that already exist.
+ *
+ ****************************************************************************/
+
+void ttrace_sched_enable(bool enable);
+
+/****************************************************************************
+ * Name: ttrace_sched_read
+ *
+ * Description:
+ *   Copy up to len bytes of the record stream, starting at offset pos, to
+ *   buffer.  Returns the number of bytes copied, zero at the end of the
+ *   stream or -EBUSY while recording is enabled.
+ *
+ ****************************************************************************/
+
+ssize_t ttrace_sched_read(off_t pos, FAR char *buffer, size_t len);
+
+/****************************************************************************
+ * Name: ttrace_sched_size
+ *
+ * Description:
+ *   Return the size in bytes of the record stream.
+ *
+ ****************************************************************************/
+
+size_t ttrace_sched_size(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* __INCLUDE_TINYARA_TTRACE_SCHED_H */
@@ -153,6 +153,9 @@ struct wdog_s {
 	uint8_t flags;				/* See WDOGF_* definitions above */
 	uint8_t argc;				/* The number of parameters to pass */
 	uint32_t parm[CONFIG_MAX_WDOGPARMS];
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	FAR struct wdog_s **pprev;	/* Link pointing at this watchdog in the timer wheel */
+#endif
 };
 
 /* Watchdog 'handle' */
@@ -308,7 +308,31 @@ struct work_s {
 	FAR void *arg;				/* Callback argument */
 	systime_t qtime;			/* Time work queued */
 	systime_t delay;			/* Delay until work performed */
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	FAR struct work_s *child;	/* Deadline heap link */
+#endif
+};
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+/* Statistics of one kernel work queue as returned by work_getstats().  All
+ * times are in clock ticks.  The latency of a work item is the time from
+ * its deadline (the time it was queued plus its delay) to the time its
+ * worker callback was started.
+ */
+
+struct work_stats_s {
+	uint32_t nqueued;			/* Number of work items queued */
+	uint32_t nrun;				/* Number of worker callbacks run */
+	uint32_t nwakeups;			/* Idle worker wakeups by work_queue() */
+	uint16_t npending;			/* Work items currently pending */
+	uint16_t maxpending;		/* Most work items ever pending at once */
+	uint32_t totlatency;		/* Sum of all latencies */
+	uint32_t maxlatency;		/* Longest latency */
+	uint32_t totrun;			/* Sum of all worker callback run times */
+	uint32_t maxrun;			/* Longest worker callback run time */
+	worker_t maxworker;			/* The worker callback that took maxrun */
 };
+#endif
 
 /****************************************************************************
  * Public Data
@@ -358,6 +382,12 @@ int work_usrstart(void);
  *   from the queue, or (2) work_cancel() has been called to cancel the work
  *   and remove it from the work queue.
  *
+ *   Work structures should be zero-initialized before their first use
+ *   (static storage or kmm_zalloc()).  The work queue clears the worker
+ *   field when the work is dequeued or cancelled; work with a non-NULL
+ *   worker has to be searched for in the queue before it can be queued or
+ *   cancelled, as that may be uninitialized memory.
+ *
  * Input parameters:
  *   qid    - The work queue ID
  *   work   - The work structure to queue
@@ -415,6 +445,26 @@ int work_cancel(int qid, FAR struct work_s *work);
 
 int work_signal(int qid);
 
+/****************************************************************************
+ * Name: work_getstats
+ *
+ * Description:
+ *   Return a snapshot of the latency and run-time statistics of a kernel
+ *   work queue.
+ *
+ * Input parameters:
+ *   qid    - The work queue ID (HPWORK or LPWORK)
+ *   stats  - Location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+int work_getstats(int qid, FAR struct work_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: work_available
  *
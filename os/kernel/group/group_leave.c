@@ -215,6 +215,12 @@ static inline void group_release(FAR struct task_group_s *group)
 	mq_release(group);
 #endif
 
+#ifdef CONFIG_MM_SMALLCACHE
+	/* Return the cached small chunks to the heap */
+
+	mm_smallcache_release(&group->tg_smallcache);
+#endif
+
 #if defined(CONFIG_BUILD_KERNEL) && defined(CONFIG_MM_SHM)
 	/* Release any resource held by shared memory virtual page allocator */
 
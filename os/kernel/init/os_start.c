@@ -353,6 +353,9 @@ void os_start(void)
 	/* Then add the idle task's TCB to the head of the ready to run list */
 
 	dq_addfirst((FAR dq_entry_t *)&g_idletcb, (FAR dq_queue_t *)&g_readytorun);
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	sched_prioindex_reset((FAR dq_queue_t *)&g_readytorun);
+#endif
 
 	/* Initialize the processor-specific portion of the TCB */
 
@@ -56,6 +56,7 @@
 
 #include <tinyara/config.h>
 
+#include <sched.h>
 #include <debug.h>
 #include <tinyara/arch.h>
 #include <tinyara/irq.h>
@@ -117,5 +118,7 @@ void irq_dispatch(int irq, FAR void *context)
 
 	/* Then dispatch to the interrupt handler */
 
+	sched_note_irqhandler(irq, (FAR void *)vector, true);
 	vector(irq, context, arg);
+	sched_note_irqhandler(irq, (FAR void *)vector, false);
 }
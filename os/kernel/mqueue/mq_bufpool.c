@@ -0,0 +1,223 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/mqueue/mq_bufpool.c
+ *
+ * Buffer pool of a zero-copy message queue.  A queue created with
+ * MQ_ZEROCOPY owns mq_maxmsg buffers, each a struct mqueue_msg_s header
+ * followed by mq_msgsize bytes of mail, allocated with the queue from the
+ * user heap so that the mail can be handed to the application.  Every
+ * message of such a queue lives in one of these buffers: mq_send() copies
+ * into a free buffer, mq_getbuf() gives one to the sender to fill in place
+ * and mq_receivebuf() gives the queued buffer to the receiver.  poolsem
+ * counts the free buffers.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <semaphore.h>
+#include <mqueue.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/kmalloc.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_poolinit
+ *
+ * Description:
+ *   Allocate the buffer pool of a new zero-copy message queue.  maxmsgs
+ *   and maxmsgsize must already be set.
+ *
+ * Return Value:
+ *   OK, or -ENOMEM if the pool could not be allocated.
+ *
+ ****************************************************************************/
+
+int mq_poolinit(FAR struct mqueue_inode_s *msgq)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+	size_t bufsize = MQ_POOLBUF_SIZE(msgq);
+	int i;
+
+	msgq->pool = (FAR char *)kumm_malloc(bufsize * msgq->maxmsgs);
+	if (!msgq->pool) {
+		return -ENOMEM;
+	}
+
+	sq_init(&msgq->poolfree);
+	msgq->poolheld = 0;
+	for (i = 0; i < msgq->maxmsgs; i++) {
+		mqmsg = (FAR struct mqueue_msg_s *)(msgq->pool + i * bufsize);
+		mqmsg->type = MQ_ALLOC_POOL;
+		sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->poolfree);
+	}
+
+	/* poolsem is a counting semaphore; there is no holder to boost */
+
+	sem_init(&msgq->poolsem, 0, msgq->maxmsgs);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&msgq->poolsem, SEM_PRIO_NONE);
+#endif
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mq_poolalloc
+ *
+ * Description:
+ *   Take a free buffer from the pool of a zero-copy message queue, waiting
+ *   for one unless mqdes is non-blocking or we are in an interrupt handler.
+ *   If abstime is not NULL the wait ends at that time.
+ *
+ * Return Value:
+ *   The buffer, or NULL with errno set (EAGAIN, EINTR, ETIMEDOUT).
+ *
+ ****************************************************************************/
+
+FAR struct mqueue_msg_s *mq_poolalloc(mqd_t mqdes, FAR const struct timespec *abstime)
+{
+	FAR struct mqueue_inode_s *msgq = mqdes->msgq;
+	FAR struct mqueue_msg_s *mqmsg;
+	irqstate_t saved_state;
+	int ret;
+
+	if (up_interrupt_context() || (mqdes->oflags & O_NONBLOCK) != 0) {
+		ret = sem_trywait(&msgq->poolsem);
+	} else if (abstime) {
+		ret = sem_timedwait(&msgq->poolsem, abstime);
+	} else {
+		ret = sem_wait(&msgq->poolsem);
+	}
+
+	if (ret != OK) {
+		return NULL;
+	}
+
+	saved_state = irqsave();
+	mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->poolfree);
+	irqrestore(saved_state);
+
+	DEBUGASSERT(mqmsg && mqmsg->type == MQ_ALLOC_POOL);
+	return mqmsg;
+}
+
+/****************************************************************************
+ * Name: mq_poolgrant
+ *
+ * Description:
+ *   Hand a pool buffer of msgq, taken from the pool or from the message
+ *   list, over to the user (mq_getbuf(), mq_receivebuf()).
+ *
+ ****************************************************************************/
+
+void mq_poolgrant(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg)
+{
+	irqstate_t saved_state;
+
+	saved_state = irqsave();
+	DEBUGASSERT(mqmsg->type == MQ_ALLOC_POOL);
+	mqmsg->type = MQ_ALLOC_POOLUSER;
+	msgq->poolheld++;
+	irqrestore(saved_state);
+}
+
+/****************************************************************************
+ * Name: mq_poolreclaim
+ *
+ * Description:
+ *   Take back a buffer that the user passes to mq_sendbuf() or
+ *   mq_freebuf().  buf must be the mail of a pool buffer of msgq that is
+ *   currently held by the user, so a buffer that was already freed or sent
+ *   is refused rather than queued or freed a second time.
+ *
+ * Return Value:
+ *   The buffer, or NULL if buf is not a buffer held by the user.
+ *
+ ****************************************************************************/
+
+FAR struct mqueue_msg_s *mq_poolreclaim(FAR struct mqueue_inode_s *msgq, FAR void *buf)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+	size_t bufsize = MQ_POOLBUF_SIZE(msgq);
+	irqstate_t saved_state;
+	uintptr_t offset;
+
+	if (!msgq->pool || !buf) {
+		return NULL;
+	}
+
+	mqmsg = MQ_BUF2MSG(buf);
+	offset = (uintptr_t)mqmsg - (uintptr_t)msgq->pool;
+	if (offset >= bufsize * msgq->maxmsgs || offset % bufsize != 0) {
+		return NULL;
+	}
+
+	saved_state = irqsave();
+	if (mqmsg->type != MQ_ALLOC_POOLUSER) {
+		irqrestore(saved_state);
+		return NULL;
+	}
+
+	mqmsg->type = MQ_ALLOC_POOL;
+	msgq->poolheld--;
+	irqrestore(saved_state);
+	return mqmsg;
+}
+
+/****************************************************************************
+ * Name: mq_msgrelease
+ *
+ * Description:
+ *   Free a message that has been removed from msgq: pool buffers go back to
+ *   the pool of the queue, anything else to mq_msgfree().
+ *
+ ****************************************************************************/
+
+void mq_msgrelease(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg)
+{
+	irqstate_t saved_state;
+
+	if (mqmsg->type != MQ_ALLOC_POOL) {
+		mq_msgfree(mqmsg);
+		return;
+	}
+
+	saved_state = irqsave();
+	sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->poolfree);
+	irqrestore(saved_state);
+
+	sem_post(&msgq->poolsem);
+}
+
+#endif							/* CONFIG_MQ_ZEROCOPY */
@@ -0,0 +1,72 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/mqueue/mq_freebuf.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <mqueue.h>
+#include <errno.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_freebuf
+ *
+ * Description:
+ *   Return a buffer obtained with mq_getbuf() or mq_receivebuf() to the
+ *   pool of its message queue.
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor the buffer was obtained from
+ *   buf   - The buffer
+ *
+ * Return Value:
+ *   OK on success.  On failure -1 (ERROR) is returned and errno is set to
+ *   EINVAL: buf does not belong to the pool of mqdes or is not held by the
+ *   caller (already freed or sent).
+ *
+ ****************************************************************************/
+
+int mq_freebuf(mqd_t mqdes, FAR void *buf)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+
+	mqmsg = mqdes ? mq_poolreclaim(mqdes->msgq, buf) : NULL;
+	if (!mqmsg) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	mq_msgrelease(mqdes->msgq, mqmsg);
+	return OK;
+}
+
+#endif							/* CONFIG_MQ_ZEROCOPY */
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/mqueue/mq_getbuf.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <mqueue.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_getbuf
+ *
+ * Description:
+ *   Take a buffer from the pool of a zero-copy message queue (one created
+ *   with MQ_ZEROCOPY in mq_attr.mq_flags).  The caller fills in up to
+ *   mq_msgsize bytes and either queues the buffer with mq_sendbuf() or
+ *   returns it with mq_freebuf().
+ *
+ *   If all buffers are in use, mq_getbuf() blocks until one is returned
+ *   unless the queue was opened with O_NONBLOCK.
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor, opened for writing
+ *
+ * Return Value:
+ *   The buffer on success.  On failure NULL is returned and errno is set:
+ *
+ *   EINVAL   mqdes is not a zero-copy message queue.
+ *   EPERM    mqdes was not opened for writing.
+ *   EAGAIN   No buffer is free and O_NONBLOCK is set.
+ *   EINTR    The wait was interrupted by a signal.
+ *
+ ****************************************************************************/
+
+FAR void *mq_getbuf(mqd_t mqdes)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+
+	if (!mqdes || !mqdes->msgq->pool) {
+		set_errno(EINVAL);
+		return NULL;
+	}
+
+	if ((mqdes->oflags & O_WROK) == 0) {
+		set_errno(EPERM);
+		return NULL;
+	}
+
+	mqmsg = mq_poolalloc(mqdes, NULL);
+	if (!mqmsg) {
+		return NULL;
+	}
+
+	mq_poolgrant(mqdes->msgq, mqmsg);
+	return mqmsg->mail;
+}
+
+#endif							/* CONFIG_MQ_ZEROCOPY */
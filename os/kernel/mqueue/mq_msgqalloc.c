@@ -114,12 +114,22 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 	FAR struct mqueue_inode_s *msgq;
 
 	/* Check if the caller is attempting to allocate a message for messages
-	 * larger than the configured maximum message size.
+	 * larger than the configured maximum message size.  Zero-copy queues
+	 * have their own buffers and are only limited by maxmsgsize.
 	 */
 
-	DEBUGASSERT(!attr || attr->mq_msgsize <= MQ_MAX_BYTES);
-	if (attr && attr->mq_msgsize > MQ_MAX_BYTES) {
-		return NULL;
+#ifdef CONFIG_MQ_ZEROCOPY
+	if (attr && (attr->mq_flags & MQ_ZEROCOPY) != 0) {
+		if (attr->mq_msgsize > UINT16_MAX || attr->mq_maxmsg <= 0) {
+			return NULL;
+		}
+	} else
+#endif
+	{
+		DEBUGASSERT(!attr || attr->mq_msgsize <= MQ_MAX_BYTES);
+		if (attr && attr->mq_msgsize > MQ_MAX_BYTES) {
+			return NULL;
+		}
 	}
 
 	/* Allocate memory for the new message queue. */
@@ -141,6 +151,13 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode, FAR struct mq_attr *attr)
 #ifndef CONFIG_DISABLE_SIGNALS
 		msgq->ntpid = INVALID_PROCESS_ID;
 #endif
+
+#ifdef CONFIG_MQ_ZEROCOPY
+		if (attr && (attr->mq_flags & MQ_ZEROCOPY) != 0 && mq_poolinit(msgq) != OK) {
+			sched_kfree(msgq);
+			return NULL;
+		}
+#endif
 	}
 
 	return msgq;
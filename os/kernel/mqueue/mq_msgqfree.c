@@ -114,10 +114,32 @@ void mq_msgqfree(FAR struct mqueue_inode_s *msgq)
 		/* Deallocate the message structure. */
 
 		next = curr->next;
-		mq_msgfree(curr);
+#ifdef CONFIG_MQ_ZEROCOPY
+		if (curr->type != MQ_ALLOC_POOL)
+#endif
+		{
+			mq_msgfree(curr);
+		}
 		curr = next;
 	}
 
+#ifdef CONFIG_MQ_ZEROCOPY
+	/* Buffers of a zero-copy queue go away with the pool.  If the user
+	 * still holds some of them (mq_getbuf() or mq_receivebuf() without a
+	 * matching mq_sendbuf() or mq_freebuf() before the last mq_close()),
+	 * the pool is left allocated so that they stay valid memory.
+	 */
+
+	if (msgq->pool) {
+		sem_destroy(&msgq->poolsem);
+		if (msgq->poolheld == 0) {
+			kumm_free(msgq->pool);
+		} else {
+			sdbg("%d zero-copy buffers still held, pool not freed\n", msgq->poolheld);
+		}
+	}
+#endif
+
 	/* Then deallocate the message queue itself */
 
 	sched_kfree(msgq);
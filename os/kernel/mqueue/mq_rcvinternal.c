@@ -254,7 +254,8 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
  * Parameters:
  *   mqdes - Message queue descriptor
  *   mqmsg   - The message obtained by mq_waitmsg()
- *   ubuffer - The address of the user provided buffer to receive the message
+ *   ubuffer - The address of the user provided buffer to receive the message,
+ *             or NULL if the caller takes over mqmsg (mq_receivebuf)
  *   prio    - The user-provided location to return the message priority.
  *
  * Return Value:
@@ -280,11 +281,16 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 	/* Get the length of the message (also the return value) */
 
+	msgq = mqdes->msgq;
 	rcvmsglen = mqmsg->msglen;
 
-	/* Copy the message into the caller's buffer */
+	/* Copy the message into the caller's buffer.  There is no buffer for a
+	 * zero-copy receive; the message itself is handed to the caller.
+	 */
 
-	memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+	if (ubuffer) {
+		memcpy(ubuffer, (const void *)mqmsg->mail, rcvmsglen);
+	}
 
 	/* Copy the message priority as well (if a buffer is provided) */
 
@@ -294,11 +300,16 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR char *ubuf
 
 	/* We are done with the message.  Deallocate it now. */
 
-	mq_msgfree(mqmsg);
+	if (ubuffer) {
+#ifdef CONFIG_MQ_ZEROCOPY
+		mq_msgrelease(msgq, mqmsg);
+#else
+		mq_msgfree(mqmsg);
+#endif
+	}
 
 	/* Check if any tasks are waiting for the MQ not full event. */
 
-	msgq = mqdes->msgq;
 	if (msgq->nwaitnotfull > 0) {
 		/* Find the highest priority task that is waiting for
 		 * this queue to be not-full in g_waitingformqnotfull list.
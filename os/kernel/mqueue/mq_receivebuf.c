@@ -0,0 +1,109 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/mqueue/mq_receivebuf.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <mqueue.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_receivebuf
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages from a zero-copy
+ *   message queue without copying it.  This behaves like mq_receive()
+ *   except that *buf is set to the buffer holding the message.  The caller
+ *   owns the buffer and must return it with mq_freebuf() on the same
+ *   queue when done.
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor, opened for reading
+ *   buf   - Location to return the message buffer
+ *   prio  - If not NULL, the location to store message priority.
+ *
+ * Return Value:
+ *   On success, the length of the message in bytes is returned.  On failure
+ *   -1 (ERROR) is returned and errno is set as for mq_receive().  EINVAL
+ *   is also returned if mqdes is not a zero-copy message queue.
+ *
+ ****************************************************************************/
+
+ssize_t mq_receivebuf(mqd_t mqdes, FAR void **buf, FAR int *prio)
+{
+	FAR struct mqueue_msg_s *mqmsg;
+	irqstate_t saved_state;
+	ssize_t ret = ERROR;
+
+	DEBUGASSERT(up_interrupt_context() == false);
+
+	/* mq_receivebuf() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	if (!buf || !mqdes || !mqdes->msgq->pool) {
+		set_errno(EINVAL);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if ((mqdes->oflags & O_RDOK) == 0) {
+		set_errno(EPERM);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	/* See mq_receive() */
+
+	sched_lock();
+	saved_state = irqsave();
+	mqmsg = mq_waitreceive(mqdes);
+	irqrestore(saved_state);
+
+	if (mqmsg) {
+		ret = mq_doreceive(mqdes, mqmsg, NULL, prio);
+		mq_poolgrant(mqdes->msgq, mqmsg);
+		*buf = mqmsg->mail;
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
+
+#endif							/* CONFIG_MQ_ZEROCOPY */
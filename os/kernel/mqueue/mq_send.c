@@ -171,7 +171,11 @@ int mq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
 		/* Allocate the message */
 
 		irqrestore(saved_state);
+#ifdef CONFIG_MQ_ZEROCOPY
+		mqmsg = msgq->pool ? mq_poolalloc(mqdes, NULL) : mq_msgalloc();
+#else
 		mqmsg = mq_msgalloc();
+#endif
 	} else {
 		/* We cannot send the message (and didn't even try to allocate it)
 		 * because:
@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/mqueue/mq_sendbuf.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <mqueue.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_sendbuf
+ *
+ * Description:
+ *   Queue a buffer obtained with mq_getbuf() on the same message queue.
+ *   This behaves like mq_send() except that the message is not copied:
+ *   the buffer itself is queued and ownership passes to the receiver.
+ *
+ * Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buf    - Buffer from mq_getbuf(), holding the message
+ *   msglen - Message length
+ *   prio   - Message priority
+ *
+ * Return Value:
+ *   On success, OK is returned.  On failure -1 (ERROR) is returned, errno
+ *   is set as for mq_send() and the caller still owns buf.  In addition:
+ *
+ *   EINVAL   buf does not belong to the pool of mqdes or is not held by
+ *            the caller (already freed or sent).
+ *
+ ****************************************************************************/
+
+int mq_sendbuf(mqd_t mqdes, FAR void *buf, size_t msglen, int prio)
+{
+	FAR struct mqueue_inode_s *msgq;
+	FAR struct mqueue_msg_s *mqmsg;
+	irqstate_t saved_state;
+	int ret = ERROR;
+
+	/* mq_sendbuf() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	if (!mqdes) {
+		set_errno(EINVAL);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	if (mq_verifysend(mqdes, buf, msglen, prio) != OK) {
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	/* Take the buffer back from the caller, so that it cannot be sent or
+	 * freed twice.  It is handed back if it cannot be queued.
+	 */
+
+	mqmsg = mq_poolreclaim(mqdes->msgq, buf);
+	if (!mqmsg) {
+		set_errno(EINVAL);
+		leave_cancellation_point();
+		return ERROR;
+	}
+
+	/* As in mq_send(), wait until the queue is not full unless we are in an
+	 * interrupt handler.  There is nothing to allocate.
+	 */
+
+	sched_lock();
+	msgq = mqdes->msgq;
+
+	saved_state = irqsave();
+	if (up_interrupt_context() ||	/* In an interrupt handler */
+		msgq->nmsgs < msgq->maxmsgs ||	/* OR Message queue not full */
+		mq_waitsend(mqdes) == OK) {	/* OR Successfully waited for mq not full */
+		irqrestore(saved_state);
+		ret = mq_dosend(mqdes, mqmsg, buf, msglen, prio);
+	} else {
+		irqrestore(saved_state);
+	}
+
+	if (ret != OK) {
+		mq_poolgrant(msgq, mqmsg);
+	}
+
+	sched_unlock();
+	leave_cancellation_point();
+	return ret;
+}
+
+#endif							/* CONFIG_MQ_ZEROCOPY */
@@ -335,7 +335,7 @@ int mq_waitsend(mqd_t mqdes)
  *
  * Parameters:
  *   mqdes - Message queue descriptor
- *   msg - Message to send
+ *   msg - Message to send (mqmsg->mail if it was filled in place)
  *   msglen - The length of the message in bytes
  *   prio - The priority of the message
  *
@@ -366,9 +366,13 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 	mqmsg->priority = prio;
 	mqmsg->msglen = msglen;
 
-	/* Copy the message data into the message */
+	/* Copy the message data into the message, unless it was filled in place
+	 * (zero-copy send).
+	 */
 
-	memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+	if (msg != mqmsg->mail) {
+		memcpy((void *)mqmsg->mail, (FAR const void *)msg, msglen);
+	}
 
 	/* Insert the new message in the message queue */
 
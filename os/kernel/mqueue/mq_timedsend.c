@@ -253,7 +253,11 @@ int mq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio, FAR
 		/* Allocate the message */
 
 		irqrestore(saved_state);
+#ifdef CONFIG_MQ_ZEROCOPY
+		mqmsg = msgq->pool ? mq_poolalloc(mqdes, abstime) : mq_msgalloc();
+#else
 		mqmsg = mq_msgalloc();
+#endif
 	} else {
 		int ticks;
 
@@ -309,7 +313,11 @@ int mq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio, FAR
 		 */
 
 		if (ret == OK) {
+#ifdef CONFIG_MQ_ZEROCOPY
+			mqmsg = msgq->pool ? mq_poolalloc(mqdes, abstime) : mq_msgalloc();
+#else
 			mqmsg = mq_msgalloc();
+#endif
 		}
 	}
 
@@ -63,6 +63,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <limits.h>
 #include <mqueue.h>
 #include <sched.h>
@@ -99,16 +100,21 @@
 enum mqalloc_e {
 	MQ_ALLOC_FIXED = 0,			/* pre-allocated; never freed */
 	MQ_ALLOC_DYN,				/* dynamically allocated; free when unused */
-	MQ_ALLOC_IRQ				/* Preallocated, reserved for interrupt handling */
+	MQ_ALLOC_IRQ,				/* Preallocated, reserved for interrupt handling */
+	MQ_ALLOC_POOL,				/* Zero-copy buffer, free or queued */
+	MQ_ALLOC_POOLUSER			/* Zero-copy buffer held by the user */
 };
 
-/* This structure describes one buffered POSIX message. */
+/* This structure describes one buffered POSIX message.  The buffers in
+ * the pool of a zero-copy queue use the same header followed by
+ * maxmsgsize bytes of mail, which may be more or less than MQ_MAX_BYTES.
+ */
 
 struct mqueue_msg_s {
 	FAR struct mqueue_msg_s *next;	/* Forward link to next message */
 	uint8_t type;					/* (Used to manage allocations) */
 	uint8_t priority;				/* priority of message */
-#if MQ_MAX_BYTES < 256
+#if MQ_MAX_BYTES < 256 && !defined(CONFIG_MQ_ZEROCOPY)
 	uint8_t msglen;					/* Message data length */
 #else
 	uint16_t msglen;				/* Message data length */
@@ -116,6 +122,16 @@ struct mqueue_msg_s {
 	char mail[MQ_MAX_BYTES];		/* Message data */
 };
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/* Size of one pool buffer of a zero-copy queue and the header that
+ * precedes the mail handed out to the user.
+ */
+
+#define MQ_POOLHDR_SIZE       offsetof(struct mqueue_msg_s, mail)
+#define MQ_POOLBUF_SIZE(q)    (((MQ_POOLHDR_SIZE + (q)->maxmsgsize) + 7) & ~7)
+#define MQ_BUF2MSG(b)         ((FAR struct mqueue_msg_s *)((FAR char *)(b) - MQ_POOLHDR_SIZE))
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -175,6 +191,16 @@ FAR struct mqueue_msg_s *mq_msgalloc(void);
 int mq_waitsend(mqd_t mqdes);
 int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg, size_t msglen, int prio);
 
+/* mq_bufpool.c ************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+int mq_poolinit(FAR struct mqueue_inode_s *msgq);
+FAR struct mqueue_msg_s *mq_poolalloc(mqd_t mqdes, FAR const struct timespec *abstime);
+void mq_poolgrant(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg);
+FAR struct mqueue_msg_s *mq_poolreclaim(FAR struct mqueue_inode_s *msgq, FAR void *buf);
+void mq_msgrelease(FAR struct mqueue_inode_s *msgq, FAR struct mqueue_msg_s *mqmsg);
+#endif
+
 /* mq_release.c ************************************************************/
 
 struct task_group_s;			/* Forward reference */
@@ -133,10 +133,21 @@ int pthread_mutex_trytake(FAR struct pthread_mutex_s *mutex);
 int pthread_mutex_give(FAR struct pthread_mutex_s *mutex);
 void pthread_mutex_inconsistent(FAR struct pthread_tcb_s *tcb);
 #else
-#define pthread_mutex_take(m,i) pthread_sem_take(&(m)->sem,(i))
 #define pthread_mutex_trytake(m) pthread_sem_trytake(&(m)->sem)
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+#define pthread_mutex_take(m,i) (pthread_mutex_fastcontend(m), pthread_sem_take(&(m)->sem,(i)))
+#define pthread_mutex_give(m)   ((m)->fastlock = 0, pthread_sem_give(&(m)->sem))
+#else
+#define pthread_mutex_take(m,i) pthread_sem_take(&(m)->sem,(i))
 #define pthread_mutex_give(m)   pthread_sem_give(&(m)->sem)
 #endif
+#endif
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+bool pthread_mutex_fasttake(FAR struct pthread_mutex_s *mutex);
+bool pthread_mutex_fastgive(FAR struct pthread_mutex_s *mutex);
+void pthread_mutex_fastcontend(FAR struct pthread_mutex_s *mutex);
+#endif
 
 #if defined(CONFIG_CANCELLATION_POINTS) && !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
 uint16_t pthread_disable_cancel(void);
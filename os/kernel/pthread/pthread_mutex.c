@@ -142,6 +142,14 @@ int pthread_mutex_take(FAR struct pthread_mutex_s *mutex, bool intr)
 			 * returns zero on success and a positive errno value on failure.
 			 */
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+			/* Let the owner inherit our priority if it took the mutex
+			 * through the fast path.
+			 */
+
+			pthread_mutex_fastcontend(mutex);
+#endif
+
 			ret = pthread_sem_take(&mutex->sem, intr);
 			if (ret == OK) {
 				/* Check if the holder of the mutex has terminated without
@@ -268,6 +276,12 @@ int pthread_mutex_give(FAR struct pthread_mutex_s *mutex)
 		mutex->flink = NULL;
 		irqrestore(flags);
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+		/* The mutex is released through the semaphore from now on */
+
+		mutex->fastlock = 0;
+#endif
+
 		/* Now release the underlying semaphore */
 
 		ret = pthread_sem_give(&mutex->sem);
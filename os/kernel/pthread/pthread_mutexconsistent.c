@@ -136,6 +136,9 @@ int pthread_mutex_consistent(FAR pthread_mutex_t *mutex)
 				mutex->flags &= _PTHREAD_MFLAGS_ROBUST;
 #ifdef CONFIG_PTHREAD_MUTEX_TYPES
 				mutex->nlocks = 0;
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+				mutex->fastlock = 0;
 #endif
 				/* Reset the semaphore.  This has the same affect as if the
 				 * dead task had called pthread_mutex_unlock().
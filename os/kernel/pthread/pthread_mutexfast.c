@@ -0,0 +1,255 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/pthread/pthread_mutexfast.c
+ *
+ * An uncontended mutex is locked and unlocked with a compare-and-swap on
+ * the count of the semaphore underlying the mutex:
+ *
+ *    1 -> 0  Lock an available mutex
+ *    0 -> 1  Unlock a mutex that nobody is waiting for
+ *
+ * Because the count is the same one that sem_wait() and sem_post() use,
+ * the slow paths do not need to know how the mutex was taken.  The only
+ * state the fast path skips is the priority inheritance holder.  The
+ * fastlock flag marks a mutex that was taken without recording its holder;
+ * the first thread that has to wait for the mutex records the holder on
+ * behalf of the owner and clears the flag so that the owner will release
+ * the mutex through sem_post().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/sched.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+#include "pthread/pthread.h"
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_cas
+ *
+ * Description:
+ *   Atomically replace the count of the semaphore underlying the mutex
+ *   with 'newcount' if it is still 'oldcount'.
+ *
+ ****************************************************************************/
+
+static inline bool pthread_mutex_cas(FAR struct pthread_mutex_s *mutex, int16_t oldcount, int16_t newcount)
+{
+	return __atomic_compare_exchange_n(&mutex->sem.semcount, &oldcount, newcount, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_fasttake
+ *
+ * Description:
+ *   Take the mutex if it is available, without blocking and without going
+ *   through sem_wait().  Robust mutexes are also added to the list of
+ *   mutexes held by the calling thread.
+ *
+ * Parameters:
+ *  mutex - The mutex to be locked
+ *
+ * Return Value:
+ *   true if the calling thread now owns the mutex.  false if the mutex is
+ *   locked (by any thread, including the caller) or inconsistent; the
+ *   caller must then take the normal path.
+ *
+ ****************************************************************************/
+
+bool pthread_mutex_fasttake(FAR struct pthread_mutex_s *mutex)
+{
+	bool taken = false;
+
+	/* A waiter must not run between the count update and the publication of
+	 * the owner below, or it would find the mutex locked with no owner to
+	 * record.  The list of held mutexes is only modified by threads, so
+	 * locking the scheduler also keeps it and the inconsistent flag stable.
+	 */
+
+	sched_lock();
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+	if ((mutex->flags & _PTHREAD_MFLAGS_INCONSISTENT) == 0 && pthread_mutex_cas(mutex, 1, 0)) {
+		FAR struct pthread_tcb_s *rtcb = (FAR struct pthread_tcb_s *)this_task();
+
+		DEBUGASSERT(mutex->flink == NULL);
+		mutex->flink = rtcb->mhead;
+		rtcb->mhead = mutex;
+		taken = true;
+	}
+#else
+	taken = pthread_mutex_cas(mutex, 1, 0);
+#endif
+
+	if (taken) {
+		mutex->pid = (int)getpid();
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		mutex->nlocks = 1;
+#endif
+
+		/* Publish the owner before the flag; a waiter uses mutex->pid to
+		 * find the TCB of the holder.
+		 */
+
+		__atomic_store_n(&mutex->fastlock, 1, __ATOMIC_RELEASE);
+	}
+
+	sched_unlock();
+	return taken;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_fastgive
+ *
+ * Description:
+ *   Release a mutex that was taken by pthread_mutex_fasttake().  If another
+ *   thread started waiting in the meantime, the mutex is released through
+ *   sem_post() instead.
+ *
+ * Parameters:
+ *  mutex - The mutex to be unlocked.  The caller must have verified that
+ *          it holds the mutex and that this is the outermost unlock.
+ *
+ * Return Value:
+ *   true if the mutex was released.  false if it was not taken by the fast
+ *   path; the caller must then take the normal path.
+ *
+ ****************************************************************************/
+
+bool pthread_mutex_fastgive(FAR struct pthread_mutex_s *mutex)
+{
+	bool given = false;
+
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+	sched_lock();
+#endif
+
+	if (__atomic_load_n(&mutex->fastlock, __ATOMIC_ACQUIRE) != 0) {
+		/* Clear the flag before the count becomes available so that a new
+		 * owner never sees a stale flag.
+		 */
+
+		mutex->fastlock = 0;
+		mutex->pid = -1;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+		mutex->nlocks = 0;
+#endif
+
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+		{
+			FAR struct pthread_tcb_s *rtcb = (FAR struct pthread_tcb_s *)this_task();
+			FAR struct pthread_mutex_s *curr;
+			FAR struct pthread_mutex_s *prev;
+
+			/* Remove the mutex from the list of mutexes held by this thread */
+
+			for (prev = NULL, curr = rtcb->mhead; curr != NULL && curr != mutex; prev = curr, curr = curr->flink) ;
+
+			DEBUGASSERT(curr == mutex);
+			if (prev == NULL) {
+				rtcb->mhead = mutex->flink;
+			} else {
+				prev->flink = mutex->flink;
+			}
+
+			mutex->flink = NULL;
+		}
+#endif
+
+		/* A thread that started waiting after the flag was cleared is woken
+		 * up by sem_post().
+		 */
+
+		if (!pthread_mutex_cas(mutex, 0, 1)) {
+			(void)pthread_sem_give(&mutex->sem);
+		}
+
+		given = true;
+	}
+
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+	sched_unlock();
+#endif
+	return given;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_fastcontend
+ *
+ * Description:
+ *   Called by a thread that is about to wait for the mutex.  If the mutex
+ *   was taken by the fast path, record the owner as the holder of the
+ *   semaphore so that it can inherit the priority of the waiter, and make
+ *   the owner release the mutex with sem_post().
+ *
+ * Parameters:
+ *  mutex - The mutex about to be waited for
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pthread_mutex_fastcontend(FAR struct pthread_mutex_s *mutex)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	FAR struct tcb_s *htcb;
+#endif
+	irqstate_t flags;
+
+	/* The owner must not release the mutex while its holder is recorded */
+
+	flags = irqsave();
+	if (mutex->fastlock != 0) {
+		mutex->fastlock = 0;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+		htcb = sched_gettcb(mutex->pid);
+		if (htcb != NULL && mutex->sem.semcount <= 0) {
+			sem_addholder_tcb(htcb, &mutex->sem);
+		}
+#endif
+	}
+
+	irqrestore(flags);
+}
+
+#endif							/* CONFIG_PTHREAD_MUTEX_FASTPATH */
@@ -176,6 +176,9 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
 
 		mutex->type = type;
 		mutex->nlocks = 0;
+#endif
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+		mutex->fastlock = 0;
 #endif
 	}
 
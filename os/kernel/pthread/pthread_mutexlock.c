@@ -150,6 +150,18 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 	DEBUGASSERT(mutex != NULL);
 
 	if (mutex != NULL) {
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+		/* Take an available mutex without going through the semaphore.  A
+		 * locked mutex, including a recursive one held by the caller, is
+		 * handled below.
+		 */
+
+		if (pthread_mutex_fasttake(mutex)) {
+			svdbg("Returning %d\n", OK);
+			return OK;
+		}
+#endif
+
 		/* Make sure the semaphore is stable while we make the following
 		 * checks.  This all needs to be one atomic action.
 		 */
@@ -154,6 +154,22 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 		return EINVAL;
 	}
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+	/* If the calling thread took the mutex through the fast path and this
+	 * is the outermost unlock, release it the same way.
+	 */
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+	if (mutex->pid == (int)getpid() && mutex->nlocks <= 1 && pthread_mutex_fastgive(mutex))
+#else
+	if (mutex->pid == (int)getpid() && pthread_mutex_fastgive(mutex))
+#endif
+	{
+		svdbg("Returning %d\n", OK);
+		return OK;
+	}
+#endif
+
 	/* Make sure the semaphore is stable while we make the following checks.
 	 * This all needs to be one atomic action.
 	 */
@@ -250,6 +250,14 @@ extern volatile uint32_t g_cpuload_total;
 bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *newTcb, DSEG dq_queue_t *list);
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+bool sched_prioindex_add(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+void sched_prioindex_reset(DSEG dq_queue_t *list);
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#else
+#define sched_removeprioritized(tcb, list) \
+		dq_rem((FAR dq_entry_t *)(tcb), (list))
+#endif
 bool sched_mergepending(void);
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
@@ -276,6 +284,18 @@ void sched_timer_reassess(void);
 void weak_function sched_process_cpuload(void);
 #endif
 
+#ifdef CONFIG_SCHED_CPUACCT
+void sched_cpuacct_switch(FAR struct tcb_s *from, FAR struct tcb_s *to);
+void sched_cpuacct_ready(FAR struct tcb_s *tcb);
+void sched_cpuacct_lock(FAR struct tcb_s *tcb);
+void sched_cpuacct_unlock(FAR struct tcb_s *tcb);
+#else
+#define sched_cpuacct_switch(f, t)
+#define sched_cpuacct_ready(t)
+#define sched_cpuacct_lock(t)
+#define sched_cpuacct_unlock(t)
+#endif
+
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
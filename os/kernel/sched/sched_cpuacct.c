@@ -0,0 +1,217 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/sched/sched_cpuacct.c
+ *
+ * Per-thread CPU accounting driven by the context switch points of the
+ * scheduler (the same places that call sched_note_switch()).  Times are
+ * taken from the architecture cycle counter, so they are exact rather
+ * than sampled like the CPU load of sched_cpuload.c.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUACCT
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+/****************************************************************************
+ * Name: sched_cpuacct_bucket
+ *
+ * Description:
+ *   Map an interval to its histogram bucket.  See
+ *   CONFIG_SCHED_CPUACCT_HISTSHIFT for the bounds of the buckets.
+ *
+ ****************************************************************************/
+
+static inline int sched_cpuacct_bucket(uint32_t cycles)
+{
+	int bucket;
+
+	if ((cycles >> CONFIG_SCHED_CPUACCT_HISTSHIFT) == 0) {
+		return 0;
+	}
+
+	bucket = 31 - __builtin_clz(cycles) - CONFIG_SCHED_CPUACCT_HISTSHIFT + 1;
+	return bucket < CPUACCT_NBUCKETS ? bucket : CPUACCT_NBUCKETS - 1;
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_cpuacct_preemptoff
+ *
+ * Description:
+ *   Record an interval during which tcb ran with preemption disabled.
+ *
+ ****************************************************************************/
+
+static void sched_cpuacct_preemptoff(FAR struct tcb_s *tcb, uint32_t now)
+{
+	uint32_t elapsed = now - tcb->acct.locktime;
+
+	if (elapsed > tcb->acct.maxpreemptoff) {
+		tcb->acct.maxpreemptoff = elapsed;
+	}
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+	tcb->acct.preemptoff[sched_cpuacct_bucket(elapsed)]++;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_cpuacct_switch
+ *
+ * Description:
+ *   Called when the running thread changes from 'from' to 'to'.  Charge
+ *   the cycles since 'from' was switched in to 'from' and, if 'to' was
+ *   just made ready-to-run, record its wakeup latency.
+ *
+ *   A thread that blocks while it has preemption disabled lets the other
+ *   threads run, so its preemption-off interval is closed here and a new
+ *   one is started when it runs again.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_cpuacct_switch(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+	uint32_t now = up_cyclecount();
+	uint32_t elapsed;
+
+	from->acct.runtime += (uint32_t)(now - from->acct.switchin);
+	if (from->lockcount > 0) {
+		sched_cpuacct_preemptoff(from, now);
+	}
+
+	to->acct.switchin = now;
+	to->acct.nswitches++;
+	if (to->lockcount > 0) {
+		to->acct.locktime = now;
+	}
+
+	if (to->acct.ready) {
+		to->acct.ready = false;
+		elapsed = now - to->acct.readytime;
+		if (elapsed > to->acct.maxwakeup) {
+			to->acct.maxwakeup = elapsed;
+		}
+#ifdef CONFIG_SCHED_CPUACCT_HISTOGRAM
+		to->acct.wakeup[sched_cpuacct_bucket(elapsed)]++;
+#endif
+	}
+}
+
+/****************************************************************************
+ * Name: sched_cpuacct_ready
+ *
+ * Description:
+ *   Called when a blocked thread is removed from its blocked list to be
+ *   made ready-to-run.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_cpuacct_ready(FAR struct tcb_s *tcb)
+{
+	tcb->acct.readytime = up_cyclecount();
+	tcb->acct.ready = true;
+	tcb->acct.nwakeups++;
+}
+
+/****************************************************************************
+ * Name: sched_cpuacct_lock and sched_cpuacct_unlock
+ *
+ * Description:
+ *   Called by sched_lock() and sched_unlock() when the running thread
+ *   disables and re-enables preemption.
+ *
+ ****************************************************************************/
+
+void sched_cpuacct_lock(FAR struct tcb_s *tcb)
+{
+	tcb->acct.locktime = up_cyclecount();
+}
+
+void sched_cpuacct_unlock(FAR struct tcb_s *tcb)
+{
+	sched_cpuacct_preemptoff(tcb, up_cyclecount());
+}
+
+/****************************************************************************
+ * Name: sched_cpuacct
+ *
+ * Description:
+ *   Return the CPU accounting data of a thread.  The run time includes the
+ *   current run of the thread if it is the running thread.
+ *
+ * Parameters:
+ *   pid  - The ID of the thread
+ *   acct - The location to return the accounting data
+ *
+ * Return Value:
+ *   OK on success; -ESRCH if pid does not refer to a thread.
+ *
+ ****************************************************************************/
+
+int sched_cpuacct(pid_t pid, FAR struct cpuacct_s *acct)
+{
+	FAR struct tcb_s *tcb;
+	irqstate_t flags;
+	int ret = -ESRCH;
+
+	flags = irqsave();
+	tcb = sched_gettcb(pid);
+	if (tcb != NULL) {
+		*acct = tcb->acct;
+		if (tcb == this_task()) {
+			acct->runtime += (uint32_t)(up_cyclecount() - tcb->acct.switchin);
+		}
+
+		ret = OK;
+	}
+
+	irqrestore(flags);
+	return ret;
+}
+
+#endif							/* CONFIG_SCHED_CPUACCT */
@@ -119,7 +119,9 @@ int sched_lock(void)
 
 	if (rtcb && !up_interrupt_context()) {
 		ASSERT(rtcb->lockcount < MAX_LOCK_COUNT);
-		rtcb->lockcount++;
+		if (rtcb->lockcount++ == 0) {
+			sched_cpuacct_lock(rtcb);
+		}
 	}
 
 	return OK;
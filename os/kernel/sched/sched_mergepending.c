@@ -111,6 +111,43 @@
 
 bool sched_mergepending(void)
 {
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+	FAR struct tcb_s *pndtcb;
+	FAR struct tcb_s *pndnext;
+	FAR struct tcb_s *rtrtcb;
+	bool ret = false;
+
+	/* Process every TCB in the g_pendingtasks list.  The priority index
+	 * gives the insertion point of each one directly.
+	 */
+
+	for (pndtcb = (FAR struct tcb_s *)g_pendingtasks.head; pndtcb; pndtcb = pndnext) {
+		pndnext = pndtcb->flink;
+		rtrtcb = this_task();
+
+		if (sched_prioindex_add(pndtcb, (FAR dq_queue_t *)&g_readytorun)) {
+			/* pndtcb was inserted at the head of the list.  Inform the
+			 * instrumentation layer that we are switching tasks.
+			 */
+
+			sched_note_switch(rtrtcb, pndtcb);
+			sched_cpuacct_switch(rtrtcb, pndtcb);
+			rtrtcb->task_state = TSTATE_TASK_READYTORUN;
+			pndtcb->task_state = TSTATE_TASK_RUNNING;
+			ret = true;
+		} else {
+			pndtcb->task_state = TSTATE_TASK_READYTORUN;
+		}
+	}
+
+	/* Mark the input list empty */
+
+	g_pendingtasks.head = NULL;
+	g_pendingtasks.tail = NULL;
+	sched_prioindex_reset((FAR dq_queue_t *)&g_pendingtasks);
+
+	return ret;
+#else
 	FAR struct tcb_s *pndtcb;
 	FAR struct tcb_s *pndnext;
 	FAR struct tcb_s *rtrtcb;
@@ -149,6 +186,7 @@ bool sched_mergepending(void)
 			/* Inform the instrumentation layer that we are switching tasks */
 
 			sched_note_switch(rtrtcb, pndtcb);
+			sched_cpuacct_switch(rtrtcb, pndtcb);
 
 			/* Then insert at the head of the list */
 
@@ -180,4 +218,5 @@ bool sched_mergepending(void)
 	g_pendingtasks.tail = NULL;
 
 	return ret;
+#endif
 }
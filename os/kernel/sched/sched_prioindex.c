@@ -0,0 +1,279 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/sched/sched_prioindex.c
+ *
+ * Priority index over the g_readytorun and g_pendingtasks lists.  Both
+ * lists stay ordered exactly as before (highest priority first, FIFO within
+ * a priority), so this_task() and every list walker are unaffected.  The
+ * index only records, for each priority level, the last TCB of that level
+ * in the list plus a bitmap of the non-empty levels.  With it the insert
+ * position of a TCB is found with two count-trailing-zeros operations
+ * instead of a walk of the list with interrupts disabled.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PRIOINDEX_NWORDS     ((SCHED_PRIORITY_MAX >> 5) + 1)
+#define PRIOINDEX_WORD(p)    ((p) >> 5)
+#define PRIOINDEX_BIT(p)     (1u << ((p) & 31))
+
+#define prioindex_ffs(x)     __builtin_ctz(x)
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+/* A tail pointer is only valid while the bit of its level is set */
+
+struct prioindex_s {
+	uint32_t summary;			/* Bit n set if levels[n] is non-zero */
+	uint32_t levels[PRIOINDEX_NWORDS];	/* Bit per non-empty priority level */
+	FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1];	/* Last TCB of each level */
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+static struct prioindex_s g_readytorun_index;
+static struct prioindex_s g_pendingtasks_index;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline FAR struct prioindex_s *sched_prioindex(DSEG dq_queue_t *list)
+{
+	if (list == (FAR dq_queue_t *)&g_readytorun) {
+		return &g_readytorun_index;
+	} else if (list == (FAR dq_queue_t *)&g_pendingtasks) {
+		return &g_pendingtasks_index;
+	}
+
+	return NULL;
+}
+
+static inline bool prioindex_isset(FAR struct prioindex_s *index, uint8_t prio)
+{
+	return (index->levels[PRIOINDEX_WORD(prio)] & PRIOINDEX_BIT(prio)) != 0;
+}
+
+static inline void prioindex_set(FAR struct prioindex_s *index, uint8_t prio, FAR struct tcb_s *tcb)
+{
+	index->tail[prio] = tcb;
+	index->levels[PRIOINDEX_WORD(prio)] |= PRIOINDEX_BIT(prio);
+	index->summary |= 1u << PRIOINDEX_WORD(prio);
+}
+
+static inline void prioindex_clear(FAR struct prioindex_s *index, uint8_t prio)
+{
+	index->levels[PRIOINDEX_WORD(prio)] &= ~PRIOINDEX_BIT(prio);
+	if (index->levels[PRIOINDEX_WORD(prio)] == 0) {
+		index->summary &= ~(1u << PRIOINDEX_WORD(prio));
+	}
+}
+
+/****************************************************************************
+ * Name: prioindex_above
+ *
+ * Description:
+ *   Return the last TCB of the lowest non-empty level strictly above prio,
+ *   i.e. the TCB that a new TCB of priority prio goes after when its own
+ *   level is empty.  NULL if there is no such level and the new TCB goes at
+ *   the head of the list.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *prioindex_above(FAR struct prioindex_s *index, uint8_t prio)
+{
+	unsigned int word = PRIOINDEX_WORD(prio);
+	unsigned int bit = prio & 31;
+	uint32_t mask;
+
+	/* Higher levels in the same word */
+
+	mask = bit == 31 ? 0 : index->levels[word] & (0xffffffffu << (bit + 1));
+	if (mask != 0) {
+		return index->tail[(word << 5) + prioindex_ffs(mask)];
+	}
+
+	/* Otherwise the lowest level of the next non-empty word */
+
+	mask = index->summary & (0xffffffffu << (word + 1));
+	if (mask != 0) {
+		word = prioindex_ffs(mask);
+		return index->tail[(word << 5) + prioindex_ffs(index->levels[word])];
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_prioindex_add
+ *
+ * Description:
+ *   O(1) version of sched_addprioritized() for the indexed lists.  The TCB
+ *   goes after every TCB of the same or higher priority.
+ *
+ * Inputs:
+ *   tcb  - Points to the TCB to add to the prioritized list
+ *   list - g_readytorun or g_pendingtasks
+ *
+ * Return Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ *   Same as sched_addprioritized().
+ *
+ ****************************************************************************/
+
+bool sched_prioindex_add(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+	FAR struct prioindex_s *index = sched_prioindex(list);
+	uint8_t prio = tcb->sched_priority;
+	FAR struct tcb_s *prev;
+	FAR struct tcb_s *next;
+
+	DEBUGASSERT(index != NULL);
+
+	if (prioindex_isset(index, prio)) {
+		prev = index->tail[prio];
+	} else {
+		prev = prioindex_above(index, prio);
+	}
+
+	if (prev) {
+		/* Insert after prev, possibly at the end of the list */
+
+		next = prev->flink;
+		tcb->flink = next;
+		tcb->blink = prev;
+		prev->flink = tcb;
+		if (next) {
+			next->blink = tcb;
+		} else {
+			list->tail = (FAR dq_entry_t *)tcb;
+		}
+	} else {
+		/* Nothing of the same or higher priority:  insert at the head */
+
+		next = (FAR struct tcb_s *)list->head;
+		tcb->flink = next;
+		tcb->blink = NULL;
+		if (next) {
+			next->blink = tcb;
+		} else {
+			list->tail = (FAR dq_entry_t *)tcb;
+		}
+
+		list->head = (FAR dq_entry_t *)tcb;
+	}
+
+	prioindex_set(index, prio, tcb);
+	return prev == NULL;
+}
+
+/****************************************************************************
+ * Name: sched_removeprioritized
+ *
+ * Description:
+ *   Remove a TCB from a prioritized list, keeping the index of the list up
+ *   to date.  The TCB must still have the priority it was added with.
+ *
+ * Inputs:
+ *   tcb  - Points to the TCB to remove
+ *   list - The list that holds tcb
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+	FAR struct prioindex_s *index = sched_prioindex(list);
+	uint8_t prio = tcb->sched_priority;
+	FAR struct tcb_s *prev;
+
+	if (index && prioindex_isset(index, prio) && index->tail[prio] == tcb) {
+		/* tcb was the last of its level.  The level stays non-empty if the
+		 * TCB before it has the same priority.
+		 */
+
+		prev = tcb->blink;
+		if (prev && prev->sched_priority == prio) {
+			index->tail[prio] = prev;
+		} else {
+			prioindex_clear(index, prio);
+		}
+	}
+
+	dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_reset
+ *
+ * Description:
+ *   Rebuild the index of an indexed list from its contents.  This is used
+ *   once the idle task has been added at start-up and, with an empty list,
+ *   after sched_mergepending() has emptied g_pendingtasks.
+ *
+ ****************************************************************************/
+
+void sched_prioindex_reset(DSEG dq_queue_t *list)
+{
+	FAR struct prioindex_s *index = sched_prioindex(list);
+	FAR struct tcb_s *tcb;
+
+	DEBUGASSERT(index != NULL);
+
+	index->summary = 0;
+	memset(index->levels, 0, sizeof(index->levels));
+
+	/* The list is ordered, so the last TCB seen at a level is its tail */
+
+	for (tcb = (FAR struct tcb_s *)list->head; tcb; tcb = tcb->flink) {
+		prioindex_set(index, tcb->sched_priority, tcb);
+	}
+}
+
+#endif							/* CONFIG_SCHED_PRIORITY_BITMAP */
@@ -66,6 +66,7 @@
 #include "sched/sched.h"
 #include "group/group.h"
 #include "timer/timer.h"
+#include "semaphore/semaphore.h"
 #if defined(CONFIG_ENABLE_STACKMONITOR) && defined(CONFIG_DEBUG)
 #include <apps/system/utils.h>
 #endif
@@ -140,6 +141,12 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 		stkmon_logging(tcb);
 #endif
 
+		/* Detach the semaphore holder containers in this TCB from the
+		 * semaphores before the TCB memory is freed.
+		 */
+
+		sem_releasetcbholders(tcb);
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 		/* Release any timers that the task might hold.  We do this
 		 * before release the PID because it may still be trying to
@@ -123,4 +123,8 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
 	 */
 
 	btcb->task_state = TSTATE_TASK_INVALID;
+
+	/* Start measuring the latency until the thread runs */
+
+	sched_cpuacct_ready(btcb);
 }
@@ -161,9 +161,17 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 		/* Otherwise, we can just change priority since it has no effect */
 
 		else {
-			/* Change the task priority */
+			/* Change the task priority.  It stays at the head of the list,
+			 * but the priority index must move it to its new level.
+			 */
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+			sched_removeprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+			tcb->sched_priority = (uint8_t)sched_priority;
+			ASSERT(sched_addprioritized(tcb, (FAR dq_queue_t *)&g_readytorun));
+#else
 			tcb->sched_priority = (uint8_t)sched_priority;
+#endif
 		}
 		break;
 
@@ -213,7 +221,7 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 		if (g_tasklisttable[task_state].prioritized) {
 			/* Remove the TCB from the prioritized task list */
 
-			dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
+			sched_removeprioritized(tcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
 
 			/* Change the task priority */
 
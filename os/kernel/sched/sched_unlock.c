@@ -119,7 +119,9 @@ int sched_unlock(void)
 		/* Decrement the preemption lock counter */
 
 		if (rtcb->lockcount) {
-			rtcb->lockcount--;
+			if (--rtcb->lockcount == 0) {
+				sched_cpuacct_unlock(rtcb);
+			}
 		}
 
 		/* Check if the lock counter has decremented to zero.  If so,
@@ -56,6 +56,7 @@
 
 #include <tinyara/config.h>
 
+#include <stdbool.h>
 #include <semaphore.h>
 #include <sched.h>
 #include <assert.h>
@@ -77,6 +78,28 @@
 #define CONFIG_SEM_PREALLOCHOLDERS 0
 #endif
 
+/* The semaphore keeps a list of holders (hhead) unless it only has room for
+ * a single, built-in holder.
+ */
+
+#if CONFIG_SEM_PREALLOCHOLDERS > 0 || defined(CONFIG_SEM_TCBHOLDERS)
+#define HAVE_HOLDERLIST 1
+#endif
+
+/* Keep track of the number of holders for the contention statistics */
+
+#ifdef CONFIG_SEM_STATISTICS
+#define sem_statholders(sem, n) \
+	do { \
+		(sem)->stats.nholders += (n); \
+		if ((sem)->stats.nholders > (sem)->stats.maxholders) { \
+			(sem)->stats.maxholders = (sem)->stats.nholders; \
+		} \
+	} while (0)
+#else
+#define sem_statholders(sem, n)
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -98,24 +121,97 @@ static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
 static FAR struct semholder_s *g_freeholders;
 #endif
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sem_ownsholder
+ *
+ * Description:
+ *   Check that a holder container of a TCB still belongs to sem: it was
+ *   taken for this generation of the semaphore and it is still linked into
+ *   the holder list of the semaphore.  The containers left behind by a
+ *   semaphore that was freed or re-initialized without sem_destroy() fail
+ *   the check.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_TCBHOLDERS
+static inline bool sem_ownsholder(FAR sem_t *sem, FAR struct semholder_s *pholder)
+{
+	if (pholder->sem != sem || pholder->gen != sem->gen) {
+		return false;
+	}
+
+	if (pholder->blink) {
+		return pholder->blink->flink == pholder;
+	}
+
+	return sem->hhead == pholder;
+}
+#endif
+
 /****************************************************************************
  * Name: sem_allocholder
  ****************************************************************************/
 
-static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
+static inline FAR struct semholder_s *sem_allocholder(sem_t *sem, FAR struct tcb_s *htcb)
 {
 	FAR struct semholder_s *pholder;
+#ifdef CONFIG_SEM_TCBHOLDERS
+	int i;
+#endif
 
 	/* Check if the "built-in" holder is being used.  We have this built-in
 	 * holder to optimize for the simplest case where semaphores are only
 	 * used to implement mutexes.
 	 */
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if defined(CONFIG_SEM_TCBHOLDERS)
+	/* Take a free container from the TCB of the new holder */
+
+	for (i = 0, pholder = NULL; i < CONFIG_SEM_NTCBHOLDERS; i++) {
+		if (htcb->holders[i].sem == NULL) {
+			pholder = &htcb->holders[i];
+			break;
+		}
+	}
+
+	/* If there is none, take back one that was left behind by a semaphore
+	 * that is gone.
+	 */
+
+	for (i = 0; pholder == NULL && i < CONFIG_SEM_NTCBHOLDERS; i++) {
+		if (!sem_ownsholder(htcb->holders[i].sem, &htcb->holders[i])) {
+			sdbg("Stale holder of semaphore %p\n", htcb->holders[i].sem);
+			pholder = &htcb->holders[i];
+			sem_freeholder(pholder->sem, pholder);
+		}
+	}
+
+	if (pholder) {
+		/* Put it at the head of the semaphore's holder list */
+
+		pholder->sem = sem;
+		pholder->gen = sem->gen;
+		pholder->blink = NULL;
+		pholder->flink = sem->hhead;
+		if (sem->hhead) {
+			sem->hhead->blink = pholder;
+		}
+
+		sem->hhead = pholder;
+		pholder->counts = 0;
+		sem_statholders(sem, 1);
+	}
+#elif CONFIG_SEM_PREALLOCHOLDERS > 0
 	pholder = g_freeholders;
 	if (pholder) {
 		/* Remove the holder from the free list an put it into the semaphore's
@@ -129,11 +225,13 @@ static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
 		/* Make sure the initial count is zero */
 
 		pholder->counts = 0;
+		sem_statholders(sem, 1);
 	}
 #else
 	if (!sem->holder.htcb) {
 		pholder = &sem->holder;
 		pholder->counts = 0;
+		sem_statholders(sem, 1);
 	}
 #endif
 	else {
@@ -152,6 +250,18 @@ static FAR struct semholder_s *sem_findholder(sem_t *sem, FAR struct tcb_s *htcb
 {
 	FAR struct semholder_s *pholder;
 
+#ifdef CONFIG_SEM_TCBHOLDERS
+	int i;
+
+	/* The holder can only be one of the containers in the TCB of htcb */
+
+	for (i = 0; i < CONFIG_SEM_NTCBHOLDERS; i++) {
+		pholder = &htcb->holders[i];
+		if (sem_ownsholder(sem, pholder)) {
+			return pholder;
+		}
+	}
+#else
 	/* Try to find the holder in the list of holders associated with this
 	 * semaphore
 	 */
@@ -168,6 +278,7 @@ static FAR struct semholder_s *sem_findholder(sem_t *sem, FAR struct tcb_s *htcb
 			return pholder;
 		}
 	}
+#endif
 
 	/* The holder does not appear in the list */
 
@@ -182,7 +293,7 @@ static inline FAR struct semholder_s *sem_findorallocateholder(sem_t *sem, FAR s
 {
 	FAR struct semholder_s *pholder = sem_findholder(sem, htcb);
 	if (!pholder) {
-		pholder = sem_allocholder(sem);
+		pholder = sem_allocholder(sem, htcb);
 	}
 
 	return pholder;
@@ -199,10 +310,49 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 	FAR struct semholder_s *prev;
 #endif
 
+#if defined(CONFIG_SEM_TCBHOLDERS)
+	/* Unlink the holder from the semaphore's list and return the container
+	 * to its TCB.  A container that no longer belongs to sem is only linked
+	 * with the other containers left behind by the same semaphore, and the
+	 * memory of the semaphore may have been reused: leave it alone.
+	 */
+
+	if (pholder->sem != NULL) {
+		if (sem_ownsholder(sem, pholder)) {
+			if (pholder->htcb) {
+				sem_statholders(sem, -1);
+			}
+
+			if (!pholder->blink) {
+				sem->hhead = pholder->flink;
+			}
+		}
+
+		if (pholder->blink) {
+			pholder->blink->flink = pholder->flink;
+		}
+
+		if (pholder->flink) {
+			pholder->flink->blink = pholder->blink;
+		}
+
+		pholder->flink = NULL;
+		pholder->blink = NULL;
+		pholder->sem = NULL;
+	}
+
+	pholder->htcb = NULL;
+	pholder->counts = 0;
+#else
 	/* Release the holder and counts */
 
+	if (pholder->htcb) {
+		sem_statholders(sem, -1);
+	}
+
 	pholder->htcb = NULL;
 	pholder->counts = 0;
+#endif
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
 	/* Search the list for the matching holder */
@@ -233,18 +383,18 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 static int sem_foreachholder(FAR sem_t *sem, holderhandler_t handler, FAR void *arg)
 {
 	FAR struct semholder_s *pholder;
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#ifdef HAVE_HOLDERLIST
 	FAR struct semholder_s *next;
 #endif
 	int ret = 0;
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#ifdef HAVE_HOLDERLIST
 	for (pholder = sem->hhead; pholder && ret == 0; pholder = next)
 #else
 	pholder = &sem->holder;
 #endif
 	{
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#ifdef HAVE_HOLDERLIST
 		/* In case this holder gets deleted */
 
 		next = pholder->flink;
@@ -265,7 +415,7 @@ static int sem_foreachholder(FAR sem_t *sem, holderhandler_t handler, FAR void *
  * Name: sem_recoverholders
  ****************************************************************************/
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#ifdef HAVE_HOLDERLIST
 static int sem_recoverholders(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR void *arg)
 {
 	sem_freeholder(sem, pholder);
@@ -394,7 +544,7 @@ static int sem_verifyholder(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR
 #if defined(CONFIG_DEBUG) && defined(CONFIG_SEM_PHDEBUG)
 static int sem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem, FAR void *arg)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#ifdef HAVE_HOLDERLIST
 	vdbg("  %08x: %08x %08x %04x\n", pholder, pholder->flink, pholder->htcb, pholder->counts);
 #else
 	vdbg("  %08x: %08x %04x\n", pholder, pholder->htcb, pholder->counts);
@@ -782,7 +932,7 @@ void sem_destroyholder(FAR sem_t *sem)
 	 * doing.
 	 */
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#ifdef HAVE_HOLDERLIST
 	if (sem->hhead) {
 		sdbg("Semaphore destroyed with holders\n");
 		(void)sem_foreachholder(sem, sem_recoverholders, NULL);
@@ -790,12 +940,57 @@ void sem_destroyholder(FAR sem_t *sem)
 #else
 	if (sem->holder.htcb) {
 		sdbg("Semaphore destroyed with holder\n");
+		sem_statholders(sem, -1);
 	}
 
 	sem->holder.htcb = NULL;
 #endif
 }
 
+/****************************************************************************
+ * Name: sem_releasetcbholders
+ *
+ * Description:
+ *   Called when a TCB is released or a task is restarted.  Remove all of
+ *   the holder containers of the thread from the holder lists of the
+ *   semaphores.  Whatever counts the thread still held are lost.  The
+ *   containers of semaphores that were freed or re-initialized while the
+ *   thread held them are returned without touching the semaphore.
+ *
+ * Parameters:
+ *   tcb - The TCB of the exiting or restarting thread
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   The thread is not running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_TCBHOLDERS
+void sem_releasetcbholders(FAR struct tcb_s *tcb)
+{
+	FAR struct semholder_s *pholder;
+	irqstate_t flags;
+	int i;
+
+	/* The holder lists are also modified by sem_post() from interrupt
+	 * handlers.
+	 */
+
+	flags = irqsave();
+	for (i = 0; i < CONFIG_SEM_NTCBHOLDERS; i++) {
+		pholder = &tcb->holders[i];
+		if (pholder->sem != NULL) {
+			sem_freeholder(pholder->sem, pholder);
+		}
+	}
+
+	irqrestore(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: sem_addholder_tcb
  *
@@ -1052,7 +1247,20 @@ void sem_enumholders(FAR sem_t *sem)
 #if defined(CONFIG_DEBUG) && defined(CONFIG_SEM_PHDEBUG)
 int sem_nfreeholders(void)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
+#if defined(CONFIG_SEM_TCBHOLDERS)
+	FAR struct tcb_s *rtcb = this_task();
+	int n;
+	int i;
+
+	/* The containers are per thread; count those of the running thread */
+
+	for (i = 0, n = 0; i < CONFIG_SEM_NTCBHOLDERS; i++) {
+		if (rtcb->holders[i].sem == NULL) {
+			n++;
+		}
+	}
+	return n;
+#elif CONFIG_SEM_PREALLOCHOLDERS > 0
 	FAR struct semholder_s *pholder;
 	int n;
 
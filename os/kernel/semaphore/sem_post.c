@@ -171,6 +171,7 @@ int sem_post(FAR sem_t *sem)
 
 				/* Restart the waiting task. */
 
+				sched_note_semwake(stcb, sem);
 				up_unblock_task(stcb);
 			}
 		}
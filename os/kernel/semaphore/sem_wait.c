@@ -62,6 +62,9 @@
 #include <assert.h>
 #include <tinyara/arch.h>
 #include <tinyara/cancelpt.h>
+#ifdef CONFIG_SEM_STATISTICS
+#include <tinyara/clock.h>
+#endif
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -116,6 +119,10 @@ int sem_wait(FAR sem_t *sem)
 {
 	FAR struct tcb_s *rtcb = this_task();
 	irqstate_t saved_state;
+#ifdef CONFIG_SEM_STATISTICS
+	systime_t start;
+	systime_t elapsed;
+#endif
 	int ret = ERROR;
 
 	/* This API should not be called from interrupt handlers */
@@ -189,10 +196,17 @@ int sem_wait(FAR sem_t *sem)
 			 */
 
 			sem_boostpriority(sem);
+#endif
+#ifdef CONFIG_SEM_STATISTICS
+			/* Count the contended wait and time it */
+
+			sem->stats.nwaits++;
+			start = clock_systimer();
 #endif
 			/* Add the TCB to the prioritized semaphore wait queue */
 
 			set_errno(0);
+			sched_note_semwait(rtcb, sem);
 			up_block_task(rtcb, TSTATE_WAIT_SEM);
 
 			/* When we resume at this point, either (1) the semaphore has been
@@ -219,6 +233,14 @@ int sem_wait(FAR sem_t *sem)
 				/* Not awakened by a signal or a timeout... We hold the semaphore */
 				ret = OK;
 			}
+#ifdef CONFIG_SEM_STATISTICS
+			/* Interrupted and timed out waits count as well */
+
+			elapsed = clock_systimer() - start;
+			if (elapsed > sem->stats.maxwait) {
+				sem->stats.maxwait = (uint32_t)elapsed;
+			}
+#endif
 #ifdef CONFIG_PRIORITY_INHERITANCE
 			sched_unlock();
 #endif
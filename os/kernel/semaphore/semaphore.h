@@ -115,6 +115,11 @@ void sem_addholder_tcb(FAR struct tcb_s *tcb, FAR sem_t *sem);
 void sem_boostpriority(FAR sem_t *sem);
 void sem_releaseholder(FAR sem_t *sem);
 void sem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
+#ifdef CONFIG_SEM_TCBHOLDERS
+void sem_releasetcbholders(FAR struct tcb_s *tcb);
+#else
+#define sem_releasetcbholders(tcb)
+#endif
 #ifndef CONFIG_DISABLE_SIGNALS
 void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #else
@@ -128,6 +133,7 @@ void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #define sem_boostpriority(sem)
 #define sem_releaseholder(sem)
 #define sem_restorebaseprio(stcb, sem)
+#define sem_releasetcbholders(tcb)
 #define sem_canceled(stcb, sem)
 #endif
 
@@ -66,6 +66,7 @@
 #include "group/group.h"
 #include "signal/signal.h"
 #include "task/task.h"
+#include "semaphore/semaphore.h"
 #include <ttrace.h>
 
 /****************************************************************************
@@ -180,7 +181,7 @@ int task_restart(pid_t pid)
 		 */
 
 		state = irqsave();
-		dq_rem((FAR dq_entry_t *)tcb, (dq_queue_t *)g_tasklisttable[tcb->cmn.task_state].list);
+		sched_removeprioritized((FAR struct tcb_s *)tcb, (dq_queue_t *)g_tasklisttable[tcb->cmn.task_state].list);
 		tcb->cmn.task_state = TSTATE_TASK_INVALID;
 		irqrestore(state);
 
@@ -199,6 +200,7 @@ int task_restart(pid_t pid)
 #if CONFIG_SEM_NNESTPRIO > 0
 		tcb->cmn.npend_reprio = 0;
 #endif
+		sem_releasetcbholders((FAR struct tcb_s *)tcb);
 #endif
 
 		/* Re-initialize the processor-specific portion of the TCB
@@ -108,8 +108,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
+#endif
 	irqstate_t state;
 	int ret = ERROR;
 
@@ -124,6 +126,14 @@ int wd_cancel(WDOG_ID wdog)
 	 */
 
 	if (wdog && WDOG_ISACTIVE(wdog)) {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+		/* Unlink the watchdog from its timer wheel slot.  The interval timer
+		 * is left alone: if this watchdog was the next to expire, the timer
+		 * fires once with nothing to do and is then reprogrammed.
+		 */
+
+		wd_wheel_remove(wdog);
+#else
 		/* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
 		 * to do this because there are additional operations that need to be
 		 * done.
@@ -168,6 +178,7 @@ int wd_cancel(WDOG_ID wdog)
 
 			sched_timer_reassess();
 		}
+#endif
 
 		/* Mark the watchdog inactive */
 
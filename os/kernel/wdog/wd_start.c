@@ -111,6 +111,55 @@ typedef void (*wdentry4_t)(int argc, uint32_t arg1, uint32_t arg2, uint32_t arg3
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Execute the function of a watchdog that has just expired.
+ *
+ * Parameters:
+ *   wdog - The expired watchdog, already removed from the active timers.
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_dispatch(FAR struct wdog_s *wdog)
+{
+	up_setpicbase(wdog->picbase);
+	switch (wdog->argc) {
+	default:
+		DEBUGPANIC();
+		break;
+
+	case 0:
+		(*((wdentry0_t)(wdog->func)))(0);
+		break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+	case 1:
+		(*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+	case 2:
+		(*((wdentry2_t)(wdog->func)))(2, wdog->parm[0], wdog->parm[1]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+	case 3:
+		(*((wdentry3_t)(wdog->func)))(3, wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+	case 4:
+		(*((wdentry4_t)(wdog->func)))(4, wdog->parm[0], wdog->parm[1], wdog->parm[2], wdog->parm[3]);
+		break;
+#endif
+	}
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -128,6 +177,7 @@ typedef void (*wdentry4_t)(int argc, uint32_t arg1, uint32_t arg2, uint32_t arg3
  *
  ****************************************************************************/
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 static inline void wd_expiration(void)
 {
 	FAR struct wdog_s *wdog;
@@ -158,40 +208,47 @@ static inline void wd_expiration(void)
 
 			/* Execute the watchdog function */
 
-			up_setpicbase(wdog->picbase);
-			switch (wdog->argc) {
-			default:
-				DEBUGPANIC();
-				break;
+			wd_dispatch(wdog);
+		}
+	}
+}
+#else
+static inline void wd_expiration(void)
+{
+	FAR struct wdog_s *wdog;
 
-			case 0:
-				(*((wdentry0_t)(wdog->func)))(0);
-				break;
+	/* Run every watchdog that expires at the current wheel time */
 
-#if CONFIG_MAX_WDOGPARMS > 0
-			case 1:
-				(*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-			case 2:
-				(*((wdentry2_t)(wdog->func)))(2, wdog->parm[0], wdog->parm[1]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-			case 3:
-				(*((wdentry3_t)(wdog->func)))(3, wdog->parm[0], wdog->parm[1], wdog->parm[2]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-			case 4:
-				(*((wdentry4_t)(wdog->func)))(4, wdog->parm[0], wdog->parm[1], wdog->parm[2], wdog->parm[3]);
-				break;
-#endif
-			}
-		}
+	while ((wdog = wd_wheel_expired()) != NULL) {
+		WDOG_CLRACTIVE(wdog);
+		wd_dispatch(wdog);
+	}
+}
+
+/****************************************************************************
+ * Name: wd_process
+ *
+ * Description:
+ *   Advance the timer wheel by 'ticks', running the watchdogs that expire
+ *   on the way.  Stretches without any timer activity are skipped in one
+ *   step.
+ *
+ * Parameters:
+ *   ticks - The number of ticks that have elapsed
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void wd_process(unsigned int ticks)
+{
+	while (ticks > 0) {
+		ticks -= wd_wheel_advance(ticks);
+		wd_expiration();
 	}
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -233,10 +290,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 {
 	va_list ap;
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
 	FAR struct wdog_s *next;
 	int32_t now;
+#endif
 	irqstate_t state;
 	int i;
 
@@ -292,6 +351,11 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 	(void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	/* Hash the watchdog into the timer wheel */
+
+	wd_wheel_insert(wdog, delay);
+#else
 	/* Do the easy case first -- when the watchdog timer queue is empty. */
 
 	if (g_wdactivelist.head == NULL) {
@@ -363,9 +427,13 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 		}
 	}
 
-	/* Put the lag into the watchdog structure and mark it as active. */
+	/* Put the lag into the watchdog structure */
 
 	wdog->lag = delay;
+#endif
+
+	/* Mark the watchdog as active. */
+
 	WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -406,8 +474,30 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
+{
+	/* Advance the timer wheel, running the expired watchdogs */
+
+	if (ticks > 0) {
+		wd_process(ticks);
+	}
+
+	/* Return the delay until the wheel next needs attention */
+
+	return wd_wheel_nextevent();
+}
+
+#else
+void wd_timer(void)
+{
+	wd_process(1);
+}
+#endif							/* CONFIG_SCHED_TICKLESS */
+
+#elif defined(CONFIG_SCHED_TICKLESS)
+unsigned int wd_timer(int ticks)
 {
 	FAR struct wdog_s *wdog;
 	int decr;
@@ -461,4 +551,4 @@ void wd_timer(void)
 		wd_expiration();
 	}
 }
-#endif							/* CONFIG_SCHED_TICKLESS */
+#endif							/* CONFIG_WDOG_TIMER_WHEEL */
@@ -0,0 +1,395 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wdog/wd_wheel.c
+ *
+ * Hierarchical timing wheel holding the active watchdogs.  There are
+ * WHEEL_NLEVELS levels of WHEEL_NSLOTS slots.  A slot of level 0 covers
+ * one tick, a slot of level n covers WHEEL_NSLOTS^n ticks.  A watchdog is
+ * hashed into the lowest level whose span covers its delay; when the
+ * wheel time reaches the start of a higher level slot, the watchdogs in
+ * that slot are cascaded down into the lower levels.  Starting and
+ * cancelling a watchdog are O(1), each watchdog is cascaded at most
+ * WHEEL_NLEVELS - 1 times before it expires.
+ *
+ * While a watchdog is in the wheel its 'lag' field holds the absolute
+ * wheel time at which it expires.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <tinyara/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WHEEL_SLOTBITS       6
+#define WHEEL_NSLOTS         (1 << WHEEL_SLOTBITS)
+#define WHEEL_SLOTMASK       (WHEEL_NSLOTS - 1)
+#define WHEEL_NLEVELS        4
+
+/* Ticks covered by one slot of a level, and by a whole level */
+
+#define WHEEL_SHIFT(l)       ((l) * WHEEL_SLOTBITS)
+#define WHEEL_SPAN(l)        ((uint32_t)1 << WHEEL_SHIFT((l) + 1))
+
+/* The largest delay that the wheel can represent directly.  Longer delays
+ * are parked in the last slot of the top level and re-hashed from there.
+ */
+
+#define WHEEL_MAXDELAY       (WHEEL_SPAN(WHEEL_NLEVELS - 1) - 1)
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+struct wd_wheel_s {
+	uint32_t now;				/* Current wheel time in ticks */
+	uint16_t nactive;			/* Number of watchdogs in the wheel */
+	uint64_t used[WHEEL_NLEVELS];	/* Bitmap of the non-empty slots */
+	FAR struct wdog_s *slot[WHEEL_NLEVELS][WHEEL_NSLOTS];
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+static struct wd_wheel_s g_wdwheel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ *
+ * Description:
+ *   Hash a watchdog into the wheel according to its expiration time.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_link(FAR struct wdog_s *wdog)
+{
+	FAR struct wdog_s **head;
+	uint32_t expire = (uint32_t)wdog->lag;
+	int32_t delay = (int32_t)(expire - g_wdwheel.now);
+	int level;
+	int index;
+
+	if (delay <= 0) {
+		/* Due now.  This only happens while cascading; the slot of the
+		 * current tick is emptied right after the cascade.
+		 */
+
+		level = 0;
+		index = g_wdwheel.now & WHEEL_SLOTMASK;
+	} else {
+		if ((uint32_t)delay > WHEEL_MAXDELAY) {
+			expire = g_wdwheel.now + WHEEL_MAXDELAY;
+			delay = WHEEL_MAXDELAY;
+		}
+
+		for (level = 0; (uint32_t)delay >= WHEEL_SPAN(level); level++);
+		index = (expire >> WHEEL_SHIFT(level)) & WHEEL_SLOTMASK;
+	}
+
+	head = &g_wdwheel.slot[level][index];
+	wdog->next = *head;
+	if (*head) {
+		(*head)->pprev = &wdog->next;
+	}
+
+	wdog->pprev = head;
+	*head = wdog;
+	g_wdwheel.used[level] |= (uint64_t)1 << index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_unlink
+ *
+ * Description:
+ *   Remove a watchdog from its slot.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_unlink(FAR struct wdog_s *wdog)
+{
+	FAR struct wdog_s **pprev = wdog->pprev;
+	uintptr_t offset;
+
+	*pprev = wdog->next;
+	if (wdog->next) {
+		wdog->next->pprev = pprev;
+	} else {
+		/* If the watchdog was alone in its slot, pprev points at the slot
+		 * itself and the slot is now empty.
+		 */
+
+		offset = (uintptr_t)pprev - (uintptr_t)&g_wdwheel.slot[0][0];
+		if (offset < sizeof(g_wdwheel.slot)) {
+			offset /= sizeof(FAR struct wdog_s *);
+			g_wdwheel.used[offset >> WHEEL_SLOTBITS] &= ~((uint64_t)1 << (offset & WHEEL_SLOTMASK));
+		}
+	}
+
+	wdog->next = NULL;
+	wdog->pprev = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_search
+ *
+ * Description:
+ *   Return the distance, in slots, from 'start' to the first non-empty
+ *   slot of a level, wrapping around the end of the level.  Returns a
+ *   negative value if the level is empty.
+ *
+ ****************************************************************************/
+
+static inline int wd_wheel_search(int level, unsigned int start)
+{
+	uint64_t used = g_wdwheel.used[level];
+
+	if (used == 0) {
+		return -1;
+	}
+
+	start &= WHEEL_SLOTMASK;
+	used = (used >> start) | (used << ((WHEEL_NSLOTS - start) & WHEEL_SLOTMASK));
+	return __builtin_ctzll(used);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Called when the wheel time reaches a new tick.  Every higher level
+ *   slot that starts at this tick is emptied and its watchdogs re-hashed
+ *   relative to the new time.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(void)
+{
+	FAR struct wdog_s *wdog;
+	FAR struct wdog_s *next;
+	uint32_t now = g_wdwheel.now;
+	int level;
+	int index;
+
+	for (level = 1; level < WHEEL_NLEVELS; level++) {
+		if ((now & (((uint32_t)1 << WHEEL_SHIFT(level)) - 1)) != 0) {
+			break;
+		}
+
+		index = (now >> WHEEL_SHIFT(level)) & WHEEL_SLOTMASK;
+		wdog = g_wdwheel.slot[level][index];
+		if (wdog == NULL) {
+			continue;
+		}
+
+		g_wdwheel.slot[level][index] = NULL;
+		g_wdwheel.used[level] &= ~((uint64_t)1 << index);
+
+		for (; wdog; wdog = next) {
+			next = wdog->next;
+			wd_wheel_link(wdog);
+		}
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Empty the timing wheel.  Called from wd_initialize().
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+	memset(&g_wdwheel, 0, sizeof(struct wd_wheel_s));
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the wheel to expire 'delay' ticks from now.  Must be
+ *   called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int delay)
+{
+	DEBUGASSERT(delay > 0);
+
+	wdog->lag = (int)(g_wdwheel.now + (uint32_t)delay);
+	wd_wheel_link(wdog);
+	g_wdwheel.nactive++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the wheel.  Must be called with
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+	DEBUGASSERT(wdog->pprev != NULL && g_wdwheel.nactive > 0);
+
+	wd_wheel_unlink(wdog);
+	g_wdwheel.nactive--;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks before an active watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+	int32_t delay = (int32_t)((uint32_t)wdog->lag - g_wdwheel.now);
+
+	return delay > 0 ? (int)delay : 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextevent
+ *
+ * Description:
+ *   Return the number of ticks until the wheel next has work to do: either
+ *   watchdogs expire or a higher level slot must be cascaded.  Returns zero
+ *   if the wheel is empty.  A cascade may come before the first expiration,
+ *   in which case the caller is simply woken up once more to perform it.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_nextevent(void)
+{
+	uint32_t now = g_wdwheel.now;
+	uint32_t next = UINT32_MAX;
+	uint32_t block;
+	uint32_t delay;
+	int dist;
+	int level;
+
+	if (g_wdwheel.nactive == 0) {
+		return 0;
+	}
+
+	for (level = 0; level < WHEEL_NLEVELS; level++) {
+		block = now >> WHEEL_SHIFT(level);
+		dist = wd_wheel_search(level, block + 1);
+		if (dist >= 0) {
+			delay = ((block + 1 + dist) << WHEEL_SHIFT(level)) - now;
+			if (delay < next) {
+				next = delay;
+			}
+		}
+	}
+
+	DEBUGASSERT(next != UINT32_MAX);
+	return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the wheel time by at most 'ticks'.  The wheel stops at the
+ *   first tick where there is work to do, performs any cascade, and leaves
+ *   the watchdogs expiring at that tick to be collected with
+ *   wd_wheel_expired().  Empty stretches of time are skipped in one step.
+ *
+ * Return Value:
+ *   The number of ticks actually advanced.  Zero if watchdogs expiring at
+ *   the current time have not been collected yet.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_advance(unsigned int ticks)
+{
+	unsigned int next;
+
+	/* Finish the current tick first.  This only matters if a watchdog
+	 * function re-enters the timer logic before its siblings have run.
+	 */
+
+	if (g_wdwheel.slot[0][g_wdwheel.now & WHEEL_SLOTMASK] != NULL) {
+		return 0;
+	}
+
+	next = wd_wheel_nextevent();
+	if (next == 0 || next > ticks) {
+		g_wdwheel.now += ticks;
+		return ticks;
+	}
+
+	g_wdwheel.now += next;
+	wd_wheel_cascade();
+	return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove and return one watchdog that expires at the current wheel time,
+ *   or NULL if there are none left.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+	FAR struct wdog_s *wdog;
+
+	wdog = g_wdwheel.slot[0][g_wdwheel.now & WHEEL_SLOTMASK];
+	if (wdog) {
+		DEBUGASSERT((uint32_t)wdog->lag == g_wdwheel.now);
+		wd_wheel_remove(wdog);
+	}
+
+	return wdog;
+}
+
+#endif							/* CONFIG_WDOG_TIMER_WHEEL */
@@ -95,7 +95,9 @@ extern sq_queue_t g_wdfreelist;
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -182,6 +184,21 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Timing wheel (see wd_wheel.c).  All of these must be called with
+ * interrupts disabled.
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+void wd_wheel_initialize(void);
+void wd_wheel_insert(FAR struct wdog_s *wdog, int delay);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+int wd_wheel_remaining(FAR struct wdog_s *wdog);
+unsigned int wd_wheel_nextevent(void);
+unsigned int wd_wheel_advance(unsigned int ticks);
+FAR struct wdog_s *wd_wheel_expired(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
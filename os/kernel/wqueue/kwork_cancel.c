@@ -111,7 +111,9 @@
 
 static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_DEADLINE
 	struct work_s *cur_work;
+#endif
 	irqstate_t flags;
 	int ret = -ENOENT;
 
@@ -124,6 +126,27 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wo
 
 	flags = irqsave();
 	if (work->worker != NULL) {
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+		/* Immediate work is on the FIFO list, delayed work in the deadline
+		 * heap.  Make sure that it is really there first: the worker field
+		 * of work that was never queued may hold anything.
+		 */
+
+		if (!work_isqueued(wqueue, work)) {
+			irqrestore(flags);
+			return -ENOENT;
+		}
+
+		if (work->delay == 0) {
+			dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+		} else {
+			work_heapremove(wqueue, work);
+		}
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+		wqueue->stats.npending--;
+#endif
+#else
 		/* A little test of the integrity of the work queue */
 
 		DEBUGASSERT(work->dq.flink || (FAR dq_entry_t *)work == wqueue->q.tail);
@@ -147,6 +170,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wo
 		 */
 
 		dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+#endif
 		work->worker = NULL;
 		ret = OK;
 	}
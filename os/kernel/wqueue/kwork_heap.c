@@ -0,0 +1,296 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wqueue/kwork_heap.c
+ *
+ * Delayed work of a kernel work queue ordered by deadline (qtime + delay).
+ * The work items form an intrusive pairing heap: the work with the earliest
+ * deadline is always the root, insertion and melding are O(1), and removal
+ * of the root or of an arbitrary (cancelled) item is O(log n) amortized.
+ * Work queued without delay does not go through the heap; it stays on the
+ * FIFO wqueue->q so that it runs in the order it was queued.
+ *
+ * The links of struct work_s are reused as follows while the work is in
+ * the heap:
+ *
+ *   child    - First (leftmost) child
+ *   dq.flink - Next sibling to the right
+ *   dq.blink - Left sibling, or the parent for the leftmost child.  NULL
+ *              only for the root.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORK_NEXT(w)         ((FAR struct work_s *)(w)->dq.flink)
+#define WORK_PREV(w)         ((FAR struct work_s *)(w)->dq.blink)
+#define WORK_SETNEXT(w, n)   ((w)->dq.flink = (FAR struct dq_entry_s *)(n))
+#define WORK_SETPREV(w, p)   ((w)->dq.blink = (FAR struct dq_entry_s *)(p))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_before
+ *
+ * Description:
+ *   Return true if the deadline of work 'a' comes before that of 'b'.  The
+ *   comparison is done on the difference so that it survives wrap-around
+ *   of the system timer.
+ *
+ ****************************************************************************/
+
+static inline bool work_before(FAR struct work_s *a, FAR struct work_s *b)
+{
+	systime_t diff = WORK_DEADLINE(a) - WORK_DEADLINE(b);
+
+	return diff > ((systime_t)~0 >> 1);
+}
+
+/****************************************************************************
+ * Name: work_meld
+ *
+ * Description:
+ *   Meld two heaps, both given by a root without siblings, and return the
+ *   root of the result.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_meld(FAR struct work_s *a, FAR struct work_s *b)
+{
+	FAR struct work_s *tmp;
+
+	if (a == NULL) {
+		return b;
+	}
+
+	if (b == NULL) {
+		return a;
+	}
+
+	/* On equal deadlines 'a' stays the root */
+
+	if (work_before(b, a)) {
+		tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	/* Make 'b' the leftmost child of 'a' */
+
+	WORK_SETNEXT(b, a->child);
+	if (a->child) {
+		WORK_SETPREV(a->child, b);
+	}
+
+	WORK_SETPREV(b, a);
+	a->child = b;
+	return a;
+}
+
+/****************************************************************************
+ * Name: work_combine
+ *
+ * Description:
+ *   Turn a list of sibling sub-heaps into a single heap using the standard
+ *   two-pass pairing: meld the siblings pairwise from left to right, then
+ *   meld the pairs from right to left.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_combine(FAR struct work_s *first)
+{
+	FAR struct work_s *pairs = NULL;
+	FAR struct work_s *root = NULL;
+	FAR struct work_s *a;
+	FAR struct work_s *b;
+
+	/* First pass.  The melded pairs are pushed on a list linked through
+	 * dq.flink, so the list ends up in right to left order.
+	 */
+
+	while (first) {
+		a = first;
+		b = WORK_NEXT(a);
+		first = b ? WORK_NEXT(b) : NULL;
+
+		WORK_SETNEXT(a, NULL);
+		WORK_SETPREV(a, NULL);
+		if (b) {
+			WORK_SETNEXT(b, NULL);
+			WORK_SETPREV(b, NULL);
+		}
+
+		a = work_meld(a, b);
+		WORK_SETNEXT(a, pairs);
+		pairs = a;
+	}
+
+	/* Second pass */
+
+	while (pairs) {
+		a = pairs;
+		pairs = WORK_NEXT(a);
+		WORK_SETNEXT(a, NULL);
+		root = work_meld(root, a);
+	}
+
+	return root;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_heapinsert
+ *
+ * Description:
+ *   Add work to the deadline heap of a work queue.  qtime and delay must
+ *   already be set.  Must be called with interrupts disabled.
+ *
+ * Returned Value:
+ *   True if the new work is now the earliest pending work, i.e. if a worker
+ *   waiting for the previous earliest deadline must be woken up.
+ *
+ ****************************************************************************/
+
+bool work_heapinsert(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
+{
+	work->child = NULL;
+	WORK_SETNEXT(work, NULL);
+	WORK_SETPREV(work, NULL);
+
+	wqueue->root = work_meld(wqueue->root, work);
+	return wqueue->root == work;
+}
+
+/****************************************************************************
+ * Name: work_heapremove
+ *
+ * Description:
+ *   Remove work, normally the root, from the deadline heap of a work queue.
+ *   Must be called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void work_heapremove(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
+{
+	FAR struct work_s *prev;
+	FAR struct work_s *next;
+
+	if (work == wqueue->root) {
+		wqueue->root = work_combine(work->child);
+	} else {
+		/* Unlink the sub-heap rooted at 'work' from its parent or left
+		 * sibling, then put its children back into the heap.
+		 */
+
+		prev = WORK_PREV(work);
+		next = WORK_NEXT(work);
+		DEBUGASSERT(prev != NULL);
+
+		if (prev->child == work) {
+			prev->child = next;
+		} else {
+			WORK_SETNEXT(prev, next);
+		}
+
+		if (next) {
+			WORK_SETPREV(next, prev);
+		}
+
+		wqueue->root = work_meld(wqueue->root, work_combine(work->child));
+	}
+
+	work->child = NULL;
+	WORK_SETNEXT(work, NULL);
+	WORK_SETPREV(work, NULL);
+}
+
+/****************************************************************************
+ * Name: work_isqueued
+ *
+ * Description:
+ *   Return true if work is pending on the FIFO list or in the deadline heap
+ *   of a work queue.  Unlike the worker field, this does not depend on the
+ *   contents of the work structure, which may be uninitialized.  It takes
+ *   time linear in the number of pending work items and must be called
+ *   with interrupts disabled.
+ *
+ ****************************************************************************/
+
+bool work_isqueued(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
+{
+	FAR struct work_s *node;
+
+	for (node = (FAR struct work_s *)wqueue->q.head; node; node = WORK_NEXT(node)) {
+		if (node == work) {
+			return true;
+		}
+	}
+
+	/* Walk the heap depth first without a stack: descend to the leftmost
+	 * child, else move to the next sibling, else climb back up.  The
+	 * parent of a sibling list is the prev link of its leftmost entry.
+	 */
+
+	node = wqueue->root;
+	while (node) {
+		if (node == work) {
+			return true;
+		}
+
+		if (node->child) {
+			node = node->child;
+			continue;
+		}
+
+		while (node != wqueue->root && WORK_NEXT(node) == NULL) {
+			while (WORK_PREV(node)->child != node) {
+				node = WORK_PREV(node);
+			}
+
+			node = WORK_PREV(node);
+		}
+
+		node = node == wqueue->root ? NULL : WORK_NEXT(node);
+	}
+
+	return false;
+}
+
+#endif							/* CONFIG_SCHED_WORKQUEUE_DEADLINE */
@@ -64,6 +64,7 @@
 #include <tinyara/kthread.h>
 #include <tinyara/kmalloc.h>
 #include <tinyara/clock.h>
+#include <tinyara/semaphore.h>
 
 #include "wqueue/wqueue.h"
 
@@ -178,6 +179,17 @@ int work_hpstart(void)
 	g_hpwork.delay = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
 	dq_init(&g_hpwork.q);
 
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	/* The workers wait on this semaphore for new work.  It is used for
+	 * signalling, not for locking, so there must be no priority inheritance.
+	 */
+
+	sem_init(&g_hpwork.sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&g_hpwork.sem, SEM_PRIO_NONE);
+#endif
+#endif
+
 	/* Start the high-priority, kernel mode worker thread */
 
 	svdbg("Starting high-priority kernel worker thread\n");
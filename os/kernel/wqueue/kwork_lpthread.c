@@ -67,6 +67,7 @@
 #include <tinyara/kthread.h>
 #include <tinyara/kmalloc.h>
 #include <tinyara/clock.h>
+#include <tinyara/semaphore.h>
 
 #include "wqueue/wqueue.h"
 
@@ -213,6 +214,17 @@ int work_lpstart(void)
 	g_lpwork.delay = CONFIG_SCHED_LPWORKPERIOD / USEC_PER_TICK;
 	dq_init(&g_lpwork.q);
 
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	/* The workers wait on this semaphore for new work.  It is used for
+	 * signalling, not for locking, so there must be no priority inheritance.
+	 */
+
+	sem_init(&g_lpwork.sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	sem_setprotocol(&g_lpwork.sem, SEM_PRIO_NONE);
+#endif
+#endif
+
 	/* Don't permit any of the threads to run until we have fully initialized
 	 * g_lpwork.
 	 */
@@ -58,10 +58,12 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <signal.h>
+#include <semaphore.h>
 #include <assert.h>
 #include <queue.h>
 
 #include <tinyara/clock.h>
+#include <tinyara/semaphore.h>
 #include <tinyara/wqueue.h>
 
 #include <arch/irq.h>
@@ -124,6 +126,114 @@
  *   None
  *
  ****************************************************************************/
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
+{
+	FAR struct work_s *work;
+	worker_t worker;
+	irqstate_t flags;
+	FAR void *arg;
+	systime_t ctick;
+	systime_t next;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	systime_t elapsed;
+#endif
+
+	/* Interrupts stay disabled while we look at the queue and until we are
+	 * blocked on the semaphore, so that a wakeup cannot be lost.
+	 */
+
+	flags = irqsave();
+
+	for (;;) {
+		/* Immediate work first, in the order it was queued, then the delayed
+		 * work whose deadline has passed.  Only the root of the deadline heap
+		 * ever needs to be examined.
+		 */
+
+		ctick = clock_systimer();
+		work = (FAR struct work_s *)wqueue->q.head;
+		if (work != NULL) {
+			dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+		} else if (wqueue->root != NULL && ctick - wqueue->root->qtime >= wqueue->root->delay) {
+			work = wqueue->root;
+			work_heapremove(wqueue, work);
+		} else {
+			break;
+		}
+
+		/* Extract the work description and mark the work as no longer being
+		 * queued before re-enabling interrupts.
+		 */
+
+		worker = work->worker;
+		arg = work->arg;
+		DEBUGASSERT(worker != NULL);
+		work->worker = NULL;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+		elapsed = ctick - WORK_DEADLINE(work);
+		wqueue->stats.npending--;
+		wqueue->stats.nrun++;
+		wqueue->stats.totlatency += elapsed;
+		if (elapsed > wqueue->stats.maxlatency) {
+			wqueue->stats.maxlatency = elapsed;
+		}
+#endif
+
+		/* Do the work.  Re-enable interrupts while the work is being
+		 * performed... we don't have any idea how long this will take!
+		 */
+
+		irqrestore(flags);
+		worker(arg);
+		flags = irqsave();
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+		elapsed = clock_systimer() - ctick;
+		wqueue->stats.totrun += elapsed;
+		if (elapsed > wqueue->stats.maxrun) {
+			wqueue->stats.maxrun = elapsed;
+			wqueue->stats.maxworker = worker;
+		}
+#endif
+	}
+
+	/* Nothing is due.  Sleep until the earliest deadline, or until the end
+	 * of the polling period if that comes first.  A period of zero (the
+	 * extra low priority workers) means that there is no periodic activity.
+	 * work_queue() posts the semaphore if new work changes the earliest
+	 * deadline.
+	 */
+
+	next = 0;
+	if (wqueue->root != NULL) {
+		next = WORK_DEADLINE(wqueue->root) - ctick;
+	}
+
+	if (period > 0 && (next == 0 || next > period)) {
+		next = period;
+	}
+
+	/* Do not wait at all if work_signal() has been called since the last
+	 * time, the caller has something to do (garbage collection).
+	 */
+
+	if (!wqueue->worker[wndx].signaled) {
+		wqueue->worker[wndx].busy = false;
+		if (next > 0) {
+			(void)sem_tickwait(&wqueue->sem, ctick, (uint32_t)next);
+		} else {
+			(void)sem_wait(&wqueue->sem);
+		}
+
+		wqueue->worker[wndx].busy = true;
+	}
+
+	wqueue->worker[wndx].signaled = false;
+	irqrestore(flags);
+}
+#else
 void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 {
 	volatile FAR struct work_s *work;
@@ -303,5 +413,6 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx)
 
 	irqrestore(flags);
 }
+#endif							/* CONFIG_SCHED_WORKQUEUE_DEADLINE */
 
 #endif							/* CONFIG_SCHED_WORKQUEUE */
@@ -56,6 +56,7 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <assert.h>
 #include <errno.h>
@@ -118,6 +119,60 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
+{
+	irqstate_t flags;
+	bool wakeup;
+
+	DEBUGASSERT(work != NULL && worker != NULL);
+
+	flags = irqsave();
+
+	/* Queued work always has a worker (see work_available()), so work
+	 * without one needs no search.  A worker alone does not prove that the
+	 * work is queued, the structure may never have been initialized.
+	 */
+
+	if (work->worker != NULL && work_isqueued(wqueue, work)) {
+		irqrestore(flags);
+		return -EALREADY;
+	}
+
+	work->worker = worker;		/* Work callback */
+	work->arg = arg;			/* Callback argument */
+	work->delay = delay;		/* Delay until work performed */
+	work->qtime = clock_systimer();	/* Time work queued */
+
+	if (delay == 0) {
+		/* Immediate work is run in the order it was queued */
+
+		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+		wakeup = true;
+	} else {
+		/* Delayed work only needs a worker to be woken up if it is now the
+		 * earliest deadline; otherwise the workers are already waiting for
+		 * an earlier one.
+		 */
+
+		wakeup = work_heapinsert(wqueue, work);
+	}
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	wqueue->stats.nqueued++;
+	if (++wqueue->stats.npending > wqueue->stats.maxpending) {
+		wqueue->stats.maxpending = wqueue->stats.npending;
+	}
+#endif
+
+	if (wakeup) {
+		work_wakeup(wqueue);
+	}
+
+	irqrestore(flags);
+	return OK;
+}
+#else
 static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, uint32_t delay)
 {
 	struct work_s *cur_work;
@@ -162,6 +217,7 @@ static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *wor
 
 	return OK;
 }
+#endif							/* CONFIG_SCHED_WORKQUEUE_DEADLINE */
 #endif
 
 /****************************************************************************
@@ -207,10 +263,16 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg,
 		/* Cancel high priority work */
 
 		result = work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+		/* work_qqueue() has already woken up a worker if that was needed */
+
+		return result;
+#else
 		if (result != OK) {
 			return result;
 		}
 		return work_signal(HPWORK);
+#endif
 	} else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
@@ -218,10 +280,16 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg,
 			/* Cancel low priority work */
 
 			result = work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+			/* work_qqueue() has already woken up a worker if that was needed */
+
+			return result;
+#else
 			if (result != OK) {
 				return result;
 			}
 			return work_signal(LPWORK);
+#endif
 		} else
 #endif
 		{
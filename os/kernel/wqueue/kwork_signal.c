@@ -57,8 +57,10 @@
 #include <tinyara/config.h>
 
 #include <signal.h>
+#include <semaphore.h>
 #include <errno.h>
 
+#include <tinyara/arch.h>
 #include <tinyara/wqueue.h>
 
 #include "wqueue/wqueue.h"
@@ -68,6 +70,42 @@
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up one idle worker of a work queue.  The semaphore is only posted
+ *   if a worker is actually blocked on it: a worker that is busy examines
+ *   the queue again, with interrupts disabled, before it waits, so it
+ *   cannot miss new work.  This keeps the semaphore count from building up
+ *   and the workers from spinning on stale posts.
+ *
+ * Input parameters:
+ *   wqueue - The work queue
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+void work_wakeup(FAR struct kwork_wqueue_s *wqueue)
+{
+	irqstate_t flags;
+	int semcount;
+
+	flags = irqsave();
+	if (sem_getvalue(&wqueue->sem, &semcount) == OK && semcount < 0) {
+		sem_post(&wqueue->sem);
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+		wqueue->stats.nwakeups++;
+#endif
+	}
+
+	irqrestore(flags);
+}
+#endif
 /****************************************************************************
  * Name: work_signal
  *
@@ -84,6 +122,48 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+int work_signal(int qid)
+{
+	FAR struct kwork_wqueue_s *wqueue;
+	irqstate_t flags;
+	int ret = OK;
+
+#ifdef CONFIG_SCHED_HPWORK
+	if (qid == HPWORK) {
+		wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork;
+	} else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+		if (qid == LPWORK) {
+			wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork;
+		} else
+#endif
+		{
+			return -EINVAL;
+		}
+
+	/* Worker 0 collects garbage each time work_process() returns, and
+	 * sched_free() relies on this call to get that done.  Posting the
+	 * semaphore could wake any of the low priority workers, so flag worker
+	 * 0 and interrupt its wait with SIGWORK if it is idle.  A busy worker 0
+	 * sees the flag before it waits again.
+	 */
+
+	flags = irqsave();
+	wqueue->worker[0].signaled = true;
+	if (wqueue->worker[0].pid > 0 && !wqueue->worker[0].busy) {
+		ret = kill(wqueue->worker[0].pid, SIGWORK);
+		if (ret < 0) {
+			int errcode = errno;
+			ret = -errcode;
+		}
+	}
+
+	irqrestore(flags);
+	return ret;
+}
+#else
 int work_signal(int qid)
 {
 	pid_t pid;
@@ -135,5 +215,6 @@ int work_signal(int qid)
 
 	return OK;
 }
+#endif							/* CONFIG_SCHED_WORKQUEUE_DEADLINE */
 
 #endif							/* CONFIG_SCHED_WORKQUEUE */
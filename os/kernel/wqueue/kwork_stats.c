@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wqueue/kwork_stats.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_getstats
+ *
+ * Description:
+ *   Return a snapshot of the latency and run-time statistics of a kernel
+ *   work queue.
+ *
+ * Input parameters:
+ *   qid    - The work queue ID (HPWORK or LPWORK)
+ *   stats  - Location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_getstats(int qid, FAR struct work_stats_s *stats)
+{
+	FAR struct kwork_wqueue_s *wqueue;
+	irqstate_t flags;
+
+#ifdef CONFIG_SCHED_HPWORK
+	if (qid == HPWORK) {
+		wqueue = (FAR struct kwork_wqueue_s *)&g_hpwork;
+	} else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+		if (qid == LPWORK) {
+			wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork;
+		} else
+#endif
+		{
+			return -EINVAL;
+		}
+
+	/* Take the snapshot with interrupts disabled so that it is consistent */
+
+	flags = irqsave();
+	memcpy(stats, &wqueue->stats, sizeof(struct work_stats_s));
+	irqrestore(flags);
+
+	return OK;
+}
+
+#endif							/* CONFIG_SCHED_WORKQUEUE_STATS */
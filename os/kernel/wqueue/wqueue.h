@@ -61,8 +61,11 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <semaphore.h>
 #include <queue.h>
 
+#include <tinyara/wqueue.h>
+
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
@@ -74,6 +77,10 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* The time at which delayed work becomes due */
+
+#define WORK_DEADLINE(w) ((w)->qtime + (w)->delay)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -82,6 +89,9 @@
 struct kworker_s {
 	pid_t pid;					/* The task ID of the worker thread */
 	volatile bool busy;			/* True: Worker is not available */
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	volatile bool signaled;		/* work_signal() called, see work_process() */
+#endif
 };
 
 /* This structure defines the state of one kernel-mode work queue */
@@ -89,6 +99,13 @@ struct kworker_s {
 struct kwork_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	FAR struct work_s *root;	/* Heap of delayed work, earliest deadline first */
+	sem_t sem;					/* Posted to wake up an idle worker */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	struct work_stats_s stats;	/* Latency and run-time statistics */
+#endif
+#endif
 	struct kworker_s worker[1];	/* Describes a worker thread */
 };
 
@@ -100,6 +117,13 @@ struct kwork_wqueue_s {
 struct hp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	FAR struct work_s *root;	/* Heap of delayed work, earliest deadline first */
+	sem_t sem;					/* Posted to wake up an idle worker */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	struct work_stats_s stats;	/* Latency and run-time statistics */
+#endif
+#endif
 	struct kworker_s worker[1];	/* Describes the single high priority worker */
 };
 #endif
@@ -112,6 +136,13 @@ struct hp_wqueue_s {
 struct lp_wqueue_s {
 	uint32_t delay;				/* Delay between polling cycles (ticks) */
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+	FAR struct work_s *root;	/* Heap of delayed work, earliest deadline first */
+	sem_t sem;					/* Posted to wake up an idle worker */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+	struct work_stats_s stats;	/* Latency and run-time statistics */
+#endif
+#endif
 
 	/* Describes each thread in the low priority queue's thread pool */
 
@@ -198,5 +229,33 @@ int work_lpstart(void);
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, uint32_t period, int wndx);
 
+/****************************************************************************
+ * Name: work_heapinsert, work_heapremove, work_isqueued
+ *
+ * Description:
+ *   Add delayed work to, or remove it from, the deadline heap of a work
+ *   queue (see kwork_heap.c).  Must be called with interrupts disabled.
+ *   work_heapinsert() returns true if the work became the earliest pending
+ *   work.  work_isqueued() searches the FIFO list and the heap for work.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_DEADLINE
+bool work_heapinsert(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work);
+void work_heapremove(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work);
+bool work_isqueued(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work);
+
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up one idle worker of a work queue, if any worker is waiting.
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+void work_wakeup(FAR struct kwork_wqueue_s *wqueue);
+#endif
+
 #endif							/* CONFIG_SCHED_WORKQUEUE */
 #endif							/* __SCHED_WQUEUE_WQUEUE_H */
@@ -93,7 +93,11 @@
 void kmm_free(FAR void *mem)
 {
 	DEBUGASSERT(kmm_heapmember(mem));
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	mm_free(&g_kmmheap, mem, __builtin_return_address(0));
+#else
 	mm_free(&g_kmmheap, mem);
+#endif
 }
 
 #endif							/* CONFIG_MM_KERNEL_HEAP */
@@ -139,5 +139,9 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size, int regio
 	 * located.
 	 */
 
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	mm_free(heap, (FAR void *)mem, 0);
+#else
 	mm_free(heap, (FAR void *)mem);
+#endif
 }
@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_findfreechunk.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <tinyara/mm/mm.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find the smallest free chunk of at least 'size' bytes.  The node is
+ *   not removed from the nodelist.  It is assumed that the caller holds the
+ *   mm semaphore.
+ *
+ * Parameters:
+ *   heap - The selected heap
+ *   size - Chunk size, including the allocation node, aligned to MM_MIN_CHUNK
+ *
+ * Return Value:
+ *   The best fitting free node, or NULL if there is none large enough.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_freenode_s *node;
+	int ndx;
+
+	/* Get the location in the node list to start the search. Special case
+	 * really big allocations
+	 */
+
+	if (size >= MM_MAX_CHUNK) {
+		ndx = MM_NNODES - 1;
+	} else {
+		/* Convert the request size into a nodelist index */
+
+		ndx = mm_size2ndx(size);
+	}
+
+	/* Search for a large enough chunk in the list of nodes. This list is
+	 * ordered by size, but will have occasional zero sized nodes as we visit
+	 * other mm_nodelist[] entries.  Since the list is ordered, the first
+	 * large enough node must be the best fitting chunk available.
+	 */
+
+	for (node = heap->mm_nodelist[ndx].flink; node && node->size < size; node = node->flink) ;
+
+	return node;
+}
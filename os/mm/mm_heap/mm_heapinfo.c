@@ -97,6 +97,13 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 #else
 #define region 0
 #endif
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+	if (mode == HEAPINFO_TRACE) {
+		heapinfo_trace_dump(heap);
+		return;
+	}
+#endif
+
 	/* initialize the nonsched and stack resource */
 	nonsched_resource = 0;
 	stack_resource = 0;
@@ -260,6 +267,78 @@ void heapinfo_update_node(FAR struct mm_allocnode_s *node, mmaddress_t caller_re
 	return;
 }
 
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+/****************************************************************************
+ * Name: heapinfo_trace_event
+ *
+ * Description:
+ * Record one heap event.  'mem' must still point to a valid chunk: a freed
+ * chunk must be recorded before it is merged with its neighbours.
+ ****************************************************************************/
+void heapinfo_trace_event(FAR struct mm_heap_s *heap, char type, FAR void *mem, FAR void *prev, mmaddress_t caller_retaddr)
+{
+	struct heapinfo_trace_s *event;
+	struct mm_allocnode_s *node;
+
+	if (heap->mm_ntrace >= CONFIG_DEBUG_MM_HEAPINFO_TRACE_ENTRIES) {
+		heap->mm_tracedropped++;
+		return;
+	}
+
+	node = (struct mm_allocnode_s *)((char *)mem - SIZEOF_MM_ALLOCNODE);
+	event = &heap->mm_trace[heap->mm_ntrace++];
+
+	event->type = type;
+	event->addr = (mmaddress_t)mem;
+	event->prev = (mmaddress_t)prev;
+	event->caller = caller_retaddr;
+	event->size = node->size - SIZEOF_MM_ALLOCNODE;
+	event->pid = up_interrupt_context() ? HEAPINFO_INT : getpid();
+}
+
+/****************************************************************************
+ * Name: heapinfo_trace_dump
+ *
+ * Description:
+ * Print the recorded heap events in the text format read by tools/heapbench:
+ *
+ *   HEAPTRACE 1 <heap size> <number of events> <dropped events>
+ *   A <pid> <caller> <addr> <size>
+ *   F <pid> <caller> <addr> <size>
+ *   R <pid> <caller> <addr> <size> <previous addr>
+ *   END
+ *
+ * Addresses are hexadecimal, sizes are decimal usable chunk sizes.
+ ****************************************************************************/
+void heapinfo_trace_dump(FAR struct mm_heap_s *heap)
+{
+	struct heapinfo_trace_s *event;
+	uint32_t nevents;
+	uint32_t ndx;
+
+	mm_takesemaphore(heap);
+	nevents = heap->mm_ntrace;
+	mm_givesemaphore(heap);
+
+	/* Events are only appended, so they can be printed without holding the
+	 * semaphore.
+	 */
+
+	printf("HEAPTRACE 1 %u %u %u\n", heap->mm_heapsize, nevents, heap->mm_tracedropped);
+	for (ndx = 0; ndx < nevents; ndx++) {
+		event = &heap->mm_trace[ndx];
+		printf("%c %d %08x %08x %u", event->type, event->pid, event->caller, event->addr, event->size);
+		if (event->type == HEAPINFO_TRACE_REALLOC) {
+			printf(" %08x", event->prev);
+		}
+
+		printf("\n");
+	}
+
+	printf("END\n");
+}
+#endif
+
 /****************************************************************************
  * Name: heapinfo_exclude_stacksize
  *
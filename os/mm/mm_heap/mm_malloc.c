@@ -110,7 +110,6 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 {
 	FAR struct mm_freenode_s *node;
 	void *ret = NULL;
-	int ndx;
 
 	/* Handle bad sizes */
 
@@ -128,44 +127,22 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
 	mm_takesemaphore(heap);
 
-	/* Get the location in the node list to start the search. Special case
-	 * really big allocations
+	/* Find the best fitting free chunk.  The search strategy depends on
+	 * how the free lists are organized (see mm_findfreechunk()).
 	 */
 
-	if (size >= MM_MAX_CHUNK) {
-		ndx = MM_NNODES - 1;
-	} else {
-		/* Convert the request size into a nodelist index */
-
-		ndx = mm_size2ndx(size);
-	}
-
-	/* Search for a large enough chunk in the list of nodes. This list is
-	 * ordered by size, but will have occasional zero sized nodes as we visit
-	 * other mm_nodelist[] entries.
-	 */
+	node = mm_findfreechunk(heap, size);
 
-	for (node = heap->mm_nodelist[ndx].flink; node && node->size < size; node = node->flink) ;
-
-	/* If we found a node with non-zero size, then this is one to use. Since
-	 * the list is ordered, we know that is must be best fitting chunk
-	 * available.
-	 */
+	/* If we found a node with non-zero size, then this is one to use. */
 
 	if (node) {
 		FAR struct mm_freenode_s *remainder;
 		FAR struct mm_freenode_s *next;
 		size_t remaining;
 
-		/* Remove the node.  There must be a predecessor, but there may not be
-		 * a successor node.
-		 */
+		/* Remove the node from the free list */
 
-		DEBUGASSERT(node->blink);
-		node->blink->flink = node->flink;
-		if (node->flink) {
-			node->flink->blink = node->blink;
-		}
+		mm_delfreechunk(heap, node);
 
 		/* Check if we have to split the free node into one of the allocated
 		 * size and another smaller freenode.  In some cases, the remaining
@@ -211,6 +188,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 		heapinfo_update_total_size(heap, node->size);
 #endif
 		ret = (void *)((char *)node + SIZEOF_MM_ALLOCNODE);
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+		heapinfo_trace_event(heap, HEAPINFO_TRACE_ALLOC, ret, NULL, caller_retaddr);
+#endif
 	}
 
 	mm_givesemaphore(heap);
@@ -238,6 +238,11 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment, size_t size)
 
 	heapinfo_add_size(node->pid, node->size);
 	heapinfo_update_total_size(heap, node->size);
+#endif
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+	/* The chunk was recorded by mm_malloc() at its raw address */
+
+	heapinfo_trace_event(heap, HEAPINFO_TRACE_REALLOC, (FAR void *)alignedchunk, (FAR void *)rawchunk, caller_retaddr);
 #endif
 	mm_givesemaphore(heap);
 	return (FAR void *)alignedchunk;
@@ -128,7 +128,11 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 	/* If size is zero, then realloc is equivalent to free */
 
 	if (size < 1) {
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+		mm_free(heap, oldmem, caller_retaddr);
+#else
 		mm_free(heap, oldmem);
+#endif
 		return NULL;
 	}
 
@@ -170,6 +174,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 
 			heapinfo_add_size(oldnode->pid, oldnode->size);
 			heapinfo_update_total_size(heap, oldnode->size);
+#endif
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+			heapinfo_trace_event(heap, HEAPINFO_TRACE_REALLOC, oldmem, oldmem, caller_retaddr);
 #endif
 		}
 
@@ -259,15 +266,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		if (takeprev) {
 			FAR struct mm_allocnode_s *newnode;
 
-			/* Remove the previous node.  There must be a predecessor, but
-			 * there may not be a successor node.
-			 */
+			/* Remove the previous node from the free list */
 
-			DEBUGASSERT(prev->blink);
-			prev->blink->flink = prev->flink;
-			if (prev->flink) {
-				prev->flink->blink = prev->blink;
-			}
+			mm_delfreechunk(heap, prev);
 
 			/* Extend the node into the previous free chunk */
 			/* Did we consume the entire preceding chunk? */
@@ -317,15 +318,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 
 			andbeyond = (FAR struct mm_allocnode_s *)((char *)next + nextsize);
 
-			/* Remove the next node.  There must be a predecessor, but there
-			 * may not be a successor node.
-			 */
+			/* Remove the next node from the free list */
 
-			DEBUGASSERT(next->blink);
-			next->blink->flink = next->flink;
-			if (next->flink) {
-				next->flink->blink = next->blink;
-			}
+			mm_delfreechunk(heap, next);
 
 			/* Extend the node into the next chunk */
 			/* Did we consume the entire preceding chunk? */
@@ -357,6 +352,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		heapinfo_add_size(oldnode->pid, oldnode->size);
 		heapinfo_update_total_size(heap, oldnode->size);
 #endif
+#ifdef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+		heapinfo_trace_event(heap, HEAPINFO_TRACE_REALLOC, newmem, oldmem, caller_retaddr);
+#endif
 
 		mm_givesemaphore(heap);
 		return newmem;
@@ -378,7 +376,11 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 #endif
 		if (newmem) {
 			memcpy(newmem, oldmem, oldsize);
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+			mm_free(heap, oldmem, caller_retaddr);
+#else
 			mm_free(heap, oldmem);
+#endif
 		}
 
 		return newmem;
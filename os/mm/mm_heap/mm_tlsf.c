@@ -0,0 +1,231 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ * Two-level segregated-fit free chunk management.
+ *
+ * When CONFIG_MM_TLSF is selected, free chunks are no longer kept in one
+ * size-ordered list that must be walked on every allocation.  Instead the
+ * free chunk size range is split into first-level classes (powers of two,
+ * one per MM_NNODES entry) which are each split again into
+ * MM_TLSF_SLCOUNT linearly spaced second-level classes.  Every class has
+ * its own unordered free list and a bit in a two-level bitmap that tells
+ * whether the list is non-empty.  Insertion, removal and the best-fit
+ * search are therefore done with a few find-first-set operations and never
+ * walk a list.
+ *
+ * The chunk headers are exactly those of the default allocator so that
+ * mm_free(), mm_realloc(), mm_mallinfo() and the heapinfo logic that walk
+ * the physical chunk chain are unchanged.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Index of the least/most significant set bit of a non-zero 32-bit word */
+
+#define mm_tlsf_ffs(x)   __builtin_ctz(x)
+#define mm_tlsf_fls(x)   (31 - __builtin_clz(x))
+
+/* The last class collects every chunk of MM_MAX_CHUNK bytes or more */
+
+#define MM_TLSF_LAST_FL  (MM_NNODES - 1)
+#define MM_TLSF_LAST_SL  (MM_TLSF_SLCOUNT - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Convert a chunk size into its first-level and second-level class.
+ *
+ ****************************************************************************/
+
+static inline void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+	int msb;
+
+	if (size >= MM_MAX_CHUNK) {
+		*fl = MM_TLSF_LAST_FL;
+		*sl = MM_TLSF_LAST_SL;
+		return;
+	}
+
+	msb = mm_tlsf_fls((uint32_t)size);
+	*fl = msb - MM_MIN_SHIFT;
+	*sl = (int)(size >> (msb - MM_TLSF_SLSHIFT)) & (MM_TLSF_SLCOUNT - 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of the free list of its size class.  It is
+ *   assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+	FAR struct mm_freenode_s *head;
+	int fl;
+	int sl;
+
+	mm_tlsf_mapping(node->size, &fl, &sl);
+
+	head = heap->mm_freelist[fl][sl];
+	node->blink = NULL;
+	node->flink = head;
+	if (head) {
+		head->blink = node;
+	}
+
+	heap->mm_freelist[fl][sl] = node;
+	heap->mm_flbitmap |= (1u << fl);
+	heap->mm_slbitmap[fl] |= (1u << sl);
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the free list of its size class.  The chunk
+ *   size must not have been modified since it was added with
+ *   mm_addfreechunk().  It is assumed that the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+	int fl;
+	int sl;
+
+	if (node->flink) {
+		node->flink->blink = node->blink;
+	}
+
+	if (node->blink) {
+		node->blink->flink = node->flink;
+		return;
+	}
+
+	/* This was the head of its list.  Update the list head and clear the
+	 * bitmaps if the list is now empty.
+	 */
+
+	mm_tlsf_mapping(node->size, &fl, &sl);
+	DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+	heap->mm_freelist[fl][sl] = node->flink;
+	if (node->flink == NULL) {
+		heap->mm_slbitmap[fl] &= ~(1u << sl);
+		if (heap->mm_slbitmap[fl] == 0) {
+			heap->mm_flbitmap &= ~(1u << fl);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes.  The request is rounded up
+ *   to the next second-level class boundary so that any chunk in the
+ *   selected class is large enough; the search is then two find-first-set
+ *   operations on the class bitmaps.  Only requests for MM_MAX_CHUNK or
+ *   more, which all share the last class, must check the chunk sizes.  The
+ *   node is not removed from its free list.  It is assumed that the caller
+ *   holds the mm semaphore.
+ *
+ * Parameters:
+ *   heap - The selected heap
+ *   size - Chunk size, including the allocation node, aligned to MM_MIN_CHUNK
+ *
+ * Return Value:
+ *   A large enough free node, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_freenode_s *node;
+	uint32_t map;
+	size_t rounded;
+	int fl;
+	int sl;
+
+	rounded = size;
+	if (size < MM_MAX_CHUNK) {
+		rounded += (1 << (mm_tlsf_fls((uint32_t)size) - MM_TLSF_SLSHIFT)) - 1;
+	}
+
+	mm_tlsf_mapping(rounded, &fl, &sl);
+
+	/* Look for a non-empty class at the same first level ... */
+
+	map = heap->mm_slbitmap[fl] & (~0u << sl);
+	if (map == 0) {
+		/* ... or else at the next non-empty first level */
+
+		map = (fl + 1 < MM_NNODES) ? heap->mm_flbitmap & (~0u << (fl + 1)) : 0;
+		if (map == 0) {
+			return NULL;
+		}
+
+		fl  = mm_tlsf_ffs(map);
+		map = heap->mm_slbitmap[fl];
+	}
+
+	sl   = mm_tlsf_ffs(map);
+	node = heap->mm_freelist[fl][sl];
+	DEBUGASSERT(node != NULL);
+
+	/* The last class is not bounded in size */
+
+	if (fl == MM_TLSF_LAST_FL && sl == MM_TLSF_LAST_SL) {
+		while (node && node->size < size) {
+			node = node->flink;
+		}
+	}
+
+	return node;
+}
+
+#endif							/* CONFIG_MM_TLSF */
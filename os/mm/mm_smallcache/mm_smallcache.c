@@ -0,0 +1,386 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_smallcache/mm_smallcache.c
+ *
+ * Per task group caches of small heap chunks.
+ *
+ * Small allocations are served from singly linked free lists kept in the
+ * task group of the caller, one list per chunk size class.  The lists are
+ * refilled from and drained to the heap in batches, so the heap semaphore
+ * is taken only once per CONFIG_MM_SMALLCACHE_BATCH small allocations or
+ * frees.  The lists themselves are protected by a short critical section
+ * since they are shared by all threads of the group.
+ *
+ * Cached chunks are ordinary allocated heap chunks: the size class of a
+ * freed chunk is taken from its chunk header and the chunk can be returned
+ * to the heap with mm_free() at any time.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <arch/irq.h>
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <tinyara/mm/mm.h>
+#include <tinyara/mm/smallcache.h>
+
+#ifdef CONFIG_MM_SMALLCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The link to the next cached chunk is kept in the first word of the user
+ * memory of each chunk.
+ */
+
+#define SC_NEXT(mem)  (*(FAR void **)(mem))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct mm_smallcache_stats_s g_mm_smallcache_stats[MM_SMALLCACHE_NCLASSES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_smallcache_get
+ *
+ * Description:
+ *   Return the cache of the calling task group or NULL if small chunks
+ *   cannot be cached in this context.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_smallcache_s *mm_smallcache_get(void)
+{
+	FAR struct tcb_s *tcb;
+
+	if (up_interrupt_context()) {
+		return NULL;
+	}
+
+	/* A group with no members is being released and must not take any
+	 * more chunks.
+	 */
+
+	tcb = sched_self();
+	if (!tcb || !tcb->group || tcb->group->tg_nmembers == 0) {
+		return NULL;
+	}
+
+	return &tcb->group->tg_smallcache;
+}
+
+/****************************************************************************
+ * Name: mm_smallcache_refill
+ *
+ * Description:
+ *   Allocate a batch of chunks of the size class 'ndx' with a single hold
+ *   of the heap semaphore.  One chunk is returned to the caller and the
+ *   others are added to the cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+static FAR void *mm_smallcache_refill(FAR struct mm_heap_s *heap, FAR struct mm_smallcache_s *cache, int ndx, mmaddress_t caller_retaddr)
+#else
+static FAR void *mm_smallcache_refill(FAR struct mm_heap_s *heap, FAR struct mm_smallcache_s *cache, int ndx)
+#endif
+{
+	size_t usable = ((ndx + 1) << MM_MIN_SHIFT) - SIZEOF_MM_ALLOCNODE;
+	FAR void *head = NULL;
+	FAR void *tail = NULL;
+	FAR void *mem;
+	irqstate_t flags;
+	int count = 0;
+	int i;
+
+	mm_takesemaphore(heap);
+
+	for (i = 0; i < CONFIG_MM_SMALLCACHE_BATCH; i++) {
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+		mem = mm_malloc(heap, usable, caller_retaddr);
+#else
+		mem = mm_malloc(heap, usable);
+#endif
+		if (!mem) {
+			break;
+		}
+
+		SC_NEXT(mem) = head;
+		if (!head) {
+			tail = mem;
+		}
+
+		head = mem;
+		count++;
+	}
+
+	mm_givesemaphore(heap);
+
+	if (!head) {
+		return NULL;
+	}
+
+	/* Keep the first chunk for the caller and cache the rest */
+
+	mem  = head;
+	head = SC_NEXT(mem);
+	count--;
+
+	flags = irqsave();
+	if (head) {
+		SC_NEXT(tail) = cache->sc_head[ndx];
+		cache->sc_head[ndx] = head;
+		cache->sc_count[ndx] += count;
+		g_mm_smallcache_stats[ndx].cached += count;
+	}
+
+	g_mm_smallcache_stats[ndx].refills++;
+	irqrestore(flags);
+
+	return mem;
+}
+
+/****************************************************************************
+ * Name: mm_smallcache_drain
+ *
+ * Description:
+ *   Return up to CONFIG_MM_SMALLCACHE_BATCH chunks of the size class 'ndx'
+ *   to the heap with a single hold of the heap semaphore.
+ *
+ ****************************************************************************/
+
+static void mm_smallcache_drain(FAR struct mm_heap_s *heap, FAR struct mm_smallcache_s *cache, int ndx)
+{
+	FAR void *head;
+	FAR void *mem;
+	irqstate_t flags;
+	int count;
+
+	/* Detach a batch of chunks from the list */
+
+	flags = irqsave();
+	head = cache->sc_head[ndx];
+	if (!head) {
+		irqrestore(flags);
+		return;
+	}
+
+	for (mem = head, count = 1; SC_NEXT(mem) && count < CONFIG_MM_SMALLCACHE_BATCH; count++) {
+		mem = SC_NEXT(mem);
+	}
+
+	cache->sc_head[ndx] = SC_NEXT(mem);
+	SC_NEXT(mem) = NULL;
+	cache->sc_count[ndx] -= count;
+	g_mm_smallcache_stats[ndx].cached -= count;
+	g_mm_smallcache_stats[ndx].drains++;
+	irqrestore(flags);
+
+	/* Then free them to the heap.  mm_free() will take the semaphore
+	 * recursively, so this is only one real semaphore wait.  The chunks
+	 * were freed by earlier callers, so no caller is recorded for them.
+	 */
+
+	mm_takesemaphore(heap);
+	while (head) {
+		mem  = head;
+		head = SC_NEXT(mem);
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+		mm_free(heap, mem, 0);
+#else
+		mm_free(heap, mem);
+#endif
+	}
+
+	mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_smallcache_alloc
+ *
+ * Description:
+ *   Allocate a small chunk from the cache of the calling task group.  See
+ *   include/tinyara/mm/smallcache.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *mm_smallcache_alloc(FAR struct mm_heap_s *heap, size_t size, mmaddress_t caller_retaddr)
+#else
+FAR void *mm_smallcache_alloc(FAR struct mm_heap_s *heap, size_t size)
+#endif
+{
+	FAR struct mm_smallcache_s *cache;
+	FAR void *mem;
+	irqstate_t flags;
+	int ndx;
+
+	if (size < 1 || size > CONFIG_MM_SMALLCACHE_MAXSIZE) {
+		return NULL;
+	}
+
+	cache = mm_smallcache_get();
+	if (!cache) {
+		return NULL;
+	}
+
+	ndx = MM_SMALLCACHE_NDX(MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE));
+
+	flags = irqsave();
+	mem = cache->sc_head[ndx];
+	if (mem) {
+		cache->sc_head[ndx] = SC_NEXT(mem);
+		cache->sc_count[ndx]--;
+		g_mm_smallcache_stats[ndx].cached--;
+		g_mm_smallcache_stats[ndx].hits++;
+	}
+
+	irqrestore(flags);
+
+	if (!mem) {
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+		return mm_smallcache_refill(heap, cache, ndx, caller_retaddr);
+#else
+		return mm_smallcache_refill(heap, cache, ndx);
+#endif
+	}
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	/* Transfer the ownership of the chunk to the caller */
+
+	{
+		FAR struct mm_allocnode_s *node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+		heapinfo_subtract_size(node->pid, node->size);
+		heapinfo_update_node(node, caller_retaddr);
+		heapinfo_add_size(node->pid, node->size);
+	}
+#endif
+
+	return mem;
+}
+
+/****************************************************************************
+ * Name: mm_smallcache_free
+ *
+ * Description:
+ *   Keep a small chunk in the cache of the calling task group.  See
+ *   include/tinyara/mm/smallcache.h.
+ *
+ ****************************************************************************/
+
+bool mm_smallcache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+	FAR struct mm_allocnode_s *node;
+	FAR struct mm_smallcache_s *cache;
+	irqstate_t flags;
+	bool drain;
+	int ndx;
+
+	if (!mem) {
+		return false;
+	}
+
+	node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+	if (node->size > MM_SMALLCACHE_MAXCHUNK || (node->preceding & MM_ALLOC_BIT) == 0) {
+		return false;
+	}
+
+	cache = mm_smallcache_get();
+	if (!cache) {
+		return false;
+	}
+
+	ndx = MM_SMALLCACHE_NDX(node->size);
+
+	flags = irqsave();
+	SC_NEXT(mem) = cache->sc_head[ndx];
+	cache->sc_head[ndx] = mem;
+	cache->sc_count[ndx]++;
+	g_mm_smallcache_stats[ndx].cached++;
+	g_mm_smallcache_stats[ndx].frees++;
+	drain = cache->sc_count[ndx] > CONFIG_MM_SMALLCACHE_HIGHWATER;
+	irqrestore(flags);
+
+	if (drain) {
+		mm_smallcache_drain(heap, cache, ndx);
+	}
+
+	return true;
+}
+
+/****************************************************************************
+ * Name: mm_smallcache_release
+ *
+ * Description:
+ *   Return every chunk held by a task group cache to the heap.  See
+ *   include/tinyara/mm/smallcache.h.
+ *
+ ****************************************************************************/
+
+void mm_smallcache_release(FAR struct mm_smallcache_s *cache)
+{
+	FAR void *mem;
+	irqstate_t flags;
+	int ndx;
+
+	mm_takesemaphore(&g_mmheap);
+
+	for (ndx = 0; ndx < MM_SMALLCACHE_NCLASSES; ndx++) {
+		flags = irqsave();
+		mem = cache->sc_head[ndx];
+		g_mm_smallcache_stats[ndx].cached -= cache->sc_count[ndx];
+		cache->sc_head[ndx] = NULL;
+		cache->sc_count[ndx] = 0;
+		irqrestore(flags);
+
+		while (mem) {
+			FAR void *next = SC_NEXT(mem);
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+			mm_free(&g_mmheap, mem, 0);
+#else
+			mm_free(&g_mmheap, mem);
+#endif
+			mem = next;
+		}
+	}
+
+	mm_givesemaphore(&g_mmheap);
+}
+
+#endif							/* CONFIG_MM_SMALLCACHE */
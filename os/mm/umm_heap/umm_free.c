@@ -59,6 +59,9 @@
 #include <stdlib.h>
 
 #include <tinyara/mm/mm.h>
+#ifdef CONFIG_MM_SMALLCACHE
+#include <tinyara/mm/smallcache.h>
+#endif
 
 #if !defined(CONFIG_BUILD_PROTECTED) || !defined(__KERNEL__)
 
@@ -102,7 +105,23 @@
 
 void free(FAR void *mem)
 {
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	ARCH_GET_RET_ADDRESS
+#endif
+
+#ifdef CONFIG_MM_SMALLCACHE
+	/* Small chunks are kept in the cache of the calling task group */
+
+	if (mm_smallcache_free(USR_HEAP, mem)) {
+		return;
+	}
+#endif
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	mm_free(USR_HEAP, mem, retaddr);
+#else
 	mm_free(USR_HEAP, mem);
+#endif
 }
 
 #endif							/* !CONFIG_BUILD_PROTECTED || !__KERNEL__ */
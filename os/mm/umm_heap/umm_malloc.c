@@ -60,6 +60,9 @@
 #include <unistd.h>
 
 #include <tinyara/mm/mm.h>
+#ifdef CONFIG_MM_SMALLCACHE
+#include <tinyara/mm/smallcache.h>
+#endif
 
 #if !defined(CONFIG_BUILD_PROTECTED) || !defined(__KERNEL__)
 
@@ -147,8 +150,27 @@ FAR void *malloc(size_t size)
 
 	return mem;
 #else
+#ifdef CONFIG_MM_SMALLCACHE
+	FAR void *mem;
+#endif
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
+#endif
+
+#ifdef CONFIG_MM_SMALLCACHE
+	/* Try the small chunk cache of the calling task group first */
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	mem = mm_smallcache_alloc(USR_HEAP, size, retaddr);
+#else
+	mem = mm_smallcache_alloc(USR_HEAP, size);
+#endif
+	if (mem) {
+		return mem;
+	}
+#endif
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
 	return mm_malloc(USR_HEAP, size, retaddr);
 #else
 	return mm_malloc(USR_HEAP, size);
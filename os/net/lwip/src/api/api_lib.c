@@ -661,6 +661,68 @@ err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t siz
 	return err;
 }
 
+#if LWIP_TCP_PBUF_WRITE
+/**
+ * Send pbufs over a TCP netconn without copying their payload.
+ *
+ * Every pbuf of the chain must come from tcp_alloc_pbuf() and is queued as
+ * one segment. The chain is always consumed: the pbufs that could not be
+ * queued are freed before returning.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param p chain of pbufs from tcp_alloc_pbuf() holding the data
+ * @param apiflags combination of following flags :
+ * - NETCONN_MORE: for TCP connection, PSH flag will be set on last segment sent
+ * - NETCONN_DONTBLOCK: only write the data if all data can be written at once
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @return ERR_OK if data was sent, any other err_t on error
+ */
+err_t netconn_write_pbuf(struct netconn *conn, struct pbuf *p, u8_t apiflags, size_t *bytes_written)
+{
+	struct api_msg msg;
+	struct pbuf *rest;
+	size_t size;
+	err_t err;
+
+	*bytes_written = 0;
+	LWIP_ERROR("netconn_write_pbuf: invalid conn", (conn != NULL), pbuf_free(p); return ERR_ARG;);
+	LWIP_ERROR("netconn_write_pbuf: invalid conn->type", (conn->type == NETCONN_TCP), pbuf_free(p); return ERR_VAL;);
+	if (p->tot_len == 0) {
+		pbuf_free(p);
+		return ERR_OK;
+	}
+	size = p->tot_len;
+
+	msg.function = do_write;
+	msg.msg.conn = conn;
+	msg.msg.msg.w.dataptr = p;
+	msg.msg.msg.w.apiflags = (apiflags & (NETCONN_MORE | NETCONN_DONTBLOCK)) | NETCONN_PBUF;
+	msg.msg.msg.w.len = size;
+#if LWIP_SO_SNDTIMEO
+	if (conn->send_timeout != 0) {
+		msg.msg.msg.w.time_started = sys_now();
+	} else {
+		msg.msg.msg.w.time_started = 0;
+	}
+#endif							/* LWIP_SO_SNDTIMEO */
+
+	err = TCPIP_APIMSG(&msg);
+
+	/* do_write() leaves the pbufs it did not queue in dataptr, the others
+	   belong to the pcb now */
+	rest = (struct pbuf *)msg.msg.msg.w.dataptr;
+	if (rest != NULL) {
+		*bytes_written = size - rest->tot_len;
+		pbuf_free(rest);
+	} else {
+		*bytes_written = size;
+	}
+
+	NETCONN_SET_SAFE_ERR(conn, err);
+	return err;
+}
+#endif							/* LWIP_TCP_PBUF_WRITE */
+
 /**
  * Close ot shutdown a TCP netconn (doesn't delete it).
  *
@@ -1190,6 +1190,107 @@ void do_recv(struct api_msg_msg *msg)
 	TCPIP_APIMSG_ACK(msg);
 }
 
+#if LWIP_TCP_PBUF_WRITE
+/**
+ * do_writemore() for netconn_write_pbuf(): queue the pbufs of the chain in
+ * current_msg->msg.w.dataptr one segment at a time. The pbufs that were not
+ * queued are left in dataptr for the application thread to free.
+ *
+ * @param conn netconn (that is currently in state NETCONN_WRITE) to process
+ * @return ERR_OK
+ *         ERR_MEM if LWIP_TCPIP_CORE_LOCKING=1 and sending hasn't yet finished
+ */
+static err_t do_writemore_pbuf(struct netconn *conn)
+{
+	struct api_msg_msg *msg = conn->current_msg;
+	struct pbuf *p;
+	struct pbuf *rest;
+	u16_t len;
+	err_t err = ERR_OK;
+	u8_t write_finished = 0;
+	u8_t dontblock = netconn_is_nonblocking(conn) || (msg->msg.w.apiflags & NETCONN_DONTBLOCK);
+	u8_t apiflags = msg->msg.w.apiflags & NETCONN_MORE;
+
+#if LWIP_SO_SNDTIMEO
+	if ((conn->send_timeout != 0) && ((systime_t)(sys_now() - msg->msg.w.time_started) >= conn->send_timeout)) {
+		write_finished = 1;
+		err = (conn->write_offset == 0) ? ERR_WOULDBLOCK : ERR_OK;
+	}
+#endif							/* LWIP_SO_SNDTIMEO */
+
+	while (!write_finished) {
+		/* detach the first pbuf: each one becomes a segment of its own */
+		p = (struct pbuf *)msg->msg.w.dataptr;
+		rest = p->next;
+		len = p->len;
+		p->next = NULL;
+		p->tot_len = len;
+
+		err = tcp_write_pbuf(conn->pcb.tcp, p, (rest != NULL) ? (apiflags | TCP_WRITE_FLAG_MORE) : apiflags);
+		if (err == ERR_OK) {
+			conn->write_offset += len;
+			msg->msg.w.dataptr = rest;
+			if (rest == NULL) {
+				write_finished = 1;
+			}
+			continue;
+		}
+
+		/* put the pbuf back, it is still ours */
+		p->next = rest;
+		if (rest != NULL) {
+			p->tot_len += rest->tot_len;
+		}
+
+		if (err == ERR_MEM && !dontblock) {
+			/* wait for sent_tcp or poll_tcp to call us again */
+#if LWIP_TCPIP_CORE_LOCKING
+			conn->flags |= NETCONN_FLAG_WRITE_DELAYED;
+#endif
+			break;
+		}
+
+		write_finished = 1;
+		if (err == ERR_MEM) {
+			/* non-blocking write did not write everything: mark the pcb non-writable
+			   and let poll_tcp check writable space to mark the pcb writable again */
+			API_EVENT(conn, NETCONN_EVT_SENDMINUS, 0);
+			conn->flags |= NETCONN_FLAG_CHECK_WRITESPACE;
+			err = (conn->write_offset == 0) ? ERR_WOULDBLOCK : ERR_OK;
+		}
+	}
+
+	if (conn->pcb.tcp != NULL) {
+		if ((tcp_sndbuf(conn->pcb.tcp) <= TCP_SNDLOWAT) || (tcp_sndqueuelen(conn->pcb.tcp) >= TCP_SNDQUEUELOWAT)) {
+			/* The queued byte- or pbuf-count exceeds the configured low-water limit,
+			   let select mark this pcb as non-writable. */
+			API_EVENT(conn, NETCONN_EVT_SENDMINUS, 0);
+		}
+		tcp_output(conn->pcb.tcp);
+	}
+
+	if (write_finished) {
+		msg->msg.w.len = conn->write_offset;
+		conn->write_offset = 0;
+		msg->err = err;
+		conn->current_msg = NULL;
+		conn->state = NETCONN_NONE;
+#if LWIP_TCPIP_CORE_LOCKING
+		if ((conn->flags & NETCONN_FLAG_WRITE_DELAYED) != 0)
+#endif
+		{
+			sys_sem_signal(&conn->op_completed);
+		}
+	}
+#if LWIP_TCPIP_CORE_LOCKING
+	else {
+		return ERR_MEM;
+	}
+#endif
+	return ERR_OK;
+}
+#endif							/* LWIP_TCP_PBUF_WRITE */
+
 /**
  * See if more data needs to be written from a previous call to netconn_write.
  * Called initially from do_write. If the first call can't send all data
@@ -1211,6 +1312,12 @@ static err_t do_writemore(struct netconn *conn)
 	u8_t dontblock = netconn_is_nonblocking(conn) || (conn->current_msg->msg.w.apiflags & NETCONN_DONTBLOCK);
 	u8_t apiflags = conn->current_msg->msg.w.apiflags;
 
+#if LWIP_TCP_PBUF_WRITE
+	if (apiflags & NETCONN_PBUF) {
+		return do_writemore_pbuf(conn);
+	}
+#endif							/* LWIP_TCP_PBUF_WRITE */
+
 	LWIP_ASSERT("conn != NULL", conn != NULL);
 	LWIP_ASSERT("conn->state == NETCONN_WRITE", (conn->state == NETCONN_WRITE));
 	LWIP_ASSERT("conn->current_msg != NULL", conn->current_msg != NULL);
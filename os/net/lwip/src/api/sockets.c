@@ -67,6 +67,12 @@
 #else
 #define NET_DEVNAME "wl0"
 #endif
+#elif defined(CONFIG_ARCH_SIM)
+#if LWIP_HAVE_LOOPIF
+#define NET_DEVNAME "en1"
+#else
+#define NET_DEVNAME "en0"
+#endif
 #else
 #error "undefined CONFIG_NET_<type>, check your .config"
 #endif
@@ -860,6 +866,75 @@ int lwip_send(int s, const void *data, size_t size, int flags)
 	return (err == ERR_OK ? (int)written : -1);
 }
 
+#if LWIP_TCP_PBUF_WRITE
+/**
+ * Send the pbufs of a chain from tcp_alloc_pbuf() on a TCP socket, each as a
+ * segment of its own and without copying. The chain is always consumed.
+ *
+ * @return the number of bytes queued, or -1 with errno set
+ */
+int lwip_send_pbuf(int s, struct pbuf *p, int flags)
+{
+	struct socket *sock;
+	err_t err;
+	size_t written;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_pbuf(%d, p=%p, size=%" U16_F ", flags=0x%x)\n", s, (void *)p, p->tot_len, flags));
+
+	sock = get_socket(s);
+	if (!sock) {
+		pbuf_free(p);
+		return -1;
+	}
+
+	if (sock->conn->type != NETCONN_TCP) {
+		pbuf_free(p);
+		sock_set_errno(sock, EOPNOTSUPP);
+		return -1;
+	}
+
+	err = netconn_write_pbuf(sock->conn, p, ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0), &written);
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_pbuf(%d) err=%d written=%" SZT_F "\n", s, err, written));
+	sock_set_errno(sock, err_to_errno(err));
+	return (err == ERR_OK ? (int)written : -1);
+}
+
+/**
+ * Send data on a TCP socket by reference instead of copying it. The data
+ * must not change while the stack may still need it for a retransmission,
+ * so this is only for data in read-only memory, like the files of an XIP
+ * filesystem.
+ *
+ * @return the number of bytes queued, or -1 with errno set
+ */
+int lwip_send_static(int s, const void *data, size_t size, int flags)
+{
+	struct socket *sock;
+	err_t err;
+	size_t written;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_static(%d, data=%p, size=%" SZT_F ", flags=0x%x)\n", s, data, size, flags));
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	if (sock->conn->type != NETCONN_TCP) {
+		sock_set_errno(sock, EOPNOTSUPP);
+		return -1;
+	}
+
+	written = 0;
+	err = netconn_write_partly(sock->conn, data, size, NETCONN_NOCOPY | ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0), &written);
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_static(%d) err=%d written=%" SZT_F "\n", s, err, written));
+	sock_set_errno(sock, err_to_errno(err));
+	return (err == ERR_OK ? (int)written : -1);
+}
+#endif							/* LWIP_TCP_PBUF_WRITE */
+
 int lwip_sendto(int s, const void *data, size_t size, int flags, const struct sockaddr *to, socklen_t tolen)
 {
 	struct socket *sock;
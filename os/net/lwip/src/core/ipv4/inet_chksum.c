@@ -69,7 +69,7 @@
  * #define LWIP_CHKSUM <your_checksum_routine>
  *
  * Or you can select from the implementations below by defining
- * LWIP_CHKSUM_ALGORITHM to 1, 2 or 3.
+ * LWIP_CHKSUM_ALGORITHM to 1, 2, 3 or 4.
  */
 
 #ifndef LWIP_CHKSUM
@@ -270,6 +270,102 @@ static u16_t lwip_standard_chksum(void *dataptr, int len)
 }
 #endif
 
+#if (LWIP_CHKSUM_ALGORITHM == 4) || (LWIP_CHKSUM_COPY_ALGORITHM == 2)
+/**
+ * Fold a 64-bit accumulator of 32-bit words down to the 16-bit one's
+ * complement sum and undo the byte swap caused by an odd start address.
+ */
+static inline u16_t lwip_chksum_fold64(u64_t sum, int odd)
+{
+	u32_t acc;
+
+	sum = (sum >> 32) + (sum & 0xffffffffULL);
+	sum = (sum >> 32) + (sum & 0xffffffffULL);
+	acc = (u32_t)sum;
+	acc = FOLD_U32T(acc);
+	acc = FOLD_U32T(acc);
+
+	if (odd) {
+		acc = SWAP_BYTES_IN_WORD(acc);
+	}
+
+	return (u16_t)acc;
+}
+#endif
+
+#if (LWIP_CHKSUM_ALGORITHM == 4)	/* Alternative version #4 */
+/**
+ * Word-at-a-time checksum: after aligning to 32 bits the inner loop adds
+ * eight words per iteration into a 64-bit accumulator. The accumulator
+ * cannot overflow for any length below 16 GB, so no carry has to be
+ * propagated inside the loop and the additions are independent of each
+ * other. The 32-bit partial sums are folded once at the end.
+ *
+ * @arg start of buffer to be checksummed. May be an odd byte address.
+ * @len number of bytes in the buffer to be checksummed.
+ * @return host order (!) lwip checksum (non-inverted Internet sum)
+ */
+
+static u16_t lwip_standard_chksum(void *dataptr, int len)
+{
+	const u8_t *pb = (const u8_t *)dataptr;
+	const u32_t *pl;
+	u64_t sum = 0;
+	u16_t t = 0;
+	/* starts at odd byte address? */
+	int odd = ((mem_ptr_t)pb & 1);
+
+	if (odd && len > 0) {
+		((u8_t *)&t)[1] = *pb++;
+		len--;
+	}
+
+	if (((mem_ptr_t)pb & 2) && len > 1) {
+		sum += *(const u16_t *)pb;
+		pb += 2;
+		len -= 2;
+	}
+
+	pl = (const u32_t *)pb;
+
+	while (len >= 32) {
+		sum += pl[0];
+		sum += pl[1];
+		sum += pl[2];
+		sum += pl[3];
+		sum += pl[4];
+		sum += pl[5];
+		sum += pl[6];
+		sum += pl[7];
+		pl += 8;
+		len -= 32;
+	}
+
+	while (len >= 4) {
+		sum += *pl++;
+		len -= 4;
+	}
+
+	pb = (const u8_t *)pl;
+
+	/* 16-bit aligned word remaining? */
+	if (len > 1) {
+		sum += *(const u16_t *)pb;
+		pb += 2;
+		len -= 2;
+	}
+
+	/* dangling tail byte remaining? */
+	if (len > 0) {
+		((u8_t *)&t)[0] = *pb;
+	}
+
+	sum += t;
+
+	return lwip_chksum_fold64(sum, odd);
+}
+#endif
+
 /* inet_chksum_pseudo:
  *
  * Calculates the pseudo Internet checksum used by TCP and UDP for a pbuf chain.
@@ -451,3 +547,94 @@ u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len)
 	return LWIP_CHKSUM(dst, len);
 }
 #endif							/* (LWIP_CHKSUM_COPY_ALGORITHM == 1) */
+
+#if (LWIP_CHKSUM_COPY_ALGORITHM == 2)	/* Version #2 */
+/* Store to a destination of unknown alignment: a constant size memcpy()
+ * compiles to a single (unaligned) store where the CPU supports it and to
+ * byte stores elsewhere.
+ */
+#define CHKSUM_COPY_STORE(dst, src, n)  memcpy((dst), (src), (n))
+
+#define CHKSUM_COPY_WORD(i) \
+	do { \
+		w = pl[i]; \
+		sum += w; \
+		CHKSUM_COPY_STORE(pd + 4 * (i), &w, 4); \
+	} while (0)
+
+/** Fused copy and checksum: every word is loaded once and summed while it
+ * is in a register, so the payload is not read a second time. The source
+ * is aligned to 32 bits as in LWIP_CHKSUM_ALGORITHM 4, the destination may
+ * have any alignment.
+ */
+u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len)
+{
+	u8_t *pd = (u8_t *)dst;
+	const u8_t *pb = (const u8_t *)src;
+	const u32_t *pl;
+	int n = len;
+	u64_t sum = 0;
+	u32_t w;
+	u16_t h;
+	u16_t t = 0;
+	int odd = ((mem_ptr_t)pb & 1);
+
+	if (odd && n > 0) {
+		((u8_t *)&t)[1] = *pb;
+		*pd++ = *pb++;
+		n--;
+	}
+
+	if (((mem_ptr_t)pb & 2) && n > 1) {
+		h = *(const u16_t *)pb;
+		sum += h;
+		CHKSUM_COPY_STORE(pd, &h, 2);
+		pb += 2;
+		pd += 2;
+		n -= 2;
+	}
+
+	pl = (const u32_t *)pb;
+
+	while (n >= 32) {
+		CHKSUM_COPY_WORD(0);
+		CHKSUM_COPY_WORD(1);
+		CHKSUM_COPY_WORD(2);
+		CHKSUM_COPY_WORD(3);
+		CHKSUM_COPY_WORD(4);
+		CHKSUM_COPY_WORD(5);
+		CHKSUM_COPY_WORD(6);
+		CHKSUM_COPY_WORD(7);
+		pl += 8;
+		pd += 32;
+		n -= 32;
+	}
+
+	while (n >= 4) {
+		CHKSUM_COPY_WORD(0);
+		pl++;
+		pd += 4;
+		n -= 4;
+	}
+
+	pb = (const u8_t *)pl;
+
+	if (n > 1) {
+		h = *(const u16_t *)pb;
+		sum += h;
+		CHKSUM_COPY_STORE(pd, &h, 2);
+		pb += 2;
+		pd += 2;
+		n -= 2;
+	}
+
+	if (n > 0) {
+		((u8_t *)&t)[0] = *pb;
+		*pd = *pb;
+	}
+
+	sum += t;
+
+	return lwip_chksum_fold64(sum, odd);
+}
+#endif							/* (LWIP_CHKSUM_COPY_ALGORITHM == 2) */
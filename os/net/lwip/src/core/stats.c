@@ -101,6 +101,9 @@ void stats_display_proto(struct stats_proto *proto, const char *name)
 	LWIP_STATS_DIAG(("opterr: %" STAT_COUNTER_F "\n\t", proto->opterr));
 	LWIP_STATS_DIAG(("err: %" STAT_COUNTER_F "\n\t", proto->err));
 	LWIP_STATS_DIAG(("cachehit: %" STAT_COUNTER_F "\n", proto->cachehit));
+	if (proto->demux != 0) {
+		LWIP_STATS_DIAG(("\tdemux: %" U32_F " lookups, %" U32_F " pcbs compared\n", proto->demux, proto->demuxpcb));
+	}
 }
 
 #if IGMP_STATS
@@ -134,6 +134,22 @@ struct tcp_pcb **const tcp_pcb_lists[] = { &tcp_listen_pcbs.pcbs, &tcp_bound_pcb
 /** Only used for temporary storage. */
 struct tcp_pcb *tcp_tmp_pcb;
 
+#if LWIP_TCP_PCB_HASH
+#if (TCP_PCB_HASH_SIZE & (TCP_PCB_HASH_SIZE - 1)) != 0
+#error "TCP_PCB_HASH_SIZE must be a power of 2"
+#endif
+#if (TCP_LISTEN_HASH_SIZE & (TCP_LISTEN_HASH_SIZE - 1)) != 0
+#error "TCP_LISTEN_HASH_SIZE must be a power of 2"
+#endif
+
+/** Active and TIME-WAIT PCBs hashed by 4-tuple, chained through hash_next */
+static struct tcp_pcb *tcp_conn_hash[TCP_PCB_HASH_SIZE];
+/** Listening PCBs hashed by local port, chained through hash_next */
+static struct tcp_pcb_listen *tcp_listen_hash[TCP_LISTEN_HASH_SIZE];
+
+#define TCP_HASH_LISTEN_IDX(port) (((port) ^ ((port) >> 8)) & (TCP_LISTEN_HASH_SIZE - 1))
+#endif							/* LWIP_TCP_PCB_HASH */
+
 u8_t tcp_active_pcbs_changed;
 
 /** Timer counter to handle calling slow-timer from tcp_tmr() */
@@ -926,6 +942,7 @@ tcp_slowtmr_start:
 			void *err_arg;
 			tcp_pcb_purge(pcb);
 			/* Remove PCB from tcp_active_pcbs list. */
+			TCP_HASH_RMV(&tcp_active_pcbs, pcb);
 			if (prev != NULL) {
 				LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_active_pcbs", pcb != tcp_active_pcbs);
 				prev->next = pcb->next;
@@ -990,6 +1007,7 @@ tcp_slowtmr_start:
 			struct tcp_pcb *pcb2;
 			tcp_pcb_purge(pcb);
 			/* Remove PCB from tcp_tw_pcbs list. */
+			TCP_HASH_RMV(&tcp_tw_pcbs, pcb);
 			if (prev != NULL) {
 				LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_tw_pcbs", pcb != tcp_tw_pcbs);
 				prev->next = pcb->next;
@@ -1470,6 +1488,169 @@ void tcp_pcb_purge(struct tcp_pcb *pcb)
 	}
 }
 
+#if LWIP_TCP_PCB_HASH
+/**
+ * Returns the tcp_conn_hash bucket of a connection.
+ */
+static u16_t tcp_hash_conn(ip_addr_t *local_ip, u16_t local_port, ip_addr_t *remote_ip, u16_t remote_port)
+{
+	u32_t h;
+
+	h = ip4_addr_get_u32(local_ip) ^ ip4_addr_get_u32(remote_ip) ^ (((u32_t)local_port << 16) | remote_port);
+	h ^= h >> 16;
+	h *= 0x45d9f3b;
+	h ^= h >> 16;
+	return (u16_t)(h & (TCP_PCB_HASH_SIZE - 1));
+}
+
+/**
+ * Adds a PCB that has just been put on a PCB list to the hash table of
+ * that list. Called from TCP_REG. PCBs on tcp_bound_pcbs are not hashed.
+ *
+ * @param pcbs the PCB list npcb has been added to
+ * @param npcb the PCB to hash
+ */
+void tcp_hash_reg(struct tcp_pcb **pcbs, struct tcp_pcb *npcb)
+{
+	struct tcp_pcb_listen *lpcb;
+	u16_t idx;
+
+	if (pcbs == &tcp_active_pcbs || pcbs == &tcp_tw_pcbs) {
+		idx = tcp_hash_conn(&npcb->local_ip, npcb->local_port, &npcb->remote_ip, npcb->remote_port);
+		npcb->hash_next = tcp_conn_hash[idx];
+		tcp_conn_hash[idx] = npcb;
+	} else if (pcbs == &tcp_listen_pcbs.pcbs) {
+		lpcb = (struct tcp_pcb_listen *)npcb;
+		idx = TCP_HASH_LISTEN_IDX(lpcb->local_port);
+		lpcb->hash_next = tcp_listen_hash[idx];
+		tcp_listen_hash[idx] = lpcb;
+	}
+}
+
+/**
+ * Removes a PCB from the hash table of the PCB list it is on. Called from
+ * TCP_RMV and wherever a PCB is unlinked from a list directly.
+ *
+ * @param pcbs the PCB list npcb is on
+ * @param npcb the PCB to remove
+ * @return 1 if npcb was found in the table, 0 otherwise
+ */
+u8_t tcp_hash_rmv(struct tcp_pcb **pcbs, struct tcp_pcb *npcb)
+{
+	struct tcp_pcb **pp;
+	struct tcp_pcb_listen **lpp;
+	struct tcp_pcb_listen *lpcb;
+
+	if (pcbs == &tcp_active_pcbs || pcbs == &tcp_tw_pcbs) {
+		pp = &tcp_conn_hash[tcp_hash_conn(&npcb->local_ip, npcb->local_port, &npcb->remote_ip, npcb->remote_port)];
+		for (; *pp != NULL; pp = &(*pp)->hash_next) {
+			if (*pp == npcb) {
+				*pp = npcb->hash_next;
+				npcb->hash_next = NULL;
+				return 1;
+			}
+		}
+	} else if (pcbs == &tcp_listen_pcbs.pcbs) {
+		lpcb = (struct tcp_pcb_listen *)npcb;
+		lpp = &tcp_listen_hash[TCP_HASH_LISTEN_IDX(lpcb->local_port)];
+		for (; *lpp != NULL; lpp = &(*lpp)->hash_next) {
+			if (*lpp == lpcb) {
+				*lpp = lpcb->hash_next;
+				lpcb->hash_next = NULL;
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * Finds the active or TIME-WAIT PCB of a connection. A PCB that is found
+ * is moved to the front of its bucket, as tcp_input() does with the list
+ * when hashing is off.
+ *
+ * @return the matching PCB (check for TIME_WAIT), or NULL
+ */
+struct tcp_pcb *tcp_hash_lookup(ip_addr_t *local_ip, u16_t local_port, ip_addr_t *remote_ip, u16_t remote_port)
+{
+	struct tcp_pcb *pcb;
+	struct tcp_pcb *prev;
+	u16_t idx;
+
+	idx = tcp_hash_conn(local_ip, local_port, remote_ip, remote_port);
+	prev = NULL;
+	for (pcb = tcp_conn_hash[idx]; pcb != NULL; pcb = pcb->hash_next) {
+		TCP_STATS_INC(tcp.demuxpcb);
+		LWIP_ASSERT("tcp_hash_lookup: pcb->state != CLOSED", pcb->state != CLOSED);
+		LWIP_ASSERT("tcp_hash_lookup: pcb->state != LISTEN", pcb->state != LISTEN);
+		if (pcb->remote_port == remote_port && pcb->local_port == local_port && ip_addr_cmp(&(pcb->remote_ip), remote_ip) && ip_addr_cmp(&(pcb->local_ip), local_ip)) {
+			if (prev != NULL) {
+				prev->hash_next = pcb->hash_next;
+				pcb->hash_next = tcp_conn_hash[idx];
+				tcp_conn_hash[idx] = pcb;
+			}
+			return pcb;
+		}
+		prev = pcb;
+	}
+	return NULL;
+}
+
+/**
+ * Finds the listening PCB for a connection request. With SO_REUSE, a PCB
+ * bound to local_ip is preferred over one bound to IP_ADDR_ANY.
+ *
+ * @return the matching PCB, or NULL
+ */
+struct tcp_pcb_listen *tcp_hash_lookup_listen(ip_addr_t *local_ip, u16_t local_port)
+{
+	struct tcp_pcb_listen *lpcb;
+	struct tcp_pcb_listen *prev;
+	u16_t idx;
+#if SO_REUSE
+	struct tcp_pcb_listen *lpcb_prev = NULL;
+	struct tcp_pcb_listen *lpcb_any = NULL;
+#endif							/* SO_REUSE */
+
+	idx = TCP_HASH_LISTEN_IDX(local_port);
+	prev = NULL;
+	for (lpcb = tcp_listen_hash[idx]; lpcb != NULL; lpcb = lpcb->hash_next) {
+		TCP_STATS_INC(tcp.demuxpcb);
+		if (lpcb->local_port == local_port) {
+#if SO_REUSE
+			if (ip_addr_cmp(&(lpcb->local_ip), local_ip)) {
+				/* found an exact match */
+				break;
+			} else if (ip_addr_isany(&(lpcb->local_ip))) {
+				/* found an ANY-match */
+				lpcb_any = lpcb;
+				lpcb_prev = prev;
+			}
+#else							/* SO_REUSE */
+			if (ip_addr_cmp(&(lpcb->local_ip), local_ip) || ip_addr_isany(&(lpcb->local_ip))) {
+				/* found a match */
+				break;
+			}
+#endif							/* SO_REUSE */
+		}
+		prev = lpcb;
+	}
+#if SO_REUSE
+	if (lpcb == NULL) {
+		/* only pass to ANY if no specific local IP has been found */
+		lpcb = lpcb_any;
+		prev = lpcb_prev;
+	}
+#endif							/* SO_REUSE */
+	if (lpcb != NULL && prev != NULL) {
+		prev->hash_next = lpcb->hash_next;
+		lpcb->hash_next = tcp_listen_hash[idx];
+		tcp_listen_hash[idx] = lpcb;
+	}
+	return lpcb;
+}
+#endif							/* LWIP_TCP_PCB_HASH */
+
 /**
  * Purges the PCB and removes it from a PCB list. Any delayed ACKs are sent first.
  *
@@ -86,6 +86,12 @@ static u16_t tcplen;
 static u8_t recv_flags;
 static struct pbuf *recv_data;
 
+#if LWIP_TCP_SACK
+/* SACK blocks of the incoming segment, left and right edge in host order */
+static u8_t sack_nblocks;
+static u32_t sack_edges[2 * TCP_SACK_MAX_BLOCKS];
+#endif							/* LWIP_TCP_SACK */
+
 struct tcp_pcb *tcp_input_pcb;
 
 /* Forward declarations. */
@@ -107,12 +113,15 @@ static err_t tcp_timewait_input(struct tcp_pcb *pcb);
  */
 void tcp_input(struct pbuf *p, struct netif *inp)
 {
-	struct tcp_pcb *pcb, *prev;
+	struct tcp_pcb *pcb;
 	struct tcp_pcb_listen *lpcb;
+#if !LWIP_TCP_PCB_HASH
+	struct tcp_pcb *prev;
 #if SO_REUSE
 	struct tcp_pcb *lpcb_prev = NULL;
 	struct tcp_pcb_listen *lpcb_any = NULL;
 #endif							/* SO_REUSE */
+#endif							/* !LWIP_TCP_PCB_HASH */
 	u8_t hdrlen;
 	err_t err;
 
@@ -179,9 +188,32 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 
 	/* Demultiplex an incoming segment. First, we check if it is destined
 	   for an active connection. */
+	TCP_STATS_INC(tcp.demux);
+#if LWIP_TCP_PCB_HASH
+	/* Active and TIME-WAIT connections share one table, listening PCBs
+	   are looked up by port if no connection matches. */
+	pcb = tcp_hash_lookup(&current_iphdr_dest, tcphdr->dest, &current_iphdr_src, tcphdr->src);
+	if (pcb != NULL && pcb->state == TIME_WAIT) {
+		LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for TIME_WAITing connection.\n"));
+		tcp_timewait_input(pcb);
+		pbuf_free(p);
+		return;
+	}
+
+	if (pcb == NULL) {
+		lpcb = tcp_hash_lookup_listen(&current_iphdr_dest, tcphdr->dest);
+		if (lpcb != NULL) {
+			LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for LISTENing connection.\n"));
+			tcp_listen_input(lpcb);
+			pbuf_free(p);
+			return;
+		}
+	}
+#else							/* LWIP_TCP_PCB_HASH */
 	prev = NULL;
 
 	for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+		TCP_STATS_INC(tcp.demuxpcb);
 		LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
 		LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
 		LWIP_ASSERT("tcp_input: active pcb->state != LISTEN", pcb->state != LISTEN);
@@ -206,6 +238,7 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 		/* If it did not go to an active connection, we check the connections
 		   in the TIME-WAIT state. */
 		for (pcb = tcp_tw_pcbs; pcb != NULL; pcb = pcb->next) {
+			TCP_STATS_INC(tcp.demuxpcb);
 			LWIP_ASSERT("tcp_input: TIME-WAIT pcb->state == TIME-WAIT", pcb->state == TIME_WAIT);
 			if (pcb->remote_port == tcphdr->src && pcb->local_port == tcphdr->dest && ip_addr_cmp(&(pcb->remote_ip), &current_iphdr_src) && ip_addr_cmp(&(pcb->local_ip), &current_iphdr_dest)) {
 				/* We don't really care enough to move this PCB to the front
@@ -222,6 +255,7 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 		   are LISTENing for incoming connections. */
 		prev = NULL;
 		for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+			TCP_STATS_INC(tcp.demuxpcb);
 			if (lpcb->local_port == tcphdr->dest) {
 #if SO_REUSE
 				if (ip_addr_cmp(&(lpcb->local_ip), &current_iphdr_dest)) {
@@ -267,6 +301,7 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 			return;
 		}
 	}
+#endif							/* LWIP_TCP_PCB_HASH */
 #if TCP_INPUT_DEBUG
 	LWIP_DEBUGF(TCP_INPUT_DEBUG, ("+-+-+-+-+-+-+-+-+-+-+-+-+-+- tcp_input: flags "));
 	tcp_debug_print_flags(TCPH_FLAGS(tcphdr));
@@ -898,6 +933,12 @@ static void tcp_receive(struct tcp_pcb *pcb)
 		 *
 		 */
 
+#if LWIP_TCP_SACK
+		if (sack_nblocks != 0 && TCP_SACK_ENABLED(pcb)) {
+			tcp_sack_update(pcb, sack_edges, sack_nblocks);
+		}
+#endif							/* LWIP_TCP_SACK */
+
 		/* Clause 1 */
 		if (TCP_SEQ_LEQ(ackno, pcb->lastack)) {
 			pcb->acked = 0;
@@ -913,14 +954,15 @@ static void tcp_receive(struct tcp_pcb *pcb)
 							if ((u8_t)(pcb->dupacks + 1) > pcb->dupacks) {
 								++pcb->dupacks;
 							}
-							if (pcb->dupacks > 3) {
+							if (pcb->dupacks > 3 && !TCP_SACK_ENABLED(pcb)) {
 								/* Inflate the congestion window, but not if it means that
 								   the value overflows. */
 								if ((u16_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
 									pcb->cwnd += pcb->mss;
 								}
-							} else if (pcb->dupacks == 3) {
-								/* Do fast retransmit */
+							} else if (pcb->dupacks >= 3 || (TCP_SACK_ENABLED(pcb) && tcp_sack_lost(pcb))) {
+								/* Do fast retransmit (with SACK also once the
+								   scoreboard shows the first segment lost) */
 								tcp_rexmit_fast(pcb);
 							}
 						}
@@ -939,8 +981,16 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			   in fast retransmit. Also reset the congestion window to the
 			   slow start threshold. */
 			if (pcb->flags & TF_INFR) {
-				pcb->flags &= ~TF_INFR;
-				pcb->cwnd = pcb->ssthresh;
+#if LWIP_TCP_SACK
+				if (TCP_SACK_ENABLED(pcb) && TCP_SEQ_LT(ackno, pcb->sack_recover)) {
+					/* Partial ACK: SACK recovery lasts until all data
+					   outstanding when it started is acknowledged */
+				} else
+#endif							/* LWIP_TCP_SACK */
+				{
+					pcb->flags &= ~TF_INFR;
+					pcb->cwnd = pcb->ssthresh;
+				}
 			}
 
 			/* Reset the number of retransmissions. */
@@ -960,7 +1010,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			/* Update the congestion control variables (cwnd and
 			   ssthresh). */
-			if (pcb->state >= ESTABLISHED) {
+			if (pcb->state >= ESTABLISHED && !(pcb->flags & TF_INFR)) {
 				if (pcb->cwnd < pcb->ssthresh) {
 					if ((u16_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
 						pcb->cwnd += pcb->mss;
@@ -1000,6 +1050,13 @@ static void tcp_receive(struct tcp_pcb *pcb)
 				}
 			}
 
+#if LWIP_TCP_SACK
+			/* A partial ACK in recovery points at the next hole */
+			if ((pcb->flags & TF_INFR) && pcb->unacked != NULL && !(pcb->unacked->flags & TF_SEG_SACKED)) {
+				pcb->unacked->flags |= TF_SEG_SACK_LOST;
+			}
+#endif							/* LWIP_TCP_SACK */
+
 			/* If there's nothing left to acknowledge, stop the retransmit
 			   timer, otherwise reset it to start again */
 			if (pcb->unacked == NULL) {
@@ -1309,8 +1366,14 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			} else {
 				/* We get here if the incoming segment is out-of-sequence. */
+#if !LWIP_TCP_SACK || !TCP_QUEUE_OOSEQ
 				tcp_send_empty_ack(pcb);
+#endif
 #if TCP_QUEUE_OOSEQ
+#if LWIP_TCP_SACK
+				/* The first SACK block reports the segment received last */
+				pcb->rcv_sack_seq = seqno;
+#endif
 				/* We queue the segment on the ->ooseq queue. */
 				if (pcb->ooseq == NULL) {
 					pcb->ooseq = tcp_seg_copy(&inseg);
@@ -1450,6 +1513,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 					}
 				}
 #endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
+#if LWIP_TCP_SACK
+				/* ACK once the queue is updated, so the SACK blocks include
+				   this segment */
+				tcp_send_empty_ack(pcb);
+#endif
 #endif							/* TCP_QUEUE_OOSEQ */
 			}
 		} else {
@@ -1471,7 +1539,7 @@ static void tcp_receive(struct tcp_pcb *pcb)
  * Parses the options contained in the incoming segment.
  *
  * Called from tcp_listen_input() and tcp_process().
- * Currently, only the MSS option is supported!
+ * Supported are MSS, timestamps and SACK (if enabled).
  *
  * @param pcb the tcp_pcb for which a segment arrived
  */
@@ -1483,6 +1551,11 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 #if LWIP_TCP_TIMESTAMPS
 	u32_t tsval;
 #endif
+#if LWIP_TCP_SACK
+	u8_t i;
+
+	sack_nblocks = 0;
+#endif
 
 	opts = (u8_t *)tcphdr + TCP_HLEN;
 
@@ -1535,6 +1608,37 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 				c += 0x0A;
 				break;
 #endif
+#if LWIP_TCP_SACK
+			case 0x04:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK permitted\n"));
+				if (opts[c + 1] != 0x02 || c + 0x02 > max_c) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				if (flags & TCP_SYN) {
+					pcb->sack_flags |= TF_SACK_PERM;
+				}
+				/* Advance to next option */
+				c += 0x02;
+				break;
+			case 0x05:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+				if (opts[c + 1] < 0x0A || ((opts[c + 1] - 2) & 0x07) != 0 || c + opts[c + 1] > max_c) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				/* Edges are 32-bit values in network order, 2 per block */
+				for (i = 0; i < ((opts[c + 1] - 2) >> 2) && i < 2 * TCP_SACK_MAX_BLOCKS; i++) {
+					u8_t *edge = &opts[c + 2 + 4 * i];
+					sack_edges[i] = ((u32_t)edge[0] << 24) | ((u32_t)edge[1] << 16) | ((u32_t)edge[2] << 8) | edge[3];
+				}
+				sack_nblocks = i >> 1;
+				/* Advance to next option */
+				c += opts[c + 1];
+				break;
+#endif							/* LWIP_TCP_SACK */
 			default:
 				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
 				if (opts[c + 1] == 0) {
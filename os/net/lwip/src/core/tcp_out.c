@@ -96,6 +96,9 @@
 
 /* Forward declarations.*/
 static void tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+static u32_t tcp_sack_output(struct tcp_pcb *pcb);
+#endif
 
 /** Allocate a pbuf and create a tcphdr at p->payload, used for output
  * functions other than the default tcp_output -> tcp_output_segment
@@ -681,6 +684,126 @@ memerr:
 	return ERR_MEM;
 }
 
+#if LWIP_TCP_PBUF_WRITE
+/** Room reserved in front of the payload of tcp_alloc_pbuf() pbufs for the
+ * TCP options of a data segment */
+#define TCP_PBUF_OPTLEN (LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS))
+
+/**
+ * Allocate a pbuf to be filled by the caller and queued with tcp_write_pbuf().
+ *
+ * The pbuf is a single PBUF_RAM pbuf with room for all protocol headers and
+ * the TCP options in front of the payload, so the segment built from it goes
+ * out as one contiguous buffer.  The payload may later be shortened with
+ * pbuf_realloc().
+ *
+ * @param len payload length, at most TCP_PBUF_MAXLEN
+ * @return the pbuf, or NULL if out of memory
+ */
+struct pbuf *tcp_alloc_pbuf(u16_t len)
+{
+	struct pbuf *p;
+
+	LWIP_ERROR("tcp_alloc_pbuf: len <= TCP_PBUF_MAXLEN", len <= TCP_PBUF_MAXLEN, return NULL;);
+
+	p = pbuf_alloc(PBUF_TRANSPORT, len + TCP_PBUF_OPTLEN, PBUF_RAM);
+	if (p != NULL) {
+		/* hide the option space until the segment is built */
+		pbuf_header(p, -TCP_PBUF_OPTLEN);
+	}
+	return p;
+}
+
+/**
+ * Enqueue a pbuf from tcp_alloc_pbuf() as one segment, without copying its
+ * payload. Like tcp_write(), the data is not sent until tcp_output() is
+ * called.
+ *
+ * If the payload does not fit in one segment for this connection (the
+ * remote MSS or window is smaller than ours), the data is copied with
+ * tcp_write() instead.
+ *
+ * @param pcb Protocol control block for the TCP connection to enqueue data for.
+ * @param p single pbuf from tcp_alloc_pbuf() holding the data
+ * @param apiflags TCP_WRITE_FLAG_MORE to not set the PSH flag
+ * @return ERR_OK if enqueued (the pcb now owns p), another err_t on error
+ *         (the caller still owns p)
+ */
+err_t tcp_write_pbuf(struct tcp_pcb *pcb, struct pbuf *p, u8_t apiflags)
+{
+	struct tcp_seg *seg;
+	struct tcp_seg *last_unsent;
+	u16_t len = p->tot_len;
+	u8_t optflags = 0;
+	u8_t optlen = 0;
+	err_t err;
+	/* same segment size limit as tcp_write() */
+	u16_t mss_local = LWIP_MIN(pcb->mss, pcb->snd_wnd_max / 2);
+
+	LWIP_ERROR("tcp_write_pbuf: single pbuf", p->next == NULL, return ERR_ARG;);
+
+	err = tcp_write_checks(pcb, len);
+	if (err != ERR_OK || len == 0) {
+		return err;
+	}
+
+#if LWIP_TCP_TIMESTAMPS
+	if ((pcb->flags & TF_TIMESTAMP)) {
+		optflags = TF_SEG_OPTS_TS;
+		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
+	}
+#endif							/* LWIP_TCP_TIMESTAMPS */
+
+	if ((u32_t)len + optlen > mss_local || pbuf_header(p, optlen) != 0) {
+		err = tcp_write(pcb, p->payload, len, apiflags | TCP_WRITE_FLAG_COPY);
+		if (err == ERR_OK) {
+			pbuf_free(p);
+		}
+		return err;
+	}
+
+	/* tcp_create_segment() frees the pbuf on failure, keep it for the caller */
+	pbuf_ref(p);
+	seg = tcp_create_segment(pcb, p, 0, pcb->snd_lbb, optflags);
+	if (seg == NULL) {
+		pbuf_header(p, -(s16_t)optlen);
+		pcb->flags |= TF_NAGLEMEMERR;
+		TCP_STATS_INC(tcp.memerr);
+		return ERR_MEM;
+	}
+	pbuf_free(p);
+
+#if TCP_CHECKSUM_ON_COPY
+	seg->chksum = ~inet_chksum((u8_t *)seg->tcphdr + TCP_HLEN + optlen, len);
+	seg->chksum_swapped = 0;
+	seg->flags |= TF_SEG_DATA_CHECKSUMMED;
+#endif							/* TCP_CHECKSUM_ON_COPY */
+
+	if ((apiflags & TCP_WRITE_FLAG_MORE) == 0) {
+		TCPH_SET_FLAG(seg->tcphdr, TCP_PSH);
+	}
+
+	/* Append the segment to pcb->unsent. Any oversize of the former last
+	 * segment is given up, the new segment is the tail now. */
+	if (pcb->unsent == NULL) {
+		pcb->unsent = seg;
+	} else {
+		for (last_unsent = pcb->unsent; last_unsent->next != NULL; last_unsent = last_unsent->next) ;
+		last_unsent->next = seg;
+	}
+#if TCP_OVERSIZE
+	pcb->unsent_oversize = 0;
+#endif							/* TCP_OVERSIZE */
+
+	pcb->snd_lbb += len;
+	pcb->snd_buf -= len;
+	pcb->snd_queuelen += pbuf_clen(seg->p);
+
+	LWIP_DEBUGF(TCP_OUTPUT_DEBUG | LWIP_DBG_TRACE, ("tcp_write_pbuf: queueing %" U32_F ":%" U32_F "\n", ntohl(seg->tcphdr->seqno), ntohl(seg->tcphdr->seqno) + TCP_TCPLEN(seg)));
+	return ERR_OK;
+}
+#endif							/* LWIP_TCP_PBUF_WRITE */
+
 /**
  * Enqueue TCP options for transmission.
  *
@@ -712,6 +835,12 @@ err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
 
 	if (flags & TCP_SYN) {
 		optflags = TF_SEG_OPTS_MSS;
+#if LWIP_TCP_SACK
+		/* Offer SACK on a SYN, answer a SYN that offered it with SYN|ACK */
+		if (!(flags & TCP_ACK) || TCP_SACK_ENABLED(pcb)) {
+			optflags |= TF_SEG_OPTS_SACK_PERM;
+		}
+#endif							/* LWIP_TCP_SACK */
 	}
 #if LWIP_TCP_TIMESTAMPS
 	if ((pcb->flags & TF_TIMESTAMP)) {
@@ -797,6 +926,61 @@ static void tcp_build_timestamp_option(struct tcp_pcb *pcb, u32_t *opts)
 }
 #endif
 
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+/* Find the contiguous block of ooseq data that starts at seg
+ *
+ * @return the first segment after the block
+ */
+static struct tcp_seg *tcp_sack_block(struct tcp_seg *seg, u32_t *left, u32_t *right)
+{
+	*left = seg->tcphdr->seqno;
+	*right = *left + TCP_TCPLEN(seg);
+	for (seg = seg->next; seg != NULL && seg->tcphdr->seqno == *right; seg = seg->next) {
+		*right += TCP_TCPLEN(seg);
+	}
+	return seg;
+}
+
+/* Build a SACK option (RFC 2018) reporting the data on the ooseq queue at
+ * the specified options pointer. The block that holds the segment received
+ * last comes first, the others follow in sequence order.
+ *
+ * @param pcb tcp_pcb
+ * @param opts option pointer where to store the SACK option
+ * @param max_blocks most blocks the option may hold
+ * @return the length of the option in bytes
+ */
+static u8_t tcp_build_sack_option(struct tcp_pcb *pcb, u32_t *opts, u8_t max_blocks)
+{
+	struct tcp_seg *seg;
+	u32_t first_left = 0;
+	u32_t left, right;
+	u8_t n = 0;
+
+	for (seg = pcb->ooseq; seg != NULL;) {
+		seg = tcp_sack_block(seg, &left, &right);
+		if (TCP_SEQ_BETWEEN(pcb->rcv_sack_seq, left, right - 1)) {
+			first_left = left;
+			opts[1] = htonl(left);
+			opts[2] = htonl(right);
+			n = 1;
+			break;
+		}
+	}
+	for (seg = pcb->ooseq; seg != NULL && n < max_blocks;) {
+		seg = tcp_sack_block(seg, &left, &right);
+		if (n == 0 || left != first_left) {
+			opts[1 + 2 * n] = htonl(left);
+			opts[2 + 2 * n] = htonl(right);
+			n++;
+		}
+	}
+	/* Pad with two NOP options to keep the blocks aligned */
+	opts[0] = htonl(0x01010500 | (2 + 8 * n));
+	return TCP_SACK_OPT_LENGTH(n);
+}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
+
 /** Send an ACK without data.
  *
  * @param pcb Protocol control block for the TCP connection to send the ACK
@@ -806,12 +990,26 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 	struct pbuf *p;
 	struct tcp_hdr *tcphdr;
 	u8_t optlen = 0;
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	u8_t sack_blocks = 0;
+	struct tcp_seg *seg;
+#endif
 
 #if LWIP_TCP_TIMESTAMPS
 	if (pcb->flags & TF_TIMESTAMP) {
 		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	/* Count the blocks up front, the header is allocated with the options */
+	if (TCP_SACK_ENABLED(pcb)) {
+		for (seg = pcb->ooseq; seg != NULL && sack_blocks < TCP_SACK_MAX_BLOCKS - (optlen ? 1 : 0); sack_blocks++) {
+			u32_t left, right;
+			seg = tcp_sack_block(seg, &left, &right);
+		}
+		optlen += TCP_SACK_OPT_LENGTH(sack_blocks);
+	}
+#endif
 
 	p = tcp_output_alloc_header(pcb, optlen, 0, htonl(pcb->snd_nxt));
 	if (p == NULL) {
@@ -831,6 +1029,11 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		tcp_build_timestamp_option(pcb, (u32_t *)(tcphdr + 1));
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if (sack_blocks != 0) {
+		tcp_build_sack_option(pcb, (u32_t *)(tcphdr + 1) + (optlen - TCP_SACK_OPT_LENGTH(sack_blocks)) / 4, sack_blocks);
+	}
+#endif
 
 #if CHECKSUM_GEN_TCP
 	tcphdr->chksum = inet_chksum_pseudo(p, &(pcb->local_ip), &(pcb->remote_ip), IP_PROTO_TCP, p->tot_len);
@@ -872,6 +1075,18 @@ err_t tcp_output(struct tcp_pcb *pcb)
 	}
 
 	wnd = LWIP_MIN(pcb->snd_wnd, pcb->cwnd);
+#if LWIP_TCP_SACK
+	if (TCP_SACK_ENABLED(pcb)) {
+		if (pcb->flags & TF_INFR) {
+			/* Loss recovery: fill the holes first, new data gets what is left */
+			wnd = LWIP_MIN(pcb->snd_wnd, tcp_sack_output(pcb));
+		} else if (pcb->dupacks > 0 && pcb->dupacks < 3) {
+			/* Limited transmit (RFC 3042): new data for the first two
+			   dupacks, so a small window still sees enough of them */
+			wnd = LWIP_MIN(pcb->snd_wnd, (u32_t)pcb->cwnd + pcb->dupacks * pcb->mss);
+		}
+	}
+#endif							/* LWIP_TCP_SACK */
 
 	seg = pcb->unsent;
 
@@ -986,6 +1201,9 @@ static void tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
 	u16_t len;
 	struct netif *netif;
 	u32_t *opts;
+#if LWIP_TCP_PCB_HASH
+	u8_t rehash;
+#endif							/* LWIP_TCP_PCB_HASH */
 
 	/** @bug Exclude retransmitted segments from this count. */
 	snmp_inc_tcpoutsegs();
@@ -1012,6 +1230,13 @@ static void tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
 		*opts = TCP_BUILD_MSS_OPTION(mss);
 		opts += 1;
 	}
+#if LWIP_TCP_SACK
+	if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+		/* Two NOPs and SACK permitted */
+		*opts = PP_HTONL(0x01010402);
+		opts += 1;
+	}
+#endif							/* LWIP_TCP_SACK */
 #if LWIP_TCP_TIMESTAMPS
 	pcb->ts_lastacksent = pcb->rcv_nxt;
 
@@ -1034,7 +1259,16 @@ static void tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
 		if (netif == NULL) {
 			return;
 		}
+#if LWIP_TCP_PCB_HASH
+		/* the local address is part of the demux hash key */
+		rehash = tcp_hash_rmv(&tcp_active_pcbs, pcb);
+#endif							/* LWIP_TCP_PCB_HASH */
 		ip_addr_copy(pcb->local_ip, netif->ip_addr);
+#if LWIP_TCP_PCB_HASH
+		if (rehash) {
+			tcp_hash_reg(&tcp_active_pcbs, pcb);
+		}
+#endif							/* LWIP_TCP_PCB_HASH */
 	}
 
 	if (pcb->rttest == 0) {
@@ -1162,6 +1396,17 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 		return;
 	}
 
+#if LWIP_TCP_SACK
+	if (TCP_SACK_ENABLED(pcb)) {
+		/* The receiver may have dropped what it SACKed (RFC 2018, section 8),
+		   start over with an empty scoreboard */
+		for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+			seg->flags &= ~(TF_SEG_SACKED | TF_SEG_SACK_LOST | TF_SEG_SACK_RETX);
+		}
+		pcb->flags &= ~TF_INFR;
+	}
+#endif							/* LWIP_TCP_SACK */
+
 	/* Move all unacked segments to the head of the unsent queue */
 	for (seg = pcb->unacked; seg->next != NULL; seg = seg->next) ;
 	/* concatenate unsent queue after unacked queue */
@@ -1237,7 +1482,26 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 	if (pcb->unacked != NULL && !(pcb->flags & TF_INFR)) {
 		/* This is fast retransmit. Retransmit the first unacked segment. */
 		LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_receive: dupacks %" U16_F " (%" U32_F "), fast retransmit %" U32_F "\n", (u16_t)pcb->dupacks, pcb->lastack, ntohl(pcb->unacked->tcphdr->seqno)));
-		tcp_rexmit(pcb);
+#if LWIP_TCP_SACK
+		if (TCP_SACK_ENABLED(pcb)) {
+			struct tcp_seg *seg;
+
+			/* A new recovery may resend everything again (RFC 6675
+			   resets HighRxt): forget what earlier ones marked and
+			   resent, a resent segment may have been lost as well */
+			for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+				seg->flags &= ~(TF_SEG_SACK_LOST | TF_SEG_SACK_RETX);
+			}
+
+			/* tcp_output() resends it from the unacked queue together
+			   with the other holes the scoreboard finds */
+			pcb->unacked->flags |= TF_SEG_SACK_LOST;
+			pcb->sack_recover = pcb->snd_nxt;
+		} else
+#endif							/* LWIP_TCP_SACK */
+		{
+			tcp_rexmit(pcb);
+		}
 
 		/* Set ssthresh to half of the minimum of the current
 		 * cwnd and the advertised window */
@@ -1253,11 +1517,148 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 			pcb->ssthresh = 2 * pcb->mss;
 		}
 
-		pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
+		/* With SACK the pipe estimate replaces the window inflation */
+		if (TCP_SACK_ENABLED(pcb)) {
+			pcb->cwnd = pcb->ssthresh;
+		} else {
+			pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
+		}
 		pcb->flags |= TF_INFR;
 	}
 }
 
+#if LWIP_TCP_SACK
+/**
+ * Update the scoreboard from the SACK blocks of an incoming ACK
+ *
+ * Segments on the unacked queue that lie completely inside a block are
+ * marked as SACKed. Blocks that are not between lastack and snd_nxt are
+ * ignored (RFC 2883 D-SACK blocks and stale or forged ones).
+ *
+ * @param pcb the tcp_pcb that received the ACK
+ * @param edges left and right edges of the blocks, in host byte order
+ * @param nblocks number of blocks
+ */
+void tcp_sack_update(struct tcp_pcb *pcb, const u32_t *edges, u8_t nblocks)
+{
+	struct tcp_seg *seg;
+	u32_t left, right, seqno;
+	u8_t i;
+
+	for (i = 0; i < nblocks; i++) {
+		left = edges[2 * i];
+		right = edges[2 * i + 1];
+		if (!TCP_SEQ_LT(left, right) || !TCP_SEQ_GT(right, pcb->lastack) || TCP_SEQ_GT(right, pcb->snd_nxt)) {
+			continue;
+		}
+		for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+			seqno = ntohl(seg->tcphdr->seqno);
+			if (TCP_SEQ_GEQ(seqno, right)) {
+				break;
+			}
+			if (TCP_SEQ_GEQ(seqno, left) && TCP_SEQ_LEQ(seqno + TCP_TCPLEN(seg), right)) {
+				seg->flags |= TF_SEG_SACKED;
+			}
+		}
+	}
+}
+
+/**
+ * Walk the scoreboard: mark the segments considered lost (RFC 6675,
+ * IsLost()) and estimate the number of bytes still in the network.
+ *
+ * A segment is lost once TCP_SACK_DUPTHRESH segments or more than
+ * (TCP_SACK_DUPTHRESH - 1) * mss bytes above it have been SACKed. A lost
+ * segment that has been retransmitted is counted once.
+ *
+ * @param pcb the tcp_pcb to examine
+ * @return the number of bytes in flight ("pipe")
+ */
+u32_t tcp_sack_pipe(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+	u32_t sacked_bytes = 0;
+	u32_t pipe = 0;
+	u16_t sacked_segs = 0;
+
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		if (seg->flags & TF_SEG_SACKED) {
+			sacked_bytes += TCP_TCPLEN(seg);
+			sacked_segs++;
+		}
+	}
+
+	/* sacked_* count what is SACKed above the current segment */
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		if (seg->flags & TF_SEG_SACKED) {
+			sacked_bytes -= TCP_TCPLEN(seg);
+			sacked_segs--;
+			continue;
+		}
+		if (sacked_segs >= TCP_SACK_DUPTHRESH || sacked_bytes > (u32_t)(TCP_SACK_DUPTHRESH - 1) * pcb->mss) {
+			seg->flags |= TF_SEG_SACK_LOST;
+		}
+		if (!(seg->flags & TF_SEG_SACK_LOST) || (seg->flags & TF_SEG_SACK_RETX)) {
+			pipe += TCP_TCPLEN(seg);
+		}
+	}
+	return pipe;
+}
+
+/**
+ * Check whether the scoreboard shows the first unacked segment as lost,
+ * which starts loss recovery before the third dupack arrives.
+ *
+ * @param pcb the tcp_pcb to examine
+ * @return 1 if the first unacked segment is lost
+ */
+u8_t tcp_sack_lost(struct tcp_pcb *pcb)
+{
+	if (pcb->unacked == NULL) {
+		return 0;
+	}
+	tcp_sack_pipe(pcb);
+	return (pcb->unacked->flags & TF_SEG_SACK_LOST) != 0;
+}
+
+/**
+ * Retransmit the lost segments while in SACK loss recovery
+ *
+ * The first unacked segment is always resent once it is lost, the other
+ * holes only while cwnd leaves room for a full segment.
+ *
+ * @param pcb the tcp_pcb in loss recovery
+ * @return the window, counted from lastack, left for new data
+ */
+static u32_t tcp_sack_output(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+	u32_t pipe;
+
+	pipe = tcp_sack_pipe(pcb);
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		if ((seg->flags & (TF_SEG_SACK_LOST | TF_SEG_SACK_RETX)) != TF_SEG_SACK_LOST) {
+			continue;
+		}
+		if (seg != pcb->unacked && pipe + pcb->mss > pcb->cwnd) {
+			break;
+		}
+		LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_output: SACK retransmit %" U32_F ", pipe %" U32_F "\n", ntohl(seg->tcphdr->seqno), pipe));
+		tcp_output_segment(seg, pcb);
+		seg->flags |= TF_SEG_SACK_RETX;
+		pipe += TCP_TCPLEN(seg);
+		/* Karn: no RTT sample from a retransmission */
+		pcb->rttest = 0;
+		snmp_inc_tcpretranssegs();
+	}
+
+	if (pipe >= pcb->cwnd) {
+		return 0;
+	}
+	return (pcb->snd_nxt - pcb->lastack) + (pcb->cwnd - pipe);
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Send keepalive packets to keep a connection active although
  * no data is sent over it.
@@ -95,6 +95,46 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs;
 
+#if LWIP_UDP_PCB_HASH
+#if (UDP_PCB_HASH_SIZE & (UDP_PCB_HASH_SIZE - 1)) != 0
+#error "UDP_PCB_HASH_SIZE must be a power of 2"
+#endif
+
+/* The PCBs of udp_pcbs again, hashed by local port and chained through
+   hash_next. A PCB is in this table exactly when it is on udp_pcbs. */
+static struct udp_pcb *udp_hash[UDP_PCB_HASH_SIZE];
+
+#define UDP_HASH_IDX(port)      (((port) ^ ((port) >> 8)) & (UDP_PCB_HASH_SIZE - 1))
+
+/* Walk only the PCBs that may be bound to a given local port */
+#define UDP_DEMUX_FIRST(port)   udp_hash[UDP_HASH_IDX(port)]
+#define UDP_DEMUX_NEXT(pcb)     ((pcb)->hash_next)
+
+static void udp_hash_add(struct udp_pcb *pcb)
+{
+	pcb->hash_next = UDP_DEMUX_FIRST(pcb->local_port);
+	UDP_DEMUX_FIRST(pcb->local_port) = pcb;
+}
+
+static void udp_hash_del(struct udp_pcb *pcb)
+{
+	struct udp_pcb **pp;
+
+	for (pp = &UDP_DEMUX_FIRST(pcb->local_port); *pp != NULL; pp = &(*pp)->hash_next) {
+		if (*pp == pcb) {
+			*pp = pcb->hash_next;
+			pcb->hash_next = NULL;
+			break;
+		}
+	}
+}
+#else							/* LWIP_UDP_PCB_HASH */
+#define UDP_DEMUX_FIRST(port)   udp_pcbs
+#define UDP_DEMUX_NEXT(pcb)     ((pcb)->next)
+#define udp_hash_add(pcb)
+#define udp_hash_del(pcb)
+#endif							/* LWIP_UDP_PCB_HASH */
+
 /**
  * Initialize this module.
  */
@@ -119,8 +159,8 @@ again:
 	if (udp_port++ == UDP_LOCAL_PORT_RANGE_END) {
 		udp_port = UDP_LOCAL_PORT_RANGE_START;
 	}
-	/* Check all PCBs. */
-	for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+	/* Check all PCBs that may use this port. */
+	for (pcb = UDP_DEMUX_FIRST(udp_port); pcb != NULL; pcb = UDP_DEMUX_NEXT(pcb)) {
 		if (pcb->local_port == udp_port) {
 			if (++n > (UDP_LOCAL_PORT_RANGE_END - UDP_LOCAL_PORT_RANGE_START)) {
 				return 0;
@@ -227,11 +267,13 @@ void udp_input(struct pbuf *p, struct netif *inp)
 		prev = NULL;
 		local_match = 0;
 		uncon_pcb = NULL;
+		UDP_STATS_INC(udp.demux);
 		/* Iterate through the UDP pcb list for a matching pcb.
 		 * 'Perfect match' pcbs (connected to the remote port & ip address) are
 		 * preferred. If no perfect match is found, the first unconnected pcb that
 		 * matches the local port and ip address gets the datagram. */
-		for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+		for (pcb = UDP_DEMUX_FIRST(dest); pcb != NULL; pcb = UDP_DEMUX_NEXT(pcb)) {
+			UDP_STATS_INC(udp.demuxpcb);
 			local_match = 0;
 			/* print the PCB local and remote address */
 			LWIP_DEBUGF(UDP_DEBUG, ("pcb (%" U16_F ".%" U16_F ".%" U16_F ".%" U16_F ", %" U16_F ") --- " "(%" U16_F ".%" U16_F ".%" U16_F ".%" U16_F ", %" U16_F ")\n", ip4_addr1_16(&pcb->local_ip), ip4_addr2_16(&pcb->local_ip), ip4_addr3_16(&pcb->local_ip), ip4_addr4_16(&pcb->local_ip), pcb->local_port, ip4_addr1_16(&pcb->remote_ip), ip4_addr2_16(&pcb->remote_ip), ip4_addr3_16(&pcb->remote_ip), ip4_addr4_16(&pcb->remote_ip), pcb->remote_port));
@@ -258,11 +300,11 @@ void udp_input(struct pbuf *p, struct netif *inp)
 			if ((local_match != 0) && (pcb->remote_port == src) && (ip_addr_isany(&pcb->remote_ip) || ip_addr_cmp(&(pcb->remote_ip), &current_iphdr_src))) {
 				/* the first fully matching PCB */
 				if (prev != NULL) {
-					/* move the pcb to the front of udp_pcbs so that is
+					/* move the pcb to the front of the demux chain so that is
 					   found faster next time */
-					prev->next = pcb->next;
-					pcb->next = udp_pcbs;
-					udp_pcbs = pcb;
+					UDP_DEMUX_NEXT(prev) = UDP_DEMUX_NEXT(pcb);
+					UDP_DEMUX_NEXT(pcb) = UDP_DEMUX_FIRST(dest);
+					UDP_DEMUX_FIRST(dest) = pcb;
 				} else {
 					UDP_STATS_INC(udp.cachehit);
 				}
@@ -340,7 +382,7 @@ void udp_input(struct pbuf *p, struct netif *inp)
 				   if SOF_REUSEADDR is set on the first match */
 				struct udp_pcb *mpcb;
 				u8_t p_header_changed = 0;
-				for (mpcb = udp_pcbs; mpcb != NULL; mpcb = mpcb->next) {
+				for (mpcb = UDP_DEMUX_FIRST(dest); mpcb != NULL; mpcb = UDP_DEMUX_NEXT(mpcb)) {
 					if (mpcb != pcb) {
 						/* compare PCB local addr+port to UDP destination addr+port */
 						if ((mpcb->local_port == dest) && ((!broadcast && ip_addr_isany(&mpcb->local_ip)) || ip_addr_cmp(&(mpcb->local_ip), &current_iphdr_dest) ||
@@ -774,6 +816,10 @@ err_t udp_bind(struct udp_pcb *pcb, ip_addr_t *ipaddr, u16_t port)
 			return ERR_USE;
 		}
 	}
+	if (rebind) {
+		/* the port may change, take the PCB out of its hash chain */
+		udp_hash_del(pcb);
+	}
 	pcb->local_port = port;
 	snmp_insert_udpidx_tree(pcb);
 	/* pcb not active yet? */
@@ -782,6 +828,7 @@ err_t udp_bind(struct udp_pcb *pcb, ip_addr_t *ipaddr, u16_t port)
 		pcb->next = udp_pcbs;
 		udp_pcbs = pcb;
 	}
+	udp_hash_add(pcb);
 	LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("udp_bind: bound to %" U16_F ".%" U16_F ".%" U16_F ".%" U16_F ", port %" U16_F "\n", ip4_addr1_16(&pcb->local_ip), ip4_addr2_16(&pcb->local_ip), ip4_addr3_16(&pcb->local_ip), ip4_addr4_16(&pcb->local_ip), pcb->local_port));
 	return ERR_OK;
 }
@@ -849,6 +896,7 @@ err_t udp_connect(struct udp_pcb *pcb, ip_addr_t *ipaddr, u16_t port)
 	/* PCB not yet on the list, add PCB now */
 	pcb->next = udp_pcbs;
 	udp_pcbs = pcb;
+	udp_hash_add(pcb);
 	return ERR_OK;
 }
 
@@ -895,6 +943,7 @@ void udp_remove(struct udp_pcb *pcb)
 	struct udp_pcb *pcb2;
 
 	snmp_delete_udpidx_tree(pcb);
+	udp_hash_del(pcb);
 	/* pcb to be removed is first in list? */
 	if (udp_pcbs == pcb) {
 		/* make list start at 2nd pcb */
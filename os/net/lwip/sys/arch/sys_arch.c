@@ -51,6 +51,7 @@
 
 static u16_t s_nextthread = 0;
 
+#ifndef CONFIG_NET_LWIP_MBOX_LOCKFREE
 /*---------------------------------------------------------------------------*
  * Routine:  sys_mbox_new
  *---------------------------------------------------------------------------*
@@ -354,6 +355,7 @@ errout_with_mutex:
 	sys_sem_signal(&(mbox->mutex));
 	return err;
 }
+#endif							/* CONFIG_NET_LWIP_MBOX_LOCKFREE */
 
 /*---------------------------------------------------------------------------*
  * Routine:  sys_mbox_valid
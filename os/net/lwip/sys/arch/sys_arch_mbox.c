@@ -0,0 +1,380 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Lock-free mailboxes for the TinyAra lwIP port.
+ *
+ * Each mailbox is a ring of SYS_MBOX_MAXSIZE slots with two free running
+ * positions, head (next message to fetch) and tail (next slot to post to),
+ * and two token counters kept with atomic operations:
+ *
+ *   nmsgs - messages that can be fetched, or minus the number of fetchers
+ *           sleeping on 'mail'
+ *   nfree - free slots, or minus the number of posters sleeping on 'room'
+ *
+ * A thread takes a token by decrementing a counter and only touches the
+ * semaphore when there was none left; a token is given back by
+ * incrementing the counter and the semaphore is only posted when that
+ * hands the token to a sleeping thread.  For the tcpip thread this means
+ * the mailbox costs two atomic updates per message while it is busy, and
+ * one semaphore post when it is woken on the empty to non-empty
+ * transition.
+ *
+ * Holding a token guarantees the slot, so positions are reserved with an
+ * atomic increment.  The few instructions between reserving a position and
+ * filling or emptying its slot run with pre-emption disabled, so on this
+ * uniprocessor kernel no thread can observe a reserved slot that was not
+ * written yet.  Interrupt handlers may use the non-blocking calls.
+ */
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <errno.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/debug.h>
+#include <net/lwip/def.h>
+#include <net/lwip/sys.h>
+#include <net/lwip/stats.h>
+
+#include <net/lwip/arch/sys_arch.h>
+
+#ifdef CONFIG_NET_LWIP_MBOX_LOCKFREE
+
+#define MBOX_SLOT(pos)  ((pos) & (SYS_MBOX_MAXSIZE - 1))
+
+#if (SYS_MBOX_MAXSIZE & (SYS_MBOX_MAXSIZE - 1)) != 0
+#error "SYS_MBOX_MAXSIZE must be a power of two"
+#endif
+
+/*---------------------------------------------------------------------------*
+ * Atomic helpers
+ *---------------------------------------------------------------------------*/
+static inline s32_t mbox_atomic_add(volatile s32_t *value, s32_t delta)
+{
+	return __atomic_fetch_add(value, delta, __ATOMIC_ACQ_REL);
+}
+
+static inline u32_t mbox_atomic_inc(volatile u32_t *pos)
+{
+	return __atomic_fetch_add(pos, 1, __ATOMIC_ACQ_REL);
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  mbox_token_trytake
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Take a token if one is available, never blocks.
+ * Outputs:
+ *      bool                    -- true if a token was taken
+ *---------------------------------------------------------------------------*/
+static bool mbox_token_trytake(volatile s32_t *tokens)
+{
+	s32_t old = __atomic_load_n(tokens, __ATOMIC_ACQUIRE);
+
+	while (old > 0) {
+		if (__atomic_compare_exchange_n(tokens, &old, old - 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  mbox_token_give
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Give a token back and wake one sleeper if there is any.
+ *---------------------------------------------------------------------------*/
+static void mbox_token_give(volatile s32_t *tokens, sys_sem_t *sem)
+{
+	if (mbox_atomic_add(tokens, 1) < 0) {
+		sys_sem_signal(sem);
+	}
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  mbox_token_take
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Take a token, sleeping on "sem" for at most "timeout" milliseconds
+ *      (0 = forever) if there is none.
+ * Outputs:
+ *      u32_t                   -- SYS_ARCH_CANCELED or SYS_ARCH_TIMEOUT
+ *                                 without a token, else the number of
+ *                                 milliseconds spent waiting.
+ *---------------------------------------------------------------------------*/
+static u32_t mbox_token_take(volatile s32_t *tokens, sys_sem_t *sem, u32_t timeout)
+{
+	s32_t old;
+	u32_t ret;
+
+	if (mbox_atomic_add(tokens, -1) > 0) {
+		return 0;
+	}
+
+	ret = sys_arch_sem_wait(sem, timeout);
+	if (ret != SYS_ARCH_TIMEOUT && ret != SYS_ARCH_CANCELED) {
+		return ret;
+	}
+
+	/* Withdraw from the sleepers, unless a token was handed to us after
+	 * the wait gave up.
+	 */
+
+	old = __atomic_load_n(tokens, __ATOMIC_ACQUIRE);
+	while (old < 0) {
+		if (__atomic_compare_exchange_n(tokens, &old, old + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			return ret;
+		}
+	}
+
+	/* The giver has already posted (it does so with pre-emption disabled),
+	 * consume that post so that the semaphore stays balanced.
+	 */
+
+	if (sem_trywait(sem) != OK) {
+		(void)sys_arch_sem_wait(sem, 0);
+	}
+
+	if (ret == SYS_ARCH_CANCELED) {
+		mbox_token_give(tokens, sem);
+		return SYS_ARCH_CANCELED;
+	}
+
+	return timeout;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  mbox_put
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Store a message; the caller holds a free slot token.
+ *---------------------------------------------------------------------------*/
+static void mbox_put(sys_mbox_t *mbox, void *msg)
+{
+	sched_lock();
+	mbox->msgs[MBOX_SLOT(mbox_atomic_inc(&mbox->tail))] = msg;
+	mbox_token_give(&mbox->nmsgs, &mbox->mail);
+	sched_unlock();
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  mbox_get
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Remove the oldest message; the caller holds a message token.
+ *---------------------------------------------------------------------------*/
+static void *mbox_get(sys_mbox_t *mbox)
+{
+	void *msg;
+
+	sched_lock();
+	msg = mbox->msgs[MBOX_SLOT(mbox_atomic_inc(&mbox->head))];
+	mbox_token_give(&mbox->nfree, &mbox->room);
+	sched_unlock();
+
+	return msg;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_new
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Creates a new mailbox
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      int queue_sz            -- Size of elements in the mailbox
+ * Outputs:
+ *      err_t                   -- ERR_OK if message posted, else ERR_MEM
+ *---------------------------------------------------------------------------*/
+err_t sys_mbox_new(sys_mbox_t *mbox, int queue_sz)
+{
+	if (queue_sz <= 0 || queue_sz > SYS_MBOX_MAXSIZE) {
+		queue_sz = SYS_MBOX_MAXSIZE;
+	}
+
+	mbox->id = lwip_stats.sys.mbox.used + 1;
+	mbox->queue_size = queue_sz;
+	mbox->head = 0;
+	mbox->tail = 0;
+	mbox->nmsgs = 0;
+	mbox->nfree = queue_sz;
+
+	if (sys_sem_new(&mbox->mail, 0) != ERR_OK) {
+		return ERR_MEM;
+	}
+
+	if (sys_sem_new(&mbox->room, 0) != ERR_OK) {
+		sys_sem_free(&mbox->mail);
+		return ERR_MEM;
+	}
+
+	mbox->is_valid = 1;
+
+#if SYS_STATS
+	SYS_STATS_INC_USED(mbox);
+#endif							/* SYS_STATS */
+
+	LWIP_DEBUGF(SYS_DEBUG, ("Succesfully Created MBOX with id %d", mbox->id));
+	return ERR_OK;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_free
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Deallocates a mailbox. If there are messages still present in the
+ *      mailbox when the mailbox is deallocated, it is an indication of a
+ *      programming error in lwIP and the developer should be notified.
+ * Inputs:
+ *      sys_mbox_t *mbox         -- Handle of mailbox
+ *---------------------------------------------------------------------------*/
+void sys_mbox_free(sys_mbox_t *mbox)
+{
+	if (mbox != SYS_MBOX_NULL) {
+		LWIP_DEBUGF(SYS_DEBUG, ("Deleting MBOX with id %d", mbox->id));
+
+		mbox->is_valid = 0;
+		mbox->id = 0;
+		mbox->queue_size = 0;
+		sys_sem_free(&mbox->mail);
+		sys_sem_free(&mbox->room);
+
+#if SYS_STATS
+		SYS_STATS_DEC(mbox.used);
+#endif							/* SYS_STATS */
+	}
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_post (Blocking Call)
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Post the "msg" to the mailbox.
+ * Inputs:
+ *      sys_mbox_t mbox        -- Handle of mailbox
+ *      void *msg              -- Pointer to data to post
+ *---------------------------------------------------------------------------*/
+void sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
+
+	if (mbox_token_take(&mbox->nfree, &mbox->room, 0) == SYS_ARCH_CANCELED) {
+		return;
+	}
+
+	mbox_put(mbox, msg);
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_trypost
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Try to post the "msg" to the mailbox.  Returns immediately with
+ *      error if cannot.
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      void *msg               -- Pointer to data to post
+ * Outputs:
+ *      err_t                   -- ERR_OK if message posted, else ERR_MEM
+ *                                  if not.
+ *---------------------------------------------------------------------------*/
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
+
+	if (!mbox_token_trytake(&mbox->nfree)) {
+		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, returning error\n"));
+		return ERR_MEM;
+	}
+
+	mbox_put(mbox, msg);
+	return ERR_OK;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_arch_mbox_fetch
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Blocks the thread until a message arrives in the mailbox, but does
+ *      not block the thread longer than "timeout" milliseconds (similar to
+ *      the sys_arch_sem_wait() function).  "msg" may be NULL to drop the
+ *      message.
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      void **msg              -- Pointer to pointer to msg received
+ *      u32_t timeout           -- Number of milliseconds until timeout
+ * Outputs:
+ *      u32_t                   -- SYS_ARCH_CANCELED if the operation canceled,
+ *				   SYS_ARCH_TIMEOUT if timeout, else number
+ *                                 of milliseconds until received.
+ *---------------------------------------------------------------------------*/
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+	void *data;
+	u32_t ret;
+
+	ret = mbox_token_take(&mbox->nmsgs, &mbox->mail, timeout);
+	if (ret == SYS_ARCH_TIMEOUT || ret == SYS_ARCH_CANCELED) {
+		return ret;
+	}
+
+	data = mbox_get(mbox);
+	if (msg != NULL) {
+		*msg = data;
+	}
+
+	LWIP_DEBUGF(SYS_DEBUG, (" mbox %p msg %p\n", (void *)mbox, data));
+	return ret;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_arch_mbox_tryfetch
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Similar to sys_arch_mbox_fetch, but if message is not ready
+ *      immediately, we'll return with SYS_MBOX_EMPTY.  On success, 0 is
+ *      returned.
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      void **msg              -- Pointer to pointer to msg received
+ * Outputs:
+ *      u32_t                   -- SYS_MBOX_EMPTY if no messages.  Otherwise,
+ *                                  return ERR_OK.
+ *---------------------------------------------------------------------------*/
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+	void *data;
+
+	if (!mbox_token_trytake(&mbox->nmsgs)) {
+		LWIP_DEBUGF(SYS_DEBUG, ("SYS_MBOX_EMPTY , returning\n"));
+		return SYS_MBOX_EMPTY;
+	}
+
+	data = mbox_get(mbox);
+	if (msg != NULL) {
+		*msg = data;
+	}
+
+	return ERR_OK;
+}
+
+#endif							/* CONFIG_NET_LWIP_MBOX_LOCKFREE */
@@ -65,4 +65,14 @@
 /* Minimal changes to opt.h required for etharp unit tests: */
 #define ETHARP_SUPPORT_STATIC_ENTRIES   1
 
+/* Hashed PCB demux, with tables small enough for the tests to see collisions */
+#define LWIP_TCP_PCB_HASH               1
+#define TCP_PCB_HASH_SIZE               4
+#define TCP_LISTEN_HASH_SIZE            2
+#define LWIP_UDP_PCB_HASH               1
+#define UDP_PCB_HASH_SIZE               2
+
+/* Selective acknowledgment, negotiated per connection by the tests */
+#define LWIP_TCP_SACK                   1
+
 #endif							/* __LWIPOPTS_H__ */
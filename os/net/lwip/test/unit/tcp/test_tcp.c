@@ -44,6 +44,50 @@ static void test_tcp_tmr(void)
 	}
 }
 
+#if LWIP_TCP_SACK
+/** Get the TCP header of the first packet copied by the test netif */
+static struct tcp_hdr *test_tcp_tx_hdr(struct test_tcp_txcounters *txcounters)
+{
+	if (txcounters->tx_packets == NULL) {
+		return NULL;
+	}
+	return (struct tcp_hdr *)((u8_t *)txcounters->tx_packets->payload + sizeof(struct ip_hdr));
+}
+
+/** Drop the packets copied by the test netif and reset the counters */
+static void test_tcp_tx_reset(struct test_tcp_txcounters *txcounters)
+{
+	if (txcounters->tx_packets != NULL) {
+		pbuf_free(txcounters->tx_packets);
+		txcounters->tx_packets = NULL;
+	}
+	txcounters->num_tx_calls = 0;
+	txcounters->num_tx_bytes = 0;
+}
+
+/** Build a SACK option (two NOPs first) with blocks given relative to base
+ *
+ * @return length of the option
+ */
+static u8_t test_tcp_sack_opt(u8_t *opts, u32_t base, const u32_t *edges, u8_t nblocks)
+{
+	u8_t i;
+
+	opts[0] = 1;
+	opts[1] = 1;
+	opts[2] = 5;
+	opts[3] = (u8_t)(2 + 8 * nblocks);
+	for (i = 0; i < 2 * nblocks; i++) {
+		u32_t edge = base + edges[i];
+		opts[4 + 4 * i] = (u8_t)(edge >> 24);
+		opts[5 + 4 * i] = (u8_t)(edge >> 16);
+		opts[6 + 4 * i] = (u8_t)(edge >> 8);
+		opts[7 + 4 * i] = (u8_t)edge;
+	}
+	return (u8_t)(4 + 8 * nblocks);
+}
+#endif							/* LWIP_TCP_SACK */
+
 /* Setups/teardown functions */
 
 static void tcp_setup(void)
@@ -131,6 +175,57 @@ START_TEST(test_tcp_recv_inseq)
 	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
 }
 
+END_TEST
+/** Create several ESTABLISHED pcbs sharing the local port and check that
+ * each segment is demultiplexed to its own connection */
+START_TEST(test_tcp_demux)
+{
+#define TEST_TCP_DEMUX_PCBS 4
+	struct test_tcp_counters counters[TEST_TCP_DEMUX_PCBS];
+	struct tcp_pcb *pcbs[TEST_TCP_DEMUX_PCBS];
+	struct pbuf *p;
+	char data[] = { 1, 2, 3, 4 };
+	ip_addr_t remote_ip, local_ip;
+	u16_t local_port = 0x101;
+	u32_t demux, demuxpcb;
+	struct netif netif;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	memset(&netif, 0, sizeof(netif));
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+
+	for (i = 0; i < TEST_TCP_DEMUX_PCBS; i++) {
+		memset(&counters[i], 0, sizeof(counters[i]));
+		counters[i].expected_data_len = sizeof(data);
+		counters[i].expected_data = data;
+		pcbs[i] = test_tcp_new_counters_pcb(&counters[i]);
+		EXPECT_RET(pcbs[i] != NULL);
+		tcp_set_state(pcbs[i], ESTABLISHED, &local_ip, &remote_ip, local_port, (u16_t)(0x200 + i));
+	}
+
+	demux = lwip_stats.tcp.demux;
+	demuxpcb = lwip_stats.tcp.demuxpcb;
+	/* deliver in reverse order of registration */
+	for (i = TEST_TCP_DEMUX_PCBS - 1; i >= 0; i--) {
+		p = tcp_create_rx_segment(pcbs[i], data, sizeof(data), 0, 0, 0);
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+	}
+	EXPECT(lwip_stats.tcp.demux - demux == TEST_TCP_DEMUX_PCBS);
+	EXPECT(lwip_stats.tcp.demuxpcb - demuxpcb >= TEST_TCP_DEMUX_PCBS);
+
+	for (i = 0; i < TEST_TCP_DEMUX_PCBS; i++) {
+		EXPECT(counters[i].recv_calls == 1);
+		EXPECT(counters[i].recved_bytes == sizeof(data));
+		EXPECT(counters[i].err_calls == 0);
+		tcp_abort(pcbs[i]);
+	}
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+#undef TEST_TCP_DEMUX_PCBS
+}
+
 END_TEST
 /** Provoke fast retransmission by duplicate ACKs and then recover by ACKing all sent data.
  * At the end, send more data. */
@@ -662,17 +757,324 @@ END_TEST START_TEST(test_tcp_tx_full_window_lost_from_unacked)
 }
 
 END_TEST
+#if LWIP_TCP_SACK
+/** Check that SACK is offered on SYN and used only if the SYN|ACK permits it */
+START_TEST(test_tcp_sack_negotiate)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct tcp_pcb *pcb;
+	struct tcp_hdr *tcphdr;
+	struct pbuf *p;
+	u8_t sack_perm[] = { 1, 1, 4, 2 };
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t remote_port = 0x100;
+	err_t err;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	/* initialize local vars */
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	memset(&counters, 0, sizeof(counters));
+
+	/* the first peer permits SACK, the second one does not */
+	for (i = 0; i < 2; i++) {
+		pcb = test_tcp_new_counters_pcb(&counters);
+		EXPECT_RET(pcb != NULL);
+		txcounters.copy_tx_packets = 1;
+		err = tcp_connect(pcb, &remote_ip, remote_port, NULL);
+		EXPECT_RET(err == ERR_OK);
+
+		/* SYN with MSS and SACK permitted options */
+		EXPECT_RET(txcounters.num_tx_calls == 1);
+		tcphdr = test_tcp_tx_hdr(&txcounters);
+		EXPECT_RET(tcphdr != NULL);
+		EXPECT(TCPH_HDRLEN(tcphdr) == 7);
+		EXPECT(memcmp((u8_t *)(tcphdr + 1) + 4, sack_perm, sizeof(sack_perm)) == 0);
+		test_tcp_tx_reset(&txcounters);
+
+		/* SYN|ACK, acknowledging our SYN */
+		p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, pcb->snd_nxt - pcb->lastack, TCP_SYN | TCP_ACK, sack_perm, (u8_t)(i == 0 ? sizeof(sack_perm) : 0));
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+		EXPECT_RET(pcb->state == ESTABLISHED);
+		EXPECT(TCP_SACK_ENABLED(pcb) == (i == 0));
+
+		tcp_abort(pcb);
+		test_tcp_tx_reset(&txcounters);
+	}
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+}
+
+END_TEST
+/** Lose two segments out of six: the SACK scoreboard resends the first hole
+ * on the third dupack and the second on the partial ACK, without resending
+ * what the receiver already has */
+START_TEST(test_tcp_sack_rexmit)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct tcp_pcb *pcb;
+	struct tcp_hdr *tcphdr;
+	struct pbuf *p;
+	char data[24];
+	u32_t edges[4];
+	u8_t opts[4 + 8 * 2];
+	u8_t optlen;
+	u32_t seq0;
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t remote_port = 0x100, local_port = 0x101;
+	err_t err;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	/* initialize local vars */
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	txcounters.copy_tx_packets = 1;
+	memset(&counters, 0, sizeof(counters));
+	for (i = 0; i < (int)sizeof(data); i++) {
+		data[i] = (char)i;
+	}
+
+	/* create and initialize the pcb */
+	pcb = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(pcb != NULL);
+	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+	pcb->mss = TCP_MSS;
+	/* disable initial congestion window (we don't send a SYN here...) */
+	pcb->cwnd = pcb->snd_wnd;
+	pcb->sack_flags |= TF_SACK_PERM;
+	tcp_nagle_disable(pcb);
+	seq0 = pcb->snd_nxt;
+
+	/* send six segments of 4 bytes: 0..24 */
+	for (i = 0; i < 6; i++) {
+		err = tcp_write(pcb, &data[4 * i], 4, TCP_WRITE_FLAG_COPY);
+		EXPECT_RET(err == ERR_OK);
+		err = tcp_output(pcb);
+		EXPECT_RET(err == ERR_OK);
+	}
+	EXPECT_RET(txcounters.num_tx_calls == 6);
+	test_tcp_tx_reset(&txcounters);
+
+	/* ACK for 0..4, 4..8 and 12..16 are lost */
+	p = tcp_create_rx_segment(pcb, NULL, 0, 0, 4, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 0);
+
+	/* 1st dupack: 8..12 */
+	edges[0] = 8;
+	edges[1] = 12;
+	optlen = test_tcp_sack_opt(opts, seq0, edges, 1);
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 0);
+	EXPECT(pcb->dupacks == 1);
+	EXPECT(pcb->unacked->next->flags & TF_SEG_SACKED);
+
+	/* 2nd dupack: 16..20, 8..12 */
+	edges[0] = 16;
+	edges[1] = 20;
+	edges[2] = 8;
+	edges[3] = 12;
+	optlen = test_tcp_sack_opt(opts, seq0, edges, 2);
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 0);
+	EXPECT(pcb->dupacks == 2);
+
+	/* 3rd dupack: 16..24, 8..12 -> resend 4..8 only, 12..16 is not lost yet */
+	edges[1] = 24;
+	optlen = test_tcp_sack_opt(opts, seq0, edges, 2);
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(pcb->flags & TF_INFR);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_tx_hdr(&txcounters);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(ntohl(tcphdr->seqno) == seq0 + 4);
+	test_tcp_tx_reset(&txcounters);
+
+	/* partial ACK up to 12, 16..24 SACKed -> resend 12..16 */
+	optlen = test_tcp_sack_opt(opts, seq0, edges, 1);
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 8, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(pcb->flags & TF_INFR);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_tx_hdr(&txcounters);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(ntohl(tcphdr->seqno) == seq0 + 12);
+	test_tcp_tx_reset(&txcounters);
+
+	/* ACK for everything ends the recovery */
+	p = tcp_create_rx_segment(pcb, NULL, 0, 0, 12, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(!(pcb->flags & TF_INFR));
+	EXPECT(pcb->unacked == NULL);
+	EXPECT(txcounters.num_tx_calls == 0);
+
+	/* make sure the pcb is freed */
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	tcp_abort(pcb);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	test_tcp_tx_reset(&txcounters);
+}
+
+END_TEST
+/** A segment sent as new data during one recovery and resent in it is
+ * resent again by the next recovery if that copy is lost as well */
+START_TEST(test_tcp_sack_rexmit_next_recovery)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct tcp_pcb *pcb;
+	struct tcp_hdr *tcphdr;
+	struct pbuf *p;
+	char data[36];
+	u32_t edges[4];
+	u8_t opts[4 + 8 * 2];
+	u8_t optlen;
+	u32_t seq0;
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t remote_port = 0x100, local_port = 0x101;
+	err_t err;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	/* initialize local vars */
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	txcounters.copy_tx_packets = 1;
+	memset(&counters, 0, sizeof(counters));
+	for (i = 0; i < (int)sizeof(data); i++) {
+		data[i] = (char)i;
+	}
+
+	/* create and initialize the pcb */
+	pcb = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(pcb != NULL);
+	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+	pcb->mss = TCP_MSS;
+	/* disable initial congestion window (we don't send a SYN here...) */
+	pcb->cwnd = pcb->snd_wnd;
+	pcb->sack_flags |= TF_SACK_PERM;
+	tcp_nagle_disable(pcb);
+	seq0 = pcb->snd_nxt;
+
+	/* send four segments of 4 bytes: 0..16, the first one is lost */
+	for (i = 0; i < 4; i++) {
+		err = tcp_write(pcb, &data[4 * i], 4, TCP_WRITE_FLAG_COPY);
+		EXPECT_RET(err == ERR_OK);
+		err = tcp_output(pcb);
+		EXPECT_RET(err == ERR_OK);
+	}
+	EXPECT_RET(txcounters.num_tx_calls == 4);
+	test_tcp_tx_reset(&txcounters);
+
+	/* three dupacks, 4..16 SACKed -> resend 0..4, recovery up to 16 */
+	edges[0] = 4;
+	for (i = 0; i < 3; i++) {
+		edges[1] = 8 + 4 * i;
+		optlen = test_tcp_sack_opt(opts, seq0, edges, 1);
+		p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+	}
+	EXPECT_RET(pcb->flags & TF_INFR);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	test_tcp_tx_reset(&txcounters);
+
+	/* new data during the recovery: 16..36, 16..20 is lost */
+	for (i = 4; i < 9; i++) {
+		err = tcp_write(pcb, &data[4 * i], 4, TCP_WRITE_FLAG_COPY);
+		EXPECT_RET(err == ERR_OK);
+		err = tcp_output(pcb);
+		EXPECT_RET(err == ERR_OK);
+	}
+	EXPECT_RET(txcounters.num_tx_calls == 5);
+	test_tcp_tx_reset(&txcounters);
+
+	/* dupack with 20..32 SACKed -> 16..20 is lost and resent */
+	edges[0] = 20;
+	edges[1] = 32;
+	edges[2] = 4;
+	edges[3] = 16;
+	optlen = test_tcp_sack_opt(opts, seq0, edges, 2);
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_tx_hdr(&txcounters);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(ntohl(tcphdr->seqno) == seq0 + 16);
+	test_tcp_tx_reset(&txcounters);
+
+	/* ACK up to 16 ends the recovery, the resent 16..20 is lost too */
+	optlen = test_tcp_sack_opt(opts, seq0, edges, 1);
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 16, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(!(pcb->flags & TF_INFR));
+	test_tcp_tx_reset(&txcounters);
+
+	/* dupacks with 20..36 SACKed start a new recovery that resends 16..20
+	 * again instead of waiting for the retransmission timer */
+	edges[1] = 36;
+	optlen = test_tcp_sack_opt(opts, seq0, edges, 1);
+	for (i = 0; i < 3 && txcounters.num_tx_calls == 0; i++) {
+		p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+	}
+	EXPECT(pcb->flags & TF_INFR);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_tx_hdr(&txcounters);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(ntohl(tcphdr->seqno) == seq0 + 16);
+	test_tcp_tx_reset(&txcounters);
+
+	/* make sure the pcb is freed */
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	tcp_abort(pcb);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+}
+
+END_TEST
+#endif							/* LWIP_TCP_SACK */
 /** Create the suite including all tests for this module */
 Suite *tcp_suite(void)
 {
 	TFun tests[] = {
 		test_tcp_new_abort,
 		test_tcp_recv_inseq,
+		test_tcp_demux,
 		test_tcp_fast_retx_recover,
 		test_tcp_fast_rexmit_wraparound,
 		test_tcp_rto_rexmit_wraparound,
 		test_tcp_tx_full_window_lost_from_unacked,
-		test_tcp_tx_full_window_lost_from_unsent
+		test_tcp_tx_full_window_lost_from_unsent,
+#if LWIP_TCP_SACK
+		test_tcp_sack_negotiate,
+		test_tcp_sack_rexmit,
+		test_tcp_sack_rexmit_next_recovery
+#endif
 	};
 	return create_suite("TCP", tests, sizeof(tests) / sizeof(TFun), tcp_setup, tcp_teardown);
 }
@@ -130,6 +130,42 @@ static int tcp_oos_tcplen(struct tcp_pcb *pcb)
 	return len;
 }
 
+#if LWIP_TCP_SACK
+/** Get the SACK blocks of a packet sent by the test netif
+ *
+ * @param p the packet (IP header first)
+ * @param base the edges are returned relative to this seqno
+ * @param edges left and right edges of the blocks
+ * @return number of blocks, -1 if the packet has no SACK option
+ */
+static int tcp_oos_tx_sack(struct pbuf *p, u32_t base, u32_t *edges)
+{
+	struct tcp_hdr *tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + sizeof(struct ip_hdr));
+	u8_t *opts = (u8_t *)(tcphdr + 1);
+	int c, max_c, i;
+
+	max_c = (TCPH_HDRLEN(tcphdr) - 5) * 4;
+	for (c = 0; c < max_c;) {
+		if (opts[c] == 1) {
+			c++;
+			continue;
+		}
+		if (opts[c] == 0 || c + 1 >= max_c || opts[c + 1] < 2) {
+			break;
+		}
+		if (opts[c] == 5) {
+			for (i = 0; i < (opts[c + 1] - 2) / 4; i++) {
+				u8_t *edge = &opts[c + 2 + 4 * i];
+				edges[i] = (((u32_t)edge[0] << 24) | ((u32_t)edge[1] << 16) | ((u32_t)edge[2] << 8) | edge[3]) - base;
+			}
+			return i / 2;
+		}
+		c += opts[c + 1];
+	}
+	return -1;
+}
+#endif							/* LWIP_TCP_SACK */
+
 /* Setup/teardown functions */
 
 static void tcp_oos_setup(void)
@@ -139,6 +175,7 @@ static void tcp_oos_setup(void)
 
 static void tcp_oos_teardown(void)
 {
+	netif_list = NULL;
 	tcp_remove_all();
 }
 
@@ -892,6 +929,98 @@ static void test_tcp_recv_ooseq_double_FINs(int delay_packet)
 	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
 }
 
+#if LWIP_TCP_SACK
+/** Receive segments out of order with SACK in use and check the blocks
+ * reported in the ACKs: the block with the segment received last first,
+ * adjacent segments merged */
+START_TEST(test_tcp_recv_ooseq_sack)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct tcp_pcb *pcb;
+	struct pbuf *p;
+	char data[] = {
+		1, 2, 3, 4,
+		5, 6, 7, 8,
+		9, 10, 11, 12,
+		13, 14, 15, 16
+	};
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t remote_port = 0x100, local_port = 0x101;
+	u32_t edges[2 * TCP_SACK_MAX_BLOCKS];
+	u32_t rcv_nxt;
+	LWIP_UNUSED_ARG(_i);
+
+	/* initialize local vars */
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	txcounters.copy_tx_packets = 1;
+	memset(&counters, 0, sizeof(counters));
+	counters.expected_data_len = sizeof(data);
+	counters.expected_data = data;
+
+	/* create and initialize the pcb */
+	pcb = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(pcb != NULL);
+	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+	pcb->sack_flags |= TF_SACK_PERM;
+	rcv_nxt = pcb->rcv_nxt;
+
+	/* bytes 4..8: one block */
+	p = tcp_create_rx_segment(pcb, &data[4], 4, 4, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	EXPECT(tcp_oos_tx_sack(txcounters.tx_packets, rcv_nxt, edges) == 1);
+	EXPECT(edges[0] == 4 && edges[1] == 8);
+	pbuf_free(txcounters.tx_packets);
+	txcounters.tx_packets = NULL;
+
+	/* bytes 12..16: reported first, 4..8 follows */
+	p = tcp_create_rx_segment(pcb, &data[12], 4, 12, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 2);
+	EXPECT(tcp_oos_tx_sack(txcounters.tx_packets, rcv_nxt, edges) == 2);
+	EXPECT(edges[0] == 12 && edges[1] == 16);
+	EXPECT(edges[2] == 4 && edges[3] == 8);
+	pbuf_free(txcounters.tx_packets);
+	txcounters.tx_packets = NULL;
+
+	/* bytes 8..12 close the gap between the two blocks */
+	p = tcp_create_rx_segment(pcb, &data[8], 4, 8, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 3);
+	EXPECT(tcp_oos_tx_sack(txcounters.tx_packets, rcv_nxt, edges) == 1);
+	EXPECT(edges[0] == 4 && edges[1] == 16);
+	pbuf_free(txcounters.tx_packets);
+	txcounters.tx_packets = NULL;
+	EXPECT(pcb->rcv_nxt == rcv_nxt);
+
+	/* in-sequence bytes 0..4 deliver everything */
+	p = tcp_create_rx_segment(pcb, &data[0], 4, 0, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(counters.recved_bytes == sizeof(data));
+	EXPECT(pcb->ooseq == NULL);
+	EXPECT(pcb->rcv_nxt == rcv_nxt + sizeof(data));
+
+	/* make sure the pcb is freed */
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	tcp_abort(pcb);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	if (txcounters.tx_packets != NULL) {
+		pbuf_free(txcounters.tx_packets);
+	}
+}
+
+END_TEST
+#endif							/* LWIP_TCP_SACK */
+
 /** create multiple segments and pass them to tcp_input with the first segment missing
  * to simulate overruning the rxwin with ooseq queueing enabled */
 #define FIN_TEST(name, num) \
@@ -942,7 +1071,10 @@ Suite *tcp_oos_suite(void)
 		test_tcp_recv_ooseq_double_FIN_12,
 		test_tcp_recv_ooseq_double_FIN_13,
 		test_tcp_recv_ooseq_double_FIN_14,
-		test_tcp_recv_ooseq_double_FIN_15
+		test_tcp_recv_ooseq_double_FIN_15,
+#if LWIP_TCP_SACK
+		test_tcp_recv_ooseq_sack
+#endif
 	};
 	return create_suite("TCP_OOS", tests, sizeof(tests) / sizeof(TFun), tcp_oos_setup, tcp_oos_teardown);
 }
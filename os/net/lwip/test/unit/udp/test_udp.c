@@ -20,6 +20,7 @@
 
 #include <net/lwip/udp.h>
 #include <net/lwip/stats.h>
+#include <net/lwip/ipv4/ip.h>
 
 #if !LWIP_STATS || !UDP_STATS || !MEMP_STATS
 #error "This tests needs UDP- and MEMP-statistics enabled"
@@ -39,6 +40,52 @@ static void udp_remove_all(void)
 	fail_unless(lwip_stats.memp[MEMP_UDP_PCB].used == 0);
 }
 
+static void test_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, ip_addr_t *addr, u16_t port)
+{
+	u32_t *recv_calls = (u32_t *)arg;
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(addr);
+	LWIP_UNUSED_ARG(port);
+
+	(*recv_calls)++;
+	pbuf_free(p);
+}
+
+/* Pass an empty datagram to 10.0.0.1:dest_port to udp_input(). The netif
+   has another address, so nothing is sent back if no pcb matches. */
+static void test_udp_input(u16_t dest_port, struct netif *inp)
+{
+	struct pbuf *p;
+	struct ip_hdr *iphdr;
+	struct udp_hdr *udphdr;
+
+	p = pbuf_alloc(PBUF_RAW, IP_HLEN + UDP_HLEN, PBUF_RAM);
+	EXPECT_RET(p != NULL);
+	memset(p->payload, 0, IP_HLEN + UDP_HLEN);
+	iphdr = (struct ip_hdr *)p->payload;
+	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(iphdr, htons(p->tot_len));
+	IPH_PROTO_SET(iphdr, IP_PROTO_UDP);
+	IP4_ADDR(&iphdr->src, 10, 0, 0, 2);
+	IP4_ADDR(&iphdr->dest, 10, 0, 0, 1);
+	udphdr = (struct udp_hdr *)((u8_t *)iphdr + IP_HLEN);
+	udphdr->src = htons(0x200);
+	udphdr->dest = htons(dest_port);
+	udphdr->len = htons(UDP_HLEN);
+
+	ip_addr_copy(current_iphdr_dest, iphdr->dest);
+	ip_addr_copy(current_iphdr_src, iphdr->src);
+	current_netif = inp;
+	current_header = iphdr;
+
+	udp_input(p, inp);
+
+	current_iphdr_dest.addr = 0;
+	current_iphdr_src.addr = 0;
+	current_netif = NULL;
+	current_header = NULL;
+}
+
 /* Setups/teardown functions */
 
 static void udp_setup(void)
@@ -69,12 +116,62 @@ START_TEST(test_udp_new_remove)
 	}
 }
 
+END_TEST
+/** Bind pcbs to ports that share a demux chain, rebind and remove some of
+ * them, and check that datagrams still reach the right pcb */
+START_TEST(test_udp_demux)
+{
+	struct udp_pcb *pcbs[3];
+	u32_t recv_calls[3];
+	struct netif netif;
+	u32_t demux;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	memset(&netif, 0, sizeof(netif));
+	IP4_ADDR(&netif.ip_addr, 10, 0, 0, 3);
+	memset(recv_calls, 0, sizeof(recv_calls));
+
+	for (i = 0; i < 3; i++) {
+		pcbs[i] = udp_new();
+		EXPECT_RET(pcbs[i] != NULL);
+		EXPECT_RET(udp_bind(pcbs[i], IP_ADDR_ANY, (u16_t)(0x100 + 2 * i)) == ERR_OK);
+		udp_recv(pcbs[i], test_udp_recv, &recv_calls[i]);
+	}
+
+	demux = lwip_stats.udp.demux;
+	test_udp_input(0x100, &netif);
+	test_udp_input(0x102, &netif);
+	test_udp_input(0x104, &netif);
+	test_udp_input(0x106, &netif);
+	EXPECT(lwip_stats.udp.demux - demux == 4);
+	EXPECT(recv_calls[0] == 1 && recv_calls[1] == 1 && recv_calls[2] == 1);
+
+	/* move pcbs[0] to another port */
+	EXPECT_RET(udp_bind(pcbs[0], IP_ADDR_ANY, 0x106) == ERR_OK);
+	test_udp_input(0x100, &netif);
+	test_udp_input(0x106, &netif);
+	EXPECT(recv_calls[0] == 2);
+
+	/* remove pcbs[1], the others must still be found */
+	udp_remove(pcbs[1]);
+	test_udp_input(0x102, &netif);
+	test_udp_input(0x104, &netif);
+	test_udp_input(0x106, &netif);
+	EXPECT(recv_calls[0] == 3 && recv_calls[1] == 1 && recv_calls[2] == 2);
+
+	udp_remove(pcbs[0]);
+	udp_remove(pcbs[2]);
+	EXPECT(lwip_stats.memp[MEMP_UDP_PCB].used == 0);
+}
+
 END_TEST
 /** Create the suite including all tests for this module */
 Suite *udp_suite(void)
 {
 	TFun tests[] = {
 		test_udp_new_remove,
+		test_udp_demux,
 	};
 	return create_suite("UDP", tests, sizeof(tests) / sizeof(TFun), udp_setup, udp_teardown);
 }
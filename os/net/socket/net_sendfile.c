@@ -0,0 +1,289 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * net/socket/net_sendfile.c
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+
+#include <net/lwip/pbuf.h>
+#include <net/lwip/tcp.h>
+
+#if defined(CONFIG_NET_SENDFILE) && CONFIG_NSOCKET_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_SENDFILE_NSEGS
+#define CONFIG_NET_SENDFILE_NSEGS 4
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_sendfile_map
+ *
+ * Description:
+ *   Return the address of the file contents if the file lives on directly
+ *   addressable, read-only media (romfs on XIP flash or on a progmem MTD).
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *net_sendfile_map(FAR struct file *filep)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR void *addr = NULL;
+
+	if (inode && inode->u.i_ops && inode->u.i_ops->ioctl) {
+		if (inode->u.i_ops->ioctl(filep, FIOC_MMAP, (unsigned long)&addr) < 0) {
+			addr = NULL;
+		}
+	}
+
+	return (FAR const uint8_t *)addr;
+}
+
+/****************************************************************************
+ * Function: net_sendfile_direct
+ *
+ * Description:
+ *   Send up to 'count' bytes at file position 'pos' of a mapped file.  The
+ *   TCP segments reference the file contents where they are.
+ *
+ ****************************************************************************/
+
+static ssize_t net_sendfile_direct(int outfd, FAR struct file *filep, FAR const uint8_t *map, off_t pos, size_t count)
+{
+	off_t size;
+
+	size = file_seek(filep, 0, SEEK_END);
+	if (size < 0) {
+		return ERROR;
+	}
+
+	if (pos >= size) {
+		return 0;
+	}
+
+	return lwip_send_static(outfd, map + pos, MIN(count, (size_t)(size - pos)), 0);
+}
+
+/****************************************************************************
+ * Function: net_sendfile_copy
+ *
+ * Description:
+ *   Send up to 'count' bytes from the current position of the file.  The
+ *   file is read straight into segment sized pbufs which are then queued
+ *   as they are, CONFIG_NET_SENDFILE_NSEGS segments at a time.
+ *
+ ****************************************************************************/
+
+static ssize_t net_sendfile_copy(int outfd, FAR struct file *filep, size_t count)
+{
+	FAR struct pbuf *chain;
+	FAR struct pbuf *p;
+	ssize_t ntransferred = 0;
+	ssize_t nread;
+	ssize_t nsent;
+	size_t nqueued;
+	u16_t seglen;
+	bool eof = false;
+	int nsegs;
+
+	while (!eof && (size_t)ntransferred < count) {
+		/* Read the next few segments */
+
+		chain = NULL;
+		nqueued = 0;
+		for (nsegs = 0; nsegs < CONFIG_NET_SENDFILE_NSEGS && ntransferred + nqueued < count; nsegs++) {
+			seglen = MIN(TCP_PBUF_MAXLEN, count - ntransferred - nqueued);
+			p = tcp_alloc_pbuf(seglen);
+			if (p == NULL) {
+				if (chain == NULL && ntransferred == 0) {
+					set_errno(ENOMEM);
+					return ERROR;
+				}
+
+				break;
+			}
+
+			nread = file_read(filep, p->payload, seglen);
+			if (nread <= 0) {
+				pbuf_free(p);
+				if (nread < 0 && chain == NULL && ntransferred == 0) {
+					return ERROR;
+				}
+
+				/* End of file, or a read error after some data */
+
+				eof = true;
+				break;
+			}
+
+			if (nread < seglen) {
+				pbuf_realloc(p, nread);
+			}
+
+			if (chain == NULL) {
+				chain = p;
+			} else {
+				pbuf_cat(chain, p);
+			}
+
+			nqueued += nread;
+		}
+
+		if (chain == NULL) {
+			break;
+		}
+
+		/* Hand the segments to the stack, it frees what it does not take */
+
+		nsent = lwip_send_pbuf(outfd, chain, (eof || ntransferred + nqueued >= count) ? 0 : MSG_MORE);
+		if (nsent < 0) {
+			return ntransferred > 0 ? ntransferred : ERROR;
+		}
+
+		/* A non-blocking socket may take less; the caller moves the file
+		 * position back to the end of the data actually sent.
+		 */
+
+		ntransferred += nsent;
+		if ((size_t)nsent < nqueued) {
+			break;
+		}
+	}
+
+	return ntransferred;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_sendfile
+ *
+ * Description:
+ *   The sendfile() back end for TCP sockets.  Same interface as sendfile()
+ *   but the data goes from the file into the TCP segments without any
+ *   intermediate buffer: files on directly addressable media are
+ *   referenced in place, other files are read into segment sized pbufs.
+ *
+ * Parameters:
+ *   outfd    Socket descriptor of a connected TCP socket
+ *   infd     File descriptor opened for reading
+ *   offset   File offset to start at, or NULL for the current position
+ *   count    The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes sent; -1 on error with errno set appropriately.
+ *   ENOSYS means that outfd is not a TCP socket and the caller should
+ *   copy the data through a buffer instead.
+ *
+ ****************************************************************************/
+
+ssize_t net_sendfile(int outfd, int infd, FAR off_t *offset, size_t count)
+{
+	FAR struct socket *sock;
+	FAR struct file *filep;
+	FAR const uint8_t *map;
+	off_t startpos;
+	off_t pos;
+	ssize_t ntransferred;
+
+	sock = get_socket(outfd);
+	if (!sock) {
+		return ERROR;
+	}
+
+	if (sock->conn->type != NETCONN_TCP) {
+		set_errno(ENOSYS);
+		return ERROR;
+	}
+
+	filep = fs_getfilep(infd);
+	if (!filep) {
+		return ERROR;
+	}
+
+	/* Get the current file position and move to 'offset' */
+
+	startpos = file_seek(filep, 0, SEEK_CUR);
+	if (startpos < 0) {
+		return ERROR;
+	}
+
+	pos = startpos;
+	if (offset) {
+		pos = file_seek(filep, *offset, SEEK_SET);
+		if (pos < 0) {
+			return ERROR;
+		}
+	}
+
+	map = net_sendfile_map(filep);
+	if (map) {
+		ntransferred = net_sendfile_direct(outfd, filep, map, pos, count);
+	} else {
+		ntransferred = net_sendfile_copy(outfd, filep, count);
+	}
+
+	if (ntransferred > 0) {
+		pos += ntransferred;
+	}
+
+	/* Leave the file position after the data sent, or restore it if the
+	 * caller gave an offset.
+	 */
+
+	if (offset) {
+		*offset = pos;
+		pos = startpos;
+	}
+
+	if (file_seek(filep, pos, SEEK_SET) < 0) {
+		return ERROR;
+	}
+
+	return ntransferred;
+}
+
+#endif							/* CONFIG_NET_SENDFILE && CONFIG_NSOCKET_DESCRIPTORS > 0 */
@@ -218,6 +218,10 @@ SYSCALL_LOOKUP(stat,                    2, STUB_stat)
 SYSCALL_LOOKUP(statfs,                  2, STUB_statfs)
 SYSCALL_LOOKUP(telldir,                 1, STUB_telldir)
 
+#  ifdef CONFIG_DEV_PIPE_SPLICE
+SYSCALL_LOOKUP(splice,                  6, STUB_splice)
+#  endif
+
 #  if CONFIG_NFILE_STREAMS > 0
 SYSCALL_LOOKUP(fdopen,                  3, STUB_fs_fdopen)
 SYSCALL_LOOKUP(sched_getstreams,        0, STUB_sched_getstreams)
@@ -288,6 +292,12 @@ SYSCALL_LOOKUP(mq_setattr,              3, STUB_mq_setattr)
 SYSCALL_LOOKUP(mq_timedreceive,         5, STUB_mq_timedreceive)
 SYSCALL_LOOKUP(mq_timedsend,            5, STUB_mq_timedsend)
 SYSCALL_LOOKUP(mq_unlink,               1, STUB_mq_unlink)
+#  ifdef CONFIG_MQ_ZEROCOPY
+SYSCALL_LOOKUP(mq_getbuf,               1, STUB_mq_getbuf)
+SYSCALL_LOOKUP(mq_sendbuf,              4, STUB_mq_sendbuf)
+SYSCALL_LOOKUP(mq_receivebuf,           3, STUB_mq_receivebuf)
+SYSCALL_LOOKUP(mq_freebuf,              2, STUB_mq_freebuf)
+#  endif
 #endif
 
 /* The following are defined only if environment variables are supported */
@@ -315,6 +325,9 @@ SYSCALL_LOOKUP(send,                    4, STUB_send)
 SYSCALL_LOOKUP(sendto,                  6, STUB_sendto)
 SYSCALL_LOOKUP(setsockopt,              5, STUB_setsockopt)
 SYSCALL_LOOKUP(socket,                  3, STUB_socket)
+#  ifdef CONFIG_NET_SENDFILE
+SYSCALL_LOOKUP(net_sendfile,            4, STUB_net_sendfile)
+#  endif
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
@@ -229,6 +229,9 @@ uintptr_t STUB_seekdir(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_stat(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_statfs(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_telldir(int nbr, uintptr_t parm1);
+uintptr_t STUB_splice(int nbr, uintptr_t parm1, uintptr_t parm2,
+					  uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
+					  uintptr_t parm6);
 
 uintptr_t STUB_fs_fdopen(int nbr, uintptr_t parm1, uintptr_t parm2,
 						 uintptr_t parm3);
@@ -312,6 +315,12 @@ uintptr_t STUB_mq_timedreceive(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_mq_timedsend(int nbr, uintptr_t parm1, uintptr_t parm2,
 							uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
 uintptr_t STUB_mq_unlink(int nbr, uintptr_t parm1);
+uintptr_t STUB_mq_getbuf(int nbr, uintptr_t parm1);
+uintptr_t STUB_mq_sendbuf(int nbr, uintptr_t parm1, uintptr_t parm2,
+						  uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_mq_receivebuf(int nbr, uintptr_t parm1, uintptr_t parm2,
+							 uintptr_t parm3);
+uintptr_t STUB_mq_freebuf(int nbr, uintptr_t parm1, uintptr_t parm2);
 
 /* The following are defined only if environment variables are supported */
 
@@ -348,6 +357,8 @@ uintptr_t STUB_setsockopt(int nbr, uintptr_t parm1, uintptr_t parm2,
 						  uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
 uintptr_t STUB_socket(int nbr, uintptr_t parm1, uintptr_t parm2,
 					  uintptr_t parm3);
+uintptr_t STUB_net_sendfile(int nbr, uintptr_t parm1, uintptr_t parm2,
+							uintptr_t parm3, uintptr_t parm4);
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
 
@@ -0,0 +1,382 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/chksumbench/chksumbench.c
+ *
+ * Measures the lwIP Internet checksum routines on the build host.  The same
+ * os/net/lwip/src/core/ipv4/inet_chksum.c is compiled once per algorithm
+ * (see the Makefile) and every variant is timed over a range of packet
+ * sizes, as a plain checksum and as the copy-and-checksum done when TCP and
+ * UDP payload is copied into pbufs.  Results are given in bytes per cycle.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEFAULT_BYTES   (32 * 1024 * 1024)
+#define DEFAULT_REPEAT  5
+#define DEFAULT_MHZ     1000
+#define MAX_SIZE        65535
+
+/* One object per algorithm, the exported symbols carry the variant name */
+
+#define CHKSUM_VARIANT(v) \
+	uint16_t inet_chksum_##v(void *dataptr, uint16_t len); \
+	uint16_t lwip_chksum_copy_##v(void *dst, const void *src, uint16_t len)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef uint16_t (*chksum_t)(void *dataptr, uint16_t len);
+typedef uint16_t (*chksum_copy_t)(void *dst, const void *src, uint16_t len);
+
+struct variant_s {
+	FAR const char *name;
+	chksum_t chksum;
+	chksum_copy_t copy;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+CHKSUM_VARIANT(alg2);
+CHKSUM_VARIANT(alg3);
+CHKSUM_VARIANT(alg4);
+CHKSUM_VARIANT(fused);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Plain checksum: LWIP_CHKSUM_ALGORITHM 2 (the lwIP default), 3 and 4 */
+
+static const struct variant_s g_chksum[] = {
+	{"alg2", inet_chksum_alg2, lwip_chksum_copy_alg2},
+	{"alg3", inet_chksum_alg3, lwip_chksum_copy_alg3},
+	{"alg4", inet_chksum_alg4, lwip_chksum_copy_alg4},
+};
+
+/* Copy and checksum: MEMCPY followed by LWIP_CHKSUM in a second pass
+ * (LWIP_CHKSUM_COPY_ALGORITHM 1) against the fused loop (algorithm 2)
+ */
+
+static const struct variant_s g_copy[] = {
+	{"cp+alg2", inet_chksum_alg2, lwip_chksum_copy_alg2},
+	{"cp+alg4", inet_chksum_alg4, lwip_chksum_copy_alg4},
+	{"fused", inet_chksum_fused, lwip_chksum_copy_fused},
+};
+
+#define NCHKSUM (sizeof(g_chksum) / sizeof(g_chksum[0]))
+#define NCOPY   (sizeof(g_copy) / sizeof(g_copy[0]))
+
+static const unsigned g_defsizes[] = {
+	20, 40, 64, 128, 256, 536, 576, 1024, 1460, 1500, 4096, 16384
+};
+
+static unsigned g_bytes = DEFAULT_BYTES;
+static unsigned g_repeat = DEFAULT_REPEAT;
+static double g_mhz = DEFAULT_MHZ;
+static unsigned g_srcoff;
+static unsigned g_dstoff;
+
+static FAR uint8_t *g_src;
+static FAR uint8_t *g_dst;
+static volatile uint32_t g_sink;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* CPU cycles: the time stamp counter on x86, elsewhere the monotonic clock
+ * scaled by the clock frequency given with -c
+ */
+
+static inline uint64_t bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)((ts.tv_sec * 1e9 + ts.tv_nsec) * g_mhz / 1000);
+#endif
+}
+
+/* Reference: RFC 1071 sum over network order halfwords */
+
+static uint16_t ref_chksum(FAR const uint8_t *data, unsigned len)
+{
+	uint32_t sum = 0;
+	unsigned i;
+
+	for (i = 0; i + 1 < len; i += 2) {
+		sum += (data[i] << 8) | data[i + 1];
+	}
+
+	if (len & 1) {
+		sum += data[len - 1] << 8;
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return (uint16_t)~sum;
+}
+
+/* Every variant must agree with the reference for all sizes and for all
+ * source and destination alignments
+ */
+
+static int check_variants(FAR const unsigned *sizes, int nsizes)
+{
+	unsigned soff;
+	unsigned doff;
+	unsigned i;
+	uint16_t ref;
+	uint16_t sum;
+	int n;
+
+	for (n = 0; n < nsizes; n++) {
+		for (soff = 0; soff < 4; soff++) {
+			ref = ref_chksum(g_src + soff, sizes[n]);
+
+			for (i = 0; i < NCHKSUM; i++) {
+				sum = ntohs(g_chksum[i].chksum(g_src + soff, sizes[n]));
+				if (sum != ref) {
+					fprintf(stderr, "chksumbench: %s: %u bytes at offset %u: 0x%04x, expected 0x%04x\n", g_chksum[i].name, sizes[n], soff, sum, ref);
+					return -1;
+				}
+			}
+
+			for (doff = 0; doff < 4; doff++) {
+				for (i = 0; i < NCOPY; i++) {
+					memset(g_dst, 0, sizes[n] + 8);
+					sum = ntohs((uint16_t)~g_copy[i].copy(g_dst + doff, g_src + soff, sizes[n]));
+					if (sum != ref || memcmp(g_dst + doff, g_src + soff, sizes[n]) != 0) {
+						fprintf(stderr, "chksumbench: %s: %u bytes from offset %u to %u: 0x%04x, expected 0x%04x%s\n", g_copy[i].name, sizes[n], soff, doff, sum, ref, sum == ref ? " (data differs)" : "");
+						return -1;
+					}
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* Best of g_repeat runs of about g_bytes bytes each, in bytes per cycle */
+
+static double bench_chksum(chksum_t chksum, unsigned size)
+{
+	unsigned iters = g_bytes / size ? g_bytes / size : 1;
+	uint64_t best = UINT64_MAX;
+	uint64_t start;
+	uint64_t cycles;
+	uint32_t acc = 0;
+	unsigned r;
+	unsigned i;
+
+	for (r = 0; r < g_repeat; r++) {
+		start = bench_cycles();
+		for (i = 0; i < iters; i++) {
+			acc += chksum(g_src + g_srcoff, size);
+		}
+
+		cycles = bench_cycles() - start;
+		if (cycles < best) {
+			best = cycles;
+		}
+	}
+
+	g_sink += acc;
+	return best ? (double)size * iters / best : 0;
+}
+
+static double bench_copy(chksum_copy_t copy, unsigned size)
+{
+	unsigned iters = g_bytes / size ? g_bytes / size : 1;
+	uint64_t best = UINT64_MAX;
+	uint64_t start;
+	uint64_t cycles;
+	uint32_t acc = 0;
+	unsigned r;
+	unsigned i;
+
+	for (r = 0; r < g_repeat; r++) {
+		start = bench_cycles();
+		for (i = 0; i < iters; i++) {
+			acc += copy(g_dst + g_dstoff, g_src + g_srcoff, size);
+		}
+
+		cycles = bench_cycles() - start;
+		if (cycles < best) {
+			best = cycles;
+		}
+	}
+
+	g_sink += acc;
+	return best ? (double)size * iters / best : 0;
+}
+
+static int parse_sizes(FAR char *arg, FAR unsigned *sizes, int max)
+{
+	FAR char *tok;
+	int n = 0;
+
+	for (tok = strtok(arg, ","); tok; tok = strtok(NULL, ",")) {
+		if (n == max) {
+			return -1;
+		}
+
+		sizes[n] = strtoul(tok, NULL, 0);
+		if (sizes[n] == 0 || sizes[n] > MAX_SIZE) {
+			return -1;
+		}
+
+		n++;
+	}
+
+	return n;
+}
+
+static void show_usage(FAR const char *progname)
+{
+	fprintf(stderr, "USAGE: %s [options]\n", progname);
+	fprintf(stderr, "  -s SIZES   Comma separated packet sizes, at most %u (default: 20..16384)\n", MAX_SIZE);
+	fprintf(stderr, "  -n BYTES   Bytes summed per measurement (default: %u)\n", DEFAULT_BYTES);
+	fprintf(stderr, "  -r COUNT   Measurements per figure, the best one is reported (default: %u)\n", DEFAULT_REPEAT);
+	fprintf(stderr, "  -a OFFSET  Source offset from a 32-bit boundary, 0-3 (default: 0)\n");
+	fprintf(stderr, "  -d OFFSET  Destination offset for the copies, 0-3 (default: 0)\n");
+	fprintf(stderr, "  -c MHZ     CPU clock for hosts without a cycle counter (default: %u)\n", DEFAULT_MHZ);
+	exit(EXIT_FAILURE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	unsigned sizes[32];
+	int nsizes = sizeof(g_defsizes) / sizeof(g_defsizes[0]);
+	unsigned i;
+	int option;
+	int n;
+
+	memcpy(sizes, g_defsizes, sizeof(g_defsizes));
+
+	while ((option = getopt(argc, argv, "s:n:r:a:d:c:h")) != -1) {
+		switch (option) {
+		case 's':
+			nsizes = parse_sizes(optarg, sizes, sizeof(sizes) / sizeof(sizes[0]));
+			if (nsizes <= 0) {
+				show_usage(argv[0]);
+			}
+			break;
+		case 'n':
+			g_bytes = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			g_repeat = strtoul(optarg, NULL, 0);
+			break;
+		case 'a':
+			g_srcoff = strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			g_dstoff = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			g_mhz = strtod(optarg, NULL);
+			break;
+		default:
+			show_usage(argv[0]);
+		}
+	}
+
+	if (g_repeat == 0 || g_srcoff > 3 || g_dstoff > 3 || g_mhz <= 0) {
+		show_usage(argv[0]);
+	}
+
+	g_src = aligned_alloc(64, MAX_SIZE + 64);
+	g_dst = aligned_alloc(64, MAX_SIZE + 64);
+	if (!g_src || !g_dst) {
+		fprintf(stderr, "chksumbench: out of host memory\n");
+		return EXIT_FAILURE;
+	}
+
+	srand(1);
+	for (i = 0; i < MAX_SIZE + 64; i++) {
+		g_src[i] = (uint8_t)rand();
+	}
+
+	if (check_variants(sizes, nsizes) != 0) {
+		return EXIT_FAILURE;
+	}
+
+	printf("chksumbench: bytes per cycle, source offset %u, destination offset %u\n", g_srcoff, g_dstoff);
+	printf("%8s", "size");
+	for (i = 0; i < NCHKSUM; i++) {
+		printf(" %8s", g_chksum[i].name);
+	}
+
+	printf("  |");
+	for (i = 0; i < NCOPY; i++) {
+		printf(" %8s", g_copy[i].name);
+	}
+
+	printf("\n");
+
+	for (n = 0; n < nsizes; n++) {
+		printf("%8u", sizes[n]);
+		for (i = 0; i < NCHKSUM; i++) {
+			printf(" %8.2f", bench_chksum(g_chksum[i].chksum, sizes[n]));
+		}
+
+		printf("  |");
+		for (i = 0; i < NCOPY; i++) {
+			printf(" %8.2f", bench_copy(g_copy[i].copy, sizes[n]));
+		}
+
+		printf("\n");
+	}
+
+	return EXIT_SUCCESS;
+}
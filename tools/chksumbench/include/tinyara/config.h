@@ -0,0 +1,47 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/chksumbench/include/tinyara/config.h
+ *
+ * Configuration used to build the lwIP checksum routines
+ * (os/net/lwip/src/core/ipv4/inet_chksum.c) as a Linux host program.  The
+ * checksum algorithms are selected per object on the compiler command line
+ * (see tools/chksumbench/Makefile), so no CONFIG_NET_LWIP_CHKSUM_* option is
+ * set here.
+ *
+ ****************************************************************************/
+
+#ifndef __TOOLS_CHKSUMBENCH_INCLUDE_TINYARA_CONFIG_H
+#define __TOOLS_CHKSUMBENCH_INCLUDE_TINYARA_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* htons() for inet_chksum_pseudo(), from the TinyAra netdb headers on the
+ * target
+ */
+
+#include <arpa/inet.h>
+
+#define FAR
+
+#define CONFIG_NET                    1
+#define CONFIG_NET_LWIP               1
+#define CONFIG_NET_IPv4               1
+
+#endif							/* __TOOLS_CHKSUMBENCH_INCLUDE_TINYARA_CONFIG_H */
@@ -0,0 +1,843 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/heapbench/heapbench.c
+ *
+ * Runs an allocation workload against the os/mm/mm_heap allocator on the
+ * build host and reports per-operation latency and fragmentation.  The
+ * workload is either one of the built-in synthetic ones or a trace dumped
+ * from a target with "heapinfo -t" (CONFIG_DEBUG_MM_HEAPINFO_TRACE).
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <tinyara/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEFAULT_HEAPSIZE  (256 * 1024)
+#define DEFAULT_NOPS      200000
+#define DEFAULT_INTERVAL  64
+#define DEFAULT_SEED      1
+
+#define OP_ALLOC          0
+#define OP_FREE           1
+#define OP_REALLOC        2
+
+#define NO_ID             0xffffffff
+
+/* Trace event types, see heapinfo_trace_dump() */
+
+#ifndef CONFIG_DEBUG_MM_HEAPINFO_TRACE
+#define HEAPINFO_TRACE_ALLOC   'A'
+#define HEAPINFO_TRACE_FREE    'F'
+#define HEAPINFO_TRACE_REALLOC 'R'
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct op_s {
+	uint8_t type;
+	uint32_t id;				/* Slot of the block operated on */
+	uint32_t size;				/* Requested size for OP_ALLOC/OP_REALLOC */
+};
+
+struct workload_s {
+	struct op_s *ops;
+	uint32_t nops;
+	uint32_t maxops;
+	uint32_t nids;				/* Number of block slots used by ops */
+};
+
+struct latency_s {
+	uint32_t *samples;
+	uint32_t nsamples;
+};
+
+/* Address to slot map used while converting a target trace */
+
+struct addrmap_s {
+	uint32_t *addr;
+	uint32_t *id;
+	uint32_t mask;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TLSF
+static const char g_engine[] = "tlsf";
+#else
+static const char g_engine[] = "list";
+#endif
+
+static struct mm_heap_s g_heap;
+static uint32_t g_rand;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t bench_rand(void)
+{
+	/* xorshift32: deterministic for a given seed on every host */
+
+	g_rand ^= g_rand << 13;
+	g_rand ^= g_rand >> 17;
+	g_rand ^= g_rand << 5;
+	return g_rand;
+}
+
+static uint32_t bench_range(uint32_t min, uint32_t max)
+{
+	return min + bench_rand() % (max - min + 1);
+}
+
+static void workload_add(struct workload_s *wl, uint8_t type, uint32_t id, uint32_t size)
+{
+	if (wl->nops == wl->maxops) {
+		wl->maxops = wl->maxops ? wl->maxops * 2 : 1024;
+		wl->ops = realloc(wl->ops, wl->maxops * sizeof(struct op_s));
+		if (!wl->ops) {
+			fprintf(stderr, "heapbench: out of host memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	wl->ops[wl->nops].type = type;
+	wl->ops[wl->nops].id = id;
+	wl->ops[wl->nops].size = size;
+	wl->nops++;
+
+	if (id >= wl->nids) {
+		wl->nids = id + 1;
+	}
+}
+
+/* Slot allocator shared by the workloads.  Each set owns the slot range
+ * [base, base + max) and 'live' holds the slots that currently own a block.
+ */
+
+struct slots_s {
+	uint32_t *live;
+	uint32_t nlive;
+	uint32_t *freeids;
+	uint32_t nfree;
+	uint32_t base;
+	uint32_t next;
+	uint32_t max;
+};
+
+static uint32_t g_nextbase;
+
+static void slots_init(struct slots_s *s, uint32_t max)
+{
+	s->live = malloc(max * sizeof(uint32_t));
+	s->freeids = malloc(max * sizeof(uint32_t));
+	s->nlive = 0;
+	s->nfree = 0;
+	s->base = g_nextbase;
+	s->next = 0;
+	s->max = max;
+
+	g_nextbase += max;
+}
+
+static void slots_deinit(struct slots_s *s)
+{
+	free(s->live);
+	free(s->freeids);
+}
+
+static uint32_t slots_get(struct slots_s *s)
+{
+	uint32_t id = s->nfree ? s->freeids[--s->nfree] : s->base + s->next++;
+	return id;
+}
+
+static void slots_put(struct slots_s *s, uint32_t id)
+{
+	s->freeids[s->nfree++] = id;
+}
+
+static void wl_alloc(struct workload_s *wl, struct slots_s *s, uint32_t size)
+{
+	uint32_t id;
+
+	if (s->nlive >= s->max) {
+		return;
+	}
+
+	id = slots_get(s);
+	s->live[s->nlive++] = id;
+	workload_add(wl, OP_ALLOC, id, size);
+}
+
+static void wl_free_at(struct workload_s *wl, struct slots_s *s, uint32_t ndx)
+{
+	uint32_t id = s->live[ndx];
+
+	/* Keep the allocation order so that index 0 is always the oldest */
+
+	s->nlive--;
+	memmove(&s->live[ndx], &s->live[ndx + 1], (s->nlive - ndx) * sizeof(uint32_t));
+	slots_put(s, id);
+	workload_add(wl, OP_FREE, id, 0);
+}
+
+static void wl_free_all(struct workload_s *wl, struct slots_s *s)
+{
+	while (s->nlive > 0) {
+		wl_free_at(wl, s, s->nlive - 1);
+	}
+}
+
+/****************************************************************************
+ * Name: workload_random
+ *
+ * Description:
+ *   Uniformly random sizes with a random mix of allocations and frees.
+ ****************************************************************************/
+
+static void workload_random(struct workload_s *wl, uint32_t nops)
+{
+	struct slots_s s;
+
+	slots_init(&s, 1024);
+	while (wl->nops < nops) {
+		if (s.nlive == 0 || (bench_rand() & 1)) {
+			wl_alloc(wl, &s, bench_range(1, (bench_rand() & 7) ? 256 : 4096));
+		} else {
+			wl_free_at(wl, &s, bench_rand() % s.nlive);
+		}
+	}
+
+	wl_free_all(wl, &s);
+	slots_deinit(&s);
+}
+
+/****************************************************************************
+ * Name: workload_pbuf
+ *
+ * Description:
+ *   lwIP style churn.  Receive pbufs of a full Ethernet frame are queued
+ *   and released in FIFO order, interleaved with short lived tcp_seg and
+ *   small control allocations and transmit pbufs of mixed sizes that are
+ *   released when "acknowledged".
+ ****************************************************************************/
+
+static void workload_pbuf(struct workload_s *wl, uint32_t nops)
+{
+	struct slots_s rx;
+	struct slots_s tx;
+	struct slots_s small;
+	uint32_t r;
+
+	slots_init(&rx, 24);
+	slots_init(&tx, 32);
+	slots_init(&small, 64);
+
+	while (wl->nops < nops) {
+		r = bench_rand() % 100;
+		if (r < 35) {
+			/* Received frame; the oldest one is consumed first */
+
+			if (rx.nlive == rx.max) {
+				wl_free_at(wl, &rx, 0);
+			}
+
+			wl_alloc(wl, &rx, bench_range(1524, 1600));
+		} else if (r < 50) {
+			if (rx.nlive > 0) {
+				wl_free_at(wl, &rx, 0);
+			}
+		} else if (r < 65) {
+			/* Transmit pbuf plus its tcp_seg */
+
+			if (tx.nlive + 2 > tx.max) {
+				wl_free_at(wl, &tx, 0);
+				wl_free_at(wl, &tx, 0);
+			}
+
+			wl_alloc(wl, &tx, bench_range(200, 1460));
+			wl_alloc(wl, &tx, 32);
+		} else if (r < 75) {
+			/* Acknowledged data is released in arbitrary order */
+
+			if (tx.nlive > 0) {
+				wl_free_at(wl, &tx, bench_rand() % tx.nlive);
+			}
+		} else if (r < 90) {
+			if (small.nlive == small.max) {
+				wl_free_at(wl, &small, bench_rand() % small.nlive);
+			}
+
+			wl_alloc(wl, &small, bench_range(64, 256));
+		} else if (small.nlive > 0) {
+			wl_free_at(wl, &small, bench_rand() % small.nlive);
+		}
+	}
+
+	wl_free_all(wl, &rx);
+	wl_free_all(wl, &tx);
+	wl_free_all(wl, &small);
+	slots_deinit(&rx);
+	slots_deinit(&tx);
+	slots_deinit(&small);
+}
+
+/****************************************************************************
+ * Name: workload_tls
+ *
+ * Description:
+ *   mbedTLS handshake pattern.  Two connections are set up in turn: each
+ *   allocates its context and 16KB record buffers, parses a certificate
+ *   chain (many small ASN.1 nodes plus the raw DER) and churns through
+ *   bignum limbs.  After the handshake the certificate chain and the
+ *   bignums are released while the session keeps its buffers; sessions
+ *   are closed in a different order than they were opened.
+ ****************************************************************************/
+
+#define TLS_NCONN 2
+
+static void workload_tls(struct workload_s *wl, uint32_t nops)
+{
+	static const uint32_t g_mpisizes[] = { 36, 68, 132, 260, 516 };
+	struct slots_s session[TLS_NCONN];
+	struct slots_s cert;
+	struct slots_s mpi;
+	uint32_t conn;
+	uint32_t i;
+	uint32_t n;
+
+	for (i = 0; i < TLS_NCONN; i++) {
+		slots_init(&session[i], 8);
+	}
+
+	slots_init(&cert, 256);
+	slots_init(&mpi, 64);
+
+	while (wl->nops < nops) {
+		conn = bench_rand() % TLS_NCONN;
+		if (session[conn].nlive > 0) {
+			wl_free_all(wl, &session[conn]);
+			continue;
+		}
+
+		/* ssl context, config and record buffers */
+
+		wl_alloc(wl, &session[conn], bench_range(380, 420));
+		wl_alloc(wl, &session[conn], bench_range(280, 320));
+		wl_alloc(wl, &session[conn], 16717);
+		wl_alloc(wl, &session[conn], 16717);
+
+		/* Certificate chain */
+
+		n = bench_range(2, 3);
+		for (i = 0; i < n; i++) {
+			uint32_t nodes = bench_range(30, 60);
+
+			wl_alloc(wl, &cert, bench_range(800, 1500));
+			while (nodes-- > 0) {
+				wl_alloc(wl, &cert, bench_range(16, 120));
+			}
+		}
+
+		/* Key exchange */
+
+		n = bench_range(100, 200);
+		for (i = 0; i < n; i++) {
+			if (mpi.nlive == mpi.max || (mpi.nlive > 0 && (bench_rand() & 1))) {
+				wl_free_at(wl, &mpi, bench_rand() % mpi.nlive);
+			} else {
+				wl_alloc(wl, &mpi, g_mpisizes[bench_rand() % 5]);
+			}
+		}
+
+		wl_free_all(wl, &mpi);
+		wl_free_all(wl, &cert);
+
+		/* Session ticket kept by the established connection */
+
+		wl_alloc(wl, &session[conn], bench_range(100, 200));
+	}
+
+	for (i = 0; i < TLS_NCONN; i++) {
+		wl_free_all(wl, &session[i]);
+		slots_deinit(&session[i]);
+	}
+
+	slots_deinit(&cert);
+	slots_deinit(&mpi);
+}
+
+/****************************************************************************
+ * Name: workload_trace
+ *
+ * Description:
+ *   Load a trace printed by "heapinfo -t" on the target.  Target addresses
+ *   are mapped to block slots; frees of blocks allocated before tracing
+ *   started are ignored.
+ ****************************************************************************/
+
+static uint32_t *addrmap_find(struct addrmap_s *map, uint32_t addr)
+{
+	uint32_t ndx = (addr * 2654435761u) & map->mask;
+
+	while (map->addr[ndx] != 0 && map->addr[ndx] != addr) {
+		ndx = (ndx + 1) & map->mask;
+	}
+
+	return &map->addr[ndx];
+}
+
+static void addrmap_set(struct addrmap_s *map, uint32_t addr, uint32_t id)
+{
+	uint32_t *slot = addrmap_find(map, addr);
+
+	*slot = addr;
+	map->id[slot - map->addr] = id;
+}
+
+static uint32_t addrmap_take(struct addrmap_s *map, uint32_t addr)
+{
+	uint32_t *slot = addrmap_find(map, addr);
+	uint32_t ndx;
+	uint32_t next;
+	uint32_t id;
+
+	if (*slot == 0) {
+		return NO_ID;
+	}
+
+	id = map->id[slot - map->addr];
+
+	/* Backward shift deletion keeps the probe sequences intact */
+
+	ndx = slot - map->addr;
+	next = (ndx + 1) & map->mask;
+	while (map->addr[next] != 0) {
+		uint32_t home = (map->addr[next] * 2654435761u) & map->mask;
+
+		if (((next - home) & map->mask) >= ((next - ndx) & map->mask)) {
+			map->addr[ndx] = map->addr[next];
+			map->id[ndx] = map->id[next];
+			ndx = next;
+		}
+
+		next = (next + 1) & map->mask;
+	}
+
+	map->addr[ndx] = 0;
+	return id;
+}
+
+static int workload_trace(struct workload_s *wl, const char *path, size_t *heapsize)
+{
+	struct addrmap_s map;
+	struct slots_s s;
+	char line[128];
+	unsigned int version;
+	unsigned int size;
+	unsigned int nevents;
+	unsigned int dropped;
+	unsigned int caller;
+	unsigned int addr;
+	unsigned int prev;
+	char type;
+	int pid;
+	bool header = false;
+	uint32_t id;
+	FILE *fp;
+
+	fp = fopen(path, "r");
+	if (!fp) {
+		perror(path);
+		return ERROR;
+	}
+
+	map.mask = (1 << 16) - 1;
+	map.addr = calloc(map.mask + 1, sizeof(uint32_t));
+	map.id = calloc(map.mask + 1, sizeof(uint32_t));
+	slots_init(&s, map.mask / 2);
+
+	while (fgets(line, sizeof(line), fp)) {
+		if (!header) {
+			/* Console output before the header is skipped */
+
+			if (sscanf(line, "HEAPTRACE %u %u %u %u", &version, &size, &nevents, &dropped) == 4) {
+				if (version != 1) {
+					fprintf(stderr, "%s: unsupported trace version %u\n", path, version);
+					break;
+				}
+
+				if (*heapsize == 0) {
+					*heapsize = size;
+				}
+
+				if (dropped) {
+					fprintf(stderr, "%s: %u events were dropped on the target\n", path, dropped);
+				}
+
+				header = true;
+			}
+
+			continue;
+		}
+
+		if (strncmp(line, "END", 3) == 0) {
+			break;
+		}
+
+		prev = 0;
+		if (sscanf(line, "%c %d %x %x %u %x", &type, &pid, &caller, &addr, &size, &prev) < 5) {
+			fprintf(stderr, "%s: bad line: %s", path, line);
+			continue;
+		}
+
+		switch (type) {
+		case HEAPINFO_TRACE_ALLOC:
+			if (s.nlive >= s.max) {
+				break;
+			}
+
+			id = slots_get(&s);
+			s.nlive++;
+			addrmap_set(&map, addr, id);
+			workload_add(wl, OP_ALLOC, id, size);
+			break;
+
+		case HEAPINFO_TRACE_FREE:
+			id = addrmap_take(&map, addr);
+			if (id != NO_ID) {
+				slots_put(&s, id);
+				s.nlive--;
+				workload_add(wl, OP_FREE, id, 0);
+			}
+			break;
+
+		case HEAPINFO_TRACE_REALLOC:
+			id = addrmap_take(&map, prev);
+			if (id != NO_ID) {
+				addrmap_set(&map, addr, id);
+				workload_add(wl, OP_REALLOC, id, size);
+			}
+			break;
+
+		default:
+			fprintf(stderr, "%s: bad event type '%c'\n", path, type);
+			break;
+		}
+	}
+
+	fclose(fp);
+	free(map.addr);
+	free(map.id);
+	slots_deinit(&s);
+
+	if (!header) {
+		fprintf(stderr, "%s: no HEAPTRACE header found\n", path);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Measurement
+ ****************************************************************************/
+
+static inline uint64_t bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int latency_compare(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* Median cost of a back-to-back bench_now() pair, subtracted from every
+ * sample so that the numbers reflect the allocator only.
+ */
+
+static uint32_t bench_overhead(void)
+{
+	uint32_t samples[1001];
+	uint64_t start;
+	int i;
+
+	for (i = 0; i < 1001; i++) {
+		start = bench_now();
+		samples[i] = bench_now() - start;
+	}
+
+	qsort(samples, 1001, sizeof(uint32_t), latency_compare);
+	return samples[500];
+}
+
+static inline uint32_t bench_elapsed(uint64_t start, uint32_t overhead)
+{
+	uint64_t delta = bench_now() - start;
+
+	return delta > overhead ? delta - overhead : 0;
+}
+
+static void latency_report(const char *name, struct latency_s *lat)
+{
+	uint32_t *s = lat->samples;
+	uint32_t n = lat->nsamples;
+	uint64_t total = 0;
+	uint32_t i;
+
+	if (n == 0) {
+		printf("  %-8s      0 ops\n", name);
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		total += s[i];
+	}
+
+	qsort(s, n, sizeof(uint32_t), latency_compare);
+	printf("  %-8s %8u ops  avg %6llu ns  p50 %6u ns  p99 %6u ns  max %7u ns\n", name, n, (unsigned long long)(total / n), s[n / 2], s[(uint64_t)n * 99 / 100], s[n - 1]);
+}
+
+/* 1 - largest free chunk / total free: 0 when all free memory is one chunk */
+
+static double heap_fragmentation(struct mallinfo *info)
+{
+	mm_mallinfo(&g_heap, info);
+	if (info->fordblks == 0) {
+		return 0.0;
+	}
+
+	return 1.0 - (double)info->mxordblk / (double)info->fordblks;
+}
+
+static void show_usage(const char *progname)
+{
+	fprintf(stderr, "USAGE: %s [options]\n", progname);
+	fprintf(stderr, "  -w pbuf|tls|random  Synthetic workload (default: pbuf)\n");
+	fprintf(stderr, "  -t FILE             Replay a trace dumped by \"heapinfo -t\"\n");
+	fprintf(stderr, "  -s SIZE             Heap size in bytes (default: %u, or the traced heap size)\n", DEFAULT_HEAPSIZE);
+	fprintf(stderr, "  -n OPS              Number of synthetic operations (default: %u)\n", DEFAULT_NOPS);
+	fprintf(stderr, "  -i N                Sample fragmentation every N operations (default: %u)\n", DEFAULT_INTERVAL);
+	fprintf(stderr, "  -r SEED             Random seed (default: %u)\n", DEFAULT_SEED);
+	exit(EXIT_FAILURE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	struct workload_s wl;
+	struct latency_s alloclat;
+	struct latency_s freelat;
+	struct mallinfo info;
+	const char *workload = "pbuf";
+	const char *tracefile = NULL;
+	size_t heapsize = 0;
+	uint32_t nops = DEFAULT_NOPS;
+	uint32_t interval = DEFAULT_INTERVAL;
+	uint32_t seed = DEFAULT_SEED;
+	uint32_t failed = 0;
+	uint32_t overhead;
+	uint32_t minlargest;
+	uint32_t maxused = 0;
+	double frag;
+	double peakfrag = 0.0;
+	double sumfrag = 0.0;
+	uint32_t nfrag = 0;
+	void **blocks;
+	void *heapmem;
+	uint64_t start;
+	uint32_t i;
+	int option;
+
+	while ((option = getopt(argc, argv, "w:t:s:n:i:r:h")) != -1) {
+		switch (option) {
+		case 'w':
+			workload = optarg;
+			break;
+		case 't':
+			tracefile = optarg;
+			break;
+		case 's':
+			heapsize = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			nops = strtoul(optarg, NULL, 0);
+			break;
+		case 'i':
+			interval = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			show_usage(argv[0]);
+		}
+	}
+
+	g_rand = seed ? seed : DEFAULT_SEED;
+	memset(&wl, 0, sizeof(wl));
+
+	if (tracefile) {
+		if (workload_trace(&wl, tracefile, &heapsize) != OK) {
+			return EXIT_FAILURE;
+		}
+
+		workload = tracefile;
+	} else if (strcmp(workload, "pbuf") == 0) {
+		workload_pbuf(&wl, nops);
+	} else if (strcmp(workload, "tls") == 0) {
+		workload_tls(&wl, nops);
+	} else if (strcmp(workload, "random") == 0) {
+		workload_random(&wl, nops);
+	} else {
+		show_usage(argv[0]);
+	}
+
+	if (heapsize == 0) {
+		heapsize = DEFAULT_HEAPSIZE;
+	}
+
+	heapmem = malloc(heapsize);
+	blocks = calloc(wl.nids ? wl.nids : 1, sizeof(void *));
+	alloclat.samples = malloc((wl.nops + 1) * sizeof(uint32_t));
+	freelat.samples = malloc((wl.nops + 1) * sizeof(uint32_t));
+	if (!heapmem || !blocks || !alloclat.samples || !freelat.samples) {
+		fprintf(stderr, "heapbench: out of host memory\n");
+		return EXIT_FAILURE;
+	}
+
+	alloclat.nsamples = 0;
+	freelat.nsamples = 0;
+
+	overhead = bench_overhead();
+	mm_initialize(&g_heap, heapmem, heapsize);
+	mm_mallinfo(&g_heap, &info);
+	minlargest = info.mxordblk;
+
+	for (i = 0; i < wl.nops; i++) {
+		struct op_s *op = &wl.ops[i];
+		void *mem;
+
+		switch (op->type) {
+		case OP_ALLOC:
+			start = bench_now();
+			mem = mm_malloc(&g_heap, op->size);
+			alloclat.samples[alloclat.nsamples++] = bench_elapsed(start, overhead);
+			if (!mem) {
+				failed++;
+			}
+
+			blocks[op->id] = mem;
+			break;
+
+		case OP_REALLOC:
+			if (!blocks[op->id]) {
+				break;
+			}
+
+			start = bench_now();
+			mem = mm_realloc(&g_heap, blocks[op->id], op->size);
+			alloclat.samples[alloclat.nsamples++] = bench_elapsed(start, overhead);
+			if (mem) {
+				blocks[op->id] = mem;
+			} else {
+				failed++;
+			}
+			break;
+
+		case OP_FREE:
+			if (!blocks[op->id]) {
+				break;
+			}
+
+			start = bench_now();
+			mm_free(&g_heap, blocks[op->id]);
+			freelat.samples[freelat.nsamples++] = bench_elapsed(start, overhead);
+			blocks[op->id] = NULL;
+			break;
+		}
+
+		if (interval && (i % interval) == 0) {
+			frag = heap_fragmentation(&info);
+			if (frag > peakfrag) {
+				peakfrag = frag;
+			}
+
+			if ((uint32_t)info.mxordblk < minlargest) {
+				minlargest = info.mxordblk;
+			}
+
+			if ((uint32_t)info.uordblks > maxused) {
+				maxused = info.uordblks;
+			}
+
+			sumfrag += frag;
+			nfrag++;
+		}
+	}
+
+	frag = heap_fragmentation(&info);
+
+	printf("heapbench: engine %s, workload %s, heap %zu bytes, %u ops\n", g_engine, workload, heapsize, wl.nops);
+	printf("  timer overhead %u ns (subtracted)\n", overhead);
+	latency_report("malloc", &alloclat);
+	latency_report("free", &freelat);
+	printf("  failed allocations:      %u\n", failed);
+	printf("  peak used:               %u bytes\n", maxused);
+	printf("  fragmentation avg/peak:  %.3f / %.3f (%u samples)\n", nfrag ? sumfrag / nfrag : 0.0, peakfrag, nfrag);
+	printf("  min largest free chunk:  %u bytes\n", minlargest);
+	printf("  final: %d free chunks, largest %d of %d free bytes\n", info.ordblks, info.mxordblk, info.fordblks);
+
+	free(heapmem);
+	free(blocks);
+	free(alloclat.samples);
+	free(freelat.samples);
+	free(wl.ops);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/heapbench/include/debug.h
+ *
+ * The heap debug output is compiled out in the host build.
+ ****************************************************************************/
+
+#ifndef __TOOLS_HEAPBENCH_INCLUDE_DEBUG_H
+#define __TOOLS_HEAPBENCH_INCLUDE_DEBUG_H
+
+#define dbg(...)
+#define mdbg(...)
+#define mvdbg(...)
+#define mlldbg(...)
+
+#endif							/* __TOOLS_HEAPBENCH_INCLUDE_DEBUG_H */
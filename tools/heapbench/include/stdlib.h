@@ -0,0 +1,38 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/heapbench/include/stdlib.h
+ *
+ * Add the TinyAra struct mallinfo (which has mxordblk) to the host
+ * stdlib.h.  The host <malloc.h> must not be included with this header.
+ ****************************************************************************/
+
+#ifndef __TOOLS_HEAPBENCH_INCLUDE_STDLIB_H
+#define __TOOLS_HEAPBENCH_INCLUDE_STDLIB_H
+
+#include_next <stdlib.h>
+
+struct mallinfo {
+	int arena;					/* Total size of the heap */
+	int ordblks;				/* Number of free chunks */
+	int mxordblk;				/* Size of the largest free chunk */
+	int uordblks;				/* Total size of the allocated chunks */
+	int fordblks;				/* Total size of the free chunks */
+};
+
+#endif							/* __TOOLS_HEAPBENCH_INCLUDE_STDLIB_H */
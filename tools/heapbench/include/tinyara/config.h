@@ -0,0 +1,45 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/heapbench/include/tinyara/config.h
+ *
+ * Configuration used to build os/mm/mm_heap as a Linux host library.  The
+ * allocator variant is selected on the compiler command line (see
+ * tools/heapbench/Makefile).
+ ****************************************************************************/
+
+#ifndef __TOOLS_HEAPBENCH_INCLUDE_TINYARA_CONFIG_H
+#define __TOOLS_HEAPBENCH_INCLUDE_TINYARA_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FAR
+#define OK    0
+#define ERROR -1
+
+#define CONFIG_MM_REGIONS       1
+#define CONFIG_HAVE_LONG_LONG   1
+#define CONFIG_CPP_HAVE_VARARGS 1
+
+#ifdef HEAPBENCH_TLSF
+#define CONFIG_MM_TLSF          1
+#define CONFIG_MM_TLSF_SLSHIFT  3
+#endif
+
+#endif							/* __TOOLS_HEAPBENCH_INCLUDE_TINYARA_CONFIG_H */
@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/flashsim.c
+ *
+ * Wraps the methods of an MTD driver (rammtd in the benchmark) to count the
+ * operations that reach the flash and to charge each of them the time it
+ * would take on a real part.  Nothing sleeps: the busy time is accumulated
+ * so that results are repeatable and the host speed does not matter.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/fs/mtd.h>
+
+#include "smartfsbench.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct flash_model_s g_model;
+static struct flash_stats_s g_stats;
+static uint32_t g_blocksize;
+
+/* The wrapped driver methods */
+
+static int (*g_erase)(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks);
+static ssize_t (*g_bread)(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR uint8_t *buffer);
+static ssize_t (*g_bwrite)(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR const uint8_t *buffer);
+static ssize_t (*g_read)(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR uint8_t *buffer);
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t (*g_write)(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR const uint8_t *buffer);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void flash_chargeread(size_t nbytes)
+{
+	g_stats.nreads++;
+	g_stats.readbytes += nbytes;
+	g_stats.busy += g_model.read_setup + g_model.read_byte * nbytes;
+}
+
+static void flash_chargeprog(off_t offset, size_t nbytes)
+{
+	size_t chunk;
+
+	g_stats.nprogs++;
+	g_stats.progbytes += nbytes;
+
+	/* A program operation cannot cross a page boundary, so the driver of a
+	 * real part issues one page program per page touched.
+	 */
+
+	while (nbytes > 0) {
+		chunk = g_model.page_size - (offset % g_model.page_size);
+		if (chunk > nbytes) {
+			chunk = nbytes;
+		}
+
+		g_stats.busy += g_model.prog_setup + g_model.prog_byte * (chunk - 1);
+		offset += chunk;
+		nbytes -= chunk;
+	}
+}
+
+static int flash_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
+{
+	g_stats.nerases += nblocks;
+	g_stats.busy += g_model.erase * nblocks;
+	return g_erase(dev, startblock, nblocks);
+}
+
+static ssize_t flash_bread(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR uint8_t *buffer)
+{
+	flash_chargeread(nblocks * g_blocksize);
+	return g_bread(dev, startblock, nblocks, buffer);
+}
+
+static ssize_t flash_bwrite(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR const uint8_t *buffer)
+{
+	flash_chargeprog(startblock * g_blocksize, nblocks * g_blocksize);
+	return g_bwrite(dev, startblock, nblocks, buffer);
+}
+
+static ssize_t flash_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR uint8_t *buffer)
+{
+	flash_chargeread(nbytes);
+	return g_read(dev, offset, nbytes, buffer);
+}
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t flash_write(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR const uint8_t *buffer)
+{
+	flash_chargeprog(offset, nbytes);
+	return g_write(dev, offset, nbytes, buffer);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: flash_attach
+ *
+ * Description:
+ *   Interpose the latency model between the MTD driver and its users.  Must
+ *   be called before the driver is handed to smart_initialize().
+ *
+ ****************************************************************************/
+
+void flash_attach(FAR struct mtd_dev_s *mtd, FAR const struct flash_model_s *model)
+{
+	struct mtd_geometry_s geo;
+
+	memcpy(&g_model, model, sizeof(struct flash_model_s));
+	if (g_model.page_size == 0) {
+		g_model.page_size = 1;
+	}
+
+	if (mtd->ioctl(mtd, MTDIOC_GEOMETRY, (unsigned long)&geo) == OK) {
+		g_blocksize = geo.blocksize;
+	}
+
+	g_erase = mtd->erase;
+	g_bread = mtd->bread;
+	g_bwrite = mtd->bwrite;
+	g_read = mtd->read;
+
+	mtd->erase = flash_erase;
+	mtd->bread = flash_bread;
+	mtd->bwrite = flash_bwrite;
+	mtd->read = flash_read;
+#ifdef CONFIG_MTD_BYTE_WRITE
+	g_write = mtd->write;
+	mtd->write = flash_write;
+#endif
+
+	flash_reset();
+}
+
+/****************************************************************************
+ * Name: flash_reset
+ ****************************************************************************/
+
+void flash_reset(void)
+{
+	memset(&g_stats, 0, sizeof(struct flash_stats_s));
+}
+
+/****************************************************************************
+ * Name: flash_getstats
+ ****************************************************************************/
+
+void flash_getstats(FAR struct flash_stats_s *stats)
+{
+	memcpy(stats, &g_stats, sizeof(struct flash_stats_s));
+}
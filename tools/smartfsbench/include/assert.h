@@ -0,0 +1,38 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/include/assert.h
+ *
+ * Map the TinyAra assertion macros onto the host assert().  As on the
+ * target, DEBUGASSERT() is only checked with CONFIG_DEBUG (make DEBUG=y).
+ ****************************************************************************/
+
+#ifndef __TOOLS_SMARTFSBENCH_INCLUDE_ASSERT_H
+#define __TOOLS_SMARTFSBENCH_INCLUDE_ASSERT_H
+
+#include_next <assert.h>
+
+#define ASSERT(f)      assert(f)
+
+#ifdef CONFIG_DEBUG
+#define DEBUGASSERT(f) assert(f)
+#else
+#define DEBUGASSERT(f)
+#endif
+
+#endif							/* __TOOLS_SMARTFSBENCH_INCLUDE_ASSERT_H */
@@ -0,0 +1,37 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/include/dirent.h
+ *
+ * Add the TinyAra d_type codes to the host dirent.h.
+ ****************************************************************************/
+
+#ifndef __TOOLS_SMARTFSBENCH_INCLUDE_DIRENT_H
+#define __TOOLS_SMARTFSBENCH_INCLUDE_DIRENT_H
+
+#include_next <dirent.h>
+
+#define DTYPE_FILE      0x01
+#define DTYPE_CHR       0x02
+#define DTYPE_BLK       0x04
+#define DTYPE_DIRECTORY 0x08
+
+#define DIRENT_ISFILE(dtype)      (((dtype) & DTYPE_FILE) != 0)
+#define DIRENT_ISDIRECTORY(dtype) (((dtype) & DTYPE_DIRECTORY) != 0)
+
+#endif							/* __TOOLS_SMARTFSBENCH_INCLUDE_DIRENT_H */
@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/include/fcntl.h
+ *
+ * The TinyAra open flags use O_RDOK/O_WROK for the access checks.  The host
+ * O_RDONLY is zero, so they get bits of their own here and the VFS shim
+ * translates the access mode of every open() (see vfs_open()).
+ ****************************************************************************/
+
+#ifndef __TOOLS_SMARTFSBENCH_INCLUDE_FCNTL_H
+#define __TOOLS_SMARTFSBENCH_INCLUDE_FCNTL_H
+
+#include_next <fcntl.h>
+
+#define O_RDOK 0x10000000		/* Read access is permitted */
+#define O_WROK 0x20000000		/* Write access is permitted */
+
+#endif							/* __TOOLS_SMARTFSBENCH_INCLUDE_FCNTL_H */
@@ -0,0 +1,101 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/include/tinyara/config.h
+ *
+ * Configuration used to build SmartFS, the SMART MTD layer and rammtd as a
+ * Linux host program.  The flash geometry and the optional SMART/SmartFS
+ * features are selected on the make command line (see
+ * tools/smartfsbench/Makefile), everything else has its Kconfig default.
+ ****************************************************************************/
+
+#ifndef __TOOLS_SMARTFSBENCH_INCLUDE_TINYARA_CONFIG_H
+#define __TOOLS_SMARTFSBENCH_INCLUDE_TINYARA_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FAR
+#define OK    0
+#define ERROR -1
+
+#define CONFIG_HAVE_LONG_LONG         1
+#define CONFIG_CPP_HAVE_VARARGS       1
+#define CONFIG_FS_WRITABLE            1
+#define CONFIG_DRVR_WRITABLE          1
+
+/* vfs_shim.c provides the block driver calls of a build with file
+ * descriptors; this makes <tinyara/fs/fs.h> declare them.
+ */
+
+#define CONFIG_NFILE_DESCRIPTORS      8
+
+/* Flash geometry */
+
+#define CONFIG_MTD                    1
+#define CONFIG_MTD_BYTE_WRITE         1
+#define CONFIG_RAMMTD                 1
+#define CONFIG_RAMMTD_FLASHSIM        1
+#define CONFIG_RAMMTD_ERASESTATE      0xff
+
+#ifndef CONFIG_RAMMTD_BLOCKSIZE
+#define CONFIG_RAMMTD_BLOCKSIZE       256
+#endif
+#ifndef CONFIG_RAMMTD_ERASESIZE
+#define CONFIG_RAMMTD_ERASESIZE       4096
+#endif
+
+/* SMART */
+
+#define CONFIG_MTD_SMART              1
+
+#ifndef CONFIG_MTD_SMART_SECTOR_SIZE
+#define CONFIG_MTD_SMART_SECTOR_SIZE  1024
+#endif
+#ifndef CONFIG_MTD_SMART_SECTOR_CACHE_SIZE
+#define CONFIG_MTD_SMART_SECTOR_CACHE_SIZE 512
+#endif
+#ifndef CONFIG_MTD_SMART_BLOCK_SUMMARY_BITS
+#define CONFIG_MTD_SMART_BLOCK_SUMMARY_BITS 4
+#endif
+#ifndef CONFIG_MTD_SMART_CHECKPOINT_INTERVAL
+#define CONFIG_MTD_SMART_CHECKPOINT_INTERVAL 256
+#endif
+#ifndef CONFIG_MTD_SMART_CHECKPOINT_SLOTS
+#define CONFIG_MTD_SMART_CHECKPOINT_SLOTS 4
+#endif
+#ifndef CONFIG_MTD_SMART_MULTI_WRITE_MAX
+#define CONFIG_MTD_SMART_MULTI_WRITE_MAX 8
+#endif
+
+/* SmartFS */
+
+#define CONFIG_FS_SMARTFS             1
+#define CONFIG_FS_PROCFS_EXCLUDE_SMARTFS 1
+#define CONFIG_SMARTFS_ERASEDSTATE    0xff
+#define CONFIG_SMARTFS_MAXNAMLEN      32
+#define CONFIG_SMARTFS_ALIGNED_ACCESS 1
+
+#ifndef CONFIG_SMARTFS_CHAIN_INDEX_SIZE
+#define CONFIG_SMARTFS_CHAIN_INDEX_SIZE 64
+#endif
+#ifndef CONFIG_SMARTFS_DCACHE_ENTRIES
+#define CONFIG_SMARTFS_DCACHE_ENTRIES 32
+#endif
+
+#endif							/* __TOOLS_SMARTFSBENCH_INCLUDE_TINYARA_CONFIG_H */
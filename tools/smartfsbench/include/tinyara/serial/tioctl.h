@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/include/tinyara/serial/tioctl.h
+ *
+ * Terminal ioctls are not needed by the file system and the TinyAra
+ * definitions clash with the host ones (struct winsize), so this is empty.
+ ****************************************************************************/
+
+#ifndef __TOOLS_SMARTFSBENCH_INCLUDE_TINYARA_SERIAL_TIOCTL_H
+#define __TOOLS_SMARTFSBENCH_INCLUDE_TINYARA_SERIAL_TIOCTL_H
+
+
+#endif							/* __TOOLS_SMARTFSBENCH_INCLUDE_TINYARA_SERIAL_TIOCTL_H */
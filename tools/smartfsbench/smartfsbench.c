@@ -0,0 +1,761 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/smartfsbench.c
+ *
+ * Runs file system workloads against SmartFS on top of the SMART MTD layer
+ * and rammtd on the build host.  The MTD operations are charged to a flash
+ * latency model (flashsim.c) so that throughput and latency resemble a real
+ * NOR part, and the bytes programmed are compared with the bytes written by
+ * the workload to give the write amplification.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include <tinyara/fs/mtd.h>
+#include <tinyara/fs/smart.h>
+
+#include "smartfsbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEFAULT_VOLSIZE   (1024 * 1024)
+#define DEFAULT_FILESIZE  (256 * 1024)
+#define DEFAULT_IOSIZE    4096
+#define DEFAULT_NOPS      256
+#define DEFAULT_MAXFILES  256
+#define DEFAULT_SEED      1
+
+#define LOOKUP_SAMPLES    64	/* stat/open samples per directory size */
+#define FILL_FILESIZE     (16 * 1024)
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+#define BENCH_BLKDEV      "/dev/smart0d1"
+#else
+#define BENCH_BLKDEV      "/dev/smart0"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Host time and flash activity accumulated over a number of operations */
+
+struct measure_s {
+	uint32_t nops;
+	uint64_t userbytes;			/* Bytes read or written by the workload */
+	double host;				/* Host time in us */
+	struct flash_stats_s flash;	/* Flash activity and simulated busy time */
+
+	/* Start of the operation in progress */
+
+	double start;
+	struct flash_stats_s fstart;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Typical 4KB sector quad SPI NOR: tBP1 30us, tBP2 2.5us, tSE 45ms */
+
+static const struct flash_model_s g_defmodel = {
+	.read_setup = 1.0,
+	.read_byte = 0.025,
+	.prog_setup = 30.0,
+	.prog_byte = 2.5,
+	.page_size = 256,
+	.erase = 45000.0,
+};
+
+static struct flash_model_s g_model;
+static FAR struct mtd_dev_s *g_mtd;
+static FAR uint8_t *g_flash;
+static size_t g_volsize;
+static size_t g_filesize;
+static size_t g_iosize;
+static uint32_t g_nops;
+static uint32_t g_maxfiles;
+static uint32_t g_rand;
+static FAR uint8_t *g_iobuf;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t bench_rand(void)
+{
+	/* xorshift32: deterministic for a given seed on every host */
+
+	g_rand ^= g_rand << 13;
+	g_rand ^= g_rand >> 17;
+	g_rand ^= g_rand << 5;
+	return g_rand;
+}
+
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void measure_begin(FAR struct measure_s *m)
+{
+	flash_getstats(&m->fstart);
+	m->start = bench_now();
+}
+
+static void measure_end(FAR struct measure_s *m, size_t userbytes)
+{
+	struct flash_stats_s now;
+
+	m->host += bench_now() - m->start;
+	flash_getstats(&now);
+
+	m->flash.nreads += now.nreads - m->fstart.nreads;
+	m->flash.readbytes += now.readbytes - m->fstart.readbytes;
+	m->flash.nprogs += now.nprogs - m->fstart.nprogs;
+	m->flash.progbytes += now.progbytes - m->fstart.progbytes;
+	m->flash.nerases += now.nerases - m->fstart.nerases;
+	m->flash.busy += now.busy - m->fstart.busy;
+	m->userbytes += userbytes;
+	m->nops++;
+}
+
+/* One line per measurement: the time is the host time plus the simulated
+ * flash time, the throughput is derived from that.
+ */
+
+static void measure_report(FAR const char *name, FAR const struct measure_s *m, bool write)
+{
+	double total = m->host + m->flash.busy;
+
+	printf("  %-12s %8llu bytes  host %9.1f ms  flash %9.1f ms  %7.1f KB/s", name, (unsigned long long)m->userbytes, m->host / 1000, m->flash.busy / 1000, total > 0 ? m->userbytes / 1.024 / total * 1000 : 0.0);
+	if (write) {
+		printf("  WA %5.2f  erases %llu\n", m->userbytes ? (double)m->flash.progbytes / m->userbytes : 0.0, (unsigned long long)m->flash.nerases);
+	} else {
+		printf("  %.1f MTD reads/op\n", m->nops ? (double)m->flash.nreads / m->nops : 0.0);
+	}
+}
+
+static void fill_pattern(FAR uint8_t *buf, size_t len, uint32_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		buf[i] = (uint8_t)(seed * 31 + i * 7 + (i >> 8));
+	}
+}
+
+/****************************************************************************
+ * Name: volume_attach
+ *
+ * Description:
+ *   (Re)run the SMART scan of the simulated flash, as on boot.  The SMART
+ *   device from a previous attach cannot be torn down and is leaked.
+ *
+ ****************************************************************************/
+
+static int volume_attach(void)
+{
+	int ret;
+
+	ret = smart_initialize(0, g_mtd, NULL);
+	if (ret < 0) {
+		fprintf(stderr, "smartfsbench: smart_initialize failed: %d\n", ret);
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: volume_create
+ *
+ * Description:
+ *   Erase the simulated flash (free of charge), then format and mount it.
+ *
+ ****************************************************************************/
+
+static int volume_create(void)
+{
+	int ret;
+
+	memset(g_flash, CONFIG_RAMMTD_ERASESTATE, g_volsize);
+
+	ret = volume_attach();
+	if (ret == OK) {
+		ret = vfs_format(BENCH_BLKDEV);
+	}
+
+	if (ret == OK) {
+		ret = vfs_mount(BENCH_BLKDEV);
+	}
+
+	if (ret < 0) {
+		fprintf(stderr, "smartfsbench: cannot create the volume: %d\n", ret);
+	}
+
+	flash_reset();
+	return ret;
+}
+
+/* Percentage of the volume in use */
+
+static uint32_t volume_used(void)
+{
+	struct statfs buf;
+
+	if (vfs_statfs(&buf) < 0 || buf.f_blocks == 0) {
+		return 100;
+	}
+
+	return (uint32_t)((buf.f_blocks - buf.f_bfree) * 100 / buf.f_blocks);
+}
+
+/* Create a file of the given size from the contents of g_iobuf */
+
+static int write_file(FAR const char *path, size_t size)
+{
+	size_t done;
+	size_t len;
+	ssize_t ret = 0;
+	int fd;
+
+	fd = vfs_open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		return fd;
+	}
+
+	for (done = 0; done < size && ret >= 0; done += len) {
+		len = size - done < g_iosize ? size - done : g_iosize;
+		ret = vfs_write(fd, g_iobuf, len);
+	}
+
+	vfs_close(fd);
+	return ret < 0 ? (int)ret : OK;
+}
+
+static int volume_remount(FAR struct measure_s *m)
+{
+	int ret;
+
+	ret = vfs_umount();
+	if (ret < 0) {
+		return ret;
+	}
+
+	measure_begin(m);
+	ret = volume_attach();
+	if (ret == OK) {
+		ret = vfs_mount(BENCH_BLKDEV);
+	}
+
+	measure_end(m, 0);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: test_seq
+ *
+ * Description:
+ *   Sequential write of a new file followed by a sequential read of it.
+ *
+ ****************************************************************************/
+
+static int test_seq(void)
+{
+	struct measure_s wr;
+	struct measure_s rd;
+	size_t done;
+	size_t len;
+	ssize_t ret;
+	int errors = 0;
+	int fd;
+
+	printf("seq: %zu byte file, %zu byte requests\n", g_filesize, g_iosize);
+	if (volume_create() < 0) {
+		return ERROR;
+	}
+
+	memset(&wr, 0, sizeof(struct measure_s));
+	memset(&rd, 0, sizeof(struct measure_s));
+
+	fd = vfs_open("/seq", O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		fprintf(stderr, "seq: open failed: %d\n", fd);
+		return ERROR;
+	}
+
+	for (done = 0; done < g_filesize; done += len) {
+		len = g_filesize - done < g_iosize ? g_filesize - done : g_iosize;
+		fill_pattern(g_iobuf, len, done / g_iosize);
+
+		measure_begin(&wr);
+		ret = vfs_write(fd, g_iobuf, len);
+		measure_end(&wr, len);
+		if (ret != (ssize_t)len) {
+			fprintf(stderr, "seq: write at %zu failed: %zd\n", done, ret);
+			vfs_close(fd);
+			return ERROR;
+		}
+	}
+
+	/* The final used byte count is written on close */
+
+	measure_begin(&wr);
+	vfs_close(fd);
+	measure_end(&wr, 0);
+
+	fd = vfs_open("/seq", O_RDONLY, 0);
+	if (fd < 0) {
+		fprintf(stderr, "seq: reopen failed: %d\n", fd);
+		return ERROR;
+	}
+
+	for (done = 0; done < g_filesize; done += len) {
+		len = g_filesize - done < g_iosize ? g_filesize - done : g_iosize;
+
+		measure_begin(&rd);
+		ret = vfs_read(fd, g_iobuf + g_iosize, len);
+		measure_end(&rd, len);
+
+		fill_pattern(g_iobuf, len, done / g_iosize);
+		if (ret != (ssize_t)len || memcmp(g_iobuf, g_iobuf + g_iosize, len) != 0) {
+			errors++;
+		}
+	}
+
+	vfs_close(fd);
+
+	measure_report("write", &wr, true);
+	measure_report("read", &rd, false);
+	if (errors) {
+		printf("  %d read requests returned bad data\n", errors);
+	}
+
+	vfs_umount();
+	return errors ? ERROR : OK;
+}
+
+/****************************************************************************
+ * Name: test_rand
+ *
+ * Description:
+ *   Random aligned overwrites and reads inside an existing file.  A copy of
+ *   the file is kept on the host and compared at the end.
+ *
+ ****************************************************************************/
+
+static int test_rand(void)
+{
+	struct measure_s wr;
+	struct measure_s rd;
+	FAR uint8_t *shadow;
+	uint32_t nchunks;
+	uint32_t i;
+	off_t offset;
+	ssize_t ret;
+	int errors = 0;
+	int fd;
+
+	nchunks = g_filesize / g_iosize;
+	printf("rand: %u requests of %zu bytes in a %u byte file\n", g_nops, g_iosize, nchunks * (uint32_t)g_iosize);
+	if (nchunks == 0) {
+		fprintf(stderr, "rand: file size is smaller than the request size\n");
+		return ERROR;
+	}
+
+	shadow = malloc(nchunks * g_iosize);
+	if (!shadow || volume_create() < 0) {
+		free(shadow);
+		return ERROR;
+	}
+
+	memset(&wr, 0, sizeof(struct measure_s));
+	memset(&rd, 0, sizeof(struct measure_s));
+
+	/* Create the file, this is not measured */
+
+	fill_pattern(shadow, nchunks * g_iosize, 0);
+	fd = vfs_open("/rand", O_RDWR | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0 || vfs_write(fd, shadow, nchunks * g_iosize) != (ssize_t)(nchunks * g_iosize)) {
+		fprintf(stderr, "rand: cannot create the file\n");
+		free(shadow);
+		return ERROR;
+	}
+
+	for (i = 0; i < g_nops; i++) {
+		offset = (off_t)(bench_rand() % nchunks) * g_iosize;
+		fill_pattern(shadow + offset, g_iosize, i + 1);
+
+		measure_begin(&wr);
+		ret = vfs_lseek(fd, offset, SEEK_SET);
+		if (ret == offset) {
+			ret = vfs_write(fd, shadow + offset, g_iosize);
+		}
+
+		measure_end(&wr, g_iosize);
+		if (ret != (ssize_t)g_iosize) {
+			fprintf(stderr, "rand: write at %ld failed: %zd\n", (long)offset, ret);
+			errors++;
+			break;
+		}
+	}
+
+	measure_begin(&wr);
+	vfs_fsync(fd);
+	measure_end(&wr, 0);
+
+	for (i = 0; i < g_nops; i++) {
+		offset = (off_t)(bench_rand() % nchunks) * g_iosize;
+
+		measure_begin(&rd);
+		ret = vfs_lseek(fd, offset, SEEK_SET);
+		if (ret == offset) {
+			ret = vfs_read(fd, g_iobuf, g_iosize);
+		}
+
+		measure_end(&rd, g_iosize);
+		if (ret != (ssize_t)g_iosize || memcmp(g_iobuf, shadow + offset, g_iosize) != 0) {
+			errors++;
+		}
+	}
+
+	vfs_close(fd);
+
+	measure_report("write", &wr, true);
+	measure_report("read", &rd, false);
+	if (errors) {
+		printf("  %d requests failed or returned bad data\n", errors);
+	}
+
+	vfs_umount();
+	free(shadow);
+	return errors ? ERROR : OK;
+}
+
+/****************************************************************************
+ * Name: test_dir
+ *
+ * Description:
+ *   stat() and open()/close() latency of files in one directory as the
+ *   directory grows.
+ *
+ ****************************************************************************/
+
+static int test_dir(void)
+{
+	struct measure_s st;
+	struct measure_s op;
+	struct stat buf;
+	char path[32];
+	uint32_t nfiles;
+	uint32_t next;
+	uint32_t i;
+	int ret;
+	int fd;
+
+	printf("dir: lookups of random files in a directory of up to %u files\n", g_maxfiles);
+	if (volume_create() < 0) {
+		return ERROR;
+	}
+
+	ret = vfs_mkdir("/dir", 0777);
+	if (ret < 0) {
+		fprintf(stderr, "dir: mkdir failed: %d\n", ret);
+		return ERROR;
+	}
+
+	printf("  %8s  %27s  %27s\n", "files", "stat host/flash us, reads", "open+close host/flash us, reads");
+
+	next = 16;
+	for (nfiles = 0; nfiles < g_maxfiles;) {
+		snprintf(path, sizeof(path), "/dir/file%04u", nfiles);
+		fd = vfs_open(path, O_WRONLY | O_CREAT, 0666);
+		if (fd < 0) {
+			fprintf(stderr, "dir: cannot create file %u: %d\n", nfiles, fd);
+			break;
+		}
+
+		vfs_write(fd, path, strlen(path));
+		vfs_close(fd);
+		nfiles++;
+
+		if (nfiles != next && nfiles != g_maxfiles) {
+			continue;
+		}
+
+		next <<= 1;
+		memset(&st, 0, sizeof(struct measure_s));
+		memset(&op, 0, sizeof(struct measure_s));
+
+		for (i = 0; i < LOOKUP_SAMPLES; i++) {
+			snprintf(path, sizeof(path), "/dir/file%04u", bench_rand() % nfiles);
+
+			measure_begin(&st);
+			ret = vfs_stat(path, &buf);
+			measure_end(&st, 0);
+
+			measure_begin(&op);
+			fd = vfs_open(path, O_RDONLY, 0);
+			if (fd >= 0) {
+				vfs_close(fd);
+			}
+
+			measure_end(&op, 0);
+			if (ret < 0 || fd < 0) {
+				fprintf(stderr, "dir: lookup of %s failed\n", path);
+				return ERROR;
+			}
+		}
+
+		printf("  %8u  %8.1f %8.1f %8.1f  %8.1f %8.1f %8.1f\n", nfiles, st.host / st.nops, st.flash.busy / st.nops, (double)st.flash.nreads / st.nops, op.host / op.nops, op.flash.busy / op.nops, (double)op.flash.nreads / op.nops);
+	}
+
+	vfs_umount();
+	return OK;
+}
+
+/****************************************************************************
+ * Name: test_mount
+ *
+ * Description:
+ *   Mount time as the volume fills up with files.
+ *
+ ****************************************************************************/
+
+static int test_mount(void)
+{
+	static const uint32_t fill[] = { 0, 25, 50, 75, 90 };
+	struct measure_s m;
+	char path[32];
+	uint32_t nfiles = 0;
+	uint32_t used;
+	uint32_t i;
+
+	printf("mount: remount time against volume fill, %u byte files\n", FILL_FILESIZE);
+	if (volume_create() < 0) {
+		return ERROR;
+	}
+
+	printf("  %8s  %10s  %10s  %10s  %12s\n", "fill %", "host ms", "flash ms", "MTD reads", "bytes read");
+	fill_pattern(g_iobuf, g_iosize, 0);
+
+	for (i = 0; i < sizeof(fill) / sizeof(fill[0]); i++) {
+		/* Add files until the requested share of the volume is in use */
+
+		used = volume_used();
+		while (used < fill[i]) {
+			snprintf(path, sizeof(path), "/fill%04u", nfiles++);
+			if (write_file(path, FILL_FILESIZE) < 0) {
+				break;
+			}
+
+			used = volume_used();
+		}
+
+		memset(&m, 0, sizeof(struct measure_s));
+		if (volume_remount(&m) < 0) {
+			fprintf(stderr, "mount: remount failed\n");
+			return ERROR;
+		}
+
+		printf("  %8u  %10.2f  %10.2f  %10llu  %12llu\n", used, m.host / 1000, m.flash.busy / 1000, (unsigned long long)m.flash.nreads, (unsigned long long)m.flash.readbytes);
+		if (used < fill[i]) {
+			printf("  volume full at %u%%\n", used);
+			break;
+		}
+	}
+
+	vfs_umount();
+	return OK;
+}
+
+/****************************************************************************
+ * Name: parse_model
+ *
+ * Description:
+ *   Parse a comma separated list of key=value latency model overrides.
+ *
+ ****************************************************************************/
+
+static int parse_model(FAR char *arg)
+{
+	FAR char *tok;
+	FAR char *val;
+	double value;
+
+	for (tok = strtok(arg, ","); tok; tok = strtok(NULL, ",")) {
+		val = strchr(tok, '=');
+		if (!val) {
+			return ERROR;
+		}
+
+		*val++ = '\0';
+		value = strtod(val, NULL);
+
+		if (strcmp(tok, "rs") == 0) {
+			g_model.read_setup = value;
+		} else if (strcmp(tok, "rb") == 0) {
+			g_model.read_byte = value;
+		} else if (strcmp(tok, "ps") == 0) {
+			g_model.prog_setup = value;
+		} else if (strcmp(tok, "pb") == 0) {
+			g_model.prog_byte = value;
+		} else if (strcmp(tok, "pg") == 0) {
+			g_model.page_size = (uint32_t)value;
+		} else if (strcmp(tok, "er") == 0) {
+			g_model.erase = value;
+		} else {
+			return ERROR;
+		}
+	}
+
+	return OK;
+}
+
+static void show_usage(FAR const char *progname)
+{
+	fprintf(stderr, "USAGE: %s [options]\n", progname);
+	fprintf(stderr, "  -t TESTS   Comma separated list of seq,rand,dir,mount (default: all)\n");
+	fprintf(stderr, "  -s SIZE    Volume size in bytes (default: %u)\n", DEFAULT_VOLSIZE);
+	fprintf(stderr, "  -f SIZE    File size for seq and rand (default: %u)\n", DEFAULT_FILESIZE);
+	fprintf(stderr, "  -b SIZE    Request size (default: %u)\n", DEFAULT_IOSIZE);
+	fprintf(stderr, "  -n OPS     Number of rand requests (default: %u)\n", DEFAULT_NOPS);
+	fprintf(stderr, "  -d FILES   Largest directory for dir (default: %u)\n", DEFAULT_MAXFILES);
+	fprintf(stderr, "  -r SEED    Random seed (default: %u)\n", DEFAULT_SEED);
+	fprintf(stderr, "  -m MODEL   Flash latency overrides in us, e.g. rs=1,rb=0.025,ps=30,pb=2.5,pg=256,er=45000\n");
+	fprintf(stderr, "             rs/rb: read setup/per byte, ps/pb: page program first/further byte,\n");
+	fprintf(stderr, "             pg: program page size, er: erase block erase\n");
+	exit(EXIT_FAILURE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	char tests[64] = "seq,rand,dir,mount";
+	uint32_t seed = DEFAULT_SEED;
+	FAR char *test;
+	int failed = 0;
+	int option;
+
+	g_volsize = DEFAULT_VOLSIZE;
+	g_filesize = DEFAULT_FILESIZE;
+	g_iosize = DEFAULT_IOSIZE;
+	g_nops = DEFAULT_NOPS;
+	g_maxfiles = DEFAULT_MAXFILES;
+	g_model = g_defmodel;
+
+	while ((option = getopt(argc, argv, "t:s:f:b:n:d:r:m:h")) != -1) {
+		switch (option) {
+		case 't':
+			snprintf(tests, sizeof(tests), "%s", optarg);
+			break;
+		case 's':
+			g_volsize = strtoul(optarg, NULL, 0);
+			break;
+		case 'f':
+			g_filesize = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			g_iosize = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			g_nops = strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			g_maxfiles = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'm':
+			if (parse_model(optarg) != OK) {
+				show_usage(argv[0]);
+			}
+			break;
+		default:
+			show_usage(argv[0]);
+		}
+	}
+
+	if (g_iosize == 0 || g_volsize < 4 * CONFIG_RAMMTD_ERASESIZE) {
+		show_usage(argv[0]);
+	}
+
+	g_rand = seed ? seed : DEFAULT_SEED;
+	g_volsize -= g_volsize % CONFIG_RAMMTD_ERASESIZE;
+	g_flash = malloc(g_volsize);
+	g_iobuf = malloc(2 * g_iosize);
+	if (!g_flash || !g_iobuf) {
+		fprintf(stderr, "smartfsbench: out of host memory\n");
+		return EXIT_FAILURE;
+	}
+
+	memset(g_flash, CONFIG_RAMMTD_ERASESTATE, g_volsize);
+	g_mtd = rammtd_initialize(g_flash, g_volsize);
+	if (!g_mtd) {
+		fprintf(stderr, "smartfsbench: rammtd_initialize failed\n");
+		return EXIT_FAILURE;
+	}
+
+	flash_attach(g_mtd, &g_model);
+
+	printf("smartfsbench: %zu byte volume, erase block %u, MTD block %u, sector %u\n", g_volsize, CONFIG_RAMMTD_ERASESIZE, CONFIG_RAMMTD_BLOCKSIZE, CONFIG_MTD_SMART_SECTOR_SIZE);
+	printf("  model: read %.2f us + %.3f us/B, program %.1f us + %.2f us/B per %u B page, erase %.0f us\n", g_model.read_setup, g_model.read_byte, g_model.prog_setup, g_model.prog_byte, g_model.page_size, g_model.erase);
+
+	for (test = strtok(tests, ","); test; test = strtok(NULL, ",")) {
+		if (strcmp(test, "seq") == 0) {
+			failed |= test_seq();
+		} else if (strcmp(test, "rand") == 0) {
+			failed |= test_rand();
+		} else if (strcmp(test, "dir") == 0) {
+			failed |= test_dir();
+		} else if (strcmp(test, "mount") == 0) {
+			failed |= test_mount();
+		} else {
+			show_usage(argv[0]);
+		}
+	}
+
+	free(g_iobuf);
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
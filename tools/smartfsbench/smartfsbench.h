@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/smartfsbench.h
+ *
+ * Interfaces shared by the benchmark driver, the VFS shim and the flash
+ * latency model.
+ ****************************************************************************/
+
+#ifndef __TOOLS_SMARTFSBENCH_SMARTFSBENCH_H
+#define __TOOLS_SMARTFSBENCH_SMARTFSBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <stdint.h>
+
+#include <tinyara/fs/mtd.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define VFS_NFILES 8			/* Number of files that can be open at once */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Per-operation cost of the simulated part, in microseconds.  A program
+ * operation is split at page boundaries and every page costs prog_setup
+ * plus prog_byte per byte, which is how NOR datasheets quote tBP1/tBP2.
+ */
+
+struct flash_model_s {
+	double read_setup;			/* Command and address phase of a read */
+	double read_byte;			/* Transfer time per byte read */
+	double prog_setup;			/* First byte of a page program */
+	double prog_byte;			/* Each further byte of a page program */
+	uint32_t page_size;			/* Program page size in bytes */
+	double erase;				/* Erase of one erase block */
+};
+
+/* Operations seen by the MTD driver since the last flash_reset() */
+
+struct flash_stats_s {
+	uint64_t nreads;			/* bread and byte read calls */
+	uint64_t readbytes;
+	uint64_t nprogs;			/* bwrite and byte write calls */
+	uint64_t progbytes;
+	uint64_t nerases;			/* Erase blocks erased */
+	double busy;				/* Simulated flash busy time (us) */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Flash latency model (flashsim.c) */
+
+void flash_attach(FAR struct mtd_dev_s *mtd, FAR const struct flash_model_s *model);
+void flash_reset(void);
+void flash_getstats(FAR struct flash_stats_s *stats);
+
+/* VFS shim (vfs_shim.c).  Paths are relative to the mounted volume and
+ * errors are returned as negated errno values, the host errno is not used.
+ */
+
+int vfs_format(FAR const char *blkdev);
+int vfs_mount(FAR const char *blkdev);
+int vfs_umount(void);
+int vfs_open(FAR const char *path, int oflags, mode_t mode);
+int vfs_close(int fd);
+ssize_t vfs_read(int fd, FAR void *buf, size_t nbytes);
+ssize_t vfs_write(int fd, FAR const void *buf, size_t nbytes);
+off_t vfs_lseek(int fd, off_t offset, int whence);
+int vfs_fsync(int fd);
+int vfs_stat(FAR const char *path, FAR struct stat *buf);
+int vfs_statfs(FAR struct statfs *buf);
+int vfs_unlink(FAR const char *path);
+int vfs_mkdir(FAR const char *path, mode_t mode);
+
+#endif							/* __TOOLS_SMARTFSBENCH_SMARTFSBENCH_H */
@@ -0,0 +1,445 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/smartfsbench/vfs_shim.c
+ *
+ * Just enough of os/fs to run SmartFS on the host: a block driver registry
+ * for smart_initialize()/mksmartfs() and a single mount point whose file
+ * operations call smartfs_operations directly.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/mksmartfs.h>
+
+#include "smartfsbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define VFS_NBLKDRVRS 8
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern const struct mountpt_operations smartfs_operations;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct inode *g_blkdrvr[VFS_NBLKDRVRS];
+static FAR struct inode *g_mountpt;
+static struct file g_files[VFS_NFILES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int vfs_findblk(FAR const char *path)
+{
+	int i;
+
+	for (i = 0; i < VFS_NBLKDRVRS; i++) {
+		if (g_blkdrvr[i] && strcmp(g_blkdrvr[i]->i_name, path) == 0) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static FAR const char *vfs_relpath(FAR const char *path)
+{
+	while (*path == '/') {
+		path++;
+	}
+
+	return path;
+}
+
+static FAR struct file *vfs_getfile(int fd)
+{
+	if (fd < 0 || fd >= VFS_NFILES || g_files[fd].f_inode == NULL) {
+		return NULL;
+	}
+
+	return &g_files[fd];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blockdriver
+ *
+ * Description:
+ *   Registering a path again replaces the previous driver, which is what a
+ *   remount with smart_initialize() on the same minor does in the benchmark.
+ *
+ ****************************************************************************/
+
+int register_blockdriver(FAR const char *path, FAR const struct block_operations *bops, mode_t mode, FAR void *priv)
+{
+	FAR struct inode *inode;
+	int ndx;
+
+	ndx = vfs_findblk(path);
+	if (ndx < 0) {
+		for (ndx = 0; ndx < VFS_NBLKDRVRS && g_blkdrvr[ndx]; ndx++) ;
+		if (ndx == VFS_NBLKDRVRS) {
+			return -ENOMEM;
+		}
+	}
+
+	inode = (FAR struct inode *)calloc(1, FSNODE_SIZE(strlen(path)));
+	if (!inode) {
+		return -ENOMEM;
+	}
+
+	strcpy(inode->i_name, path);
+	inode->u.i_bops = bops;
+	inode->i_private = priv;
+
+	free(g_blkdrvr[ndx]);
+	g_blkdrvr[ndx] = inode;
+	return OK;
+}
+
+int unregister_blockdriver(FAR const char *path)
+{
+	int ndx;
+
+	ndx = vfs_findblk(path);
+	if (ndx < 0) {
+		return ndx;
+	}
+
+	free(g_blkdrvr[ndx]);
+	g_blkdrvr[ndx] = NULL;
+	return OK;
+}
+
+int open_blockdriver(FAR const char *pathname, int mountflags, FAR struct inode **ppinode)
+{
+	FAR struct inode *inode;
+	int ndx;
+	int ret;
+
+	ndx = vfs_findblk(pathname);
+	if (ndx < 0) {
+		return ndx;
+	}
+
+	inode = g_blkdrvr[ndx];
+	if (inode->u.i_bops->open) {
+		ret = inode->u.i_bops->open(inode);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	*ppinode = inode;
+	return OK;
+}
+
+int close_blockdriver(FAR struct inode *inode)
+{
+	if (inode->u.i_bops->close) {
+		return inode->u.i_bops->close(inode);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: vfs_format
+ ****************************************************************************/
+
+int vfs_format(FAR const char *blkdev)
+{
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	return mksmartfs(blkdev, 1, true);
+#else
+	return mksmartfs(blkdev, true);
+#endif
+}
+
+/****************************************************************************
+ * Name: vfs_mount
+ ****************************************************************************/
+
+int vfs_mount(FAR const char *blkdev)
+{
+	FAR struct inode *mountpt;
+	int ndx;
+	int ret;
+
+	if (g_mountpt) {
+		return -EBUSY;
+	}
+
+	ndx = vfs_findblk(blkdev);
+	if (ndx < 0) {
+		return ndx;
+	}
+
+	mountpt = (FAR struct inode *)calloc(1, FSNODE_SIZE(0));
+	if (!mountpt) {
+		return -ENOMEM;
+	}
+
+	mountpt->u.i_mops = &smartfs_operations;
+	ret = smartfs_operations.bind(g_blkdrvr[ndx], NULL, &mountpt->i_private);
+	if (ret < 0) {
+		free(mountpt);
+		return ret;
+	}
+
+	g_mountpt = mountpt;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: vfs_umount
+ ****************************************************************************/
+
+int vfs_umount(void)
+{
+	FAR struct inode *blkdriver;
+	int ret;
+	int fd;
+
+	if (!g_mountpt) {
+		return -EINVAL;
+	}
+
+	for (fd = 0; fd < VFS_NFILES; fd++) {
+		if (g_files[fd].f_inode) {
+			(void)vfs_close(fd);
+		}
+	}
+
+	ret = smartfs_operations.unbind(g_mountpt->i_private, &blkdriver);
+	if (ret < 0) {
+		return ret;
+	}
+
+	free(g_mountpt);
+	g_mountpt = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: vfs_open
+ *
+ * Description:
+ *   Takes host open flags.  The access mode is converted to the TinyAra
+ *   O_RDOK/O_WROK bits, the other flags have the same meaning in both.
+ *
+ ****************************************************************************/
+
+int vfs_open(FAR const char *path, int oflags, mode_t mode)
+{
+	FAR struct file *filep;
+	int fd;
+	int ret;
+
+	if (!g_mountpt) {
+		return -ENODEV;
+	}
+
+	for (fd = 0; fd < VFS_NFILES && g_files[fd].f_inode; fd++) ;
+	if (fd == VFS_NFILES) {
+		return -EMFILE;
+	}
+
+	switch (oflags & O_ACCMODE) {
+	case O_RDONLY:
+		oflags = (oflags & ~O_ACCMODE) | O_RDOK;
+		break;
+	case O_WRONLY:
+		oflags = (oflags & ~O_ACCMODE) | O_WROK;
+		break;
+	default:
+		oflags = (oflags & ~O_ACCMODE) | O_RDOK | O_WROK;
+		break;
+	}
+
+	filep = &g_files[fd];
+	memset(filep, 0, sizeof(struct file));
+	filep->f_oflags = oflags;
+	filep->f_inode = g_mountpt;
+
+	ret = g_mountpt->u.i_mops->open(filep, vfs_relpath(path), oflags, mode);
+	if (ret < 0) {
+		filep->f_inode = NULL;
+		return ret;
+	}
+
+	return fd;
+}
+
+/****************************************************************************
+ * Name: vfs_close
+ ****************************************************************************/
+
+int vfs_close(int fd)
+{
+	FAR struct file *filep = vfs_getfile(fd);
+	int ret;
+
+	if (!filep) {
+		return -EBADF;
+	}
+
+	ret = g_mountpt->u.i_mops->close(filep);
+	filep->f_inode = NULL;
+	return ret;
+}
+
+/****************************************************************************
+ * Name: vfs_read
+ ****************************************************************************/
+
+ssize_t vfs_read(int fd, FAR void *buf, size_t nbytes)
+{
+	FAR struct file *filep = vfs_getfile(fd);
+
+	if (!filep) {
+		return -EBADF;
+	}
+
+	return g_mountpt->u.i_mops->read(filep, (FAR char *)buf, nbytes);
+}
+
+/****************************************************************************
+ * Name: vfs_write
+ ****************************************************************************/
+
+ssize_t vfs_write(int fd, FAR const void *buf, size_t nbytes)
+{
+	FAR struct file *filep = vfs_getfile(fd);
+
+	if (!filep) {
+		return -EBADF;
+	}
+
+	return g_mountpt->u.i_mops->write(filep, (FAR const char *)buf, nbytes);
+}
+
+/****************************************************************************
+ * Name: vfs_lseek
+ ****************************************************************************/
+
+off_t vfs_lseek(int fd, off_t offset, int whence)
+{
+	FAR struct file *filep = vfs_getfile(fd);
+
+	if (!filep) {
+		return -EBADF;
+	}
+
+	return g_mountpt->u.i_mops->seek(filep, offset, whence);
+}
+
+/****************************************************************************
+ * Name: vfs_fsync
+ ****************************************************************************/
+
+int vfs_fsync(int fd)
+{
+	FAR struct file *filep = vfs_getfile(fd);
+
+	if (!filep) {
+		return -EBADF;
+	}
+
+	return g_mountpt->u.i_mops->sync(filep);
+}
+
+/****************************************************************************
+ * Name: vfs_stat
+ ****************************************************************************/
+
+int vfs_stat(FAR const char *path, FAR struct stat *buf)
+{
+	if (!g_mountpt) {
+		return -ENODEV;
+	}
+
+	memset(buf, 0, sizeof(struct stat));
+	return g_mountpt->u.i_mops->stat(g_mountpt, vfs_relpath(path), buf);
+}
+
+/****************************************************************************
+ * Name: vfs_statfs
+ ****************************************************************************/
+
+int vfs_statfs(FAR struct statfs *buf)
+{
+	if (!g_mountpt) {
+		return -ENODEV;
+	}
+
+	memset(buf, 0, sizeof(struct statfs));
+	return g_mountpt->u.i_mops->statfs(g_mountpt, buf);
+}
+
+/****************************************************************************
+ * Name: vfs_unlink
+ ****************************************************************************/
+
+int vfs_unlink(FAR const char *path)
+{
+	if (!g_mountpt) {
+		return -ENODEV;
+	}
+
+	return g_mountpt->u.i_mops->unlink(g_mountpt, vfs_relpath(path));
+}
+
+/****************************************************************************
+ * Name: vfs_mkdir
+ ****************************************************************************/
+
+int vfs_mkdir(FAR const char *path, mode_t mode)
+{
+	if (!g_mountpt) {
+		return -ENODEV;
+	}
+
+	return g_mountpt->u.i_mops->mkdir(g_mountpt, vfs_relpath(path), mode);
+}
@@ -0,0 +1,35 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/debug.h
+ *
+ * The lwIP port maps LWIP_ASSERT() and its diagnostics onto DEBUGASSERT()
+ * and lwipdbg() from the TinyAra debug.h, which has no host counterpart.
+ *
+ ****************************************************************************/
+
+#ifndef __TOOLS_TCPSACKBENCH_INCLUDE_DEBUG_H
+#define __TOOLS_TCPSACKBENCH_INCLUDE_DEBUG_H
+
+#include <assert.h>
+#include <stdio.h>
+
+#define DEBUGASSERT(f)  assert(f)
+#define lwipdbg         printf
+
+#endif							/* __TOOLS_TCPSACKBENCH_INCLUDE_DEBUG_H */
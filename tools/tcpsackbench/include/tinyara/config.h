@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/config.h
+ *
+ * Configuration used to build the lwIP TCP core (os/net/lwip/src/core) as a
+ * Linux host program for tcpsackbench.  The TCP settings follow the
+ * artik053 defconfigs.  SACK is compiled in and switched off per connection
+ * by the benchmark, so one build measures both modes.
+ *
+ ****************************************************************************/
+
+#ifndef __TOOLS_TCPSACKBENCH_INCLUDE_TINYARA_CONFIG_H
+#define __TOOLS_TCPSACKBENCH_INCLUDE_TINYARA_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* htons() and friends, from the TinyAra netdb headers on the target */
+
+#include <arpa/inet.h>
+
+#define FAR
+
+#define CONFIG_NET                      1
+#define CONFIG_NET_LWIP                 1
+#define CONFIG_NET_IPv4                 1
+#define CONFIG_NET_GUARDSIZE            2
+
+#define CONFIG_NET_MEM_SIZE             (512 * 1024)
+#define CONFIG_NET_MEM_ALIGNMENT        4
+#define CONFIG_NET_MEMP_NUM_TCP_PCB     4
+#define CONFIG_NET_MEMP_NUM_TCP_SEG     256
+#define CONFIG_NET_PBUF_POOL_SIZE       64
+
+#define CONFIG_NET_TCP                  1
+#define CONFIG_NET_TCP_MSS              1460
+#define CONFIG_NET_TCP_WND              58400
+#define CONFIG_NET_TCP_SND_BUF          29200
+#define CONFIG_NET_TCP_SND_QUEUELEN     80
+#define CONFIG_NET_TCP_QUEUE_OOSEQ      1
+#define CONFIG_NET_TCP_SACK             1
+
+#define CONFIG_NET_STATS                1
+#define CONFIG_NET_TCP_STATS            1
+
+#endif							/* __TOOLS_TCPSACKBENCH_INCLUDE_TINYARA_CONFIG_H */
@@ -0,0 +1,659 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tcpsackbench.c
+ *
+ * Runs a bulk TCP transfer between two lwIP connections inside one host
+ * process.  The lwIP TCP core from os/net/lwip/src/core is linked in
+ * unchanged; the IP layer is replaced by an emulated link with a fixed rate
+ * and delay that drops and reorders segments at random.  The same transfer
+ * is run with and without SACK and the simulated time, goodput and
+ * retransmissions are reported.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <net/lwip/opt.h>
+#include <net/lwip/mem.h>
+#include <net/lwip/memp.h>
+#include <net/lwip/pbuf.h>
+#include <net/lwip/stats.h>
+#include <net/lwip/sys.h>
+#include <net/lwip/tcpip.h>
+#include <net/lwip/tcp_impl.h>
+#include <net/lwip/ipv4/ip.h>
+
+#if !LWIP_TCP_SACK
+#error "tcpsackbench needs CONFIG_NET_TCP_SACK"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DEFAULT_BYTES     (8 * 1024 * 1024)
+#define DEFAULT_RATE      20000		/* kbit/s */
+#define DEFAULT_DELAY     10		/* ms, one way */
+#define DEFAULT_LOSS      1.0		/* percent of data segments */
+#define DEFAULT_REORDER   0.0		/* percent of data segments */
+#define DEFAULT_REDELAY   5			/* ms added to reordered segments */
+#define DEFAULT_RUNS      5
+
+#define BENCH_PORT        5001
+#define BENCH_TIMEOUT     (600 * 1000000ULL)	/* simulated us per transfer */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A segment on its way over the emulated link */
+
+struct packet_s {
+	FAR struct packet_s *next;
+	uint64_t due;				/* delivery time in us */
+	FAR struct pbuf *p;			/* TCP segment, room for the IP header */
+	ip_addr_t src;
+	ip_addr_t dest;
+};
+
+/* One direction of the link: segments are serialized at the link rate,
+ * delayed and delivered in the order of their due time
+ */
+
+struct link_s {
+	FAR struct packet_s *head;
+	uint64_t busy;				/* end of the last serialization */
+	double loss;
+	double reorder;
+	unsigned long packets;
+	unsigned long dropped;
+	unsigned long reordered;
+	unsigned long rexmits;		/* segments below the highest seqno sent */
+	unsigned long rexmit_bytes;
+	u32_t snd_max;
+	int snd_max_valid;
+};
+
+struct result_s {
+	uint64_t time;				/* us from connect to the last byte */
+	unsigned long packets;
+	unsigned long dropped;
+	unsigned long rexmits;
+	unsigned long rexmit_bytes;
+	unsigned long rtos;
+	int complete;
+	int corrupt;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct netif g_netif;
+static ip_addr_t g_client_ip;
+static ip_addr_t g_server_ip;
+
+static struct link_s g_uplink;		/* client to server: data */
+static struct link_s g_downlink;	/* server to client: ACKs */
+
+static uint64_t g_now;				/* simulated time in us */
+static unsigned g_rate = DEFAULT_RATE;
+static unsigned g_delay = DEFAULT_DELAY;
+static unsigned g_redelay = DEFAULT_REDELAY;
+static double g_loss = DEFAULT_LOSS;
+static double g_ackloss;
+static double g_reorder = DEFAULT_REORDER;
+static uint32_t g_rand;
+
+static unsigned long g_bytes = DEFAULT_BYTES;
+static unsigned long g_sent;
+static unsigned long g_received;
+static unsigned long g_corrupt;		/* received bytes that do not match */
+static uint64_t g_start;
+static uint64_t g_end;
+static int g_sack;
+static int g_lossy;
+
+static FAR struct tcp_pcb *g_client;
+static FAR struct tcp_pcb *g_server;
+static u8_t g_txbuf[4 * TCP_MSS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Normally defined by os/net/lwip/src/core/ipv4/ip.c */
+
+struct netif *current_netif;
+const struct ip_hdr *current_header;
+ip_addr_t current_iphdr_src;
+ip_addr_t current_iphdr_dest;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* xorshift32, so that a seed gives the same run on every host libc */
+
+static double bench_random(void)
+{
+	g_rand ^= g_rand << 13;
+	g_rand ^= g_rand >> 17;
+	g_rand ^= g_rand << 5;
+	return (g_rand >> 8) * (100.0 / (1 << 24));
+}
+
+/* Byte at offset 'off' of the transferred stream.  The pattern does not
+ * repeat at any segment or buffer size, so data that is delivered twice,
+ * out of order or from the wrong segment does not match.
+ */
+
+static u8_t bench_pattern(unsigned long off)
+{
+	return (u8_t)(((uint32_t)off * 2654435761u) >> 24);
+}
+
+static void link_reset(FAR struct link_s *link, double loss, double reorder)
+{
+	memset(link, 0, sizeof(*link));
+	link->loss = loss;
+	link->reorder = reorder;
+}
+
+static void link_insert(FAR struct link_s *link, FAR struct packet_s *pkt)
+{
+	FAR struct packet_s **cur = &link->head;
+
+	while (*cur != NULL && (*cur)->due <= pkt->due) {
+		cur = &(*cur)->next;
+	}
+
+	pkt->next = *cur;
+	*cur = pkt;
+}
+
+/* Count data segments that start below the highest sequence number sent
+ * so far, whatever made the stack resend them
+ */
+
+static void link_account(FAR struct link_s *link, FAR struct pbuf *p)
+{
+	FAR struct tcp_hdr *tcphdr = (FAR struct tcp_hdr *)p->payload;
+	u32_t seqno = ntohl(tcphdr->seqno);
+	u32_t len = p->tot_len - TCPH_HDRLEN(tcphdr) * 4;
+
+	if (len == 0) {
+		return;
+	}
+
+	if (link->snd_max_valid && TCP_SEQ_LT(seqno, link->snd_max)) {
+		link->rexmits++;
+		link->rexmit_bytes += len;
+	}
+
+	if (!link->snd_max_valid || TCP_SEQ_GT(seqno + len, link->snd_max)) {
+		link->snd_max = seqno + len;
+		link->snd_max_valid = 1;
+	}
+}
+
+static void link_deliver(FAR struct packet_s *pkt)
+{
+	FAR struct ip_hdr *iphdr;
+
+	if (pbuf_header(pkt->p, IP_HLEN) != 0) {
+		pbuf_free(pkt->p);
+		return;
+	}
+
+	iphdr = (FAR struct ip_hdr *)pkt->p->payload;
+	memset(iphdr, 0, IP_HLEN);
+	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(iphdr, htons(pkt->p->tot_len));
+	IPH_TTL_SET(iphdr, TCP_TTL);
+	IPH_PROTO_SET(iphdr, IP_PROTO_TCP);
+	ip_addr_copy(iphdr->src, pkt->src);
+	ip_addr_copy(iphdr->dest, pkt->dest);
+
+	ip_addr_copy(current_iphdr_src, pkt->src);
+	ip_addr_copy(current_iphdr_dest, pkt->dest);
+	current_netif = &g_netif;
+	current_header = iphdr;
+
+	tcp_input(pkt->p, &g_netif);
+
+	ip_addr_set_any(&current_iphdr_src);
+	ip_addr_set_any(&current_iphdr_dest);
+	current_netif = NULL;
+	current_header = NULL;
+}
+
+static void link_flush(FAR struct link_s *link)
+{
+	FAR struct packet_s *pkt;
+
+	while ((pkt = link->head) != NULL) {
+		link->head = pkt->next;
+		pbuf_free(pkt->p);
+		free(pkt);
+	}
+}
+
+/* The client writes as much as the send buffer and queue take */
+
+static void client_send(FAR struct tcp_pcb *pcb)
+{
+	unsigned long len;
+	unsigned long i;
+
+	while (g_sent < g_bytes) {
+		len = LWIP_MIN(tcp_sndbuf(pcb), sizeof(g_txbuf));
+		len = LWIP_MIN(len, g_bytes - g_sent);
+		if (len == 0) {
+			break;
+		}
+
+		for (i = 0; i < len; i++) {
+			g_txbuf[i] = bench_pattern(g_sent + i);
+		}
+
+		if (tcp_write(pcb, g_txbuf, (u16_t)len, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+			break;
+		}
+
+		g_sent += len;
+	}
+
+	tcp_output(pcb);
+}
+
+static err_t client_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+	client_send(pcb);
+	return ERR_OK;
+}
+
+static err_t client_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	if (!g_sack) {
+		pcb->sack_flags = 0;
+	}
+
+	g_lossy = 1;
+	tcp_sent(pcb, client_sent);
+	client_send(pcb);
+	return ERR_OK;
+}
+
+static err_t server_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	FAR struct pbuf *q;
+	FAR const u8_t *data;
+	u16_t i;
+
+	if (p == NULL) {
+		return ERR_OK;
+	}
+
+	/* Check the data against the pattern the client sent */
+
+	for (q = p; q != NULL; q = q->next) {
+		data = (FAR const u8_t *)q->payload;
+		for (i = 0; i < q->len; i++) {
+			if (g_received + i >= g_bytes || data[i] != bench_pattern(g_received + i)) {
+				g_corrupt++;
+			}
+		}
+
+		g_received += q->len;
+	}
+
+	tcp_recved(pcb, p->tot_len);
+	pbuf_free(p);
+
+	if (g_received >= g_bytes && g_end == 0) {
+		g_end = g_now;
+	}
+
+	return ERR_OK;
+}
+
+static err_t server_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	if (!g_sack) {
+		pcb->sack_flags = 0;
+	}
+
+	g_server = pcb;
+	tcp_recv(pcb, server_recv);
+	return ERR_OK;
+}
+
+/* One transfer of g_bytes from the client to the server */
+
+static int bench_run(int sack, uint32_t seed, FAR struct result_s *res)
+{
+	FAR struct tcp_pcb *listener;
+	FAR struct tcp_pcb *pcb;
+	uint64_t timer;
+	uint64_t next;
+	u8_t nrtx;
+
+	memset(res, 0, sizeof(*res));
+	link_reset(&g_uplink, g_loss, g_reorder);
+	link_reset(&g_downlink, g_ackloss, 0);
+	g_rand = seed ? seed : 1;
+	g_sack = sack;
+	g_lossy = 0;
+	g_sent = 0;
+	g_received = 0;
+	g_corrupt = 0;
+	g_end = 0;
+	g_server = NULL;
+
+	pcb = tcp_new();
+	if (pcb == NULL || tcp_bind(pcb, IP_ADDR_ANY, BENCH_PORT) != ERR_OK) {
+		return -1;
+	}
+
+	listener = tcp_listen(pcb);
+	if (listener == NULL) {
+		return -1;
+	}
+
+	tcp_accept(listener, server_accept);
+
+	g_client = tcp_new();
+	if (g_client == NULL) {
+		return -1;
+	}
+
+	tcp_bind(g_client, &g_client_ip, 0);
+	g_start = g_now;
+	if (tcp_connect(g_client, &g_server_ip, BENCH_PORT, client_connected) != ERR_OK) {
+		return -1;
+	}
+
+	/* Deliver segments in time order, run the lwIP timers every
+	 * TCP_TMR_INTERVAL
+	 */
+
+	timer = g_now + TCP_TMR_INTERVAL * 1000;
+	while (g_end == 0 && g_now - g_start < BENCH_TIMEOUT) {
+		next = timer;
+		if (g_uplink.head != NULL && g_uplink.head->due < next) {
+			next = g_uplink.head->due;
+		}
+
+		if (g_downlink.head != NULL && g_downlink.head->due < next) {
+			next = g_downlink.head->due;
+		}
+
+		g_now = next;
+
+		if (g_now == timer) {
+			nrtx = g_client->nrtx;
+			tcp_tmr();
+			if (g_client->nrtx > nrtx) {
+				res->rtos++;
+			}
+
+			timer += TCP_TMR_INTERVAL * 1000;
+		}
+
+		while (g_uplink.head != NULL && g_uplink.head->due <= g_now) {
+			FAR struct packet_s *pkt = g_uplink.head;
+			g_uplink.head = pkt->next;
+			link_deliver(pkt);
+			free(pkt);
+		}
+
+		while (g_downlink.head != NULL && g_downlink.head->due <= g_now) {
+			FAR struct packet_s *pkt = g_downlink.head;
+			g_downlink.head = pkt->next;
+			link_deliver(pkt);
+			free(pkt);
+		}
+	}
+
+	res->complete = g_end != 0;
+	res->corrupt = g_corrupt != 0;
+	res->time = (res->complete ? g_end : g_now) - g_start;
+	res->packets = g_uplink.packets;
+	res->dropped = g_uplink.dropped;
+	res->rexmits = g_uplink.rexmits;
+	res->rexmit_bytes = g_uplink.rexmit_bytes;
+
+	tcp_abort(g_client);
+	if (g_server != NULL) {
+		tcp_abort(g_server);
+	}
+
+	tcp_close(listener);
+	link_flush(&g_uplink);
+	link_flush(&g_downlink);
+	return 0;
+}
+
+static void show_result(FAR const char *mode, FAR const struct result_s *res, int runs)
+{
+	double secs = res->time / 1e6;
+
+	printf("%-7s %9.2f %10.0f %9lu %8lu %8lu %10.2f %6lu%s\n", mode, secs / runs, g_bytes * 8.0 * runs / 1000 / secs, res->packets / runs, res->dropped / runs, res->rexmits / runs, res->packets ? 100.0 * res->rexmits / res->packets : 0, res->rtos / runs, res->corrupt ? "  (corrupt data)" : res->complete ? "" : "  (incomplete)");
+}
+
+static void show_usage(FAR const char *progname)
+{
+	fprintf(stderr, "USAGE: %s [options]\n", progname);
+	fprintf(stderr, "  -n BYTES    Bytes per transfer (default: %u)\n", DEFAULT_BYTES);
+	fprintf(stderr, "  -b KBITS    Link rate in kbit/s (default: %u)\n", DEFAULT_RATE);
+	fprintf(stderr, "  -d MS       One way delay in ms (default: %u)\n", DEFAULT_DELAY);
+	fprintf(stderr, "  -l PERCENT  Loss of data segments (default: %.1f)\n", DEFAULT_LOSS);
+	fprintf(stderr, "  -a PERCENT  Loss of ACKs (default: 0)\n");
+	fprintf(stderr, "  -r PERCENT  Reordered data segments (default: %.1f)\n", DEFAULT_REORDER);
+	fprintf(stderr, "  -R MS       Extra delay of a reordered segment (default: %u)\n", DEFAULT_REDELAY);
+	fprintf(stderr, "  -c COUNT    Transfers per mode, with seeds 1..COUNT (default: %u)\n", DEFAULT_RUNS);
+	exit(EXIT_FAILURE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* The IP layer of the emulated link: ip_route() knows one interface and
+ * ip_output() copies the segment onto the link of its direction
+ */
+
+struct netif *ip_route(ip_addr_t *dest)
+{
+	return &g_netif;
+}
+
+err_t ip_output(struct pbuf *p, ip_addr_t *src, ip_addr_t *dest, u8_t ttl, u8_t tos, u8_t proto)
+{
+	FAR struct link_s *link;
+	FAR struct packet_s *pkt;
+	uint64_t start;
+
+	link = ip_addr_cmp(src, &g_client_ip) ? &g_uplink : &g_downlink;
+
+	/* Serialize at the link rate, IP header included */
+
+	start = LWIP_MAX(g_now, link->busy);
+	link->busy = start + (uint64_t)(p->tot_len + IP_HLEN) * 8 * 1000 / g_rate;
+	link->packets++;
+	link_account(link, p);
+
+	if (g_lossy && bench_random() < link->loss) {
+		link->dropped++;
+		return ERR_OK;
+	}
+
+	pkt = malloc(sizeof(*pkt));
+	if (pkt == NULL) {
+		return ERR_MEM;
+	}
+
+	pkt->p = pbuf_alloc(PBUF_IP, p->tot_len, PBUF_RAM);
+	if (pkt->p == NULL) {
+		free(pkt);
+		return ERR_MEM;
+	}
+
+	pbuf_copy(pkt->p, p);
+	ip_addr_copy(pkt->src, *src);
+	ip_addr_copy(pkt->dest, *dest);
+	pkt->due = link->busy + g_delay * 1000ULL;
+	if (g_lossy && bench_random() < link->reorder) {
+		pkt->due += g_redelay * 1000ULL;
+		link->reordered++;
+	}
+
+	link_insert(link, pkt);
+	return ERR_OK;
+}
+
+/* Single threaded stand-ins for the TinyAra sys_arch and tcpip thread,
+ * sys_now() runs on the simulated clock (TCP timestamps)
+ */
+
+u32_t sys_now(void)
+{
+	return (u32_t)(g_now / 1000);
+}
+
+err_t sys_mutex_new(sys_mutex_t *mutex)
+{
+	return ERR_OK;
+}
+
+void sys_mutex_lock(sys_mutex_t *mutex)
+{
+}
+
+void sys_mutex_unlock(sys_mutex_t *mutex)
+{
+}
+
+void tcp_timer_needed(void)
+{
+}
+
+err_t tcpip_callback_with_block(tcpip_callback_fn function, void *ctx, u8_t block)
+{
+	function(ctx);
+	return ERR_OK;
+}
+
+int main(int argc, char **argv)
+{
+	struct result_s sum[2];
+	struct result_s res;
+	unsigned runs = DEFAULT_RUNS;
+	unsigned i;
+	int option;
+	int sack;
+
+	while ((option = getopt(argc, argv, "n:b:d:l:a:r:R:c:h")) != -1) {
+		switch (option) {
+		case 'n':
+			g_bytes = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			g_rate = strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			g_delay = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			g_loss = strtod(optarg, NULL);
+			break;
+		case 'a':
+			g_ackloss = strtod(optarg, NULL);
+			break;
+		case 'r':
+			g_reorder = strtod(optarg, NULL);
+			break;
+		case 'R':
+			g_redelay = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			runs = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			show_usage(argv[0]);
+		}
+	}
+
+	if (g_bytes == 0 || g_rate == 0 || runs == 0) {
+		show_usage(argv[0]);
+	}
+
+	mem_init();
+	memp_init();
+	pbuf_init();
+	stats_init();
+	tcp_init();
+
+	IP4_ADDR(&g_client_ip, 10, 0, 0, 1);
+	IP4_ADDR(&g_server_ip, 10, 0, 0, 2);
+	IP4_ADDR(&g_netif.netmask, 255, 255, 255, 0);
+	ip_addr_copy(g_netif.ip_addr, g_client_ip);
+	g_netif.mtu = 1500;
+	g_netif.flags = NETIF_FLAG_UP;
+
+	printf("tcpsackbench: %lu bytes, %u kbit/s, %u ms delay, %.2f%% data loss, %.2f%% ACK loss, %.2f%% reordered by %u ms, %u runs\n", g_bytes, g_rate, g_delay, g_loss, g_ackloss, g_reorder, g_redelay, runs);
+	printf("%-7s %9s %10s %9s %8s %8s %10s %6s\n", "mode", "time(s)", "kbit/s", "segments", "dropped", "rexmits", "rexmit(%)", "RTOs");
+
+	for (sack = 1; sack >= 0; sack--) {
+		memset(&sum[sack], 0, sizeof(sum[sack]));
+		sum[sack].complete = 1;
+		for (i = 0; i < runs; i++) {
+			if (bench_run(sack, i + 1, &res) != 0) {
+				fprintf(stderr, "tcpsackbench: lwIP out of memory\n");
+				return EXIT_FAILURE;
+			}
+
+			sum[sack].time += res.time;
+			sum[sack].packets += res.packets;
+			sum[sack].dropped += res.dropped;
+			sum[sack].rexmits += res.rexmits;
+			sum[sack].rexmit_bytes += res.rexmit_bytes;
+			sum[sack].rtos += res.rtos;
+			sum[sack].complete &= res.complete;
+			sum[sack].corrupt |= res.corrupt;
+		}
+
+		show_result(sack ? "sack" : "nosack", &sum[sack], runs);
+	}
+
+	/* A recovery bug that corrupts the stream must not pass as a result */
+
+	return sum[0].corrupt || sum[1].corrupt ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,318 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/ttrace2json/ttrace2json.c
+ *
+ * Converts the scheduler records written by "ttrace -o" (CONFIG_TTRACE_SCHED,
+ * format in include/tinyara/ttrace_sched.h) to the Chrome trace event JSON
+ * format, which chrome://tracing and Perfetto load directly.
+ *
+ * Every task becomes a thread with a slice for each period it ran,
+ * interrupt handlers are slices on a separate "interrupts" thread and
+ * semaphore block/wake events are instant events on the task concerned.
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include <tinyara/ttrace_sched.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MAX_PIDS      32768
+
+/* Thread that carries the interrupt handler slices */
+
+#define IRQ_TID       -1
+
+#define SWAP32(x)     ((((x) & 0xff) << 24) | (((x) & 0xff00) << 8) | \
+                       (((x) >> 8) & 0xff00) | (((x) >> 24) & 0xff))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FILE *g_out;
+static bool g_first = true;
+static bool g_running[MAX_PIDS];	/* A "running" slice is open */
+static bool g_named[MAX_PIDS];		/* thread_name was emitted */
+static int g_irqdepth;				/* Open interrupt slices */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(const char *progname)
+{
+	fprintf(stderr, "USAGE: %s [-o <out.json>] [<in.trc>]\n", progname);
+	fprintf(stderr, "\nConverts the scheduler records dumped with \"ttrace -o\"\n");
+	fprintf(stderr, "to Chrome trace JSON.  Reads stdin and writes stdout by default.\n");
+}
+
+/* Start a new event object and write the fields common to all events */
+
+static void event_begin(const char *name, char ph, int tid, uint64_t ts)
+{
+	fprintf(g_out, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":0,\"tid\":%d,\"ts\":%llu",
+			g_first ? "" : ",", name, ph, tid, (unsigned long long)ts);
+	g_first = false;
+}
+
+static void emit_name(int tid, const char *name)
+{
+	fprintf(g_out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+			g_first ? "" : ",", tid, name);
+	g_first = false;
+}
+
+static void emit_taskname(const struct ttrace_sched_rec_s *rec)
+{
+	char name[TTRACE_SCHED_NAMELEN + 16];
+	char task[TTRACE_SCHED_NAMELEN + 1];
+	int i;
+
+	memcpy(task, rec->u.name, TTRACE_SCHED_NAMELEN);
+	task[TTRACE_SCHED_NAMELEN] = '\0';
+
+	/* Task names are user supplied; keep the JSON valid */
+
+	for (i = 0; task[i] != '\0'; i++) {
+		if (task[i] == '"' || task[i] == '\\' || (unsigned char)task[i] < 0x20) {
+			task[i] = '_';
+		}
+	}
+
+	snprintf(name, sizeof(name), "%s (%d)", task[0] ? task : "task", rec->pid);
+	emit_name(rec->pid, name);
+	g_named[rec->pid] = true;
+}
+
+static void slice_begin(int pid, int prio, uint64_t ts)
+{
+	if (!g_named[pid]) {
+		char name[16];
+
+		snprintf(name, sizeof(name), "pid %d", pid);
+		emit_name(pid, name);
+		g_named[pid] = true;
+	}
+
+	event_begin("running", 'B', pid, ts);
+	fprintf(g_out, ",\"args\":{\"prio\":%d}}", prio);
+	g_running[pid] = true;
+}
+
+static void slice_end(int pid, uint64_t ts)
+{
+	if (g_running[pid]) {
+		event_begin("running", 'E', pid, ts);
+		fputs("}", g_out);
+		g_running[pid] = false;
+	}
+}
+
+static void convert_record(const struct ttrace_sched_rec_s *rec, uint64_t ts)
+{
+	int pid = rec->pid;
+	int prev;
+	char name[32];
+
+	if (pid < 0 || pid >= MAX_PIDS) {
+		return;
+	}
+
+	switch (rec->type) {
+	case TTRACE_SCHED_START:
+		emit_taskname(rec);
+		event_begin("start", 'i', pid, ts);
+		fputs(",\"s\":\"t\"}", g_out);
+		break;
+
+	case TTRACE_SCHED_NAME:
+		emit_taskname(rec);
+		break;
+
+	case TTRACE_SCHED_STOP:
+		slice_end(pid, ts);
+		event_begin("exit", 'i', pid, ts);
+		fputs(",\"s\":\"t\"}", g_out);
+		break;
+
+	case TTRACE_SCHED_SWITCH:
+		prev = (int16_t)rec->u.a.arg0;
+		if (prev >= 0 && prev < MAX_PIDS) {
+			slice_end(prev, ts);
+		}
+		slice_begin(pid, rec->prio, ts);
+		break;
+
+	case TTRACE_SCHED_IRQENTER:
+		snprintf(name, sizeof(name), "irq %u", rec->u.a.arg0);
+		event_begin(name, 'B', IRQ_TID, ts);
+		fprintf(g_out, ",\"args\":{\"handler\":\"0x%08x\",\"task\":%d}}", rec->u.a.arg1, pid);
+		g_irqdepth++;
+		break;
+
+	case TTRACE_SCHED_IRQLEAVE:
+		/* The ring may start in the middle of a handler */
+
+		if (g_irqdepth > 0) {
+			snprintf(name, sizeof(name), "irq %u", rec->u.a.arg0);
+			event_begin(name, 'E', IRQ_TID, ts);
+			fputs("}", g_out);
+			g_irqdepth--;
+		}
+		break;
+
+	case TTRACE_SCHED_SEMWAIT:
+		event_begin("sem wait", 'i', pid, ts);
+		fprintf(g_out, ",\"s\":\"t\",\"args\":{\"sem\":\"0x%08x\"}}", rec->u.a.arg0);
+		break;
+
+	case TTRACE_SCHED_SEMWAKE:
+		event_begin("sem wake", 'i', pid, ts);
+		if (rec->u.a.arg1 == 0xffffffff) {
+			fprintf(g_out, ",\"s\":\"t\",\"args\":{\"sem\":\"0x%08x\",\"by\":\"interrupt\"}}", rec->u.a.arg0);
+		} else {
+			fprintf(g_out, ",\"s\":\"t\",\"args\":{\"sem\":\"0x%08x\",\"by\":%d}}", rec->u.a.arg0, (int16_t)rec->u.a.arg1);
+		}
+		break;
+
+	default:
+		fprintf(stderr, "Unknown record type %d ignored\n", rec->type);
+		break;
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	struct ttrace_sched_hdr_s hdr;
+	struct ttrace_sched_rec_s rec;
+	const char *outpath = NULL;
+	FILE *in = stdin;
+	uint64_t ts = 0;
+	uint32_t last = 0;
+	uint32_t n;
+	int pid;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "o:h")) != -1) {
+		switch (opt) {
+		case 'o':
+			outpath = optarg;
+			break;
+		default:
+			show_usage(argv[0]);
+			return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (optind < argc) {
+		in = fopen(argv[optind], "rb");
+		if (in == NULL) {
+			perror(argv[optind]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, in) != 1) {
+		fprintf(stderr, "Truncated header\n");
+		return EXIT_FAILURE;
+	}
+
+	if (hdr.magic == SWAP32(TTRACE_SCHED_MAGIC)) {
+		fprintf(stderr, "Big endian traces are not supported\n");
+		return EXIT_FAILURE;
+	}
+
+	if (hdr.magic != TTRACE_SCHED_MAGIC || hdr.version != TTRACE_SCHED_VERSION || hdr.recsize != sizeof(rec)) {
+		fprintf(stderr, "Not a version %d scheduler trace\n", TTRACE_SCHED_VERSION);
+		return EXIT_FAILURE;
+	}
+
+	g_out = stdout;
+	if (outpath != NULL) {
+		g_out = fopen(outpath, "w");
+		if (g_out == NULL) {
+			perror(outpath);
+			return EXIT_FAILURE;
+		}
+	}
+
+	fputs("{\"traceEvents\":[", g_out);
+	emit_name(IRQ_TID, "interrupts");
+
+	for (n = 0; n < hdr.nrecords; n++) {
+		if (fread(&rec, sizeof(rec), 1, in) != 1) {
+			fprintf(stderr, "Truncated after %u of %u records\n", n, hdr.nrecords);
+			break;
+		}
+
+		/* The target timestamps are 32-bit microseconds; make them
+		 * relative to the first record and undo the wrap around.
+		 */
+
+		if (n > 0) {
+			ts += (uint32_t)(rec.ts - last);
+		}
+		last = rec.ts;
+
+		convert_record(&rec, ts);
+	}
+
+	/* Close whatever was still running when recording stopped */
+
+	for (pid = 0; pid < MAX_PIDS; pid++) {
+		slice_end(pid, ts);
+	}
+
+	for (; g_irqdepth > 0; g_irqdepth--) {
+		event_begin("irq", 'E', IRQ_TID, ts);
+		fputs("}", g_out);
+	}
+
+	fprintf(g_out, "\n],\n\"otherData\":{\"records\":%u,\"lost\":%u,\"resolution_us\":%u}}\n",
+			n, hdr.nlost, hdr.tsres);
+
+	if (g_out != stdout) {
+		fclose(g_out);
+	}
+
+	if (in != stdin) {
+		fclose(in);
+	}
+
+	fprintf(stderr, "%u records converted, %u older records were lost\n", n, hdr.nlost);
+	return EXIT_SUCCESS;
+}